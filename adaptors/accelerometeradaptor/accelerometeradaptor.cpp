@@ -46,6 +46,13 @@ AccelerometerAdaptor::AccelerometerAdaptor(const QString& id) :
     setDescription("Input device accelerometer adaptor");
     powerStatePath_ = SensorFrameworkConfig::configuration()->value("accelerometer/powerstate_path").toByteArray();
     accelMultiplier = SensorFrameworkConfig::configuration()->value("accelerometer/multiplier", QVariant(1)).toReal();
+
+    addEventFilter(EV_ABS, ABS_X);
+    addEventFilter(EV_ABS, ABS_Y);
+    addEventFilter(EV_ABS, ABS_Z);
+    addEventFilter(EV_REL, REL_X);
+    addEventFilter(EV_REL, REL_Y);
+    addEventFilter(EV_REL, REL_Z);
 }
 
 AccelerometerAdaptor::~AccelerometerAdaptor()
@@ -47,6 +47,9 @@ ALSAdaptorEvdev::ALSAdaptorEvdev(const QString& id) :
     introduceAvailableDataRange(DataRange(0, 4095, 1));
     unsigned int interval_us = 10 * 1000;
     setDefaultInterval(interval_us);
+
+    addEventFilter(EV_ABS, ABS_X);
+    addEventFilter(EV_ABS, ABS_MISC);
 }
 
 ALSAdaptorEvdev::~ALSAdaptorEvdev()
@@ -89,7 +89,7 @@ void IioAdaptor::setup()
 
     if (deviceId.startsWith("accel")) {
         const QString name = "accelerometer";
-        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(name + "/input_match");
+        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(configKey(name, "input_match"));
         qDebug() << id() << "input_match" << inputMatch;
 
         iioDevice.channelTypeName = "accel";
@@ -104,7 +104,7 @@ void IioAdaptor::setup()
         }
     } else if (deviceId.startsWith("gyro")) {
         const QString name = "gyroscope";
-        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(name + "/input_match");
+        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(configKey(name, "input_match"));
         qDebug() << id() << "input_match" << inputMatch;
 
         iioDevice.channelTypeName = "anglvel";
@@ -118,7 +118,7 @@ void IioAdaptor::setup()
         }
     } else if (deviceId.startsWith("mag")) {
         const QString name = "magnetometer";
-        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(name + "/input_match");
+        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(configKey(name, "input_match"));
         qDebug() << id() << "input_match" << inputMatch;
 
         iioDevice.channelTypeName = "magn";
@@ -132,7 +132,7 @@ void IioAdaptor::setup()
         }
     } else if (deviceId.startsWith("als")) {
         const QString name = "als";
-        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(name + "/input_match");
+        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(configKey(name, "input_match"));
 
         iioDevice.channelTypeName = "illuminance";
         devNodeNumber = findSensor(inputMatch);
@@ -145,7 +145,7 @@ void IioAdaptor::setup()
         }
     } else if (deviceId.startsWith("prox")) {
         const QString name = "proximity";
-        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(name + "/input_match");
+        const QString inputMatch = SensorFrameworkConfig::configuration()->value<QString>(configKey(name, "input_match"));
         qDebug() << id() << name + ":" << "input_match" << inputMatch;
 
         iioDevice.channelTypeName = "proximity";
@@ -173,7 +173,7 @@ void IioAdaptor::setup()
 
     /* Override the scaling factor if asked */
     bool ok;
-    double scale_override = SensorFrameworkConfig::configuration()->value(iioDevice.name + "/scale").toDouble(&ok);
+    double scale_override = SensorFrameworkConfig::configuration()->value(configKey(iioDevice.name, "scale")).toDouble(&ok);
     if (ok) {
         sensordLogD() << id() << "Overriding scale to" << scale_override;
         iioDevice.scale = scale_override;
@@ -206,7 +206,9 @@ int IioAdaptor::findSensor(const QString &sensorName)
     udev_enumerate_scan_devices(enumerate);
     devices = udev_enumerate_get_list_entry(enumerate);
 
-    bool ok2;
+    bool ok2 = false;
+    // Instance n of the adaptor takes the n:th device with the name
+    int skip = instance();
 
     udev_list_entry_foreach(dev_list_entry, devices) {
         const char *path;
@@ -215,7 +217,7 @@ int IioAdaptor::findSensor(const QString &sensorName)
         dev = udev_device_new_from_syspath(udevice, path);
         if (qstrcmp(udev_device_get_subsystem(dev), "iio") == 0) {
             iioDevice.name = QString::fromLatin1(udev_device_get_sysattr_value(dev,"name"));
-            if (iioDevice.name == sensorName) {
+            if (iioDevice.name == sensorName && skip-- == 0) {
                 struct udev_list_entry *sysattr;
                 int j = 0;
                 QString eventName = QString::fromLatin1(udev_device_get_sysname(dev));
@@ -582,6 +584,11 @@ bool IioAdaptor::startSensor()
     return SysfsAdaptor::startSensor();
 }
 
+QString IioAdaptor::iioDevicePath() const
+{
+    return devNodeNumber == -1 ? QString() : iioDevice.devicePath;
+}
+
 void IioAdaptor::stopSensor()
 {
     if (devNodeNumber == -1)
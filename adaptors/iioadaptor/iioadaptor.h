@@ -86,6 +86,7 @@ public:
 
     virtual bool startSensor();
     virtual void stopSensor();
+    virtual QString iioDevicePath() const;
 //    virtual bool standby();
 //    virtual bool resume();
 
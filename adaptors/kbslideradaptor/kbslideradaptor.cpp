@@ -42,6 +42,8 @@ KeyboardSliderAdaptor::KeyboardSliderAdaptor(const QString& id) :
     kbstateBuffer_ = new DeviceAdaptorRingBuffer<KeyboardSliderState>(1);
     setAdaptedSensor("keyboardslider", "Device keyboard slider state", kbstateBuffer_);
     setDescription("Keyboard slider events (via input device)");
+
+    addEventFilter(SELFDEF_EV_KB, SELFDEF_EV_KBSLIDE);
 }
 
 KeyboardSliderAdaptor::~KeyboardSliderAdaptor()
@@ -49,6 +49,8 @@ LidSensorAdaptorEvdev::LidSensorAdaptorEvdev(const QString& id) :
     setAdaptedSensor("lidsensor", "Lid state", lidBuffer_);
     powerStatePath_ = SensorFrameworkConfig::configuration()->value("lidsensor/powerstate_path").toByteArray();
 
+    addEventFilter(SELFDEF_EV_SW, SELFDEF_SW_LID);
+    addEventFilter(EV_MSC, MSC_SCAN);
 }
 
 LidSensorAdaptorEvdev::~LidSensorAdaptorEvdev()
@@ -46,6 +46,13 @@ MagAdaptorEvdev::MagAdaptorEvdev(const QString& id) :
   //  introduceAvailableDataRange(DataRange(0, 4095, 1));
     unsigned int interval_us = 10 * 1000;
     setDefaultInterval(interval_us);
+
+    addEventFilter(EV_ABS, ABS_X);
+    addEventFilter(EV_ABS, ABS_Y);
+    addEventFilter(EV_ABS, ABS_Z);
+    addEventFilter(EV_REL, REL_X);
+    addEventFilter(EV_REL, REL_Y);
+    addEventFilter(EV_REL, REL_Z);
 }
 
 MagAdaptorEvdev::~MagAdaptorEvdev()
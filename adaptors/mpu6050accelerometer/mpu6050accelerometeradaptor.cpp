@@ -24,6 +24,7 @@
 #include <stdio.h>
 
 #include "config.h"
+#include "deviceprobe.h"
 #include "mpu6050accelerometeradaptor.h"
 #include "logging.h"
 #include "datatypes/utils.h"
@@ -38,24 +39,22 @@
 Mpu6050AccelAdaptor::Mpu6050AccelAdaptor (const QString& id) :
     SysfsAdaptor (id, SysfsAdaptor::IntervalMode)
 {
-    struct stat st;
-
     QString xAxisPath = SensorFrameworkConfig::configuration()->value("accelerometer/x_axis_path").toString ();
-    if ( lstat (xAxisPath.toLatin1().constData(), &st) < 0 ) {
+    if (!DeviceProbe::instance().exists(xAxisPath)) {
         sensordLogW () << "x_axis_path: " << xAxisPath << " not found";
         return;
     }
     addPath(xAxisPath, X_AXIS);
 
     QString yAxisPath = SensorFrameworkConfig::configuration()->value("accelerometer/y_axis_path").toString ();
-    if ( lstat (yAxisPath.toLatin1().constData(), &st) < 0 ) {
+    if (!DeviceProbe::instance().exists(yAxisPath)) {
         sensordLogW () << "y_axis_path: " << yAxisPath << " not found";
         return;
     }
     addPath(yAxisPath, Y_AXIS);
 
     QString zAxisPath = SensorFrameworkConfig::configuration()->value("accelerometer/z_axis_path").toString ();
-    if ( lstat (zAxisPath.toLatin1().constData(), &st) < 0 ) {
+    if (!DeviceProbe::instance().exists(zAxisPath)) {
         sensordLogW () << "z_axis_path: " << zAxisPath << " not found";
         return;
     }
@@ -41,6 +41,10 @@ PegatronAccelerometerAdaptor::PegatronAccelerometerAdaptor(const QString& id) :
 
     unsigned int interval_us = 300 * 1000;
     setDefaultInterval(interval_us);
+
+    addEventFilter(EV_ABS, ABS_X);
+    addEventFilter(EV_ABS, ABS_Y);
+    addEventFilter(EV_ABS, ABS_Z);
 }
 
 PegatronAccelerometerAdaptor::~PegatronAccelerometerAdaptor()
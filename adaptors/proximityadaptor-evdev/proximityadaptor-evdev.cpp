@@ -47,6 +47,9 @@ ProximityAdaptorEvdev::ProximityAdaptorEvdev(const QString& id) :
     proximityBuffer_ = new DeviceAdaptorRingBuffer<ProximityData>(1);
     setAdaptedSensor("proximity", "Proximity state", proximityBuffer_);
     powerStatePath_ = SensorFrameworkConfig::configuration()->value("proximity/powerstate_path").toByteArray();
+
+    addEventFilter(EV_SW, SW_FRONT_PROXIMITY);
+    addEventFilter(EV_ABS, ABS_DISTANCE);
 }
 
 ProximityAdaptorEvdev::~ProximityAdaptorEvdev()
@@ -39,6 +39,10 @@ TapAdaptor::TapAdaptor(const QString& id) :
     tapBuffer_ = new DeviceAdaptorRingBuffer<TapData>(1);
     setAdaptedSensor("tap", "Internal accelerometer tap events", tapBuffer_);
     setDescription("Device tap events (lis302d)");
+
+    addEventFilter(EV_KEY, BTN_X);
+    addEventFilter(EV_KEY, BTN_Y);
+    addEventFilter(EV_KEY, BTN_Z);
 }
 
 TapAdaptor::~TapAdaptor()
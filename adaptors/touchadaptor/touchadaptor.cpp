@@ -34,12 +34,31 @@
 #include <unistd.h>
 
 const int TouchAdaptor::HARD_MAX_TOUCH_POINTS = 5;
+const int TouchAdaptor::MAX_SLOTS = 10;
 
-TouchAdaptor::TouchAdaptor(const QString& id) : InputDevAdaptor(id, HARD_MAX_TOUCH_POINTS)
+TouchAdaptor::TouchAdaptor(const QString& id) :
+    InputDevAdaptor(id, HARD_MAX_TOUCH_POINTS),
+    coalesceInterval_us_(0),
+    flushPending_(false)
 {
-    outputBuffer_ = new DeviceAdaptorRingBuffer<TouchData>(1);
+    outputBuffer_ = new DeviceAdaptorRingBuffer<TouchData>(MAX_SLOTS);
     setAdaptedSensor("touch", "Touch screen input", outputBuffer_);
     setDescription("Touch screen events");
+
+    addEventFilter(EV_ABS, ABS_X);
+    addEventFilter(EV_ABS, ABS_Y);
+    addEventFilter(EV_ABS, ABS_Z);
+    addEventFilter(EV_ABS, ABS_PRESSURE);
+    addEventFilter(EV_ABS, ABS_MT_SLOT);
+    addEventFilter(EV_ABS, ABS_MT_TRACKING_ID);
+    addEventFilter(EV_ABS, ABS_MT_POSITION_X);
+    addEventFilter(EV_ABS, ABS_MT_POSITION_Y);
+    addEventFilter(EV_ABS, ABS_MT_PRESSURE);
+    addEventFilter(EV_KEY, BTN_TOUCH);
+    addEventFilter(EV_KEY, BTN_MODE);
+
+    flushTimer_.setSingleShot(true);
+    connect(&flushTimer_, SIGNAL(timeout()), this, SLOT(flushCoalesced()));
 }
 
 TouchAdaptor::~TouchAdaptor()
@@ -105,64 +124,92 @@ bool TouchAdaptor::checkInputDevice(QString path, QString matchString)
     return true;
 }
 
-void TouchAdaptor::interpretEvent(int src, struct input_event *ev)
+TouchTracker& TouchAdaptor::tracker(int src)
 {
-    switch (ev->type) {
-
-        case EV_SYN:
-            commitOutput(src, ev);
-            break;
-
-        case EV_ABS:
-            switch (ev->code) {
-                case ABS_X:
-                    touchValues_[src].x = ev->value;
-                    break;
-                case ABS_Y:
-                    touchValues_[src].y = ev->value;
-                    break;
-                case ABS_Z:
-                    touchValues_[src].z = ev->value;
-                    break;
-            }
-            break;
-
-        case EV_KEY:
-            switch (ev->code) {
-                case BTN_TOUCH:
-                    if (ev->value) {
-                        touchValues_[src].fingerState = TouchData::FingerStateAccurate;
-                    } else {
-                        touchValues_[src].fingerState = TouchData::FingerStateNotPresent;
-                    }
-                    break;
-
-                case BTN_MODE:
-                    if (ev->value && touchValues_[src].fingerState!=TouchData::FingerStateNotPresent) {
-                        touchValues_[src].fingerState = TouchData::FingerStateInaccurate;
-                    }
-                    break;
-            }
-            break;
+    QMap<int, TouchTracker>::iterator it = trackers_.find(src);
+    if (it == trackers_.end()) {
+        it = trackers_.insert(src, TouchTracker(MAX_SLOTS));
     }
+    return *it;
 }
 
-void TouchAdaptor::interpretSync(int src, struct input_event *ev)
+void TouchAdaptor::fdOpened(int pathId, int fd)
+{
+    InputDevAdaptor::fdOpened(pathId, fd);
+
+    QMutexLocker locker(&mutex_);
+    fds_[pathId] = fd;
+}
+
+void TouchAdaptor::interpretEvent(int src, struct input_event *ev)
 {
-    commitOutput(src, ev);
+    QMutexLocker locker(&mutex_);
+    tracker(src).handleEvent(*ev);
 }
 
-void TouchAdaptor::commitOutput(int src, struct input_event *ev)
+void TouchAdaptor::interpretSync(int src, struct input_event *ev)
 {
-    TouchData* d = outputBuffer_->nextSlot();
+    QMutexLocker locker(&mutex_);
+    TouchTracker& touches = tracker(src);
+    touches.handleEvent(*ev);
+    if (touches.needsResync() && !touches.resync(fds_.value(src, -1))) {
+        sensordLogW() << id() << "Could not read contacts back after dropped events, releasing them";
+    }
+    if (!touches.hasChanges()) {
+        return;
+    }
 
-    d->timestamp_ = Utils::getTimeStamp(ev);
-    d->x_ = touchValues_[src].x;
-    d->y_ = touchValues_[src].y;
-    d->z_ = touchValues_[src].z;
-    d->object_ = src;
-    d->state_ = touchValues_[src].fingerState;
+    quint64 timestamp = Utils::getTimeStamp(ev);
+    lastFrame_[src] = timestamp;
+    if (coalesceInterval_us_ && !touches.hasTransitions() &&
+        timestamp - lastCommit_.value(src, 0) < coalesceInterval_us_) {
+        // Motion withheld from the last frame before the contact stops
+        // would otherwise wait for the next frame
+        if (!flushPending_) {
+            flushPending_ = true;
+            int interval_ms = (coalesceInterval_us_ + 999) / 1000;
+            QMetaObject::invokeMethod(&flushTimer_, "start", Qt::QueuedConnection, Q_ARG(int, interval_ms));
+        }
+        return;
+    }
+    commitOutput(src, timestamp);
+}
 
-    outputBuffer_->commit();
+void TouchAdaptor::flushCoalesced()
+{
+    QMutexLocker locker(&mutex_);
+    flushPending_ = false;
+    for (QMap<int, TouchTracker>::iterator it = trackers_.begin(); it != trackers_.end(); ++it) {
+        if (it->hasChanges()) {
+            commitOutput(it.key(), lastFrame_.value(it.key(), 0));
+        }
+    }
+}
+
+void TouchAdaptor::commitOutput(int src, quint64 timestamp)
+{
+    QVector<TouchData> changes = trackers_[src].takeChanges(timestamp, src);
+    foreach (const TouchData& change, changes) {
+        TouchData* d = outputBuffer_->nextSlot();
+        *d = change;
+        outputBuffer_->commit();
+    }
+    lastCommit_[src] = timestamp;
     outputBuffer_->wakeUpReaders();
 }
+
+bool TouchAdaptor::setInterval(const int sessionId, const unsigned int interval_us)
+{
+    Q_UNUSED(sessionId);
+
+    sensordLogD() << id() << "Coalescing touch frames to" << interval_us << "us";
+    QMutexLocker locker(&mutex_);
+    coalesceInterval_us_ = interval_us;
+    return true;
+}
+
+unsigned int TouchAdaptor::interval() const
+{
+    QMutexLocker locker(&mutex_);
+    return coalesceInterval_us_;
+}
@@ -32,11 +32,18 @@
 #include "deviceadaptorringbuffer.h"
 #include <QObject>
 #include "touchdata.h"
+#include "touchtracker.h"
+#include <QMap>
+#include <QMutex>
+#include <QTimer>
 
 /**
  * @brief Adaptor for device touchscreen.
  *
- * Provides input data from touchscreen input device.
+ * Provides input data from touchscreen input device. Contacts are
+ * tracked with multi-touch protocol B, and each frame is reported as
+ * one batch of the contacts it changed. Contacts carry the input device
+ * as TouchData::object_ and the slot as TouchData::slot_.
  */
 class TouchAdaptor : public InputDevAdaptor
 {
@@ -59,21 +66,40 @@ protected:
     TouchAdaptor(const QString& id);
     ~TouchAdaptor();
 
-private:
+    /**
+     * Set the shortest interval between reported touch sets. Frames
+     * arriving faster are coalesced, with the contacts changed in any
+     * of them reported together with the next committed frame, or at
+     * the latest one interval after the withheld frame. Presses and
+     * releases are reported without delay.
+     *
+     * @param sessionId Session requesting the interval.
+     * @param interval_us Interval in microseconds, 0 to report every frame.
+     * @return \c true.
+     */
+    bool setInterval(const int sessionId, const unsigned int interval_us);
 
-    static const int HARD_MAX_TOUCH_POINTS;
+    unsigned int interval() const;
 
     /**
-     * Holds values read from the driver.
+     * Remember the device of the event source for reading its contacts
+     * back after dropped events.
+     *
+     * @param pathId Path ID of the device.
+     * @param fd Open device file descriptor.
      */
-    struct TouchValues {
-        int x;
-        int y;
-        int z;
-        int volume;
-        int toolWidth;
-        TouchData::FingerState fingerState;
-    };
+    void fdOpened(int pathId, int fd);
+
+private slots:
+    /**
+     * Commit frames withheld for coalescing.
+     */
+    void flushCoalesced();
+
+private:
+
+    static const int HARD_MAX_TOUCH_POINTS;
+    static const int MAX_SLOTS;
 
     /**
      * Holds information related to screen properties.
@@ -94,22 +120,43 @@ private:
     bool checkInputDevice(QString path, QString matchString = "");
 
     /**
-     * Interpret a read event and store the received value.
+     * Pass a read event to the contact tracker of the device.
      * @param src Event source.
      * @param ev  Read event.
      */
     void interpretEvent(int src, struct input_event *ev);
 
     /**
-     * Pushes recorded events into filterchain.
+     * Get the contact tracker of an event source.
+     * @param src Event source.
+     * @return Tracker of the source.
+     */
+    TouchTracker& tracker(int src);
+
+    /**
+     * Pushes contacts changed since the last commit into filterchain
+     * as one batch.
      * @param src Event source.
+     * @param timestamp Timestamp of the latest frame.
      */
-    void commitOutput(int src, struct input_event *ev);
+    void commitOutput(int src, quint64 timestamp);
 
+    /**
+     * Close a frame, and commit it unless it is coalesced.
+     * @param src Event source.
+     * @param ev  Read event.
+     */
     void interpretSync(int src, struct input_event *ev);
 
     DeviceAdaptorRingBuffer<TouchData>* outputBuffer_;
-    TouchValues touchValues_[5];
+    QMap<int, TouchTracker> trackers_;   /**< contacts per event source */
+    QMap<int, quint64> lastCommit_;      /**< last commit time per event source */
+    QMap<int, quint64> lastFrame_;       /**< last frame time per event source */
+    QMap<int, int> fds_;                 /**< device descriptor per event source */
+    unsigned int coalesceInterval_us_;   /**< shortest interval between commits */
+    QTimer flushTimer_;                  /**< commits withheld frames, runs in main thread */
+    bool flushPending_;                  /**< flushTimer_ start has been requested */
+    mutable QMutex mutex_;               /**< guards contacts against reader thread and flushTimer_ */
     RangeInfo rangeInfo_;
 };
 
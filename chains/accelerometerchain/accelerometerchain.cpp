@@ -32,6 +32,7 @@
 #include "bin.h"
 #include "bufferreader.h"
 #include "config.h"
+#include "mountmatrix.h"
 #include "logging.h"
 
 #include "coordinatealignfilter.h"
@@ -39,37 +40,28 @@
 AccelerometerChain::AccelerometerChain(const QString& id) :
     AbstractChain(id)
 {
-    setMatrixFromString("1,0,0,\
-                         0,1,0,\
-                         0,0,1");
     SensorManager& sm = SensorManager::instance();
 
-    accelerometerAdaptor_ = sm.requestDeviceAdaptor("accelerometeradaptor");
+    accelerometerAdaptor_ = sm.requestDeviceAdaptor(instanceId("accelerometeradaptor"));
 
     if (accelerometerAdaptor_)
         setValid(accelerometerAdaptor_->isValid());
 
     accelerometerReader_ = new BufferReader<AccelerationData>(1);
 
-    // Get the transformation matrix from config file
-    QString aconvString = SensorFrameworkConfig::configuration()->value<QString>("accelerometer/transformation_matrix", "");
-    if (aconvString.size() > 0)
-    {
-        if (!setMatrixFromString(aconvString))
-        {
-            sensordLogW() << NodeBase::id() << "Failed to parse 'transformation_matrix' configuration key. Coordinate alignment may be invalid";
-        }
-    }
+    // Get the transformation matrix from config file, udev or sysfs
+    MountMatrix mountMatrix = MountMatrix::forSensor(getInstanceId("accelerometer", instance()), "accel",
+                                                     accelerometerAdaptor_ ? accelerometerAdaptor_->iioDevicePath() : QString());
 
     accCoordinateAlignFilter_ = sm.instantiateFilter("coordinatealignfilter");
     Q_ASSERT(accCoordinateAlignFilter_);
-    ((CoordinateAlignFilter*)accCoordinateAlignFilter_)->setMatrix(TMatrix(aconv_));
+    ((CoordinateAlignFilter*)accCoordinateAlignFilter_)->setMatrix(TMatrix(mountMatrix.data_));
 
     outputBuffer_ = new RingBuffer<AccelerationData>(1);
     nameOutputBuffer("accelerometer", outputBuffer_);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(accelerometerReader_, "accelerometer");
     filterBin_->add(accCoordinateAlignFilter_, "acccoordinatealigner");
@@ -97,7 +89,7 @@ AccelerometerChain::~AccelerometerChain()
 
     disconnectFromSource(accelerometerAdaptor_, "accelerometer", accelerometerReader_);
 
-    sm.releaseDeviceAdaptor("accelerometeradaptor");
+    sm.releaseDeviceAdaptor(instanceId("accelerometeradaptor"));
 
     delete accelerometerReader_;
     delete accCoordinateAlignFilter_;
@@ -134,19 +126,3 @@ bool AccelerometerChain::stop()
     }
     return true;
 }
-
-bool AccelerometerChain::setMatrixFromString(const QString& str)
-{
-    QStringList strList = str.split(',');
-    if (strList.size() != 9) {
-        sensordLogW() << id() << "Invalid cell count from matrix. Expected 9, got" << strList.size();
-        return false;
-    }
-
-    for (int i = 0; i < 9; ++i)
-    {
-        aconv_[i/3][i%3] = strList.at(i).toInt();
-    }
-
-    return true;
-}
@@ -70,9 +70,6 @@ protected:
 
 private:
 
-    bool setMatrixFromString(const QString& str);
-
-    double                           aconv_[3][3];
     Bin*                             filterBin_;
 
     DeviceAdaptor*                   accelerometerAdaptor_;
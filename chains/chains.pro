@@ -6,4 +6,7 @@ include( ../common-install.pri )
 SUBDIRS  = accelerometerchain \
            orientationchain \
            magcalibrationchain \
-           compasschain
+           compasschain \
+           environmentchain \
+           gyroscopechain \
+           hingechain
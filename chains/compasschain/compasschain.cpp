@@ -30,7 +30,6 @@
 #include "bufferreader.h"
 #include "config.h"
 #include "logging.h"
-#include "downsamplefilter.h"
 #include "avgaccfilter.h"
 
 #include "datatypes/orientationdata.h"
@@ -78,9 +77,6 @@ CompassChain::CompassChain(const QString& id) :
         declinationFilter = sm.instantiateFilter("declinationfilter");
         Q_ASSERT(declinationFilter);
 
-        downsampleFilter = sm.instantiateFilter("downsamplefilter");
-        Q_ASSERT(downsampleFilter);
-
         avgaccFilter = sm.instantiateFilter("avgaccfilter");
         Q_ASSERT(avgaccFilter);
     }
@@ -92,14 +88,13 @@ CompassChain::CompassChain(const QString& id) :
     nameOutputBuffer("magneticnorth", magneticNorthBuffer); //
 
     // Create buffers for filter chain
-    filterBin = new Bin;
+    filterBin = new Bin(id);
 
     if (!hasOrientationAdaptor) {
         filterBin->add(magReader, "magnetometer");
         filterBin->add(accelerometerReader, "accelerometer");
         filterBin->add(compassFilter, "compassfilter");
         filterBin->add(avgaccFilter, "avgaccelerometer");
-        filterBin->add(downsampleFilter, "downsamplefilter");
     } else {
         ////////////////////
         filterBin->add(orientationdataReader, "orientation");
@@ -112,7 +107,7 @@ CompassChain::CompassChain(const QString& id) :
 
     if (!hasOrientationAdaptor) {
         // magchain > compassfilter > magnorth/declination
-        // accelchain > avg filter > downsamplefilter > compassfilter
+        // accelchain > avg filter > compassfilter
 
         if (!filterBin->join("magnetometer", "source", "compassfilter", "magsink"))
             qDebug() << NodeBase::id() << Q_FUNC_INFO << "magnetometer join failed";
@@ -120,12 +115,9 @@ CompassChain::CompassChain(const QString& id) :
         if (!filterBin->join("accelerometer", "source", "avgaccelerometer", "sink"))
             qDebug() << NodeBase::id() << Q_FUNC_INFO << "accelerometer join failed";
 
-        if (!filterBin->join("avgaccelerometer", "source", "downsamplefilter", "sink"))
+        if (!filterBin->join("avgaccelerometer", "source", "compassfilter", "accsink"))
             qDebug() << NodeBase::id() << Q_FUNC_INFO << "avgaccelerometer join failed";
 
-        if (!filterBin->join("downsamplefilter", "source", "compassfilter", "accsink"))
-            qDebug() << NodeBase::id() << Q_FUNC_INFO << "downsamplefilter join failed";
-
         if (!filterBin->join("compassfilter", "magnorthangle", "magneticnorth", "sink"))
             qDebug() << NodeBase::id() << Q_FUNC_INFO << "compassfilter/magnorth join failed";
 
@@ -167,11 +159,8 @@ CompassChain::CompassChain(const QString& id) :
     introduceAvailableInterval(DataRange(min_interval_us, max_interval_us, 0));
 
     if (!hasOrientationAdaptor) {
-        DownsampleFilter *filter = static_cast<DownsampleFilter *>(downsampleFilter);
-        filter->setTimeout(3000);
-
-        AvgAccFilter *filter2 = static_cast<AvgAccFilter *>(avgaccFilter);
-        filter2->setFactor(0.24);
+        AvgAccFilter *filter = static_cast<AvgAccFilter *>(avgaccFilter);
+        filter->setFactor(0.24);
     }
 
     if (!hasOrientationAdaptor) {
@@ -192,10 +181,13 @@ CompassChain::~CompassChain()
 
     if (!hasOrientationAdaptor) {
         disconnectFromSource(accelerometerChain, "accelerometer", accelerometerReader);
-        disconnectFromSource(magChain, "magnetometer", magReader);
+        disconnectFromSource(magChain, "calibratedmagnetometerdata", magReader);
+        sm.releaseChain("accelerometerchain");
+        sm.releaseChain("magcalibrationchain");
         delete accelerometerReader;
         delete magReader;
         delete compassFilter;
+        delete avgaccFilter;
     } else {
         disconnectFromSource(orientAdaptor, "orientation", orientationdataReader);
         sm.releaseDeviceAdaptor("orientationadaptor");
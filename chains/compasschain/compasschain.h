@@ -80,7 +80,6 @@ private:
     FilterBase *orientationFilter;
     FilterBase *declinationFilter;
 
-    FilterBase *downsampleFilter;
     FilterBase *avgaccFilter;
 
     RingBuffer<CompassData> *trueNorthBuffer;
@@ -11,7 +11,6 @@ SOURCES += compasschain.cpp   \
            orientationfilter.cpp
 
 INCLUDEPATH += ../../filters/coordinatealignfilter \
-               ../../filters/downsamplefilter \
                ../../filters/avgaccfilter \
                ../../chains/magcalibrationchain \
                ../../filters/magcoordinatealignfilter \
@@ -39,15 +39,15 @@ QStringList CompassChainPlugin::Dependencies() {
     QByteArray orientationConfiguration = SensorFrameworkConfig::configuration()->value("plugins/orientationadaptor").toByteArray();
     if (orientationConfiguration.isEmpty()) {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-        return QString("accelerometerchain:magcalibrationchain:declinationfilter:downsamplefilter:avgaccfilter").split(":", Qt::SkipEmptyParts);
+        return QString("accelerometerchain:magcalibrationchain:declinationfilter:avgaccfilter").split(":", Qt::SkipEmptyParts);
 #else
-        return QString("accelerometerchain:magcalibrationchain:declinationfilter:downsamplefilter:avgaccfilter").split(":", QString::SkipEmptyParts);
+        return QString("accelerometerchain:magcalibrationchain:declinationfilter:avgaccfilter").split(":", QString::SkipEmptyParts);
 #endif
     } else {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-        return QString("accelerometerchain:magcalibrationchain:declinationfilter:downsamplefilter:avgaccfilter:orientationadaptor").split(":", Qt::SkipEmptyParts);
+        return QString("accelerometerchain:magcalibrationchain:declinationfilter:avgaccfilter:orientationadaptor").split(":", Qt::SkipEmptyParts);
 #else
-        return QString("accelerometerchain:magcalibrationchain:declinationfilter:downsamplefilter:avgaccfilter:orientationadaptor").split(":", QString::SkipEmptyParts);
+        return QString("accelerometerchain:magcalibrationchain:declinationfilter:avgaccfilter:orientationadaptor").split(":", QString::SkipEmptyParts);
 #endif
     }
 }
@@ -19,6 +19,7 @@
 #include <QDebug>
 #include "compassfilter.h"
 #include "config.h"
+#include "scheduler.h"
 
 #include <QtCore/qmath.h>
 
@@ -30,43 +31,64 @@
 CompassFilter::CompassFilter() :
         magDataSink(this, &CompassFilter::magDataAvailable),
         accelSink(this, &CompassFilter::accelDataAvailable),
+        headingCallback(this, &CompassFilter::updateHeading),
+        headingTimestamp(0),
+        magPending(false),
         magX(0), magY(0), magZ(0),
-        oldMagX(0), oldMagY(0), oldMagZ(0),
+        hasMag(false),
+        hasTilt(false),
         level(0),
-        oldHeading(0)
+        oldHeading(0),
+        headingResolution(1),
+        lastDegrees(-1),
+        lastLevel(-1)
 {
     addSink(&magDataSink, "magsink");
     addSink(&accelSink, "accsink");
     addSource(&magSource, "magnorthangle");
+
+    headingResolution = SensorFrameworkConfig::configuration()->value<int>("compass/resolution", 1);
+    SensorFrameworkConfig::bind<int>("compass/resolution", 1, this, &headingResolution);
 }
 
 void CompassFilter::magDataAvailable(unsigned, const CalibratedMagneticFieldData *data)
 {
-    magX = data->y_ * .001f;
-    magY = data->x_ * .001f;
-    magZ = data->z_ * .001f;
+    if (magPending) {
+        updateHeading();
+    }
+
+    // the x/y are switched as compass expects it in aero coordinates
+    qreal x = data->y_ * .001f;
+    qreal y = data->x_ * .001f;
+    qreal z = data->z_ * .001f;
     level = data->level_;
 
-    magX = oldMagX + FILTER_FACTOR * (magX - oldMagX);
-    magY = oldMagY + FILTER_FACTOR * (magY - oldMagY);
-    magZ = oldMagZ + FILTER_FACTOR * (magZ - oldMagZ);
-    oldMagX = magX;
-    oldMagY = magY;
-    oldMagZ = magZ;
-}
+    magX += FILTER_FACTOR * (x - magX);
+    magY += FILTER_FACTOR * (y - magY);
+    magZ += FILTER_FACTOR * (z - magZ);
+    hasMag = true;
 
+    if (hasTilt) {
+        headingTimestamp = data->timestamp_;
+        magPending = true;
+        Scheduler::defer(this, &headingCallback);
+    }
+}
 
 void CompassFilter::accelDataAvailable(unsigned, const AccelerationData *data)
 {
     // the x/y are switched as compass expects it in aero coordinates
-    qreal Gx = data->y_ * .001f; //convert to g
-    qreal Gy = data->x_ * .001f;
-    qreal Gz = data->z_ * .001f;
+    qreal Gx = data->y_;
+    qreal Gy = data->x_;
+    qreal Gz = data->z_;
 
-    qreal divisor = qSqrt(Gx * Gx + Gy * Gy + Gz * Gz);
-    qreal normalizedGx = Gx / divisor;
-    qreal normalizedGy = Gy / divisor;
-    qreal normalizedGz = Gz / divisor;
+    qreal norm = qSqrt(Gx * Gx + Gy * Gy + Gz * Gz);
+    if (norm == 0) {
+        return;
+    }
+    Gx /= norm;
+    Gy /= norm;
+    Gz /= norm;
 
     ///////////////
     /// this algorithm is from Circuit Cellar Aug 2012
@@ -76,34 +98,42 @@ void CompassFilter::accelDataAvailable(unsigned, const AccelerationData *data)
     /// Circuit Cellar magazine.
     /// http://circuitcellar.com/
     ///
-    qreal Psi = 0;
-    qreal The = 0;
-    qreal Phi = 0;
-    qreal sinAngle = 0;
-    qreal cosAngle = 0;
-    qreal fBfx = 0;
-    qreal fBfy = 0;
-
-    /* calculate roll angle Phi (-180deg, 180deg) and sin, cos */
-    Phi = qAtan2(normalizedGy, normalizedGz); /* Equation 2 */
-    sinAngle = qSin(Phi);
-    cosAngle = qCos(Phi);
-
-    /* de-rotate magY roll angle Phi */
-    fBfy = magY * cosAngle - magZ * sinAngle; /* Equation 5 y component */
-    magZ = magY * sinAngle + magZ * cosAngle;
-    normalizedGz = normalizedGy * sinAngle + normalizedGz * cosAngle;
-
-    /* calculate pitch angle Theta (-90deg, 90deg) and sin, cos*/
-    The = qAtan(-normalizedGx / normalizedGz);  /* Equation 3 */
-    sinAngle = qSin(The);
-    cosAngle = qCos(The);
-
-    /* de-rotate magY pitch angle Theta */
-    fBfx = magX * cosAngle + magZ * sinAngle; /* Equation 5 x component */
+    /// Roll Phi = atan2(Gy, Gz) and pitch Theta = atan(-Gx / Gz') are
+    /// only needed through their sines and cosines, which follow
+    /// directly from the normalized gravity vector.
+    qreal rollNorm = qSqrt(Gy * Gy + Gz * Gz); /* = Gz de-rotated by roll */
+    qreal sinPhi = 0;
+    qreal cosPhi = 1;
+    if (rollNorm > 0) {
+        sinPhi = Gy / rollNorm;
+        cosPhi = Gz / rollNorm;
+    }
+    qreal sinThe = -Gx;
+    qreal cosThe = rollNorm;
+
+    /* Equation 5 x component: de-rotate roll, then pitch */
+    tilt[0][0] = cosThe;
+    tilt[0][1] = sinPhi * sinThe;
+    tilt[0][2] = cosPhi * sinThe;
+    /* Equation 5 y component: de-rotate roll */
+    tilt[1][0] = 0;
+    tilt[1][1] = cosPhi;
+    tilt[1][2] = -sinPhi;
+    hasTilt = true;
+}
+
+void CompassFilter::updateHeading()
+{
+    if (!magPending) {
+        return;
+    }
+    magPending = false;
+
+    qreal fBfx = tilt[0][0] * magX + tilt[0][1] * magY + tilt[0][2] * magZ;
+    qreal fBfy = tilt[1][1] * magY + tilt[1][2] * magZ;
 
     /* calculate yaw = ecompass angle psi (-180deg, 180deg) */
-    Psi = (qAtan2(-fBfy, fBfx) * RADIANS_TO_DEGREES); /* Equation 7 */
+    qreal Psi = (qAtan2(-fBfy, fBfx) * RADIANS_TO_DEGREES); /* Equation 7 */
 
     qreal heading;
     if (Psi < -90.0f && oldHeading > 90.0f) {
@@ -113,12 +143,27 @@ void CompassFilter::accelDataAvailable(unsigned, const AccelerationData *data)
     } else {
         heading = Psi * FILTER_FACTOR + oldHeading * (1.0 - FILTER_FACTOR);
     }
+    if (heading > 180.0f) {
+        heading -= 360.0f;
+    } else if (heading < -180.0f) {
+        heading += 360.0f;
+    }
+    oldHeading = heading;
+
+    int degrees = (int)(heading + 360) % 360;
+    if (lastDegrees >= 0 && level == lastLevel) {
+        int change = qAbs(degrees - lastDegrees);
+        if (qMin(change, 360 - change) < headingResolution.load()) {
+            return;
+        }
+    }
 
     CompassData compassData; //north angle
-    compassData.timestamp_ = data->timestamp_;
-    compassData.degrees_ = (int)(heading + 360) % 360;
+    compassData.timestamp_ = headingTimestamp;
+    compassData.degrees_ = degrees;
     compassData.rawDegrees_ = compassData.degrees_;
     compassData.level_ = level;
     magSource.propagate(1, &compassData);
-    oldHeading = heading;
+    lastDegrees = degrees;
+    lastLevel = level;
 }
@@ -21,10 +21,32 @@
 #define COMPASSFILTER_H
 
 #include <QObject>
+#include <atomic>
 #include "ringbuffer.h"
 #include "orientationdata.h"
 #include "filter.h"
-
+#include "callback.h"
+
+/**
+ * @brief Tilt compensated compass.
+ *
+ * Fuses magnetometer and accelerometer samples into magnetic north
+ * heading. The tilt compensation (roll and pitch de-rotation) depends
+ * only on gravity, so it is kept as a cached 2x3 rotation matrix which
+ * is rebuilt from the normalized gravity vector on accelerometer
+ * samples, without trigonometric functions. Each sample then costs a
+ * matrix-vector product and a single \c atan2.
+ *
+ * Heading is recomputed and low-pass filtered on magnetometer samples
+ * only, so smoothing and output rate follow the magnetometer cadence;
+ * accelerometer samples just refresh the cached tilt used by the next
+ * heading. Heading is deferred to the end of the Scheduler epoch, so a
+ * magnetometer sample uses the tilt of an accelerometer sample from the
+ * same commit, and a second magnetometer sample in one epoch first
+ * produces the heading of the earlier one. Heading is propagated only
+ * when it has moved by at least \c compass/resolution degrees (default
+ * 1) or calibration level has changed.
+ */
 class CompassFilter : public QObject, public FilterBase
 {
     Q_OBJECT
@@ -35,6 +57,12 @@ public:
         return new CompassFilter;
     }
 
+    /**
+     * Smallest heading change, in degrees, that is propagated.
+     */
+    int resolution() const { return headingResolution.load(); }
+    void setResolution(int degrees) { headingResolution = degrees; }
+
 protected:
 
     CompassFilter();
@@ -47,16 +75,25 @@ private:
 
     void magDataAvailable(unsigned, const CalibratedMagneticFieldData*);
     void accelDataAvailable(unsigned, const AccelerationData*);
+    void updateHeading();
+
+    Callback<CompassFilter> headingCallback;
+    quint64 headingTimestamp;
+    bool magPending; /**< mag sample is waiting for updateHeading() */
 
     qreal magX;
     qreal magY;
     qreal magZ;
-    qreal oldMagX;
-    qreal oldMagY;
-    qreal oldMagZ;
+
+    qreal tilt[2][3]; /**< level frame x and y rows of de-rotation matrix */
+    bool hasMag;
+    bool hasTilt;
 
     int level;
     qreal oldHeading;
+    std::atomic<int> headingResolution; /**< updated on configuration reload */
+    int lastDegrees;
+    int lastLevel;
 };
 
 #endif
@@ -0,0 +1,210 @@
+/**
+   @file environmentchain.cpp
+   @brief EnvironmentChain combines temperature and humidity adaptors
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "environmentchain.h"
+#include "environmentfilter.h"
+#include "sensormanager.h"
+#include "bin.h"
+#include "bufferreader.h"
+#include "config.h"
+#include "logging.h"
+
+EnvironmentChain::EnvironmentChain(const QString& id) :
+    AbstractChain(id),
+    filterBin_(NULL),
+    temperatureReader_(NULL),
+    humidityReader_(NULL),
+    environmentFilter_(NULL),
+    outputBuffer_(NULL),
+    temperatureOutput_(NULL),
+    humidityOutput_(NULL)
+{
+    SensorManager& sm = SensorManager::instance();
+
+    temperatureAdaptor_ = sm.requestDeviceAdaptor("temperatureadaptor");
+    humidityAdaptor_ = sm.requestDeviceAdaptor("humidityadaptor");
+    if (!temperatureAdaptor_ || !humidityAdaptor_) {
+        sensordLogW() << id << "temperature or humidity adaptor not available";
+        setValid(false);
+        return;
+    }
+
+    temperatureReader_ = new BufferReader<TimedUnsigned>(1);
+    humidityReader_ = new BufferReader<TimedUnsigned>(1);
+
+    environmentFilter_ = sm.instantiateFilter("environmentfilter");
+    Q_ASSERT(environmentFilter_);
+    connect(static_cast<EnvironmentFilter*>(environmentFilter_), SIGNAL(significantChange()),
+            this, SLOT(significantChange()));
+
+    outputBuffer_ = new RingBuffer<EnvironmentData>(1);
+    nameOutputBuffer("environment", outputBuffer_);
+    temperatureOutput_ = new RingBuffer<TimedUnsigned>(1);
+    nameOutputBuffer("temperature", temperatureOutput_);
+    humidityOutput_ = new RingBuffer<TimedUnsigned>(1);
+    nameOutputBuffer("humidity", humidityOutput_);
+
+    filterBin_ = new Bin(id);
+    filterBin_->add(temperatureReader_, "temperature");
+    filterBin_->add(humidityReader_, "humidity");
+    filterBin_->add(environmentFilter_, "environmentfilter");
+    filterBin_->add(outputBuffer_, "buffer");
+    filterBin_->add(temperatureOutput_, "temperaturebuffer");
+    filterBin_->add(humidityOutput_, "humiditybuffer");
+
+    if (!filterBin_->join("temperature", "source", "environmentfilter", "temperaturesink"))
+        sensordLogW() << NodeBase::id() << "temperature join failed";
+
+    if (!filterBin_->join("humidity", "source", "environmentfilter", "humiditysink"))
+        sensordLogW() << NodeBase::id() << "humidity join failed";
+
+    if (!filterBin_->join("environmentfilter", "source", "buffer", "sink"))
+        sensordLogW() << NodeBase::id() << "environmentfilter join failed";
+
+    if (!filterBin_->join("environmentfilter", "temperature", "temperaturebuffer", "sink"))
+        sensordLogW() << NodeBase::id() << "environmentfilter/temperaturebuffer join failed";
+
+    if (!filterBin_->join("environmentfilter", "humidity", "humiditybuffer", "sink"))
+        sensordLogW() << NodeBase::id() << "environmentfilter/humiditybuffer join failed";
+
+    // Released sessions are removed from the adaptors through the source
+    // list. Any other interval request cascaded to them is overridden
+    // by applyInterval(), as the chain owns their polling interval.
+    connectToSource(temperatureAdaptor_, "temperature", temperatureReader_);
+    connectToSource(humidityAdaptor_, "humidity", humidityReader_);
+
+    setDescription("dew point and heat index from ambient temperature and humidity");
+
+    unsigned int minInterval_us = SensorFrameworkConfig::configuration()->value<unsigned int>("environment/min_interval", 1000) * 1000;
+    unsigned int maxInterval_us = SensorFrameworkConfig::configuration()->value<unsigned int>("environment/max_interval", 60000) * 1000;
+    if (maxInterval_us < minInterval_us)
+        maxInterval_us = minInterval_us;
+    backoff_ = IntervalBackoff(maxInterval_us, SensorFrameworkConfig::configuration()->value<int>("environment/backoff_samples", 4));
+
+    introduceAvailableInterval(DataRange(minInterval_us, maxInterval_us, 0));
+    setDefaultInterval(minInterval_us);
+
+    addStandbyOverrideSource(temperatureAdaptor_);
+    addStandbyOverrideSource(humidityAdaptor_);
+
+    backoffTimer_.setSingleShot(true);
+    connect(&backoffTimer_, SIGNAL(timeout()), this, SLOT(backoff()));
+
+    setValid(true);
+}
+
+EnvironmentChain::~EnvironmentChain()
+{
+    SensorManager& sm = SensorManager::instance();
+
+    if (temperatureAdaptor_) {
+        if (temperatureReader_)
+            disconnectFromSource(temperatureAdaptor_, "temperature", temperatureReader_);
+        sm.releaseDeviceAdaptor("temperatureadaptor");
+    }
+    if (humidityAdaptor_) {
+        if (humidityReader_)
+            disconnectFromSource(humidityAdaptor_, "humidity", humidityReader_);
+        sm.releaseDeviceAdaptor("humidityadaptor");
+    }
+
+    delete temperatureReader_;
+    delete humidityReader_;
+    delete environmentFilter_;
+    delete outputBuffer_;
+    delete temperatureOutput_;
+    delete humidityOutput_;
+    delete filterBin_;
+}
+
+bool EnvironmentChain::start()
+{
+    if (AbstractSensorChannel::start()) {
+        sensordLogD() << id() << "Starting EnvironmentChain";
+        static_cast<EnvironmentFilter*>(environmentFilter_)->reset();
+        backoff_.reset(backoff_.requested() ? backoff_.requested() : defaultInterval());
+        applyInterval();
+        filterBin_->start();
+        temperatureAdaptor_->startSensor();
+        humidityAdaptor_->startSensor();
+    }
+    return true;
+}
+
+bool EnvironmentChain::stop()
+{
+    if (AbstractSensorChannel::stop()) {
+        sensordLogD() << id() << "Stopping EnvironmentChain";
+        backoffTimer_.stop();
+        temperatureAdaptor_->stopSensor();
+        humidityAdaptor_->stopSensor();
+        filterBin_->stop();
+    }
+    return true;
+}
+
+unsigned int EnvironmentChain::interval() const
+{
+    return backoff_.interval();
+}
+
+bool EnvironmentChain::setInterval(int sessionId, unsigned int interval_us)
+{
+    Q_UNUSED(sessionId);
+
+    // Called with the fastest of the session requests
+    backoff_.reset(interval_us);
+    applyInterval();
+    return true;
+}
+
+void EnvironmentChain::significantChange()
+{
+    if (backoff_.change()) {
+        sensordLogD() << id() << "change detected, polling every" << backoff_.interval() << "us";
+        applyInterval();
+    }
+}
+
+void EnvironmentChain::backoff()
+{
+    if (backoff_.expire()) {
+        sensordLogD() << id() << "readings stable, polling every" << backoff_.interval() << "us";
+        applyInterval();
+        return;
+    }
+    if (running())
+        backoffTimer_.start(backoff_.period());
+}
+
+void EnvironmentChain::applyInterval()
+{
+    // Every session polls at the interval of the chain, so that none of
+    // them keeps the adaptors faster while backing off
+    unsigned int interval_us = backoff_.interval();
+    foreach (int sessionId, m_intervalMap.keys()) {
+        temperatureAdaptor_->setIntervalRequest(sessionId, interval_us);
+        humidityAdaptor_->setIntervalRequest(sessionId, interval_us);
+    }
+
+    if (running())
+        backoffTimer_.start(backoff_.period());
+}
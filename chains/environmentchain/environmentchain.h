@@ -0,0 +1,103 @@
+/**
+   @file environmentchain.h
+   @brief EnvironmentChain combines temperature and humidity adaptors
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef ENVIRONMENTCHAIN_H
+#define ENVIRONMENTCHAIN_H
+
+#include <QTimer>
+
+#include "abstractchain.h"
+#include "deviceadaptor.h"
+#include "bufferreader.h"
+#include "filter.h"
+#include "bin.h"
+
+#include "datatypes/timedunsigned.h"
+#include "datatypes/environmentdata.h"
+#include "intervalbackoff.h"
+
+class Bin;
+template <class TYPE> class BufferReader;
+class FilterBase;
+
+/**
+ * @brief Chain producing dew point and heat index from ambient
+ *        temperature and humidity.
+ *
+ * Requested interval acts as the fastest rate the adaptors are polled
+ * with. While readings stay within the reporting thresholds the polling
+ * interval is doubled every \c environment/backoff_samples samples, up
+ * to \c environment/max_interval (ms). Any reported change drops back to
+ * the requested interval.
+ *
+ * <b>Output buffers:</b>
+ * <ul><li>\em environment, reported samples with derived values</li>
+ * <li>\em temperature and \em humidity, the raw adaptor readings of
+ * reported samples</li></ul>
+ */
+class EnvironmentChain : public AbstractChain
+{
+    Q_OBJECT
+
+public:
+    static AbstractChain* factoryMethod(const QString& id)
+    {
+        EnvironmentChain* sc = new EnvironmentChain(id);
+        return sc;
+    }
+
+public Q_SLOTS:
+    bool start();
+    bool stop();
+
+protected:
+    EnvironmentChain(const QString& id);
+    ~EnvironmentChain();
+
+    unsigned int interval() const;
+    bool setInterval(int sessionId, unsigned int interval_us);
+
+private Q_SLOTS:
+    void significantChange();
+    void backoff();
+
+private:
+    void applyInterval();
+
+    Bin* filterBin_;
+
+    DeviceAdaptor* temperatureAdaptor_;
+    DeviceAdaptor* humidityAdaptor_;
+
+    BufferReader<TimedUnsigned>* temperatureReader_;
+    BufferReader<TimedUnsigned>* humidityReader_;
+
+    FilterBase* environmentFilter_;
+
+    RingBuffer<EnvironmentData>* outputBuffer_;
+    RingBuffer<TimedUnsigned>* temperatureOutput_;
+    RingBuffer<TimedUnsigned>* humidityOutput_;
+
+    QTimer backoffTimer_;
+    IntervalBackoff backoff_;
+};
+
+#endif // ENVIRONMENTCHAIN_H
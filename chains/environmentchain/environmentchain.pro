@@ -0,0 +1,13 @@
+TARGET       = environmentchain
+
+HEADERS += environmentchain.h   \
+           environmentchainplugin.h \
+           environmentfilter.h \
+           intervalbackoff.h
+
+SOURCES += environmentchain.cpp   \
+           environmentchainplugin.cpp \
+           environmentfilter.cpp \
+           intervalbackoff.cpp
+
+include( ../chain-config.pri )
@@ -0,0 +1,43 @@
+/**
+   @file environmentchainplugin.cpp
+   @brief Plugin for EnvironmentChain
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "environmentchainplugin.h"
+#include "environmentchain.h"
+#include "environmentfilter.h"
+#include "sensormanager.h"
+#include "logging.h"
+
+void EnvironmentChainPlugin::Register(class Loader&)
+{
+    sensordLogD() << "registering environmentchain";
+    SensorManager& sm = SensorManager::instance();
+
+    sm.registerChain<EnvironmentChain>("environmentchain");
+    sm.registerFilter<EnvironmentFilter>("environmentfilter");
+}
+
+QStringList EnvironmentChainPlugin::Dependencies() {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    return QString("temperatureadaptor:humidityadaptor").split(":", Qt::SkipEmptyParts);
+#else
+    return QString("temperatureadaptor:humidityadaptor").split(":", QString::SkipEmptyParts);
+#endif
+}
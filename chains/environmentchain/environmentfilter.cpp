@@ -0,0 +1,128 @@
+/**
+   @file environmentfilter.cpp
+   @brief Combines temperature and humidity into comfort values
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include <QtCore/qmath.h>
+
+#include "environmentfilter.h"
+#include "config.h"
+
+#define MAGNUS_A 17.62f
+#define MAGNUS_B 243.12f
+
+EnvironmentFilter::EnvironmentFilter() :
+        temperatureSink_(this, &EnvironmentFilter::temperatureDataAvailable),
+        humiditySink_(this, &EnvironmentFilter::humidityDataAvailable),
+        temperatureThreshold_(0),
+        humidityThreshold_(0),
+        temperature_(0),
+        humidity_(0),
+        hasTemperature_(false),
+        hasHumidity_(false),
+        hasReported_(false)
+{
+    addSink(&temperatureSink_, "temperaturesink");
+    addSink(&humiditySink_, "humiditysink");
+    addSource(&source_, "source");
+    addSource(&temperatureSource_, "temperature");
+    addSource(&humiditySource_, "humidity");
+
+    setThresholds(SensorFrameworkConfig::configuration()->value<float>("environment/temperature_threshold", 0.5f),
+                  SensorFrameworkConfig::configuration()->value<float>("environment/humidity_threshold", 2.0f));
+}
+
+void EnvironmentFilter::setThresholds(float temperature, float humidity)
+{
+    temperatureThreshold_ = qMax(temperature, 0.0f);
+    humidityThreshold_ = qMax(humidity, 0.0f);
+}
+
+void EnvironmentFilter::reset()
+{
+    hasReported_ = false;
+}
+
+void EnvironmentFilter::temperatureDataAvailable(unsigned, const TimedUnsigned* data)
+{
+    temperature_ = data->value_;
+    rawTemperature_ = *data;
+    hasTemperature_ = true;
+    evaluate(data->timestamp_);
+}
+
+void EnvironmentFilter::humidityDataAvailable(unsigned, const TimedUnsigned* data)
+{
+    humidity_ = qBound(0.0f, (float)data->value_, 100.0f);
+    rawHumidity_ = *data;
+    hasHumidity_ = true;
+    evaluate(data->timestamp_);
+}
+
+void EnvironmentFilter::evaluate(quint64 timestamp)
+{
+    if (!hasTemperature_ || !hasHumidity_)
+        return;
+
+    if (hasReported_ &&
+        qAbs(temperature_ - reported_.temperature_) < temperatureThreshold_ &&
+        qAbs(humidity_ - reported_.humidity_) < humidityThreshold_)
+        return;
+
+    reported_ = EnvironmentData(timestamp, temperature_, humidity_,
+                                dewPoint(temperature_, humidity_),
+                                heatIndex(temperature_, humidity_));
+    hasReported_ = true;
+
+    source_.propagate(1, &reported_);
+    temperatureSource_.propagate(1, &rawTemperature_);
+    humiditySource_.propagate(1, &rawHumidity_);
+    emit significantChange();
+}
+
+float EnvironmentFilter::dewPoint(float temperature, float humidity)
+{
+    // ln(0) is undefined, the formula is not meaningful below 1% anyway
+    float rh = qBound(1.0f, humidity, 100.0f);
+    float gamma = qLn(rh / 100.0f) + (MAGNUS_A * temperature) / (MAGNUS_B + temperature);
+    return (MAGNUS_B * gamma) / (MAGNUS_A - gamma);
+}
+
+float EnvironmentFilter::heatIndex(float temperature, float humidity)
+{
+    // The regression is defined in Fahrenheit
+    float t = temperature * 9.0f / 5.0f + 32.0f;
+    float rh = qBound(0.0f, humidity, 100.0f);
+
+    float hi = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+
+    if ((hi + t) / 2.0f >= 80.0f) {
+        hi = -42.379f + 2.04901523f * t + 10.14333127f * rh
+             - 0.22475541f * t * rh - 0.00683783f * t * t
+             - 0.05481717f * rh * rh + 0.00122874f * t * t * rh
+             + 0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+
+        if (rh < 13.0f && t >= 80.0f && t <= 112.0f)
+            hi -= ((13.0f - rh) / 4.0f) * qSqrt((17.0f - qAbs(t - 95.0f)) / 17.0f);
+        else if (rh > 85.0f && t >= 80.0f && t <= 87.0f)
+            hi += ((rh - 85.0f) / 10.0f) * ((87.0f - t) / 5.0f);
+    }
+
+    return (hi - 32.0f) * 5.0f / 9.0f;
+}
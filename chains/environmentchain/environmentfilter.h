@@ -0,0 +1,118 @@
+/**
+   @file environmentfilter.h
+   @brief Combines temperature and humidity into comfort values
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef ENVIRONMENTFILTER_H
+#define ENVIRONMENTFILTER_H
+
+#include <QObject>
+
+#include "filter.h"
+#include "datatypes/timedunsigned.h"
+#include "datatypes/environmentdata.h"
+
+/**
+ * @brief Filter deriving dew point and heat index from temperature and
+ *        relative humidity.
+ *
+ * Output is propagated only when either input has moved by at least the
+ * configured threshold since the last reported sample. Every reported
+ * change is also signalled with #significantChange() so that the owning
+ * chain can speed up polling. The raw readings of reported samples are
+ * propagated on \c temperature and \c humidity.
+ */
+class EnvironmentFilter : public QObject, public FilterBase
+{
+    Q_OBJECT
+
+public:
+    static FilterBase* factoryMethod()
+    {
+        return new EnvironmentFilter;
+    }
+
+    /**
+     * Sets the minimum change needed before a new sample is reported.
+     *
+     * @param temperature threshold in degrees Celsius.
+     * @param humidity threshold in relative humidity percent.
+     */
+    void setThresholds(float temperature, float humidity);
+
+    /**
+     * Forget the last reported sample, next complete sample is always
+     * propagated.
+     */
+    void reset();
+
+    /**
+     * Dew point using the Magnus approximation.
+     *
+     * @param temperature temperature in degrees Celsius.
+     * @param humidity relative humidity in percent.
+     * @return dew point in degrees Celsius.
+     */
+    static float dewPoint(float temperature, float humidity);
+
+    /**
+     * Heat index using the NWS Rothfusz regression with the Steadman
+     * approximation for mild conditions.
+     *
+     * @param temperature temperature in degrees Celsius.
+     * @param humidity relative humidity in percent.
+     * @return apparent temperature in degrees Celsius.
+     */
+    static float heatIndex(float temperature, float humidity);
+
+Q_SIGNALS:
+    /**
+     * Emitted when a sample exceeding the thresholds was propagated.
+     */
+    void significantChange();
+
+protected:
+    EnvironmentFilter();
+
+private:
+    Sink<EnvironmentFilter, TimedUnsigned> temperatureSink_;
+    Sink<EnvironmentFilter, TimedUnsigned> humiditySink_;
+    Source<EnvironmentData> source_;
+    Source<TimedUnsigned> temperatureSource_;
+    Source<TimedUnsigned> humiditySource_;
+
+    void temperatureDataAvailable(unsigned, const TimedUnsigned*);
+    void humidityDataAvailable(unsigned, const TimedUnsigned*);
+    void evaluate(quint64 timestamp);
+
+    float temperatureThreshold_;
+    float humidityThreshold_;
+
+    float temperature_;
+    float humidity_;
+    TimedUnsigned rawTemperature_;
+    TimedUnsigned rawHumidity_;
+    bool hasTemperature_;
+    bool hasHumidity_;
+
+    EnvironmentData reported_;
+    bool hasReported_;
+};
+
+#endif // ENVIRONMENTFILTER_H
@@ -0,0 +1,60 @@
+/**
+   @file intervalbackoff.cpp
+   @brief Adaptive polling interval of slowly changing sensors
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "intervalbackoff.h"
+#include <QtGlobal>
+
+IntervalBackoff::IntervalBackoff(unsigned int maxInterval_us, int samples) :
+    requested_(0),
+    current_(0),
+    max_(maxInterval_us),
+    samples_(qMax(1, samples)),
+    changed_(false)
+{
+}
+
+void IntervalBackoff::reset(unsigned int requested_us)
+{
+    requested_ = requested_us;
+    current_ = requested_us;
+    changed_ = false;
+}
+
+bool IntervalBackoff::change()
+{
+    changed_ = true;
+    if (requested_ && current_ != requested_) {
+        reset(requested_);
+        return true;
+    }
+    return false;
+}
+
+bool IntervalBackoff::expire()
+{
+    bool stable = !changed_;
+    changed_ = false;
+    if (stable && current_ < max_) {
+        current_ = qMin(current_ * 2, max_);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+/**
+   @file intervalbackoff.h
+   @brief Adaptive polling interval of slowly changing sensors
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef INTERVALBACKOFF_H
+#define INTERVALBACKOFF_H
+
+/**
+ * @brief Polling interval that backs off while readings are stable.
+ *
+ * Starts at the requested interval. Each time a period of
+ * \c samples intervals passes without a significant change the interval
+ * is doubled, up to the maximum. A significant change drops it back to
+ * the requested interval.
+ */
+class IntervalBackoff
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param maxInterval_us longest interval to back off to.
+     * @param samples number of intervals without change before backing off.
+     */
+    IntervalBackoff(unsigned int maxInterval_us = 0, int samples = 1);
+
+    /**
+     * Start over at the requested interval.
+     *
+     * @param requested_us fastest interval, as requested by clients.
+     */
+    void reset(unsigned int requested_us);
+
+    /**
+     * Note a significant change in readings.
+     *
+     * @return was the interval changed.
+     */
+    bool change();
+
+    /**
+     * Note that a backoff period has passed.
+     *
+     * @return was the interval changed.
+     */
+    bool expire();
+
+    /**
+     * Current interval.
+     */
+    unsigned int interval() const { return current_; }
+
+    /**
+     * Requested interval.
+     */
+    unsigned int requested() const { return requested_; }
+
+    /**
+     * Length of the backoff period at the current interval.
+     *
+     * @return period in milliseconds.
+     */
+    int period() const { return (current_ / 1000) * samples_; }
+
+private:
+    unsigned int requested_;
+    unsigned int current_;
+    unsigned int max_;
+    int samples_;
+    bool changed_;
+};
+
+#endif // INTERVALBACKOFF_H
@@ -0,0 +1,181 @@
+/**
+   @file gyroscopealignfilter.cpp
+   @brief Aligns, scales and removes bias from gyroscope samples
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "gyroscopealignfilter.h"
+#include "logging.h"
+
+#include <QMutexLocker>
+#include <math.h>
+
+GyroscopeAlignFilter::GyroscopeAlignFilter() :
+        Filter<TimedXyzData, GyroscopeAlignFilter, TimedXyzData>(this, &GyroscopeAlignFilter::filter),
+        scale_(1.0),
+        trackingThreshold_(0),
+        trackingSamples_(0),
+        stationaryCount_(0)
+{
+    for (int i = 0; i < 3; ++i) {
+        bias_[i] = 0;
+        stationarySum_[i] = 0;
+    }
+    updateKernel();
+}
+
+TMatrix GyroscopeAlignFilter::matrix() const
+{
+    QMutexLocker locker(&mutex_);
+    return matrix_;
+}
+
+void GyroscopeAlignFilter::setMatrix(const TMatrix& matrix)
+{
+    QMutexLocker locker(&mutex_);
+    matrix_ = matrix;
+    updateKernel();
+}
+
+double GyroscopeAlignFilter::scale() const
+{
+    QMutexLocker locker(&mutex_);
+    return scale_;
+}
+
+void GyroscopeAlignFilter::setScale(double scale)
+{
+    QMutexLocker locker(&mutex_);
+    scale_ = scale;
+    updateKernel();
+}
+
+void GyroscopeAlignFilter::setTransform(const TMatrix& matrix, double scale, const float* bias)
+{
+    QMutexLocker locker(&mutex_);
+    matrix_ = matrix;
+    scale_ = scale;
+    if (bias) {
+        bias_[0] = bias[0];
+        bias_[1] = bias[1];
+        bias_[2] = bias[2];
+    }
+    updateKernel();
+}
+
+TimedXyzData GyroscopeAlignFilter::bias() const
+{
+    QMutexLocker locker(&mutex_);
+    return TimedXyzData(0, bias_[0], bias_[1], bias_[2]);
+}
+
+void GyroscopeAlignFilter::setBias(float x, float y, float z)
+{
+    QMutexLocker locker(&mutex_);
+    bias_[0] = x;
+    bias_[1] = y;
+    bias_[2] = z;
+    updateKernel();
+}
+
+void GyroscopeAlignFilter::setBiasTracking(float threshold, int samples)
+{
+    QMutexLocker locker(&mutex_);
+    trackingThreshold_ = threshold;
+    trackingSamples_ = samples;
+    stationaryCount_ = 0;
+}
+
+void GyroscopeAlignFilter::discontinuity()
+{
+    QMutexLocker locker(&mutex_);
+    stationaryCount_ = 0;
+}
+
+void GyroscopeAlignFilter::updateKernel()
+{
+    // Build aside, then replace the kernel as a whole; caller holds mutex_
+    Kernel kernel;
+    kernel.passThrough_ = true;
+    for (int i = 0; i < 3; ++i) {
+        kernel.offset_[i] = 0;
+        for (int j = 0; j < 3; ++j) {
+            kernel.matrix_[i][j] = scale_ * matrix_.data_[i][j];
+            kernel.offset_[i] += kernel.matrix_[i][j] * bias_[j];
+            if (kernel.matrix_[i][j] != (i == j ? 1.0f : 0.0f)) {
+                kernel.passThrough_ = false;
+            }
+        }
+        if (kernel.offset_[i] != 0) {
+            kernel.passThrough_ = false;
+        }
+    }
+    kernel_ = kernel;
+}
+
+void GyroscopeAlignFilter::trackBias(const TimedXyzData& data)
+{
+    if (fabsf(data.x_ - bias_[0]) > trackingThreshold_ ||
+        fabsf(data.y_ - bias_[1]) > trackingThreshold_ ||
+        fabsf(data.z_ - bias_[2]) > trackingThreshold_) {
+        stationaryCount_ = 0;
+        return;
+    }
+
+    if (stationaryCount_ == 0) {
+        stationarySum_[0] = stationarySum_[1] = stationarySum_[2] = 0;
+    }
+    stationarySum_[0] += data.x_;
+    stationarySum_[1] += data.y_;
+    stationarySum_[2] += data.z_;
+
+    if (++stationaryCount_ >= trackingSamples_) {
+        bias_[0] = stationarySum_[0] / stationaryCount_;
+        bias_[1] = stationarySum_[1] / stationaryCount_;
+        bias_[2] = stationarySum_[2] / stationaryCount_;
+        updateKernel();
+        sensordLogT() << "Gyroscope bias updated to" << bias_[0] << bias_[1] << bias_[2];
+        stationaryCount_ = 0;
+    }
+}
+
+void GyroscopeAlignFilter::filter(unsigned, const TimedXyzData* data)
+{
+    Kernel kernel;
+    {
+        QMutexLocker locker(&mutex_);
+        if (trackingThreshold_ > 0 && trackingSamples_ > 0) {
+            trackBias(*data);
+        }
+        kernel = kernel_;
+    }
+
+    if (kernel.passThrough_) {
+        source_.propagate(1, data);
+        return;
+    }
+
+    const float (*k)[3] = kernel.matrix_;
+    TimedXyzData* aligned = source_.nextSlot();
+    aligned->timestamp_ = data->timestamp_;
+    aligned->x_ = k[0][0] * data->x_ + k[0][1] * data->y_ + k[0][2] * data->z_ - kernel.offset_[0];
+    aligned->y_ = k[1][0] * data->x_ + k[1][1] * data->y_ + k[1][2] * data->z_ - kernel.offset_[1];
+    aligned->z_ = k[2][0] * data->x_ + k[2][1] * data->y_ + k[2][2] * data->z_ - kernel.offset_[2];
+
+    source_.commit();
+}
@@ -0,0 +1,141 @@
+/**
+   @file gyroscopealignfilter.h
+   @brief Aligns, scales and removes bias from gyroscope samples
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef GYROSCOPEALIGNFILTER_H
+#define GYROSCOPEALIGNFILTER_H
+
+#include <QObject>
+#include <QMutex>
+#include "datatypes/genericdata.h"
+#include "coordinatealignfilter.h"
+#include "filter.h"
+
+/**
+ * @brief Gyroscope alignment filter.
+ *
+ * Computes <tt>out = scale * M * (in - bias)</tt> for each sample, where
+ * \c M is the mounting matrix. Matrix, scale and bias are folded into a
+ * single 3x3 kernel and offset vector whenever one of them changes, so
+ * each sample costs one matrix-vector product. Identity transforms pass
+ * samples through untouched.
+ *
+ * Bias can be set explicitly, and optionally tracked: when the raw rate
+ * stays within \c threshold of the current bias on every axis for
+ * \c samples consecutive samples, the device is considered stationary
+ * and the mean of those samples becomes the new bias.
+ *
+ * Setters may be called from another thread than the one processing
+ * samples, e.g. on configuration reload. The kernel is rebuilt aside and
+ * swapped in under a mutex, and each sample uses one consistent kernel.
+ */
+class GyroscopeAlignFilter : public QObject, public Filter<TimedXyzData, GyroscopeAlignFilter, TimedXyzData>
+{
+    Q_OBJECT;
+    Q_PROPERTY(TMatrix transMatrix READ matrix WRITE setMatrix);
+    Q_PROPERTY(double scale READ scale WRITE setScale);
+
+public:
+    /**
+     * Factory method.
+     * @return New GyroscopeAlignFilter instance as FilterBase*.
+     */
+    static FilterBase* factoryMethod() {
+        return new GyroscopeAlignFilter;
+    }
+
+    TMatrix matrix() const;
+    void setMatrix(const TMatrix& matrix);
+
+    double scale() const;
+    void setScale(double scale);
+
+    /**
+     * Set matrix, scale and, unless \c bias is NULL, bias at once, so
+     * that no sample sees only some of them changed.
+     *
+     * @param matrix Mounting matrix.
+     * @param scale Scale factor.
+     * @param bias Bias in raw sensor units and frame, three values.
+     */
+    void setTransform(const TMatrix& matrix, double scale, const float* bias = 0);
+
+    /**
+     * Get current bias in raw sensor units and frame.
+     */
+    TimedXyzData bias() const;
+
+    /**
+     * Set bias in raw sensor units and frame.
+     */
+    void setBias(float x, float y, float z);
+
+    /**
+     * Enable or disable bias tracking.
+     *
+     * @param threshold Largest per-axis deviation from current bias
+     *                  still considered stationary. Zero disables tracking.
+     * @param samples Number of consecutive stationary samples averaged
+     *                into a new bias.
+     */
+    void setBiasTracking(float threshold, int samples);
+
+    /**
+     * Restart stationary detection, so that samples from before a gap
+     * in the data do not end up in the bias.
+     */
+    virtual void discontinuity();
+
+protected:
+    /**
+     * Constructor.
+     */
+    GyroscopeAlignFilter();
+
+private:
+    /**
+     * Folded transform applied to each sample.
+     */
+    struct Kernel
+    {
+        float matrix_[3][3];
+        float offset_[3];
+        bool passThrough_;
+    };
+
+    void filter(unsigned, const TimedXyzData*);
+    void trackBias(const TimedXyzData& data);
+    void updateKernel();
+
+    mutable QMutex mutex_; /**< guards all state below */
+
+    TMatrix matrix_;
+    double scale_;
+    float bias_[3];
+
+    Kernel kernel_;
+
+    float trackingThreshold_;
+    int trackingSamples_;
+    int stationaryCount_;
+    double stationarySum_[3];
+};
+
+#endif // GYROSCOPEALIGNFILTER_H
@@ -0,0 +1,145 @@
+/**
+   @file gyroscopechain.cpp
+   @brief GyroscopeChain
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "gyroscopechain.h"
+#include <QStringList>
+#include "sensormanager.h"
+#include "bin.h"
+#include "bufferreader.h"
+#include "config.h"
+#include "mountmatrix.h"
+#include "logging.h"
+
+#include "gyroscopealignfilter.h"
+
+GyroscopeChain::GyroscopeChain(const QString& id) :
+    AbstractChain(id)
+{
+    SensorManager& sm = SensorManager::instance();
+
+    gyroscopeAdaptor_ = sm.requestDeviceAdaptor(instanceId("gyroscopeadaptor"));
+
+    if (gyroscopeAdaptor_)
+        setValid(gyroscopeAdaptor_->isValid());
+    else
+        setValid(false);
+
+    gyroscopeReader_ = new BufferReader<TimedXyzData>(1);
+
+    gyroscopeAlignFilter_ = sm.instantiateFilter("gyroscopealignfilter");
+    Q_ASSERT(gyroscopeAlignFilter_);
+    configure();
+    connect(SensorFrameworkConfig::watcher(), SIGNAL(reloaded()), this, SLOT(configure()));
+
+    outputBuffer_ = new RingBuffer<TimedXyzData>(1);
+    nameOutputBuffer("gyroscope", outputBuffer_);
+
+    // Create buffers for filter chain
+    filterBin_ = new Bin(id);
+
+    filterBin_->add(gyroscopeReader_, "gyroscope");
+    filterBin_->add(gyroscopeAlignFilter_, "gyroscopealigner");
+    filterBin_->add(outputBuffer_, "buffer");
+
+    // Join filterchain buffers
+    if (!filterBin_->join("gyroscope", "source", "gyroscopealigner", "sink"))
+        qDebug() << NodeBase::id() << Q_FUNC_INFO << "gyroscope/gyroscopealigner join failed";
+
+    if (!filterBin_->join("gyroscopealigner", "source", "buffer", "sink"))
+        qDebug() << NodeBase::id() << Q_FUNC_INFO << "gyroscopealigner/buffer join failed";
+
+    // Join datasources to the chain
+    if (gyroscopeAdaptor_)
+        connectToSource(gyroscopeAdaptor_, "gyroscope", gyroscopeReader_);
+
+    setDescription("Aligned angular velocity");
+    setRangeSource(gyroscopeAdaptor_);
+    addStandbyOverrideSource(gyroscopeAdaptor_);
+    setIntervalSource(gyroscopeAdaptor_);
+}
+
+GyroscopeChain::~GyroscopeChain()
+{
+    SensorManager& sm = SensorManager::instance();
+
+    if (gyroscopeAdaptor_) {
+        disconnectFromSource(gyroscopeAdaptor_, "gyroscope", gyroscopeReader_);
+        sm.releaseDeviceAdaptor(instanceId("gyroscopeadaptor"));
+    }
+
+    delete gyroscopeReader_;
+    delete gyroscopeAlignFilter_;
+    delete outputBuffer_;
+    delete filterBin_;
+}
+
+bool GyroscopeChain::start()
+{
+    if (!gyroscopeAdaptor_) {
+        sensordLogD() << id() << "No gyroscope adaptor to start.";
+        return false;
+    }
+
+    if (AbstractSensorChannel::start()) {
+        sensordLogD() << id() << "Starting GyroscopeChain";
+        filterBin_->start();
+        gyroscopeAdaptor_->startSensor();
+    }
+    return true;
+}
+
+bool GyroscopeChain::stop()
+{
+    if (!gyroscopeAdaptor_) {
+        sensordLogD() << id() << "No gyroscope adaptor to stop.";
+        return false;
+    }
+
+    if (AbstractSensorChannel::stop()) {
+        sensordLogD() << id() << "Stopping GyroscopeChain";
+        gyroscopeAdaptor_->stopSensor();
+        filterBin_->stop();
+    }
+    return true;
+}
+
+void GyroscopeChain::configure()
+{
+    GyroscopeAlignFilter* filter = static_cast<GyroscopeAlignFilter*>(gyroscopeAlignFilter_);
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+
+    MountMatrix mountMatrix = MountMatrix::forSensor(getInstanceId("gyroscope", instance()), "anglvel",
+                                                     gyroscopeAdaptor_ ? gyroscopeAdaptor_->iioDevicePath() : QString());
+    double scale = config->value<double>("gyroscope/scale", 1.0);
+
+    // Samples are filtered in the adaptor thread, replace the whole
+    // transform at once
+    QStringList biasList = config->value<QString>("gyroscope/bias", "").split(',');
+    if (biasList.size() == 3) {
+        float bias[3] = { biasList.at(0).toFloat(), biasList.at(1).toFloat(), biasList.at(2).toFloat() };
+        filter->setTransform(TMatrix(mountMatrix.data_), scale, bias);
+    } else {
+        filter->setTransform(TMatrix(mountMatrix.data_), scale);
+    }
+
+    filter->setBiasTracking(config->value<float>("gyroscope/bias_threshold", 0),
+                            config->value<int>("gyroscope/bias_samples", 50));
+}
@@ -0,0 +1,87 @@
+/**
+   @file gyroscopechain.h
+   @brief GyroscopeChain
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef GYROSCOPECHAIN_H
+#define GYROSCOPECHAIN_H
+
+#include "abstractsensor.h"
+#include "abstractchain.h"
+#include "deviceadaptor.h"
+#include "datatypes/genericdata.h"
+
+class Bin;
+template <class TYPE> class BufferReader;
+class FilterBase;
+
+/**
+ * @brief GyroscopeChain provides angular velocity aligned to the device
+ *        coordinate system, in mdps, with bias removed.
+ *
+ * Mounting matrix is read from \c gyroscope/transformation_matrix, or
+ * when not configured from the IIO \c in_anglvel_mount_matrix
+ * attribute. Scale and bias come from \c gyroscope/scale and
+ * \c gyroscope/bias. Bias tracking is enabled by setting
+ * \c gyroscope/bias_threshold, see #GyroscopeAlignFilter.
+ *
+ * <b>Output buffers:</b>
+ * <ul><li><em>gyroscope</em></li></ul>
+ *
+ * For direct raw data use #GyroscopeAdaptor.
+ */
+class GyroscopeChain : public AbstractChain
+{
+    Q_OBJECT;
+
+public:
+    /**
+     * Factory method for GyroscopeChain.
+     * @return Pointer to new GyroscopeChain instance as AbstractChain*
+     */
+    static AbstractChain* factoryMethod(const QString& id)
+    {
+        GyroscopeChain* sc = new GyroscopeChain(id);
+        return sc;
+    }
+
+public Q_SLOTS:
+    bool start();
+    bool stop();
+
+protected:
+    GyroscopeChain(const QString& id);
+    ~GyroscopeChain();
+
+private Q_SLOTS:
+    /**
+     * Read alignment, scale and bias settings from configuration.
+     */
+    void configure();
+
+private:
+    Bin*                          filterBin_;
+
+    DeviceAdaptor*                gyroscopeAdaptor_;
+    BufferReader<TimedXyzData>*   gyroscopeReader_;
+    FilterBase*                   gyroscopeAlignFilter_;
+    RingBuffer<TimedXyzData>*     outputBuffer_;
+};
+
+#endif // GYROSCOPECHAIN_H
@@ -0,0 +1,13 @@
+TARGET       = gyroscopechain
+
+HEADERS += gyroscopechain.h   \
+           gyroscopechainplugin.h \
+           gyroscopealignfilter.h
+
+SOURCES += gyroscopechain.cpp   \
+           gyroscopechainplugin.cpp \
+           gyroscopealignfilter.cpp
+
+INCLUDEPATH += ../../filters/coordinatealignfilter
+
+include( ../chain-config.pri )
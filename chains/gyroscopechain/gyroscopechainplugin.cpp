@@ -0,0 +1,43 @@
+/**
+   @file gyroscopechainplugin.cpp
+   @brief Plugin for GyroscopeChain
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "gyroscopechainplugin.h"
+#include "gyroscopechain.h"
+#include "gyroscopealignfilter.h"
+#include "sensormanager.h"
+#include "logging.h"
+
+void GyroscopeChainPlugin::Register(class Loader&)
+{
+    sensordLogD() << "registering gyroscopechain";
+    SensorManager& sm = SensorManager::instance();
+
+    sm.registerChain<GyroscopeChain>("gyroscopechain");
+    sm.registerFilter<GyroscopeAlignFilter>("gyroscopealignfilter");
+}
+
+QStringList GyroscopeChainPlugin::Dependencies() {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    return QString("gyroscopeadaptor").split(":", Qt::SkipEmptyParts);
+#else
+    return QString("gyroscopeadaptor").split(":", QString::SkipEmptyParts);
+#endif
+}
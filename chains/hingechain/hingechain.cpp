@@ -0,0 +1,138 @@
+/**
+   @file hingechain.cpp
+   @brief HingeChain derives device posture from base and lid accelerometers
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "hingechain.h"
+#include "hingefilter.h"
+#include "sensormanager.h"
+#include "bin.h"
+#include "bufferreader.h"
+#include "config.h"
+#include "logging.h"
+
+HingeChain::HingeChain(const QString& id) :
+    AbstractChain(id),
+    filterBin_(NULL),
+    baseChain_(NULL),
+    lidChain_(NULL),
+    baseReader_(NULL),
+    lidReader_(NULL),
+    hingeFilter_(NULL),
+    outputBuffer_(NULL)
+{
+    SensorManager& sm = SensorManager::instance();
+
+    baseId_ = SensorFrameworkConfig::configuration()->value<QString>("hinge/base", "accelerometerchain");
+    lidId_ = SensorFrameworkConfig::configuration()->value<QString>("hinge/lid", "accelerometerchain@1");
+
+    baseChain_ = sm.requestChain(baseId_);
+    lidChain_ = sm.requestChain(lidId_);
+    if (!baseChain_ || !lidChain_ || !baseChain_->isValid() || !lidChain_->isValid()) {
+        sensordLogW() << id << "needs both" << baseId_ << "and" << lidId_;
+        setValid(false);
+        return;
+    }
+
+    baseReader_ = new BufferReader<AccelerationData>(1);
+    lidReader_ = new BufferReader<AccelerationData>(1);
+
+    hingeFilter_ = sm.instantiateFilter("hingefilter");
+    Q_ASSERT(hingeFilter_);
+
+    outputBuffer_ = new RingBuffer<PostureData>(1);
+    nameOutputBuffer("posture", outputBuffer_);
+
+    filterBin_ = new Bin(id);
+    filterBin_->add(baseReader_, "base");
+    filterBin_->add(lidReader_, "lid");
+    filterBin_->add(hingeFilter_, "hingefilter");
+    filterBin_->add(outputBuffer_, "buffer");
+
+    if (!filterBin_->join("base", "source", "hingefilter", "basesink"))
+        sensordLogW() << NodeBase::id() << "base join failed";
+
+    if (!filterBin_->join("lid", "source", "hingefilter", "lidsink"))
+        sensordLogW() << NodeBase::id() << "lid join failed";
+
+    if (!filterBin_->join("hingefilter", "source", "buffer", "sink"))
+        sensordLogW() << NodeBase::id() << "hingefilter join failed";
+
+    connectToSource(baseChain_, "accelerometer", baseReader_);
+    connectToSource(lidChain_, "accelerometer", lidReader_);
+
+    setDescription("hinge angle and posture from base and lid accelerometers");
+    introduceAvailableDataRange(DataRange(0, 360, 1));
+    addStandbyOverrideSource(baseChain_);
+    addStandbyOverrideSource(lidChain_);
+    setIntervalSource(baseChain_);
+
+    setValid(true);
+}
+
+HingeChain::~HingeChain()
+{
+    SensorManager& sm = SensorManager::instance();
+
+    if (baseReader_)
+        disconnectFromSource(baseChain_, "accelerometer", baseReader_);
+    if (lidReader_)
+        disconnectFromSource(lidChain_, "accelerometer", lidReader_);
+    if (baseChain_)
+        sm.releaseChain(baseId_);
+    if (lidChain_)
+        sm.releaseChain(lidId_);
+
+    delete baseReader_;
+    delete lidReader_;
+    delete hingeFilter_;
+    delete outputBuffer_;
+    delete filterBin_;
+}
+
+PostureData HingeChain::posture() const
+{
+    HingeFilter* filter = static_cast<HingeFilter*>(hingeFilter_);
+    if (!filter)
+        return PostureData();
+    return filter->current();
+}
+
+bool HingeChain::start()
+{
+    if (AbstractSensorChannel::start()) {
+        sensordLogD() << id() << "Starting HingeChain";
+        static_cast<HingeFilter*>(hingeFilter_)->reset();
+        filterBin_->start();
+        baseChain_->start();
+        lidChain_->start();
+    }
+    return true;
+}
+
+bool HingeChain::stop()
+{
+    if (AbstractSensorChannel::stop()) {
+        sensordLogD() << id() << "Stopping HingeChain";
+        baseChain_->stop();
+        lidChain_->stop();
+        filterBin_->stop();
+    }
+    return true;
+}
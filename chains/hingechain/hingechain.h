@@ -0,0 +1,90 @@
+/**
+   @file hingechain.h
+   @brief HingeChain derives device posture from base and lid accelerometers
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef HINGECHAIN_H
+#define HINGECHAIN_H
+
+#include "abstractchain.h"
+#include "bufferreader.h"
+#include "filter.h"
+#include "bin.h"
+
+#include "datatypes/orientationdata.h"
+#include "datatypes/posturedata.h"
+
+class Bin;
+template <class TYPE> class BufferReader;
+class FilterBase;
+
+/**
+ * @brief Chain producing hinge angle and posture of a convertible from
+ *        two accelerometer chain instances.
+ *
+ * The base is read from \c hinge/base (default \c accelerometerchain)
+ * and the lid from \c hinge/lid (default \c accelerometerchain@1). See
+ * #HingeFilter for the gating done. Output is propagated only when the
+ * posture changes.
+ *
+ * <b>Output buffers:</b>
+ * <ul><li>\em posture</li></ul>
+ */
+class HingeChain : public AbstractChain
+{
+    Q_OBJECT
+    Q_PROPERTY(PostureData posture READ posture)
+
+public:
+    static AbstractChain* factoryMethod(const QString& id)
+    {
+        HingeChain* sc = new HingeChain(id);
+        return sc;
+    }
+
+    /**
+     * Current posture, with the latest gated hinge angle.
+     */
+    PostureData posture() const;
+
+public Q_SLOTS:
+    bool start();
+    bool stop();
+
+protected:
+    HingeChain(const QString& id);
+    ~HingeChain();
+
+private:
+    Bin* filterBin_;
+
+    QString baseId_;
+    QString lidId_;
+    AbstractChain* baseChain_;
+    AbstractChain* lidChain_;
+
+    BufferReader<AccelerationData>* baseReader_;
+    BufferReader<AccelerationData>* lidReader_;
+
+    FilterBase* hingeFilter_;
+
+    RingBuffer<PostureData>* outputBuffer_;
+};
+
+#endif // HINGECHAIN_H
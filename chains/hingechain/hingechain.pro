@@ -0,0 +1,11 @@
+TARGET       = hingechain
+
+HEADERS += hingechain.h   \
+           hingechainplugin.h \
+           hingefilter.h
+
+SOURCES += hingechain.cpp   \
+           hingechainplugin.cpp \
+           hingefilter.cpp
+
+include( ../chain-config.pri )
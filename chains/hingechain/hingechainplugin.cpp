@@ -0,0 +1,43 @@
+/**
+   @file hingechainplugin.cpp
+   @brief Plugin for HingeChain
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "hingechainplugin.h"
+#include "hingechain.h"
+#include "hingefilter.h"
+#include "sensormanager.h"
+#include "logging.h"
+
+void HingeChainPlugin::Register(class Loader&)
+{
+    sensordLogD() << "registering hingechain";
+    SensorManager& sm = SensorManager::instance();
+
+    sm.registerChain<HingeChain>("hingechain");
+    sm.registerFilter<HingeFilter>("hingefilter");
+}
+
+QStringList HingeChainPlugin::Dependencies() {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    return QString("accelerometerchain").split(":", Qt::SkipEmptyParts);
+#else
+    return QString("accelerometerchain").split(":", QString::SkipEmptyParts);
+#endif
+}
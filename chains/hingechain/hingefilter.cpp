@@ -0,0 +1,250 @@
+/**
+   @file hingefilter.cpp
+   @brief Computes hinge angle and posture from base and lid acceleration
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include <QtCore/qmath.h>
+
+#include "hingefilter.h"
+#include "config.h"
+#include "logging.h"
+
+/**
+ * Lower bounds of the posture ranges, in degrees. Closed starts at 0
+ * and Tablet ends at 360.
+ */
+static const float LAPTOP_ANGLE = 15.0f;
+static const float FLAT_ANGLE = 165.0f;
+static const float TENT_ANGLE = 195.0f;
+static const float TABLET_ANGLE = 315.0f;
+
+HingeFilter::HingeFilter() :
+        baseSink_(this, &HingeFilter::baseDataAvailable),
+        lidSink_(this, &HingeFilter::lidDataAvailable),
+        axis_(AxisX),
+        hasBase_(false),
+        hasLid_(false),
+        angle_(0),
+        candidate_(PostureData::Unknown),
+        candidateCount_(0)
+{
+    addSink(&baseSink_, "basesink");
+    addSink(&lidSink_, "lidsink");
+    addSource(&source_, "source");
+
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    QString axis = config->value<QString>("hinge/axis", "x");
+    if (!parseAxis(axis, axis_))
+        sensordLogW() << "Invalid hinge/axis" << axis << ", using x";
+    setGating(config->value<float>("hinge/min_projection", 0.5f),
+              config->value<float>("hinge/max_mismatch", 0.15f),
+              config->value<quint64>("hinge/max_skew", 50) * 1000,
+              config->value<int>("hinge/stable_samples", 5),
+              config->value<float>("hinge/hysteresis", 10.0f));
+}
+
+double HingeFilter::angle() const
+{
+    QMutexLocker locker(&mutex_);
+    return angle_;
+}
+
+int HingeFilter::posture() const
+{
+    QMutexLocker locker(&mutex_);
+    return reported_.posture_;
+}
+
+PostureData HingeFilter::current() const
+{
+    QMutexLocker locker(&mutex_);
+    return PostureData(0, reported_.posture_, angle_);
+}
+
+void HingeFilter::setAxis(Axis axis)
+{
+    QMutexLocker locker(&mutex_);
+    axis_ = axis;
+}
+
+void HingeFilter::setGating(float minProjection, float maxMismatch, quint64 maxSkew, int stableSamples, float hysteresis)
+{
+    QMutexLocker locker(&mutex_);
+    minProjection_ = qBound(0.0f, minProjection, 1.0f);
+    maxMismatch_ = qMax(maxMismatch, 0.0f);
+    maxSkew_ = maxSkew;
+    stableSamples_ = qMax(stableSamples, 1);
+    hysteresis_ = qBound(0.0f, hysteresis, LAPTOP_ANGLE);
+}
+
+void HingeFilter::reset()
+{
+    QMutexLocker locker(&mutex_);
+    hasBase_ = false;
+    hasLid_ = false;
+    candidate_ = PostureData::Unknown;
+    candidateCount_ = 0;
+    reported_ = PostureData();
+}
+
+void HingeFilter::discontinuity()
+{
+    // Keep the reported posture, but do not pair samples across the gap
+    QMutexLocker locker(&mutex_);
+    hasBase_ = false;
+    hasLid_ = false;
+    candidate_ = PostureData::Unknown;
+    candidateCount_ = 0;
+}
+
+bool HingeFilter::parseAxis(const QString& str, Axis& axis)
+{
+    QString name = str.trimmed().toLower();
+    if (name == "x" || name == "+x")
+        axis = AxisX;
+    else if (name == "-x")
+        axis = AxisNegX;
+    else if (name == "y" || name == "+y")
+        axis = AxisY;
+    else if (name == "-y")
+        axis = AxisNegY;
+    else
+        return false;
+    return true;
+}
+
+bool HingeFilter::hingeAngle(const AccelerationData& base, const AccelerationData& lid, Axis axis, float minProjection, float& angle)
+{
+    // Components on the plane normal to the hinge, in right-handed order
+    float bu, bv, lu, lv;
+    if (axis == AxisX || axis == AxisNegX) {
+        bu = base.y_; bv = base.z_;
+        lu = lid.y_; lv = lid.z_;
+    } else {
+        bu = base.z_; bv = base.x_;
+        lu = lid.z_; lv = lid.x_;
+    }
+
+    float baseNorm = qSqrt(base.x_ * base.x_ + base.y_ * base.y_ + base.z_ * base.z_);
+    float lidNorm = qSqrt(lid.x_ * lid.x_ + lid.y_ * lid.y_ + lid.z_ * lid.z_);
+    if (baseNorm == 0 || lidNorm == 0)
+        return false;
+    if (qSqrt(bu * bu + bv * bv) < minProjection * baseNorm ||
+        qSqrt(lu * lu + lv * lv) < minProjection * lidNorm)
+        return false;
+
+    // Gravity seen by the lid turns opposite to the lid itself
+    float rotation = qAtan2(bu * lv - bv * lu, bu * lu + bv * lv) * 180.0f / M_PI;
+    if (axis == AxisNegX || axis == AxisNegY)
+        rotation = -rotation;
+
+    angle = 180.0f - rotation;
+    if (angle >= 360.0f)
+        angle -= 360.0f;
+    return true;
+}
+
+PostureData::Posture HingeFilter::classify(float angle, PostureData::Posture current, float hysteresis)
+{
+    // Closed and fully folded back look the same, stay where we are
+    if (current == PostureData::Closed && angle > 360.0f - hysteresis)
+        angle -= 360.0f;
+    else if (current == PostureData::Tablet && angle < hysteresis)
+        angle += 360.0f;
+
+    float low = 0;
+    float high = 360.0f;
+    bool known = true;
+    switch (current) {
+        case PostureData::Closed: high = LAPTOP_ANGLE; break;
+        case PostureData::Laptop: low = LAPTOP_ANGLE; high = FLAT_ANGLE; break;
+        case PostureData::Flat:   low = FLAT_ANGLE; high = TENT_ANGLE; break;
+        case PostureData::Tent:   low = TENT_ANGLE; high = TABLET_ANGLE; break;
+        case PostureData::Tablet: low = TABLET_ANGLE; break;
+        default: known = false; break;
+    }
+    if (known && angle >= low - hysteresis && angle < high + hysteresis)
+        return current;
+
+    if (angle < LAPTOP_ANGLE)
+        return PostureData::Closed;
+    if (angle < FLAT_ANGLE)
+        return PostureData::Laptop;
+    if (angle < TENT_ANGLE)
+        return PostureData::Flat;
+    if (angle < TABLET_ANGLE)
+        return PostureData::Tent;
+    return PostureData::Tablet;
+}
+
+void HingeFilter::baseDataAvailable(unsigned, const AccelerationData* data)
+{
+    QMutexLocker locker(&mutex_);
+    base_ = *data;
+    hasBase_ = true;
+    evaluate();
+}
+
+void HingeFilter::lidDataAvailable(unsigned, const AccelerationData* data)
+{
+    QMutexLocker locker(&mutex_);
+    lid_ = *data;
+    hasLid_ = true;
+    evaluate();
+}
+
+// Called with mutex_ held. Propagating under it also keeps the two
+// adaptor threads from writing the output buffer at the same time.
+void HingeFilter::evaluate()
+{
+    if (!hasBase_ || !hasLid_)
+        return;
+
+    quint64 timestamp = qMax(base_.timestamp_, lid_.timestamp_);
+    quint64 skew = timestamp - qMin(base_.timestamp_, lid_.timestamp_);
+    if (skew > maxSkew_)
+        return;
+
+    float baseNorm = qSqrt(base_.x_ * base_.x_ + base_.y_ * base_.y_ + base_.z_ * base_.z_);
+    float lidNorm = qSqrt(lid_.x_ * lid_.x_ + lid_.y_ * lid_.y_ + lid_.z_ * lid_.z_);
+    float angle;
+    if (qAbs(baseNorm - lidNorm) > maxMismatch_ * qMax(baseNorm, lidNorm) ||
+        !hingeAngle(base_, lid_, axis_, minProjection_, angle)) {
+        candidateCount_ = 0;
+        return;
+    }
+    angle_ = angle;
+
+    PostureData::Posture posture = classify(angle, reported_.posture_, hysteresis_);
+    if (posture == reported_.posture_) {
+        candidateCount_ = 0;
+        return;
+    }
+    if (posture != candidate_) {
+        candidate_ = posture;
+        candidateCount_ = 0;
+    }
+    if (++candidateCount_ < stableSamples_)
+        return;
+
+    candidateCount_ = 0;
+    reported_ = PostureData(timestamp, posture, angle);
+    sensordLogD() << "Hinge posture" << posture << "at" << angle << "degrees";
+    source_.propagate(1, &reported_);
+}
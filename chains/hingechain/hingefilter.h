@@ -0,0 +1,187 @@
+/**
+   @file hingefilter.h
+   @brief Computes hinge angle and posture from base and lid acceleration
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef HINGEFILTER_H
+#define HINGEFILTER_H
+
+#include <QObject>
+#include <QMutex>
+
+#include "filter.h"
+#include "datatypes/orientationdata.h"
+#include "datatypes/posturedata.h"
+
+/**
+ * @brief Filter deriving the hinge angle and posture of a convertible
+ *        from the acceleration measured in its base and in its lid.
+ *
+ * Both accelerometers must report in the device frame of the base, as
+ * if the lid was opened flat, i.e. with mounting matrices applied. The
+ * angle is the rotation between the two gravity vectors projected on the
+ * plane normal to the hinge axis.
+ *
+ * A pair of samples is used only when
+ * <ul>
+ * <li>they are at most \c maxSkew apart,</li>
+ * <li>gravity is at least \c minProjection (as fraction of its length)
+ *     off the hinge axis in both, otherwise the angle is undefined, and</li>
+ * <li>the magnitudes differ by at most \c maxMismatch (as fraction), as
+ *     they don't while the device is moved.</li>
+ * </ul>
+ * A new posture is propagated only after it has been seen in
+ * \c stableSamples consecutive pairs. The range of the current posture
+ * is widened by \c hysteresis degrees on both sides.
+ *
+ * Base and lid samples arrive from different adaptor threads, and the
+ * posture is read from the main thread, so the state is guarded by a
+ * mutex.
+ */
+class HingeFilter : public QObject, public FilterBase
+{
+    Q_OBJECT
+    Q_PROPERTY(double angle READ angle)
+    Q_PROPERTY(int posture READ posture)
+
+public:
+    static FilterBase* factoryMethod()
+    {
+        return new HingeFilter;
+    }
+
+    /**
+     * Hinge axis in device frame, with direction such that opening
+     * the lid is a positive rotation.
+     */
+    enum Axis
+    {
+        AxisX = 0,   /**< hinge along +x */
+        AxisNegX,    /**< hinge along -x */
+        AxisY,       /**< hinge along +y */
+        AxisNegY     /**< hinge along -y */
+    };
+
+    /**
+     * Latest hinge angle which passed gating, in degrees.
+     */
+    double angle() const;
+
+    /**
+     * Current stable posture, as PostureData::Posture.
+     */
+    int posture() const;
+
+    /**
+     * Current stable posture with the latest angle, read together.
+     */
+    PostureData current() const;
+
+    /**
+     * Set hinge axis.
+     */
+    void setAxis(Axis axis);
+
+    /**
+     * Set gating parameters, see class description.
+     *
+     * @param minProjection smallest projected to total gravity ratio.
+     * @param maxMismatch largest relative difference of magnitudes.
+     * @param maxSkew largest timestamp difference of a pair (microsec).
+     * @param stableSamples pairs needed to accept a new posture.
+     * @param hysteresis extension of the current posture range (degrees).
+     */
+    void setGating(float minProjection, float maxMismatch, quint64 maxSkew, int stableSamples, float hysteresis);
+
+    /**
+     * Forget the current posture, next stable posture is always
+     * propagated.
+     */
+    void reset();
+
+    /**
+     * Drop unpaired samples and the pending posture after a gap in the
+     * data. The reported posture is kept.
+     */
+    virtual void discontinuity();
+
+    /**
+     * Compute hinge angle of a pair of samples.
+     *
+     * @param base acceleration of the base.
+     * @param lid acceleration of the lid.
+     * @param axis hinge axis.
+     * @param minProjection smallest projected to total gravity ratio.
+     * @param angle computed angle in degrees, [0, 360).
+     * @return was the angle defined.
+     */
+    static bool hingeAngle(const AccelerationData& base, const AccelerationData& lid, Axis axis, float minProjection, float& angle);
+
+    /**
+     * Posture of a hinge angle.
+     *
+     * @param angle hinge angle in degrees.
+     * @param current current posture, whose range is widened.
+     * @param hysteresis widening in degrees.
+     * @return posture.
+     */
+    static PostureData::Posture classify(float angle, PostureData::Posture current, float hysteresis);
+
+    /**
+     * Parse hinge axis from configuration value \c x, \c -x, \c y or \c -y.
+     *
+     * @param str string to parse.
+     * @param axis parsed axis.
+     * @return was string valid.
+     */
+    static bool parseAxis(const QString& str, Axis& axis);
+
+protected:
+    HingeFilter();
+
+private:
+    Sink<HingeFilter, AccelerationData> baseSink_;
+    Sink<HingeFilter, AccelerationData> lidSink_;
+    Source<PostureData> source_;
+
+    void baseDataAvailable(unsigned, const AccelerationData*);
+    void lidDataAvailable(unsigned, const AccelerationData*);
+    void evaluate();
+
+    Axis axis_;
+    float minProjection_;
+    float maxMismatch_;
+    quint64 maxSkew_;
+    int stableSamples_;
+    float hysteresis_;
+
+    AccelerationData base_;
+    AccelerationData lid_;
+    bool hasBase_;
+    bool hasLid_;
+
+    double angle_;
+    PostureData::Posture candidate_;
+    int candidateCount_;
+    PostureData reported_;
+
+    mutable QMutex mutex_;
+};
+
+#endif // HINGEFILTER_H
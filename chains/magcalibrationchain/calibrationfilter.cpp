@@ -47,8 +47,9 @@ CalibrationFilter::CalibrationFilter() :
     minMaxList.insert(2,qMakePair(0,0));
 
     manualCalibration = SensorFrameworkConfig::configuration()->value<bool>("magnetometer/needs_calibration", false);
+    SensorFrameworkConfig::bind<bool>("magnetometer/needs_calibration", false, this, &manualCalibration);
 
-    qDebug() << Q_FUNC_INFO << manualCalibration;
+    qDebug() << Q_FUNC_INFO << manualCalibration.load();
 #ifdef CALIBRATE_DATA
     unCalibratedData.setFileName("sensor.csv");
     calibratedData.setFileName("sensor-calibrated.csv");
@@ -76,7 +77,7 @@ void CalibrationFilter::magDataAvailable(unsigned, const CalibratedMagneticField
     transformed.z_ = data->rz_;
     transformed.level_ = data->level_;
 
-    if (manualCalibration) {
+    if (manualCalibration.load()) {
 
         //    simple hard iron correction
         if (minMaxList.at(0).first == 0) {
@@ -26,6 +26,7 @@
 #include "filter.h"
 
 #include <QFile>
+#include <atomic>
 
 class CalibrationFilter : public QObject, public Filter<CalibratedMagneticFieldData, CalibrationFilter, CalibratedMagneticFieldData>
 {
@@ -76,7 +77,7 @@ private:
     QTextStream stream;
     QTextStream calibratedStream;
     int dataPoints;
-    bool manualCalibration;
+    std::atomic<bool> manualCalibration; /**< updated on configuration reload */
 
 };
 
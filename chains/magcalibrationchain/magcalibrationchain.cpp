@@ -26,6 +26,7 @@
 #include "bin.h"
 #include "bufferreader.h"
 #include "config.h"
+#include "mountmatrix.h"
 #include "logging.h"
 #include "calibrationfilter.h"
 
@@ -37,30 +38,24 @@ MagCalibrationChain::MagCalibrationChain(const QString& id) :
     AbstractChain(id),
     filterBin(NULL),
     magAdaptor(NULL),
+    orientAdaptor(NULL),
     magReader(NULL),
     magCalFilter(NULL),
     magScaleFilter(NULL),
     magCoordinateAlignFilter_(NULL),
     calibratedMagnetometerData(NULL)
 {
-    setMatrixFromString("1,0,0,\
-                         0,1,0,\
-                         0,0,1");
     SensorManager& sm = SensorManager::instance();
 
-    magAdaptor = sm.requestDeviceAdaptor("magnetometeradaptor");
+    magAdaptor = sm.requestDeviceAdaptor(instanceId("magnetometeradaptor"));
     // valid is false by default so no need to set it if magnetormeter adaptor is not there
     if (magAdaptor)
         setValid(magAdaptor->isValid());
 
 // SensorFrameworkConfig::configuration()->value<int>("magnetometer/interval_compensation", 16);
-    // Get the transformation matrix from config file
-    QString aconvString = SensorFrameworkConfig::configuration()->value<QString>("magnetometer/transformation_matrix", "");
-    if (aconvString.size() > 0) {
-        if (!setMatrixFromString(aconvString)) {
-            sensordLogW()<< NodeBase::id() << "Failed to parse 'transformation_matrix' configuration key. Coordinate alignment may be invalid";
-        }
-    }
+    // Get the transformation matrix from config file, udev or sysfs
+    MountMatrix mountMatrix = MountMatrix::forSensor(getInstanceId("magnetometer", instance()), "magn",
+                                                     magAdaptor ? magAdaptor->iioDevicePath() : QString());
 
     needsCalibration = SensorFrameworkConfig::configuration()->value<bool>("magnetometer/needs_calibration", true);
 
@@ -68,7 +63,7 @@ MagCalibrationChain::MagCalibrationChain(const QString& id) :
     nameOutputBuffer("calibratedmagnetometerdata", calibratedMagnetometerData);
 
     // Create buffers for filter chain
-    filterBin = new Bin;
+    filterBin = new Bin(id);
     //formationsink
     magReader = new BufferReader<CalibratedMagneticFieldData>(1);
 
@@ -78,20 +73,19 @@ MagCalibrationChain::MagCalibrationChain(const QString& id) :
     filterBin->add(calibratedMagnetometerData, "calibratedmagnetometerdata"); //calibration
 
     if (sm.getAdaptorTypes().contains("orientationadaptor")) {
-        DeviceAdaptor *orientAdaptor = sm.requestDeviceAdaptor("orientationadaptor");
+        orientAdaptor = sm.requestDeviceAdaptor("orientationadaptor");
         if (orientAdaptor && orientAdaptor->isValid()) {
             needsCalibration = false;
         }
     }
     magCoordinateAlignFilter_ = sm.instantiateFilter("magcoordinatealignfilter");
     Q_ASSERT(magCoordinateAlignFilter_);
+    ((MagCoordinateAlignFilter*)magCoordinateAlignFilter_)->setMatrix(TMagMatrix(mountMatrix.data_));
     filterBin->add(magCoordinateAlignFilter_, "magcoordinatealigner");
 
     if (needsCalibration) {
         magCalFilter = sm.instantiateFilter("calibrationfilter");
 
-        ((MagCoordinateAlignFilter*)magCoordinateAlignFilter_)->setMatrix(TMagMatrix(aconv_));
-
         filterBin->add(magCalFilter, "calibration");
 
         if (!filterBin->join("calibratedmagneticfield", "source", "magcoordinatealigner", "sink"))
@@ -122,14 +116,18 @@ MagCalibrationChain::MagCalibrationChain(const QString& id) :
 MagCalibrationChain::~MagCalibrationChain()
 {
     SensorManager& sm = SensorManager::instance();
-    sm.releaseDeviceAdaptor("magnetometeradaptor");
-    disconnectFromSource(magAdaptor, "magnetometer", magReader);
 
-    delete magReader;
-    if (needsCalibration) {
-        delete magCoordinateAlignFilter_;
-        delete magCalFilter;
+    // Stop reading before the adaptor can go away
+    if (magAdaptor) {
+        disconnectFromSource(magAdaptor, "calibratedmagneticfield", magReader);
+        sm.releaseDeviceAdaptor(instanceId("magnetometeradaptor"));
     }
+    if (orientAdaptor)
+        sm.releaseDeviceAdaptor("orientationadaptor");
+
+    delete magReader;
+    delete magCoordinateAlignFilter_;
+    delete magCalFilter;
     delete calibratedMagnetometerData;
     delete filterBin;
 }
@@ -175,19 +173,3 @@ void MagCalibrationChain::resetCalibration()
        filter->dropCalibration();
    }
 }
-
-bool MagCalibrationChain::setMatrixFromString(const QString& str)
-{
-    QStringList strList = str.split(',');
-    if (strList.size() != 9) {
-        sensordLogW() << id() << "Invalid cell count from matrix. Expected 9, got" << strList.size();
-        return false;
-    }
-
-    for (int i = 0; i < 9; ++i) {
-        aconv_[i/3][i%3] = strList.at(i).toInt();
-    }
-
-    return true;
-}
-
@@ -71,11 +71,10 @@ protected:
     ~MagCalibrationChain();
 
 private:
-    bool setMatrixFromString(const QString& str);
-    double aconv_[3][3];
 
     Bin* filterBin;
     DeviceAdaptor *magAdaptor;
+    DeviceAdaptor *orientAdaptor;
 
     BufferReader<CalibratedMagneticFieldData>  *magReader; //pusher/producer
 
@@ -27,9 +27,35 @@
 #include "sensormanager.h"
 #include "bin.h"
 #include "bufferreader.h"
+#include "config.h"
+#include "logging.h"
+
+const char* OrientationChain::ROTATION_HINT_PATH = "/sys/power/pm_optimizer_rotation";
+
+RotationHintWriter::RotationHintWriter(const QString& path, const QByteArray& value) :
+    sink_(this, &RotationHintWriter::hint),
+    file_(path),
+    value_(value)
+{
+    addSink(&sink_, "sink");
+
+    if (!path.isEmpty() && !file_.open(QIODevice::WriteOnly)) {
+        sensordLogW() << "Unable to open rotation hint file" << path << ":" << file_.errorString();
+    }
+}
+
+void RotationHintWriter::hint(unsigned, const PoseData*)
+{
+    if (file_.isOpen()) {
+        file_.write(value_);
+        file_.flush();
+    }
+}
 
 OrientationChain::OrientationChain(const QString& id) :
-    AbstractChain(id)
+    AbstractChain(id),
+    gyroscopeChain_(NULL),
+    gyroscopeReader_(NULL)
 {
     SensorManager& sm = SensorManager::instance();
 
@@ -41,6 +67,21 @@ OrientationChain::OrientationChain(const QString& id) :
 
     orientationInterpreterFilter_ = sm.instantiateFilter("orientationinterpreter");
 
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    if (config->value<int>("orientation/motion_veto_rate", 0) > 0) {
+        gyroscopeChain_ = sm.requestChain("gyroscopechain");
+        if (gyroscopeChain_ && gyroscopeChain_->isValid()) {
+            gyroscopeReader_ = new BufferReader<TimedXyzData>(1);
+        } else {
+            sensordLogD() << NodeBase::id() << "Gyroscope not available, rotations are not vetoed during motion.";
+        }
+    }
+
+    // Boost CPU clock on rotations where the platform supports it
+    const QString defaultHintPath = QFile::exists(ROTATION_HINT_PATH) ? ROTATION_HINT_PATH : "";
+    rotationHintWriter_ = new RotationHintWriter(config->value<QString>("orientation/rotation_hint_path", defaultHintPath),
+                                                 config->value<QString>("orientation/rotation_hint_value", "1").toLatin1());
+
     topEdgeOutput_ = new RingBuffer<PoseData>(1);
     nameOutputBuffer("topedge", topEdgeOutput_);
 
@@ -50,14 +91,25 @@ OrientationChain::OrientationChain(const QString& id) :
     orientationOutput_ = new RingBuffer<PoseData>(1);
     nameOutputBuffer("orientation", orientationOutput_);
 
+    rotationHintOutput_ = new RingBuffer<PoseData>(1);
+    nameOutputBuffer("rotationhint", rotationHintOutput_);
+
+    confidenceOutput_ = new RingBuffer<TimedUnsigned>(1);
+    nameOutputBuffer("confidence", confidenceOutput_);
+
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(accelerometerReader_, "accelerometer");
     filterBin_->add(orientationInterpreterFilter_, "orientationinterpreter");
     filterBin_->add(topEdgeOutput_, "topedgebuffer");
     filterBin_->add(faceOutput_, "facebuffer");
     filterBin_->add(orientationOutput_, "orientationbuffer");
+    filterBin_->add(rotationHintWriter_, "rotationhintwriter");
+    filterBin_->add(rotationHintOutput_, "rotationhintbuffer");
+    filterBin_->add(confidenceOutput_, "confidencebuffer");
+    if (gyroscopeReader_)
+        filterBin_->add(gyroscopeReader_, "gyroscope");
 
     // Join filterchain buffers
     if (!filterBin_->join("accelerometer", "source", "orientationinterpreter", "accsink"))
@@ -68,9 +120,19 @@ OrientationChain::OrientationChain(const QString& id) :
         qDebug()<< NodeBase::id() << Q_FUNC_INFO << "orientationinterpreter/facebuffer join failed";
     if (!filterBin_->join("orientationinterpreter", "orientation", "orientationbuffer", "sink"))
         qDebug()<< NodeBase::id() << Q_FUNC_INFO << "orientationinterpreter/orientationbuffer join failed";
+    if (!filterBin_->join("orientationinterpreter", "rotationhint", "rotationhintbuffer", "sink"))
+        qDebug()<< NodeBase::id() << Q_FUNC_INFO << "orientationinterpreter/rotationhintbuffer join failed";
+    if (!filterBin_->join("orientationinterpreter", "rotationhint", "rotationhintwriter", "sink"))
+        qDebug()<< NodeBase::id() << Q_FUNC_INFO << "orientationinterpreter/rotationhintwriter join failed";
+    if (!filterBin_->join("orientationinterpreter", "confidence", "confidencebuffer", "sink"))
+        qDebug()<< NodeBase::id() << Q_FUNC_INFO << "orientationinterpreter/confidencebuffer join failed";
+    if (gyroscopeReader_ && !filterBin_->join("gyroscope", "source", "orientationinterpreter", "gyrosink"))
+        qDebug()<< NodeBase::id() << Q_FUNC_INFO << "gyroscope/orientationinterpreter join failed";
 
     // Join datasources to the chain
     connectToSource(accelerometerChain_, "accelerometer", accelerometerReader_);
+    if (gyroscopeReader_)
+        connectToSource(gyroscopeChain_, "gyroscope", gyroscopeReader_);
 
     setDescription("Device orientation interpretations (in different flavors)");
     introduceAvailableDataRange(DataRange(0, 6, 1));
@@ -81,12 +143,22 @@ OrientationChain::OrientationChain(const QString& id) :
 OrientationChain::~OrientationChain()
 {
     disconnectFromSource(accelerometerChain_, "accelerometer", accelerometerReader_);
+    SensorManager::instance().releaseChain("accelerometerchain");
+    if (gyroscopeReader_) {
+        disconnectFromSource(gyroscopeChain_, "gyroscope", gyroscopeReader_);
+        delete gyroscopeReader_;
+    }
+    if (gyroscopeChain_)
+        SensorManager::instance().releaseChain("gyroscopechain");
 
     delete accelerometerReader_;
     delete orientationInterpreterFilter_;
+    delete rotationHintWriter_;
     delete topEdgeOutput_;
     delete faceOutput_;
     delete orientationOutput_;
+    delete rotationHintOutput_;
+    delete confidenceOutput_;
     delete filterBin_;
 }
 
@@ -96,6 +168,8 @@ bool OrientationChain::start()
         sensordLogD() << id() << "Starting AccelerometerChain";
         filterBin_->start();
         accelerometerChain_->start();
+        if (gyroscopeReader_)
+            gyroscopeChain_->start();
     }
     return true;
 }
@@ -104,6 +178,8 @@ bool OrientationChain::stop()
 {
     if (AbstractSensorChannel::stop()) {
         sensordLogD() << id() << "Stopping AccelerometerChain";
+        if (gyroscopeReader_)
+            gyroscopeChain_->stop();
         accelerometerChain_->stop();
         filterBin_->stop();
     }
@@ -37,22 +37,54 @@
 #include "datatypes/posedata.h"
 #include "datatypes/unsigned.h"
 
+#include <QFile>
+
 class Bin;
 template <class TYPE> class BufferReader;
 class FilterBase;
 
+/**
+ * Writes to a file whenever a rotation is about to happen, e.g. to
+ * request a CPU clock boost from the kernel for smooth rotation.
+ */
+class RotationHintWriter : public FilterBase
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param path file to write, nothing is written if empty.
+     * @param value content to write.
+     */
+    RotationHintWriter(const QString& path, const QByteArray& value);
+
+private:
+    void hint(unsigned, const PoseData*);
+
+    Sink<RotationHintWriter, PoseData> sink_;
+    QFile file_;
+    QByteArray value_;
+};
+
 /**
  * @brief Orientationchain providies device orientation information
  * using the accelerometer information.
  *
+ * If the gyroscope chain is available and \c orientation/motion_veto_rate
+ * is non-zero, its samples are used to veto rotations while the device
+ * is moving.
+ *
  * <b>Output buffers:</b>
- * <ul><li>\em device orientation</li></ul>
+ * <ul><li>\em topedge, \em face and \em orientation interpretations</li>
+ * <li>\em rotationhint, top edge a rotation is pending to</li>
+ * <li>\em confidence, confidence (percent) of each top edge change</li></ul>
  */
 class OrientationChain : public AbstractChain
 {
     Q_OBJECT;
 
     Q_PROPERTY(TimedUnsigned orientation READ orientation);
+    Q_PROPERTY(int confidence READ confidence);
 
 public:
     /**
@@ -79,6 +111,19 @@ public:
         return TimedUnsigned();
     }
 
+    /**
+     * Property method returning confidence of the current top edge.
+     * @return Confidence (percent).
+     */
+    int confidence() const
+    {
+        QObject *filter = dynamic_cast<QObject*>(orientationInterpreterFilter_);
+        if (filter != NULL) {
+            return filter->property("confidence").toInt();
+        }
+        return 0;
+    }
+
 public Q_SLOTS:
     bool start();
     bool stop();
@@ -88,15 +133,21 @@ protected:
     ~OrientationChain();
 
 private:
+    static const char*               ROTATION_HINT_PATH; /**< default rotation hint file */
     static double                    aconv_[3][3];
     Bin*                             filterBin_;
 
     AbstractChain*                   accelerometerChain_;
     BufferReader<AccelerationData>*  accelerometerReader_;
+    AbstractChain*                   gyroscopeChain_;
+    BufferReader<TimedXyzData>*      gyroscopeReader_;
     FilterBase*                      orientationInterpreterFilter_;
+    RotationHintWriter*              rotationHintWriter_;
     RingBuffer<PoseData>*            topEdgeOutput_;
     RingBuffer<PoseData>*            faceOutput_;
     RingBuffer<PoseData>*            orientationOutput_;
+    RingBuffer<PoseData>*            rotationHintOutput_;
+    RingBuffer<TimedUnsigned>*       confidenceOutput_;
 };
 
 #endif // ORIENTATIONCHAIN_H
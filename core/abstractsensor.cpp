@@ -33,6 +33,9 @@
 #include "sockethandler.h"
 #include "idutils.h"
 #include "logging.h"
+#include "config.h"
+#include "suspendmonitor.h"
+#include "datatypes/clockoffsets.h"
 
 AbstractSensorChannel::AbstractSensorChannel(const QString& id) :
     NodeBase(getCleanId(id)),
@@ -86,45 +89,124 @@ bool AbstractSensorChannel::stop()
     return false;
 }
 
-bool AbstractSensorChannel::writeToSession(int sessionId, const void* source, int size)
+bool AbstractSensorChannel::writeToSession(int sessionId, const void* source, int size, const SampleSchema* schema, bool predict)
 {
-    if (!(SensorManager::instance().write(sessionId, source, size))) {
+    if (!sessionAcceptsSample(sessionId, schema))
+        return true;
+
+    TimedXyzData predicted;
+    if (predict && schema == sampleSchema<TimedXyzData>() && predictor_.model() != SamplePredictor::None) {
+        QMutexLocker locker(&predictorMutex_);
+        unsigned int horizon = predictionHorizon_.value(sessionId, 0);
+        if (horizon && predictor_.predict(static_cast<const TimedXyzData*>(source)->timestamp_ + horizon, predicted)) {
+            source = &predicted;
+        }
+    }
+
+    if (!(SensorManager::instance().write(sessionId, source, size, schema))) {
         sensordLogD() << id() << "AbstractSensor failed to write to session " << sessionId;
         return false;
     }
     return true;
 }
 
-bool AbstractSensorChannel::writeToClients(const void* source, int size)
+bool AbstractSensorChannel::writeToClients(const void* source, int size, const SampleSchema* schema)
 {
+    updatePrediction(source, schema);
+
     bool ret = true;
     foreach(int sessionId, activeSessions_) {
-        ret &= writeToSession(sessionId, source, size);
+        ret &= writeToSession(sessionId, source, size, schema);
     }
     return ret;
 }
 
+bool AbstractSensorChannel::sessionAcceptsSample(int, const SampleSchema*) const
+{
+    return true;
+}
+
+void AbstractSensorChannel::setPredictionModel(SamplePredictor::Model model)
+{
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    QMutexLocker locker(&predictorMutex_);
+    predictor_.setModel(model);
+    predictor_.setHistory(config->value<int>("global/prediction_history", 4));
+    predictor_.setMaxHorizon(config->value<int>("global/prediction_max_horizon", 100000));
+}
+
+void AbstractSensorChannel::updatePrediction(const void* source, const SampleSchema* schema)
+{
+    if (schema != sampleSchema<TimedXyzData>() || predictor_.model() == SamplePredictor::None)
+        return;
+
+    QMutexLocker locker(&predictorMutex_);
+    predictor_.update(*static_cast<const TimedXyzData*>(source));
+}
+
+bool AbstractSensorChannel::predictionSupported() const
+{
+    return predictor_.model() != SamplePredictor::None;
+}
+
+bool AbstractSensorChannel::setPredictionHorizon(int sessionId, unsigned int horizon_us)
+{
+    if (!predictionSupported())
+        return false;
+
+    sensordLogT() << id() << "Prediction horizon for session " << sessionId << ": " << horizon_us;
+    QMutexLocker locker(&predictorMutex_);
+    if (horizon_us)
+        predictionHorizon_[sessionId] = horizon_us;
+    else
+        predictionHorizon_.remove(sessionId);
+    return true;
+}
+
+unsigned int AbstractSensorChannel::predictionHorizon(int sessionId) const
+{
+    QMutexLocker locker(&predictorMutex_);
+    return predictionHorizon_.value(sessionId, 0);
+}
+
+bool AbstractSensorChannel::predict(quint64 timestamp, TimedXyzData& predicted) const
+{
+    QMutexLocker locker(&predictorMutex_);
+    return predictor_.predict(timestamp, predicted);
+}
+
 bool AbstractSensorChannel::downsampleAndPropagate(const TimedXyzData& data, TimedXyzDownsampleBuffer& buffer)
 {
+    updatePrediction(&data, sampleSchema<TimedXyzData>());
+
     bool ret = true;
     unsigned int currentInterval = getInterval();
     foreach(int sessionId, activeSessions_)
     {
         if(!downsamplingEnabled(sessionId))
         {
-            ret &= writeToSession(sessionId, (const void *)& data, sizeof(TimedXyzData));
+            ret &= writeToSession(sessionId, (const void *)& data, sizeof(TimedXyzData), sampleSchema<TimedXyzData>());
             continue;
         }
         unsigned int sessionInterval = getInterval(sessionId);
         int bufferSize = (sessionInterval < currentInterval || !currentInterval) ? 1 : sessionInterval / currentInterval;
 
+        // Samples are predicted before averaging, so that the average
+        // keeps both its smoothing and the full horizon
+        TimedXyzData sample(data);
+        unsigned int horizon = predictionHorizon(sessionId);
+        if(horizon)
+            predict(data.timestamp_ + horizon, sample);
+
         QList<TimedXyzData>& samples(buffer[sessionId]);
-        samples.push_back(data);
+        if(gapSessions_.remove(sessionId))
+            samples.clear();
+        samples.push_back(sample);
 
         for(QList<TimedXyzData>::iterator it = samples.begin(); it != samples.end(); ++it)
         {
             if(samples.size() > bufferSize ||
-               data.timestamp_ - it->timestamp_ > 2000000)
+               sample.timestamp_ - it->timestamp_ > 2000000)
             {
                 it = samples.erase(it);
                 if(it == samples.end())
@@ -146,12 +228,12 @@ bool AbstractSensorChannel::downsampleAndPropagate(const TimedXyzData& data, Tim
             y += data.y_;
             z += data.z_;
         }
-        TimedXyzData downsampled(data.timestamp_,
+        TimedXyzData downsampled(sample.timestamp_,
                                  x / samples.count(),
                                  y / samples.count(),
                                  z / samples.count());
 
-        if (writeToSession(sessionId, (const void*)& downsampled, sizeof(TimedXyzData)))
+        if (writeToSession(sessionId, (const void*)& downsampled, sizeof(TimedXyzData), sampleSchema<TimedXyzData>(), false))
         {
             samples.clear();
         }
@@ -172,13 +254,15 @@ bool AbstractSensorChannel::downsampleAndPropagate(const CalibratedMagneticField
     {
         if(!downsamplingEnabled(sessionId))
         {
-            ret &= writeToSession(sessionId, (const void *)& data, sizeof(CalibratedMagneticFieldData));
+            ret &= writeToSession(sessionId, (const void *)& data, sizeof(CalibratedMagneticFieldData), sampleSchema<CalibratedMagneticFieldData>());
             continue;
         }
         unsigned int sessionInterval = getInterval(sessionId);
         int bufferSize = (sessionInterval < currentInterval || !currentInterval) ? 1 : sessionInterval / currentInterval;
 
         QList<CalibratedMagneticFieldData>& samples(buffer[sessionId]);
+        if(gapSessions_.remove(sessionId))
+            samples.clear();
         samples.push_back(data);
 
         for(QList<CalibratedMagneticFieldData>::iterator it = samples.begin(); it != samples.end(); ++it)
@@ -221,7 +305,7 @@ bool AbstractSensorChannel::downsampleAndPropagate(const CalibratedMagneticField
                                                 rz / samples.count(),
                                                 data.level_);
 
-        if (writeToSession(sessionId, (const void*)& downsampled, sizeof(CalibratedMagneticFieldData)))
+        if (writeToSession(sessionId, (const void*)& downsampled, sizeof(CalibratedMagneticFieldData), sampleSchema<CalibratedMagneticFieldData>()))
         {
             samples.clear();
         }
@@ -257,9 +341,32 @@ bool AbstractSensorChannel::downsamplingSupported() const
     return false;
 }
 
+void AbstractSensorChannel::markDiscontinuity()
+{
+    sensordLogD() << id() << "Marking data gap to sessions";
+
+    gapSessions_ = activeSessions_;
+    {
+        QMutexLocker locker(&predictorMutex_);
+        predictor_.reset();
+    }
+
+    // Readings go through the same pipe as the samples, so they reach
+    // each session before the first sample after the gap
+    ClockOffsets offsets = ClockOffsets::sample();
+    offsets.gap_ = qMax<quint64>(SuspendMonitor::instance().lastGap(), 1);
+    foreach(int sessionId, activeSessions_) {
+        SensorManager::instance().write(sessionId, &offsets, sizeof(offsets), sampleSchema<ClockOffsets>());
+    }
+}
+
 void AbstractSensorChannel::removeSession(int sessionId)
 {
     downsampling_.take(sessionId);
+    {
+        QMutexLocker locker(&predictorMutex_);
+        predictionHorizon_.remove(sessionId);
+    }
     NodeBase::removeSession(sessionId);
 }
 
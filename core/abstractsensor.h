@@ -35,6 +35,7 @@
 #include <QMap>
 #include <QList>
 #include <QSet>
+#include <QMutex>
 
 #include "nodebase.h"
 #include "logging.h"
@@ -42,6 +43,8 @@
 #include "datarange.h"
 #include "genericdata.h"
 #include "orientationdata.h"
+#include "sampleschema.h"
+#include "samplepredictor.h"
 
 /**
  * Base class for sensor type specific nodes. This is used as base class
@@ -115,6 +118,51 @@ public:
      */
     virtual bool downsamplingSupported() const;
 
+    /**
+     * Can samples of this channel be extrapolated.
+     *
+     * @return is prediction supported.
+     */
+    bool predictionSupported() const;
+
+    /**
+     * Set how far ahead of their timestamp samples written to given
+     * session are predicted. Predicted samples carry the timestamp they
+     * were predicted to. With downsampling the samples are predicted
+     * before they are averaged.
+     *
+     * @param sessionId session ID.
+     * @param horizon_us prediction horizon, zero disables prediction.
+     * @return was the horizon set, i.e. is prediction supported.
+     */
+    bool setPredictionHorizon(int sessionId, unsigned int horizon_us);
+
+    /**
+     * Prediction horizon of given session.
+     *
+     * @param sessionId session ID.
+     * @return prediction horizon (microsec), zero if disabled.
+     */
+    unsigned int predictionHorizon(int sessionId) const;
+
+    /**
+     * Extrapolate latest samples to given time.
+     *
+     * @param timestamp target time, in the time base of the channel.
+     * @param predicted predicted sample.
+     * @return was there a sample to extrapolate from.
+     */
+    bool predict(quint64 timestamp, TimedXyzData& predicted) const;
+
+    /**
+     * Mark a gap in the output data, e.g. after system suspend. Active
+     * sessions with clock sync get fresh clock readings flagged with the
+     * gap ahead of the next sample, downsampling starts over and
+     * prediction forgets the samples before the gap. Called from
+     * DataEmitter::discontinuity() in the thread writing the samples.
+     */
+    void markDiscontinuity();
+
     virtual void removeSession(int sessionId);
 
     /**
@@ -198,9 +246,23 @@ protected:
      *
      * @param source Object to write.
      * @param size Size of the object.
+     * @param schema Schema of the object, used to encode it for sessions
+     *               not using the raw data format.
+     * @return was data succesfully written.
+     */
+    bool writeToClients(const void* source, int size, const SampleSchema* schema = 0);
+
+    /**
+     * Write output sample to all connected sessions.
+     *
+     * @param sample Sample to write.
      * @return was data succesfully written.
      */
-    bool writeToClients(const void* source, int size);
+    template<class T>
+    bool writeToClients(const T& sample)
+    {
+        return writeToClients(&sample, sizeof(T), sampleSchema<T>());
+    }
 
     /**
      * Downsample and propagate data to all connected sessions.
@@ -227,6 +289,26 @@ protected:
      */
     void signalPropertyChanged(const QString& name);
 
+    /**
+     * Does the session receive samples of given type. Channels writing
+     * more than one sample type let each session choose one, as the
+     * client reads a single type from its socket.
+     *
+     * @param sessionId session ID.
+     * @param schema schema of the sample.
+     * @return should sample be written to the session.
+     */
+    virtual bool sessionAcceptsSample(int sessionId, const SampleSchema* schema) const;
+
+    /**
+     * Enable prediction of the TimedXyzData samples written by this
+     * channel. History length and horizon limit are read from
+     * \c global/prediction_history and \c global/prediction_max_horizon.
+     *
+     * @param model how the samples evolve over time.
+     */
+    void setPredictionModel(SamplePredictor::Model model);
+
     virtual RingBufferBase* findBuffer(const QString& name) const;
 
 private:
@@ -236,15 +318,30 @@ private:
      * @param sessionId session ID.
      * @param source source object.
      * @param size size of object to write.
+     * @param schema schema of the object.
+     * @param predict extrapolate the sample by the prediction horizon of
+     *                the session, \c false if it already has been.
      * @return was data succesfully written.
      */
-    bool writeToSession(int sessionId, const void* source, int size);
+    bool writeToSession(int sessionId, const void* source, int size, const SampleSchema* schema, bool predict = true);
+
+    /**
+     * Feed a sample about to be written to the predictor.
+     *
+     * @param source sample.
+     * @param schema schema of the sample.
+     */
+    void updatePrediction(const void* source, const SampleSchema* schema);
 
     SensorError         errorCode_;       /**< previous occured error code */
     QString             errorString_;     /**< previous occured error description */
     int                 cnt_;             /**< usage reference count */
     QSet<int>           activeSessions_;  /**< active sessions */
     QMap<int, bool>     downsampling_;    /**< downsample state for sessions */
+    QMap<int, unsigned int> predictionHorizon_; /**< prediction horizon for sessions */
+    QSet<int>           gapSessions_;     /**< sessions whose downsampling restarts after a gap */
+    SamplePredictor     predictor_;       /**< extrapolates written samples */
+    mutable QMutex      predictorMutex_;  /**< guards predictor_ and predictionHorizon_ */
 };
 
 /**
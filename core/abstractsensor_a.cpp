@@ -30,6 +30,7 @@
 #include "sfwerror.h"
 #include <sensormanager.h>
 #include <sockethandler.h>
+#include "sampleencoder.h"
 
 AbstractSensorChannelAdaptor::AbstractSensorChannelAdaptor(QObject *parent) :
     QDBusAbstractAdaptor(parent)
@@ -57,6 +58,16 @@ QString AbstractSensorChannelAdaptor::description() const
     return node()->description();
 }
 
+QString AbstractSensorChannelAdaptor::timeBase() const
+{
+    return node()->timeBase();
+}
+
+QString AbstractSensorChannelAdaptor::location() const
+{
+    return node()->location();
+}
+
 QString AbstractSensorChannelAdaptor::id() const
 {
     return node()->id();
@@ -94,6 +105,23 @@ bool AbstractSensorChannelAdaptor::hwBuffering() const
     return hwBuffering;
 }
 
+bool AbstractSensorChannelAdaptor::predictionSupported() const
+{
+    return node()->predictionSupported();
+}
+
+bool AbstractSensorChannelAdaptor::setPredictionHorizon(int sessionId, unsigned int horizon_us)
+{
+    return node()->setPredictionHorizon(sessionId, horizon_us);
+}
+
+XYZ AbstractSensorChannelAdaptor::predict(quint64 timestamp)
+{
+    TimedXyzData predicted;
+    node()->predict(timestamp, predicted);
+    return XYZ(predicted);
+}
+
 QString AbstractSensorChannelAdaptor::type() const
 {
     return node()->type();
@@ -115,8 +143,7 @@ void AbstractSensorChannelAdaptor::setInterval(int sessionId, int interval_ms)
     int interval_us = 0;
     if (interval_ms > 0)
         interval_us = interval_ms * 1000;
-    node()->setIntervalRequest(sessionId, interval_us);
-    SensorManager::instance().socketHandler().setInterval(sessionId, interval_us);
+    requestInterval(sessionId, interval_us);
 }
 
 void AbstractSensorChannelAdaptor::setDataRate(int sessionId, double dataRate_Hz)
@@ -125,8 +152,18 @@ void AbstractSensorChannelAdaptor::setDataRate(int sessionId, double dataRate_Hz
     int interval_us = 0;
     if (dataRate_Hz > 0)
         interval_us = (int)(1000000.0 / dataRate_Hz);
-    node()->setIntervalRequest(sessionId, interval_us);
-    SensorManager::instance().socketHandler().setInterval(sessionId, interval_us);
+    requestInterval(sessionId, interval_us);
+}
+
+void AbstractSensorChannelAdaptor::requestInterval(int sessionId, int interval_us)
+{
+    // Over-quota requests never reach interval arbitration, the client
+    // gets a stream downsampled to its granted rate instead.
+    SensorManager& sm = SensorManager::instance();
+    int granted_us = sm.grantInterval(sessionId, interval_us);
+    node()->setIntervalRequest(sessionId, granted_us);
+    sm.socketHandler().setInterval(sessionId, granted_us);
+    sm.socketHandler().setDownsampling(sessionId, granted_us != interval_us && !node()->downsamplingEnabled(sessionId));
 }
 
 bool AbstractSensorChannelAdaptor::standbyOverride() const
@@ -215,6 +252,21 @@ void AbstractSensorChannelAdaptor::setBufferSize(int sessionId, unsigned int val
         SensorManager::instance().socketHandler().setBufferSize(sessionId, value);
 }
 
+bool AbstractSensorChannelAdaptor::setDataFormat(int sessionId, const QString& format)
+{
+    return SensorManager::instance().socketHandler().setDataFormat(sessionId, format);
+}
+
+QStringList AbstractSensorChannelAdaptor::getAvailableDataFormats() const
+{
+    return SampleEncoder::formats();
+}
+
+void AbstractSensorChannelAdaptor::setClockSync(int sessionId, bool enable)
+{
+    SensorManager::instance().socketHandler().setClockSync(sessionId, enable);
+}
+
 IntegerRangeList AbstractSensorChannelAdaptor::getAvailableBufferIntervals() const
 {
     // D-Bus interface -> interval is milliseconds
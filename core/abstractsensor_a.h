@@ -32,6 +32,7 @@
 #include <QtDBus/QtDBus>
 #include "abstractsensor.h"
 #include "datatypes/datarange.h"
+#include "datatypes/xyz.h"
 
 /**
  * @brief D-Bus adaptor base class for sensors
@@ -47,6 +48,8 @@ class AbstractSensorChannelAdaptor : public QDBusAbstractAdaptor
     Q_PROPERTY(bool isValid READ isValid)
     Q_PROPERTY(QString errorString READ errorString)
     Q_PROPERTY(QString description READ description)
+    Q_PROPERTY(QString timeBase READ timeBase)
+    Q_PROPERTY(QString location READ location)
     Q_PROPERTY(QString id READ id)
     Q_PROPERTY(unsigned int interval READ interval)
     Q_PROPERTY(bool standbyOverride READ standbyOverride)
@@ -55,6 +58,7 @@ class AbstractSensorChannelAdaptor : public QDBusAbstractAdaptor
     Q_PROPERTY(QString type READ type)
     Q_PROPERTY(int errorCodeInt READ errorCodeInt)
     Q_PROPERTY(bool hwBuffering READ hwBuffering)
+    Q_PROPERTY(bool predictionSupported READ predictionSupported)
 
 public:
     /**
@@ -85,6 +89,15 @@ private:
      */
     AbstractSensorChannel* node() const;
 
+    /**
+     * Pass interval request of a session through client quota to the
+     * channel and the session socket.
+     *
+     * @param sessionId Session ID.
+     * @param interval_us requested interval in microseconds.
+     */
+    void requestInterval(int sessionId, int interval_us);
+
 public Q_SLOTS: // METHODS
 
     /** AbstractSensorChannel::isValid() */
@@ -96,6 +109,12 @@ public Q_SLOTS: // METHODS
     /** AbstractSensorChannel::description() */
     QString description() const;
 
+    /** AbstractSensorChannel::timeBase() */
+    QString timeBase() const;
+
+    /** AbstractSensorChannel::location() */
+    QString location() const;
+
     /** AbstractSensorChannel::id() */
     QString id() const;
 
@@ -156,6 +175,23 @@ public Q_SLOTS: // METHODS
      */
     void setBufferSize(int sessionId, unsigned int value);
 
+    /** SocketHandler::setDataFormat(int, const QString&)
+     *
+     *  Selects the encoding of samples on the data connection: "raw",
+     *  "flat" or "json". See SampleEncoder.
+     */
+    bool setDataFormat(int sessionId, const QString& format);
+
+    /** SampleEncoder::formats() */
+    QStringList getAvailableDataFormats() const;
+
+    /** SocketHandler::setClockSync(int, bool)
+     *
+     *  Interleaves ClockOffsets frames with the samples on the data
+     *  connection.
+     */
+    void setClockSync(int sessionId, bool enable);
+
     /** AbstractSensorChannel::getAvailableBufferIntervals() */
     IntegerRangeList getAvailableBufferIntervals() const;
 
@@ -180,6 +216,21 @@ public Q_SLOTS: // METHODS
     /** AbstractSensorChannel::hwBuffering() */
     bool hwBuffering() const;
 
+    /** AbstractSensorChannel::predictionSupported() */
+    bool predictionSupported() const;
+
+    /** AbstractSensorChannel::setPredictionHorizon(int, unsigned int)
+     *
+     *  Horizon is in microseconds.
+     */
+    bool setPredictionHorizon(int sessionId, unsigned int horizon_us);
+
+    /** AbstractSensorChannel::predict(quint64, TimedXyzData&)
+     *
+     *  Returns a zero sample if there is nothing to predict from.
+     */
+    XYZ predict(quint64 timestamp);
+
 Q_SIGNALS:
     /** AbstractSensorChannel::propertyChanged(name) */
     void propertyChanged(const QString& name);
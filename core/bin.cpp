@@ -35,7 +35,8 @@
 #include "ringbuffer.h"
 #include "logging.h"
 
-Bin::Bin()
+Bin::Bin(const QString& name) :
+    name_(name)
 {
 }
 
@@ -57,6 +58,7 @@ void Bin::add(Pusher* pusher, const QString& name)
     Q_ASSERT(!filters_.contains(name));
 
     pushers_.insert(name, pusher);
+    pusher->setCpuNode(CpuAccounting::node(cpuNodeName(name)));
 }
 
 void Bin::add(Consumer* consumer, const QString& name)
@@ -76,6 +78,11 @@ void Bin::add(FilterBase* filter, const QString& name)
     filters_.insert(name, filter);
 }
 
+QString Bin::cpuNodeName(const QString& name) const
+{
+    return name_.isEmpty() ? name : name_ + "/" + name;
+}
+
 bool Bin::join(const QString& producerName,
                const QString& sourceName,
                const QString& consumerName,
@@ -90,6 +97,7 @@ bool Bin::join(const QString& producerName,
         if (src->join(snk)) {
 
             joined = true;
+            src->setCpuNode(CpuAccounting::node(cpuNodeName(producerName + "/" + sourceName)));
 
         } else {
             sensordLogT() << " source "
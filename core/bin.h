@@ -32,6 +32,7 @@
 
 #include "callback.h"
 #include <QHash>
+#include <QString>
 
 class SourceBase;
 class SinkBase;
@@ -58,8 +59,11 @@ public:
 
     /**
      * Constructor.
+     *
+     * @param name name of the bin, usually the ID of the owning chain or
+     *             sensor. Prefixes CPU accounting node names of the bin.
      */
-    Bin();
+    Bin(const QString& name = QString());
 
     /**
      * Destructor
@@ -165,6 +169,12 @@ protected:
     Consumer*   consumer(const QString& name) const;
 
 private:
+    /**
+     * Name of CPU accounting node for a component of the bin.
+     */
+    QString cpuNodeName(const QString& name) const;
+
+    QString                     name_;      /**< Bin name  */
     QHash<QString, Pusher*>     pushers_;   /**< Pushers   */
     QHash<QString, Consumer*>   consumers_; /**< Consumers */
     QHash<QString, FilterBase*> filters_;   /**< Filters   */
@@ -0,0 +1,127 @@
+/**
+   @file clientquota.cpp
+   @brief Per-client resource quotas
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "clientquota.h"
+#include "config.h"
+
+#include <QFileInfo>
+#include <QStringList>
+
+namespace {
+
+QVariant quotaValue(const QStringList& groups, const QString& key)
+{
+    if (!SensorFrameworkConfig::configuration())
+        return QVariant();
+
+    foreach (const QString& group, groups) {
+        QVariant value = SensorFrameworkConfig::configuration()->value(group + "/" + key);
+        if (value.isValid())
+            return value;
+    }
+    return QVariant();
+}
+
+}
+
+ClientQuota::ClientQuota() :
+    minInterval_us(0),
+    maxSessions(0),
+    maxBufferedBytes(0),
+    scope(ScopeUid)
+{
+}
+
+ClientQuota ClientQuota::forClient(uid_t uid, const QString& executable)
+{
+    ClientQuota quota;
+    QStringList groups;
+    QString exeGroup;
+
+    if (!executable.isEmpty()) {
+        exeGroup = QString("quota-exe-%1").arg(executable);
+        groups << exeGroup;
+    }
+    groups << QString("quota-uid-%1").arg(uid) << "quota";
+
+    double maxRate = quotaValue(groups, "max_rate").toDouble();
+    if (maxRate > 0)
+        quota.minInterval_us = (unsigned int)(1000000.0 / maxRate);
+
+    quota.maxSessions = qMax(0, quotaValue(groups, "max_sessions").toInt());
+    quota.maxBufferedBytes = quotaValue(groups, "max_buffered_bytes").toUInt();
+
+    if (!exeGroup.isEmpty() && SensorFrameworkConfig::configuration() &&
+        SensorFrameworkConfig::configuration()->groups().contains(exeGroup))
+        quota.scope = ScopeExecutable;
+
+    return quota;
+}
+
+QString ClientQuota::executableForPid(pid_t pid)
+{
+    if (pid <= 0)
+        return QString();
+    return QFileInfo(QFileInfo(QString("/proc/%1/exe").arg(pid)).symLinkTarget()).fileName();
+}
+
+bool ClientQuota::isLimited() const
+{
+    return minInterval_us || maxSessions || maxBufferedBytes;
+}
+
+unsigned int ClientQuota::grantInterval(unsigned int interval_us) const
+{
+    // 0 is a request for the default interval and does not drive the
+    // shared rate; the session stream is limited by the socket instead
+    if (interval_us > 0 && interval_us < minInterval_us)
+        return minInterval_us;
+    return interval_us;
+}
+
+bool ClientQuota::admitSession(uid_t uid, const QString& executable,
+                               const QList<QPair<uid_t, QString> >& sessions) const
+{
+    if (!maxSessions)
+        return true;
+
+    int count = 0;
+    for (int i = 0; i < sessions.size(); ++i) {
+        if (scope == ScopeExecutable ? sessions.at(i).second == executable : sessions.at(i).first == uid)
+            ++count;
+    }
+    return count < maxSessions;
+}
+
+QString ClientQuota::toString() const
+{
+    if (!isLimited())
+        return "unlimited";
+
+    QStringList limits;
+    if (minInterval_us)
+        limits << QString("rate <= %1 Hz").arg(1000000.0 / minInterval_us);
+    if (maxSessions)
+        limits << QString("sessions <= %1 per %2").arg(maxSessions).arg(scope == ScopeExecutable ? "executable" : "uid");
+    if (maxBufferedBytes)
+        limits << QString("buffered <= %1 bytes").arg(maxBufferedBytes);
+    return limits.join(", ");
+}
@@ -0,0 +1,111 @@
+/**
+   @file clientquota.h
+   @brief Per-client resource quotas
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef CLIENTQUOTA_H
+#define CLIENTQUOTA_H
+
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <sys/types.h>
+
+/**
+ * Resource limits for a client process. Limits are read from the
+ * configuration, looking up each key first from group
+ * \c quota-exe-<executable name>, then \c quota-uid-<uid> and finally
+ * \c quota. Recognized keys are \c max_rate (Hz), \c max_sessions and
+ * \c max_buffered_bytes. A missing or zero value means unlimited.
+ */
+class ClientQuota
+{
+public:
+    /**
+     * Which clients share the session allowance.
+     */
+    enum Scope
+    {
+        ScopeUid = 0,   /**< all processes of the same user */
+        ScopeExecutable /**< all processes of the same executable */
+    };
+
+    /**
+     * Constructor. Creates an unlimited quota.
+     */
+    ClientQuota();
+
+    /**
+     * Resolve quota for a client.
+     *
+     * @param uid User ID of the client process.
+     * @param executable Executable name of the client process.
+     * @return Quota for the client.
+     */
+    static ClientQuota forClient(uid_t uid, const QString& executable);
+
+    /**
+     * Resolve executable name of a process.
+     *
+     * @param pid Process ID.
+     * @return Executable file name, or empty string if unknown.
+     */
+    static QString executableForPid(pid_t pid);
+
+    /**
+     * Does the quota set any limit.
+     *
+     * @return \c true if any limit is set.
+     */
+    bool isLimited() const;
+
+    /**
+     * Apply rate limit to an interval request.
+     *
+     * @param interval_us Requested interval in microseconds.
+     * @return Granted interval in microseconds.
+     */
+    unsigned int grantInterval(unsigned int interval_us) const;
+
+    /**
+     * Check whether a client may open one more session. Open sessions
+     * are counted according to #scope.
+     *
+     * @param uid User ID of the client process.
+     * @param executable Executable name of the client process.
+     * @param sessions User ID and executable name of each open session.
+     * @return \c true if the session is within the quota.
+     */
+    bool admitSession(uid_t uid, const QString& executable,
+                      const QList<QPair<uid_t, QString> >& sessions) const;
+
+    /**
+     * Human readable description of the limits.
+     *
+     * @return Description string.
+     */
+    QString toString() const;
+
+    unsigned int minInterval_us;   /**< smallest allowed interval, 0 for unlimited */
+    int          maxSessions;      /**< maximum concurrent sessions, 0 for unlimited */
+    unsigned int maxBufferedBytes; /**< maximum bytes pending per session, 0 for unlimited */
+    Scope        scope;            /**< how sessions are counted */
+};
+
+#endif // CLIENTQUOTA_H
@@ -32,43 +32,119 @@
 #include <QFile>
 #include <QDir>
 #include <QList>
+#include <QFileInfo>
+#include <QReadLocker>
+#include <QWriteLocker>
 
 static SensorFrameworkConfig *static_configuration = 0;
 
-SensorFrameworkConfig::SensorFrameworkConfig() {
+SensorFrameworkConfig::SensorFrameworkConfig() :
+    m_watcher(new ConfigWatcher())
+{
 }
 
 SensorFrameworkConfig::~SensorFrameworkConfig() {
+    delete m_watcher;
 }
 
-void SensorFrameworkConfig::clearConfig() {
-    m_settings.clear();
+void SensorFrameworkConfig::setValues(const QMap<QString, QVariant> &values) {
+    QWriteLocker locker(&m_lock);
+    m_values = values;
 }
 
 bool SensorFrameworkConfig::loadConfig(const QString &defConfigPath, const QString &configDPath) {
-    /* Not having config files is ok, failing to load one that exists is not */
-    bool ret = true;
     if (!static_configuration) {
         static_configuration = new SensorFrameworkConfig();
     }
+    QPair<QString, QString> paths(defConfigPath, configDPath);
+    if (!static_configuration->m_loadedPaths.contains(paths)) {
+        static_configuration->m_loadedPaths.append(paths);
+    }
+
+    QMap<QString, QVariant> values;
+    {
+        QReadLocker locker(&static_configuration->m_lock);
+        values = static_configuration->m_values;
+    }
+    bool ret = readConfig(defConfigPath, configDPath, values);
+    static_configuration->setValues(values);
+    static_configuration->m_watcher->updateWatchedPaths();
+    return ret;
+}
+
+bool SensorFrameworkConfig::reloadConfig() {
+    if (!static_configuration) {
+        sensordLogW() << "Configuration has not been loaded";
+        return false;
+    }
+
+    QMap<QString, QVariant> values;
+    typedef QPair<QString, QString> PathPair;
+    foreach (const PathPair& paths, static_configuration->m_loadedPaths) {
+        if (!readConfig(paths.first, paths.second, values)) {
+            sensordLogW() << "Configuration reload failed, keeping current configuration";
+            return false;
+        }
+    }
+
+    QMap<QString, QVariant> current;
+    {
+        QReadLocker locker(&static_configuration->m_lock);
+        current = static_configuration->m_values;
+    }
+    QStringList changed;
+    foreach (const QString &key, current.keys()) {
+        if (!values.contains(key)) {
+            changed << key;
+        }
+    }
+    for (QMap<QString, QVariant>::const_iterator it = values.constBegin(); it != values.constEnd(); ++it) {
+        if (current.value(it.key()) != it.value()) {
+            changed << it.key();
+        }
+    }
+
+    // Readers in adaptor threads never see a partial configuration
+    static_configuration->setValues(values);
+    static_configuration->m_watcher->updateWatchedPaths();
+
+    sensordLogD() << "Configuration reloaded," << changed.size() << "keys changed";
+    foreach (const QString &key, changed) {
+        sensordLogD() << "Configuration key changed:" << key << "=" << values.value(key).toString();
+        Q_EMIT static_configuration->m_watcher->valueChanged(key, values.value(key));
+    }
+    Q_EMIT static_configuration->m_watcher->reloaded();
+    return true;
+}
+
+ConfigWatcher* SensorFrameworkConfig::watcher() {
+    if (!static_configuration) {
+        static_configuration = new SensorFrameworkConfig();
+    }
+    return static_configuration->m_watcher;
+}
+
+bool SensorFrameworkConfig::readConfig(const QString &defConfigPath, const QString &configDPath, QMap<QString, QVariant> &values) {
+    /* Not having config files is ok, failing to load one that exists is not */
+    bool ret = true;
     /* Process config.d dir in alnum order */
     if (!configDPath.isEmpty()) {
         QDir dir(configDPath, "*.conf", QDir::Name, QDir::Files);
         foreach(const QString &file, dir.entryList()) {
-            if (!static_configuration->loadConfigFile(dir.absoluteFilePath(file))) {
+            if (!readConfigFile(dir.absoluteFilePath(file), values)) {
                 ret = false;
             }
         }
     }
     /* Primary config file overrides config.d */
     if (!defConfigPath.isEmpty() && QFile::exists(defConfigPath) ) {
-        if (!static_configuration->loadConfigFile(defConfigPath))
+        if (!readConfigFile(defConfigPath, values))
             ret = false;
     }
     return ret;
 }
 
-bool SensorFrameworkConfig::loadConfigFile(const QString &configFileName) {
+bool SensorFrameworkConfig::readConfigFile(const QString &configFileName, QMap<QString, QVariant> &values) {
     /* Success means the file was loaded and processed without hiccups */
     bool loaded = false;
     if (!QFile::exists(configFileName)) {
@@ -82,7 +158,7 @@ bool SensorFrameworkConfig::loadConfigFile(const QString &configFileName) {
             sensordLogW() << "Unable to open \"" << configFileName <<  "\" configuration file";
         } else {
             foreach (const QString &key, merge.allKeys()) {
-                m_settings.setValue(key, merge.value(key));
+                values.insert(key, merge.value(key));
             }
             loaded = true;
         }
@@ -91,7 +167,11 @@ bool SensorFrameworkConfig::loadConfigFile(const QString &configFileName) {
 }
 
 QVariant SensorFrameworkConfig::value(const QString &key) const {
-    QVariant var = m_settings.value(key, QVariant());
+    QVariant var;
+    {
+        QReadLocker locker(&m_lock);
+        var = m_values.value(key);
+    }
     if(var.isValid()) {
         sensordLogT() << "Value for key" << key << ":" << var.toString();
     }
@@ -100,7 +180,14 @@ QVariant SensorFrameworkConfig::value(const QString &key) const {
 
 QStringList SensorFrameworkConfig::groups() const
 {
-    QStringList groups = m_settings.childGroups();
+    QStringList groups;
+    QReadLocker locker(&m_lock);
+    foreach (const QString &key, m_values.keys()) {
+        int slash = key.indexOf('/');
+        if (slash > 0 && !groups.contains(key.left(slash))) {
+            groups << key.left(slash);
+        }
+    }
     return groups;
 }
 
@@ -120,3 +207,80 @@ bool SensorFrameworkConfig::exists(const QString &key) const
 {
     return value(key).isValid();
 }
+
+ConfigWatcher::ConfigWatcher() :
+    m_watching(false)
+{
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(200);
+    connect(&m_reloadTimer, SIGNAL(timeout()), this, SLOT(reload()));
+}
+
+void ConfigWatcher::setWatching(bool enable)
+{
+    m_watching = enable;
+    if (enable) {
+        connect(&m_watcher, SIGNAL(fileChanged(QString)), this, SLOT(pathChanged(QString)), Qt::UniqueConnection);
+        connect(&m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(pathChanged(QString)), Qt::UniqueConnection);
+        updateWatchedPaths();
+    } else {
+        m_watcher.disconnect(this);
+        m_reloadTimer.stop();
+        QStringList watched = m_watcher.files() + m_watcher.directories();
+        if (!watched.isEmpty()) {
+            m_watcher.removePaths(watched);
+        }
+    }
+}
+
+void ConfigWatcher::pathChanged(const QString& path)
+{
+    sensordLogT() << "Configuration path changed:" << path;
+    // Editors typically write several events per save; reload once
+    m_reloadTimer.start();
+}
+
+void ConfigWatcher::reload()
+{
+    SensorFrameworkConfig::reloadConfig();
+}
+
+void ConfigWatcher::updateWatchedPaths()
+{
+    if (!m_watching || !static_configuration) {
+        return;
+    }
+
+    // Watch directories too: files replaced by rename drop out of the
+    // file watch, and new fragments appear only as directory changes.
+    QStringList paths;
+    typedef QPair<QString, QString> PathPair;
+    foreach (const PathPair& loaded, static_configuration->m_loadedPaths) {
+        if (!loaded.first.isEmpty()) {
+            QFileInfo info(loaded.first);
+            if (info.exists()) {
+                paths << info.absoluteFilePath();
+            }
+            if (info.absoluteDir().exists()) {
+                paths << info.absolutePath();
+            }
+        }
+        if (!loaded.second.isEmpty()) {
+            QDir dir(loaded.second, "*.conf", QDir::Name, QDir::Files);
+            if (dir.exists()) {
+                paths << dir.absolutePath();
+                foreach (const QString &file, dir.entryList()) {
+                    paths << dir.absoluteFilePath(file);
+                }
+            }
+        }
+    }
+    paths.removeDuplicates();
+
+    QStringList watched = m_watcher.files() + m_watcher.directories();
+    foreach (const QString &path, paths) {
+        if (!watched.contains(path)) {
+            m_watcher.addPath(path);
+        }
+    }
+}
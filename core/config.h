@@ -32,11 +32,74 @@
 #include <QVariant>
 #include <QSettings>
 #include <QList>
+#include <QPair>
+#include <QMap>
+#include <QObject>
+#include <QTimer>
+#include <QFileSystemWatcher>
+#include <QReadWriteLock>
+#include <atomic>
+
+class SensorFrameworkConfig;
+
+/**
+ * Watches the loaded configuration files and reports changed keys.
+ * Files and directories are watched with inotify through
+ * QFileSystemWatcher; bursts of change notifications are coalesced into
+ * one reload. Notifications are emitted from the thread owning the
+ * watcher, the main thread. Filters run in adaptor threads, so values
+ * they use while processing samples must be handed over with bind().
+ */
+class ConfigWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Start or stop watching the loaded configuration files.
+     *
+     * @param enable Should files be watched.
+     */
+    void setWatching(bool enable);
+
+Q_SIGNALS:
+    /**
+     * Emitted for every key whose value was added, changed or removed
+     * by a reload.
+     *
+     * @param key Configuration key.
+     * @param value New value, invalid if key was removed.
+     */
+    void valueChanged(const QString& key, const QVariant& value);
+
+    /**
+     * Emitted after configuration has been reloaded.
+     */
+    void reloaded();
+
+private Q_SLOTS:
+    void pathChanged(const QString& path);
+    void reload();
+
+private:
+    ConfigWatcher();
+    void updateWatchedPaths();
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_reloadTimer;
+    bool m_watching;
+
+    friend class SensorFrameworkConfig;
+};
 
 /**
  * Sensord configuration parser. Configuration is read and parsed with
  * the QSettings class. SensorFrameworkConfig is a singleton instance to which configuration
  * is loaded once during startup.
+ *
+ * Values may be read from any thread. Loading and reloading read the
+ * files into a new set of values and swap it in under a lock, so readers
+ * see either the old or the new configuration, never a partial one.
  */
 class SensorFrameworkConfig
 {
@@ -97,6 +160,54 @@ public:
      */
     static bool loadConfig(const QString &defConfigPath, const QString &configDPath);
 
+    /**
+     * Re-read all configuration files loaded with loadConfig() and
+     * notify subscribers of changed keys. If any file fails to parse
+     * the current configuration is kept.
+     *
+     * @return was configuration reloaded successfully.
+     */
+    static bool reloadConfig();
+
+    /**
+     * Get the change notifier of the singleton configuration.
+     *
+     * @return watcher instance.
+     */
+    static ConfigWatcher* watcher();
+
+    /**
+     * Call functor with the new value whenever given key changes on
+     * reload. The subscription is dropped when context is destroyed.
+     *
+     * @tparam T Value type for configuration entry.
+     * @param key Configuration key.
+     * @param def Value passed to functor if key is removed.
+     * @param context Receiver object controlling lifetime and thread.
+     * @param functor Callable taking a value of type T.
+     * @return connection handle.
+     */
+    template<typename T, typename Functor>
+    static QMetaObject::Connection subscribe(const QString& key, const T& def,
+                                             const QObject* context, Functor functor);
+
+    /**
+     * Keep a variable in sync with given key. The variable is stored to
+     * from the main thread whenever the key changes on reload, and may be
+     * loaded by filters in adaptor threads while processing samples.
+     * Load it once per sample if it is used more than once.
+     *
+     * @tparam T Value type for configuration entry.
+     * @param key Configuration key.
+     * @param def Value stored if key is removed.
+     * @param context Object owning the variable.
+     * @param target Variable to update.
+     * @return connection handle.
+     */
+    template<typename T>
+    static QMetaObject::Connection bind(const QString& key, const T& def,
+                                        const QObject* context, std::atomic<T>* target);
+
     /**
      * Close singleton instance.
      */
@@ -124,19 +235,37 @@ private:
     SensorFrameworkConfig& operator=(const SensorFrameworkConfig &c);
 
     /**
-     * Load configuration file from given path.
+     * Read configuration files from given paths.
+     *
+     * @param defConfigPath Path to the config file.
+     * @param configDPath Path to the directory with config files.
+     * @param values Map where read values are merged into.
+     * @return were all existing files read successfully.
+     */
+    static bool readConfig(const QString &defConfigPath, const QString &configDPath, QMap<QString, QVariant> &values);
+
+    /**
+     * Read one configuration file.
      *
      * @param configFileName Configuration file path.
-     * @return was configuration loaded successfully.
+     * @param values Map where read values are merged into.
+     * @return was configuration read successfully.
      */
-    bool loadConfigFile(const QString &configFileName);
+    static bool readConfigFile(const QString &configFileName, QMap<QString, QVariant> &values);
 
     /**
-     * Clear configuration.
+     * Replace configuration.
+     *
+     * @param values New configuration values.
      */
-    void clearConfig();
+    void setValues(const QMap<QString, QVariant> &values);
+
+    QMap<QString, QVariant> m_values; /**< parsed configuration */
+    mutable QReadWriteLock m_lock; /**< guards m_values */
+    QList<QPair<QString, QString> > m_loadedPaths; /**< (file, directory) pairs in load order */
+    ConfigWatcher* m_watcher; /**< change notifier */
 
-    QSettings m_settings; /**< parsed QSettings */
+    friend class ConfigWatcher;
 };
 
 template<typename T>
@@ -148,4 +277,23 @@ T SensorFrameworkConfig::value(const QString &key, const T &def) const
     return val.value<T>();
 }
 
+template<typename T, typename Functor>
+QMetaObject::Connection SensorFrameworkConfig::subscribe(const QString& key, const T& def,
+                                                         const QObject* context, Functor functor)
+{
+    return QObject::connect(watcher(), &ConfigWatcher::valueChanged, context,
+                            [key, def, functor](const QString& changedKey, const QVariant& value) {
+                                if (changedKey == key) {
+                                    functor(value.isValid() ? value.value<T>() : def);
+                                }
+                            });
+}
+
+template<typename T>
+QMetaObject::Connection SensorFrameworkConfig::bind(const QString& key, const T& def,
+                                                    const QObject* context, std::atomic<T>* target)
+{
+    return subscribe<T>(key, def, context, [target](const T& value) { target->store(value); });
+}
+
 #endif // SENSORD_CONFIG_H
@@ -40,7 +40,18 @@ SOURCES += sensormanager.cpp \
     sockethandler.cpp \
     inputdevadaptor.cpp \
     config.cpp \
-    nodebase.cpp
+    nodebase.cpp \
+    clientquota.cpp \
+    deviceprobe.cpp \
+    msctimestamp.cpp \
+    inputeventmask.cpp \
+    touchtracker.cpp \
+    sampleencoder.cpp \
+    cpuaccounting.cpp \
+    mountmatrix.cpp \
+    samplepredictor.cpp \
+    scheduler.cpp \
+    suspendmonitor.cpp
 
 HEADERS += sensormanager.h \
     sensormanager_a.h \
@@ -68,7 +79,18 @@ HEADERS += sensormanager.h \
     sockethandler.h \
     inputdevadaptor.h \
     config.h \
-    nodebase.h
+    nodebase.h \
+    clientquota.h \
+    deviceprobe.h \
+    msctimestamp.h \
+    inputeventmask.h \
+    touchtracker.h \
+    sampleencoder.h \
+    cpuaccounting.h \
+    mountmatrix.h \
+    samplepredictor.h \
+    scheduler.h \
+    suspendmonitor.h
 
 mce {
     SOURCES += mcewatcher.cpp
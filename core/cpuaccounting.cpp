@@ -0,0 +1,120 @@
+/**
+   @file cpuaccounting.cpp
+   @brief Per-node CPU time accounting of the dataflow graph
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "cpuaccounting.h"
+#include "logging.h"
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <time.h>
+#include <algorithm>
+
+std::atomic<bool> CpuAccounting::enabled_(false);
+
+static QMutex nodesMutex;
+static QHash<QString, CpuAccounting::Node*> nodes;
+
+static thread_local CpuAccounting::Scope* currentScope = 0;
+
+static quint64 threadCpuTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (quint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void CpuAccounting::Scope::begin()
+{
+    parent_ = currentScope;
+    currentScope = this;
+    start_ns_ = threadCpuTime();
+}
+
+void CpuAccounting::Scope::end()
+{
+    quint64 elapsed = threadCpuTime() - start_ns_;
+    ++node_->calls_;
+    node_->total_ns_ += elapsed;
+    if (parent_) {
+        parent_->node_->children_ns_ += elapsed;
+    }
+    currentScope = parent_;
+}
+
+void CpuAccounting::setEnabled(bool enabled)
+{
+    if (enabled_.exchange(enabled, std::memory_order_relaxed) != enabled) {
+        sensordLogD() << "CPU accounting" << (enabled ? "enabled" : "disabled");
+    }
+}
+
+CpuAccounting::Node* CpuAccounting::node(const QString& name)
+{
+    QMutexLocker locker(&nodesMutex);
+    Node* node = nodes.value(name);
+    if (!node) {
+        node = new Node(name);
+        nodes.insert(name, node);
+    }
+    return node;
+}
+
+void CpuAccounting::reset()
+{
+    QMutexLocker locker(&nodesMutex);
+    foreach (Node* node, nodes) {
+        node->calls_ = 0;
+        node->total_ns_ = 0;
+        node->children_ns_ = 0;
+    }
+}
+
+static bool busierThan(const CpuAccounting::Node* a, const CpuAccounting::Node* b)
+{
+    return a->selfNs() > b->selfNs();
+}
+
+QStringList CpuAccounting::report()
+{
+    QList<Node*> called;
+    {
+        QMutexLocker locker(&nodesMutex);
+        foreach (Node* node, nodes) {
+            if (node->calls()) {
+                called.append(node);
+            }
+        }
+    }
+    std::sort(called.begin(), called.end(), busierThan);
+
+    QStringList lines;
+    foreach (const Node* node, called) {
+        lines.append(QString("%1: %2 call(s), self %3 ms, total %4 ms, %5 us/call")
+                     .arg(node->name())
+                     .arg(node->calls())
+                     .arg(node->selfNs() / 1e6, 0, 'f', 3)
+                     .arg(node->totalNs() / 1e6, 0, 'f', 3)
+                     .arg(node->selfNs() / 1e3 / node->calls(), 0, 'f', 1));
+    }
+    return lines;
+}
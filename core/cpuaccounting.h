@@ -0,0 +1,136 @@
+/**
+   @file cpuaccounting.h
+   @brief Per-node CPU time accounting of the dataflow graph
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef CPUACCOUNTING_H
+#define CPUACCOUNTING_H
+
+#include <QString>
+#include <QStringList>
+#include <atomic>
+
+/**
+ * CPU time accounting of dataflow nodes.
+ *
+ * Adaptor sample processing, pusher wakeups and source propagation are
+ * wrapped in a Scope, which when accounting is enabled adds the thread
+ * CPU time (\c CLOCK_THREAD_CPUTIME_ID) spent in the scope and one call
+ * to a named Node. Scopes nest: time of a scope is total time for its
+ * own node and child time for the enclosing scope's node, so self time
+ * of a node excludes the work done downstream of it. When accounting is
+ * disabled, which is the default, a scope costs a single branch.
+ *
+ * Accounting is enabled with \c global/cpu_accounting or at runtime
+ * through the \c cpuAccounting D-Bus property of the sensor manager.
+ * Nodes are created on demand by name and live until exit. Counters of
+ * a node are only written by the thread running the node, readers may
+ * see them a sample late.
+ */
+class CpuAccounting
+{
+public:
+    /**
+     * Accumulated CPU usage of a named node.
+     */
+    class Node
+    {
+    public:
+        const QString& name() const { return name_; }
+        quint64 calls() const { return calls_; }
+        quint64 totalNs() const { return total_ns_; }
+        quint64 selfNs() const { return total_ns_ - children_ns_; }
+
+    private:
+        explicit Node(const QString& name) :
+            name_(name), calls_(0), total_ns_(0), children_ns_(0) {}
+
+        friend class CpuAccounting;
+
+        QString name_;
+        quint64 calls_;
+        quint64 total_ns_;
+        quint64 children_ns_;
+    };
+
+    /**
+     * Accounts CPU time from construction to destruction to a node.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(Node* node) : node_(enabled_.load(std::memory_order_relaxed) ? node : 0)
+        {
+            if (node_) {
+                begin();
+            }
+        }
+
+        ~Scope()
+        {
+            if (node_) {
+                end();
+            }
+        }
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        void begin();
+        void end();
+
+        Node* node_;
+        Scope* parent_;
+        quint64 start_ns_;
+    };
+
+    /**
+     * Is accounting enabled.
+     */
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Enable or disable accounting. Counters are kept.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * Find or create node with given name.
+     *
+     * @param name Node name, e.g. \c adaptor/accelerometeradaptor.
+     * @return node, never \c NULL.
+     */
+    static Node* node(const QString& name);
+
+    /**
+     * Clear counters of every node.
+     */
+    static void reset();
+
+    /**
+     * Nodes which have been called, one line per node, busiest first.
+     */
+    static QStringList report();
+
+private:
+    static std::atomic<bool> enabled_; /**< written over D-Bus, read by every Scope */
+};
+
+#endif // CPUACCOUNTING_H
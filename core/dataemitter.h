@@ -30,6 +30,7 @@
 
 #include "pusher.h"
 #include "ringbuffer.h"
+#include "abstractsensor.h"
 
 /**
  * Data producer subclass which emits individual objects. Does not have
@@ -73,6 +74,17 @@ public:
         }
     }
 
+    /**
+     * Sensor channels emitting the data flag the gap to their sessions,
+     * see AbstractSensorChannel::markDiscontinuity().
+     */
+    void discontinuity()
+    {
+        if (AbstractSensorChannel* channel = dynamic_cast<AbstractSensorChannel*>(this)) {
+            channel->markDiscontinuity();
+        }
+    }
+
 protected:
     /**
      * Callback for emitted objects.
@@ -29,6 +29,11 @@
 
 #include "deviceadaptor.h"
 #include "sensormanager.h"
+#include "config.h"
+#include "idutils.h"
+#include "ringbuffer.h"
+#include "scheduler.h"
+#include "suspendmonitor.h"
 
 AdaptedSensorEntry::AdaptedSensorEntry(const QString& name, const QString& description, RingBufferBase* buffer) :
     name_(name),
@@ -90,9 +95,22 @@ DeviceAdaptor::DeviceAdaptor(const QString& id) :
     #endif
 #endif
 {
+    cpuNode_ = CpuAccounting::node("adaptor/" + id);
+    resumesSeen_ = SuspendMonitor::instance().check();
     setValid(true);
 }
 
+QString DeviceAdaptor::configKey(const QString& group, const QString& key, bool inherit) const
+{
+    QString baseKey = group + "/" + key;
+    if (instance() == 0)
+        return baseKey;
+    QString instanceKey = getInstanceId(group, instance()) + "/" + key;
+    if (inherit && !SensorFrameworkConfig::configuration()->exists(instanceKey))
+        return baseKey;
+    return instanceKey;
+}
+
 DeviceAdaptor::~DeviceAdaptor()
 {
     delete sensor_.second;
@@ -122,6 +140,28 @@ RingBufferBase* DeviceAdaptor::findBuffer(const QString& name) const
     return entry->buffer();
 }
 
+QString DeviceAdaptor::iioDevicePath() const
+{
+    return QString();
+}
+
+bool DeviceAdaptor::checkSuspend()
+{
+    unsigned resumes = SuspendMonitor::instance().check();
+    if (resumes == resumesSeen_) {
+        return false;
+    }
+    resumesSeen_ = resumes;
+
+    RingBufferBase* buffer = findBuffer(name());
+    SinkBase* sink = buffer ? buffer->sink("sink") : 0;
+    if (sink) {
+        sensordLogD() << id() << "Data gap after suspend, resetting readers";
+        Scheduler::discontinuity(sink->downstream());
+    }
+    return true;
+}
+
 bool DeviceAdaptor::setStandbyOverride(bool override)
 {
     standbyOverride_ = override;
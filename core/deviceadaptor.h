@@ -36,6 +36,7 @@
 #include <QPair>
 #include "logging.h"
 #include "nodebase.h"
+#include "cpuaccounting.h"
 
 class RingBufferBase;
 
@@ -172,6 +173,14 @@ public:
      */
     virtual RingBufferBase* findBuffer(const QString& name) const;
 
+    /**
+     * Sysfs path of the IIO device this adaptor reads, used for finding
+     * the mounting matrix of the device.
+     *
+     * @return device path, empty if the adaptor does not read an IIO device.
+     */
+    virtual QString iioDevicePath() const;
+
     /**
      * Start adaptor.
      *
@@ -200,6 +209,36 @@ public:
 
     const QString& name() { return sensor_.first; }
 
+    /**
+     * Configuration key of this adaptor instance. Instance \c n reads
+     * \c <group>@n/<key>, falling back to \c <group>/<key> when
+     * \c inherit is set. Keys naming a device, like \c path, must not
+     * be inherited, or all instances would open the same device.
+     * Instance 0 reads \c <group>/<key>.
+     *
+     * @param group Configuration group, e.g. \c accelerometer.
+     * @param key Key within the group.
+     * @param inherit fall back to the key of the primary instance.
+     * @return full key.
+     */
+    QString configKey(const QString& group, const QString& key, bool inherit = true) const;
+
+    /**
+     * CPU accounting node of sample processing.
+     */
+    CpuAccounting::Node* cpuNode() const { return cpuNode_; }
+
+    /**
+     * Check whether the system was suspended since the previous check,
+     * and if so notify everything reading the adaptor buffer of the gap,
+     * see Scheduler::discontinuity(). Adaptors call this in the thread
+     * producing samples, after waking up and before writing the next
+     * sample.
+     *
+     * @return was the system suspended.
+     */
+    bool checkSuspend();
+
 protected:
     void setAdaptedSensor(const QString& name, const QString& description, RingBufferBase* buffer);
 
@@ -211,6 +250,8 @@ private:
     QPair<QString, AdaptedSensorEntry*> sensor_;
     bool standbyOverride_;                        /**< standby override state */
     bool screenBlanked_;                          /**< is display blanked */
+    CpuAccounting::Node* cpuNode_;                /**< CPU accounting node */
+    unsigned resumesSeen_;                        /**< SuspendMonitor resumes already handled */
 };
 
 /**
@@ -0,0 +1,226 @@
+/**
+   @file deviceprobe.cpp
+   @brief Cached device availability probes
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "deviceprobe.h"
+#include "config.h"
+#include "logging.h"
+
+#include <QRunnable>
+#include <QMutexLocker>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <linux/major.h>
+
+/**
+ * Thread pool task probing a single path.
+ */
+class DeviceProbeTask : public QRunnable
+{
+public:
+    DeviceProbeTask(DeviceProbe* cache, const QString& path) :
+        cache_(cache),
+        path_(path)
+    {
+    }
+
+    void run()
+    {
+        cache_->store(path_, DeviceProbe::probeUncached(path_));
+    }
+
+private:
+    DeviceProbe* cache_;
+    QString path_;
+};
+
+DeviceProbe::DeviceProbe() :
+    ttl_(10000)
+{
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    if (config) {
+        ttl_ = config->value<int>("global/probe_cache_ttl", 10000);
+        int threads = config->value<int>("global/probe_threads", 0);
+        if (threads > 0) {
+            pool_.setMaxThreadCount(threads);
+        }
+    }
+    clock_.start();
+}
+
+DeviceProbe& DeviceProbe::instance()
+{
+    static DeviceProbe probe;
+    return probe;
+}
+
+void DeviceProbe::prefetch(const QStringList& paths)
+{
+    QMutexLocker locker(&mutex_);
+    Result cached;
+    foreach (const QString& path, paths) {
+        if (path.isEmpty() || pending_.contains(path) || lookup(path, cached, false)) {
+            continue;
+        }
+        pending_.insert(path);
+        pool_.start(new DeviceProbeTask(this, path));
+    }
+    sensordLogD() << "Probing" << pending_.size() << "device paths on" << pool_.maxThreadCount() << "threads";
+}
+
+DeviceProbe::Result DeviceProbe::probe(const QString& path)
+{
+    Result result;
+    {
+        QMutexLocker locker(&mutex_);
+        while (pending_.contains(path)) {
+            probed_.wait(&mutex_);
+        }
+        if (lookup(path, result, true)) {
+            return result;
+        }
+    }
+
+    result = probeUncached(path);
+    store(path, result, true);
+    return result;
+}
+
+bool DeviceProbe::exists(const QString& path)
+{
+    return probe(path).exists;
+}
+
+bool DeviceProbe::waitForDone(int msecs)
+{
+    return pool_.waitForDone(msecs);
+}
+
+void DeviceProbe::invalidate()
+{
+    QMutexLocker locker(&mutex_);
+    cache_.clear();
+}
+
+void DeviceProbe::setTtl(int msecs)
+{
+    QMutexLocker locker(&mutex_);
+    ttl_ = msecs;
+}
+
+QStringList DeviceProbe::configuredPaths()
+{
+    QStringList paths;
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    if (!config) {
+        return paths;
+    }
+
+    const int MAX_EVENT_DEV = 16;
+    QString deviceSysPath = config->value("global/device_sys_path").toString();
+    if (deviceSysPath.contains("%1")) {
+        for (int i = 0; i < MAX_EVENT_DEV; ++i) {
+            paths << deviceSysPath.arg(i);
+        }
+    }
+
+    static const char* const keys[] = {
+        "device", "path", "x_axis_path", "y_axis_path", "z_axis_path", 0
+    };
+    foreach (const QString& group, config->groups()) {
+        for (int i = 0; keys[i]; ++i) {
+            QString path = config->value(group + "/" + keys[i]).toString();
+            if (path.startsWith('/') && !path.contains("%1") && !paths.contains(path)) {
+                paths << path;
+            }
+        }
+    }
+    return paths;
+}
+
+DeviceProbe::Result DeviceProbe::probeUncached(const QString& path)
+{
+    Result result;
+    QByteArray localPath = path.toLocal8Bit();
+    struct stat st;
+
+    if (lstat(localPath.constData(), &st) < 0) {
+        return result;
+    }
+    result.exists = true;
+
+    // Opening arbitrary device nodes may have side effects, e.g. on
+    // watchdogs or ttys, so only evdev nodes are opened and queried
+    if (!S_ISCHR(st.st_mode) || major(st.st_rdev) != INPUT_MAJOR) {
+        result.readable = faccessat(AT_FDCWD, localPath.constData(), R_OK, AT_EACCESS) == 0;
+        return result;
+    }
+
+    int fd = open(localPath.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) {
+        return result;
+    }
+    result.readable = true;
+
+    char deviceName[256] = {0,};
+    if (ioctl(fd, EVIOCGNAME(sizeof(deviceName)), deviceName) != -1) {
+        result.hasInputName = true;
+        result.inputName = QString(deviceName);
+    }
+    close(fd);
+
+    return result;
+}
+
+void DeviceProbe::store(const QString& path, const Result& result, bool used)
+{
+    QMutexLocker locker(&mutex_);
+    Entry entry;
+    entry.result = result;
+    entry.usedAt = used ? clock_.elapsed() : -1;
+    cache_.insert(path, entry);
+    pending_.remove(path);
+    probed_.wakeAll();
+}
+
+bool DeviceProbe::lookup(const QString& path, Result& result, bool use)
+{
+    QHash<QString, Entry>::iterator it = cache_.find(path);
+    if (it == cache_.end()) {
+        return false;
+    }
+    // Time to live starts at first use, so results prefetched at
+    // startup are not lost before the adaptors get to them
+    if (it->usedAt >= 0 && clock_.elapsed() - it->usedAt > ttl_) {
+        cache_.erase(it);
+        return false;
+    }
+    if (use && it->usedAt < 0) {
+        it->usedAt = clock_.elapsed();
+    }
+    result = it->result;
+    return true;
+}
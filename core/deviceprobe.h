@@ -0,0 +1,163 @@
+/**
+   @file deviceprobe.h
+   @brief Cached device availability probes
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef DEVICEPROBE_H
+#define DEVICEPROBE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QElapsedTimer>
+
+/**
+ * Cache for device node and sysfs availability probes.
+ *
+ * Adaptor constructors and init() probe device nodes and sysfs entries
+ * with blocking system calls. At daemon startup the probes of all
+ * configured devices can be started in parallel with prefetch(), so
+ * that adaptors created later on find the results already cached.
+ * A probe for a path which is still in flight waits for that probe
+ * instead of repeating it, and a path which was never prefetched is
+ * probed synchronously. Cached results expire
+ * \c global/probe_cache_ttl milliseconds (default 10000) after they were
+ * first looked up, so that hotplugged devices are eventually noticed.
+ * Prefetched results are kept until then however long the startup takes.
+ *
+ * Only evdev nodes (character devices with the input major number) are
+ * opened and queried with \c EVIOCGNAME. Other character devices are
+ * only checked for read access, as opening them may have side effects.
+ */
+class DeviceProbe
+{
+public:
+    /**
+     * Result of probing a single path.
+     */
+    struct Result
+    {
+        Result() : exists(false), readable(false), hasInputName(false) {}
+
+        bool exists;       /**< path exists (lstat) */
+        bool readable;     /**< path can be opened for reading (open, or access for non-evdev devices) */
+        bool hasInputName; /**< EVIOCGNAME succeeded on the path */
+        QString inputName; /**< evdev device name, if any */
+    };
+
+    /**
+     * Get the probe cache singleton.
+     *
+     * @return probe cache instance.
+     */
+    static DeviceProbe& instance();
+
+    /**
+     * Start probing given paths on the thread pool. Returns
+     * immediately. Paths which are cached or already in flight are
+     * skipped.
+     *
+     * @param paths Paths to probe.
+     */
+    void prefetch(const QStringList& paths);
+
+    /**
+     * Get probe result for a path. Uses cached result if available,
+     * waits for an in-flight probe or probes synchronously otherwise.
+     *
+     * @param path Path to probe.
+     * @return Probe result.
+     */
+    Result probe(const QString& path);
+
+    /**
+     * Convenience wrapper for probe(path).exists.
+     *
+     * @param path Path to check.
+     * @return does path exist.
+     */
+    bool exists(const QString& path);
+
+    /**
+     * Wait until all prefetched probes have completed.
+     *
+     * @param msecs Maximum time to wait, or -1 for no limit.
+     * @return \c true if no probes are in flight.
+     */
+    bool waitForDone(int msecs = -1);
+
+    /**
+     * Drop all cached results.
+     */
+    void invalidate();
+
+    /**
+     * Set how long results are cached after first lookup.
+     *
+     * @param msecs Time to live in milliseconds.
+     */
+    void setTtl(int msecs);
+
+    /**
+     * Collect the paths adaptors are going to probe according to the
+     * configuration: evdev nodes matching \c global/device_sys_path and
+     * \c device, \c path and \c [xyz]_axis_path keys of every group.
+     *
+     * @return List of paths.
+     */
+    static QStringList configuredPaths();
+
+    /**
+     * Probe a path without using the cache.
+     *
+     * @param path Path to probe.
+     * @return Probe result.
+     */
+    static Result probeUncached(const QString& path);
+
+private:
+    DeviceProbe();
+    DeviceProbe(const DeviceProbe&);
+    DeviceProbe& operator=(const DeviceProbe&);
+
+    void store(const QString& path, const Result& result, bool used = false);
+    bool lookup(const QString& path, Result& result, bool use);
+
+    struct Entry
+    {
+        Result result;
+        qint64 usedAt;  /**< first lookup, -1 while unused */
+    };
+
+    friend class DeviceProbeTask;
+
+    mutable QMutex mutex_;
+    QWaitCondition probed_;
+    QHash<QString, Entry> cache_;
+    QSet<QString> pending_;
+    QThreadPool pool_;
+    QElapsedTimer clock_;
+    qint64 ttl_;
+};
+
+#endif // DEVICEPROBE_H
@@ -824,6 +824,8 @@ void HybrisManager::processSample(const sensors_event_t& data)
 {
     foreach (HybrisAdaptor *adaptor, m_registeredAdaptors.values(data.type)) {
         if (adaptor->isRunning()) {
+            CpuAccounting::Scope scope(adaptor->cpuNode());
+            adaptor->checkSuspend();
             adaptor->processSample(data);
         }
     }
@@ -31,13 +31,17 @@
 
 #include "inputdevadaptor.h"
 #include "config.h"
+#include "deviceprobe.h"
+#include "datatypes/utils.h"
 
 #include <errno.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/epoll.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
+#include <time.h>
 
 #include <QFile>
 #include <QDir>
@@ -47,11 +51,25 @@ InputDevAdaptor::InputDevAdaptor(const QString& id, int maxDeviceCount) :
     SysfsAdaptor(id, SysfsAdaptor::SelectMode, false),
     m_deviceCount(0),
     m_maxDeviceCount(maxDeviceCount),
-    m_cachedInterval_us(0)
+    m_cachedInterval_us(0),
+    m_clockId(CLOCK_MONOTONIC),
+    m_useMscTimestamp(true),
+    m_filterInUserspace(false)
 {
     memset(m_evlist, 0x0, sizeof(input_event)*64);
 }
 
+static void setEventTime(struct input_event* ev, quint64 timestamp_us)
+{
+#ifdef input_event_sec
+    ev->input_event_sec = timestamp_us / 1000000;
+    ev->input_event_usec = timestamp_us % 1000000;
+#else
+    ev->time.tv_sec = timestamp_us / 1000000;
+    ev->time.tv_usec = timestamp_us % 1000000;
+#endif
+}
+
 InputDevAdaptor::~InputDevAdaptor()
 {
 }
@@ -66,7 +84,7 @@ int InputDevAdaptor::getInputDevices(const QString& typeName)
     m_deviceString = typeName;
 
     // Check if this device name is defined in configuration
-    QString deviceName = SensorFrameworkConfig::configuration()->value<QString>(typeName + "/device", "");
+    QString deviceName = SensorFrameworkConfig::configuration()->value<QString>(configKey(typeName, "device", false), "");
 
     // Do not perform strict checks for the input device
     if (deviceName.size() && checkInputDevice(deviceName, typeName, false)) {
@@ -76,11 +94,13 @@ int InputDevAdaptor::getInputDevices(const QString& typeName)
         const int MAX_EVENT_DEV = 16;
 qDebug() << id() << deviceNumber << m_deviceCount << m_maxDeviceCount;
 
-        // No configuration for this device, try find the device from the device system path
+        // No configuration for this device, try find the device from the device system path.
+        // Instance n of the adaptor takes the n:th matching device.
+        int skip = instance();
         while (deviceNumber < MAX_EVENT_DEV && m_deviceCount < m_maxDeviceCount) {
             deviceName = deviceSysPathString.arg(deviceNumber);
             qDebug() << id() << Q_FUNC_INFO << deviceName;
-            if (checkInputDevice(deviceName, typeName)) {
+            if (checkInputDevice(deviceName, typeName) && skip-- == 0) {
                 addPath(deviceName, m_deviceCount);
                 ++m_deviceCount;
                 break;
@@ -89,7 +109,7 @@ qDebug() << id() << deviceNumber << m_deviceCount << m_maxDeviceCount;
         }
     }
 
-    QString pollConfigKey = QString(typeName + "/poll_file");
+    QString pollConfigKey = configKey(typeName, "poll_file", false);
     if (SensorFrameworkConfig::configuration()->exists(pollConfigKey)) {
         m_usedDevicePollFilePath = SensorFrameworkConfig::configuration()->value<QString>(pollConfigKey, "");
     } else {
@@ -123,10 +143,89 @@ int InputDevAdaptor::getEvents(int fd)
     return bytes/sizeof(struct input_event);
 }
 
+void InputDevAdaptor::addEventFilter(unsigned int type, int code)
+{
+    if (code < 0) {
+        m_eventMask.add(type);
+    } else {
+        m_eventMask.add(type, code);
+    }
+}
+
+void InputDevAdaptor::fdOpened(int pathId, int fd)
+{
+    m_mscTimestamps[pathId].reset();
+
+    if (!m_eventMask.isEmpty()) {
+#ifdef MSC_TIMESTAMP
+        if (m_useMscTimestamp) {
+            m_eventMask.addAuxiliary(EV_MSC, MSC_TIMESTAMP);
+        }
+#endif
+        if (!m_eventMask.apply(fd)) {
+            sensordLogD() << id() << "Kernel event mask not available, filtering events in sensord";
+            m_filterInUserspace = true;
+        }
+    }
+
+#ifdef EVIOCSCLOCKID
+    if (ioctl(fd, EVIOCSCLOCKID, &m_clockId) == 0) {
+        return;
+    }
+    sensordLogW() << id() << "EVIOCSCLOCKID failed:" << strerror(errno) << ", timestamps are in realtime clock";
+#else
+    Q_UNUSED(fd);
+#endif
+    setTimeBase("realtime");
+}
+
+void InputDevAdaptor::applyMscTimestamps(int pathId, int numEvents)
+{
+#ifdef MSC_TIMESTAMP
+    int frameStart = 0;
+    bool hasTimestamp = false;
+    quint32 raw = 0;
+
+    for (int i = 0; i < numEvents; ++i) {
+        const input_event& ev = m_evlist[i];
+        if (ev.type == EV_MSC && ev.code == MSC_TIMESTAMP) {
+            raw = ev.value;
+            hasTimestamp = true;
+        } else if (ev.type == EV_SYN && ev.code == SYN_DROPPED) {
+            m_mscTimestamps[pathId].reset();
+            hasTimestamp = false;
+            frameStart = i + 1;
+        } else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+            if (hasTimestamp) {
+                quint64 timestamp = m_mscTimestamps[pathId].map(raw, Utils::getTimeStamp(&ev));
+                for (int j = frameStart; j <= i; ++j) {
+                    setEventTime(&m_evlist[j], timestamp);
+                }
+            }
+            hasTimestamp = false;
+            frameStart = i + 1;
+        }
+    }
+#else
+    Q_UNUSED(pathId);
+    Q_UNUSED(numEvents);
+#endif
+}
+
 void InputDevAdaptor::processSample(int pathId, int fd)
 {
     int numEvents = getEvents(fd);
 
+    // Timestamps of dropped frames still keep the hardware clock mapping
+    // in step
+    if (m_useMscTimestamp) {
+        applyMscTimestamps(pathId, numEvents);
+    }
+
+    if (m_filterInUserspace || m_eventMask.hasAuxiliary()) {
+        numEvents = m_eventMask.filter(m_evlist, numEvents);
+    }
+
     for (int i = 0; i < numEvents; ++i) {
         switch (m_evlist[i].type) {
             case EV_SYN:
@@ -141,33 +240,26 @@ void InputDevAdaptor::processSample(int pathId, int fd)
 
 bool InputDevAdaptor::checkInputDevice(const QString& path, const QString& matchString, bool strictChecks) const
 {
-    char deviceName[256] = {0,};
-    bool check = true;
 qDebug() << id() << Q_FUNC_INFO << path << matchString << strictChecks;
-    int fd = open(path.toLocal8Bit().constData(), O_RDONLY);
-    if (fd == -1) {
+    const DeviceProbe::Result probe = DeviceProbe::instance().probe(path);
+    if (!probe.readable) {
         return false;
     }
 
-    if (strictChecks) {
-        int result = ioctl(fd, EVIOCGNAME(sizeof(deviceName)), deviceName);
-        qDebug() << id() << Q_FUNC_INFO << "open result:" << result << deviceName;
-        if (result == -1) {
-           sensordLogW() << id() << "Could not read devicename for " << path;
-           check = false;
-        } else {
-            if (QString(deviceName).contains(matchString, Qt::CaseInsensitive)) {
-                sensordLogT() << id() << "\"" << matchString << "\"" << " matched in device name: " << deviceName;
-                check = true;
-            } else {
-                check = false;
-            }
-        }
+    if (!strictChecks) {
+        return true;
     }
 
-    close(fd);
-
-    return check;
+    qDebug() << id() << Q_FUNC_INFO << "device name:" << probe.inputName;
+    if (!probe.hasInputName) {
+        sensordLogW() << id() << "Could not read devicename for " << path;
+        return false;
+    }
+    if (probe.inputName.contains(matchString, Qt::CaseInsensitive)) {
+        sensordLogT() << id() << "\"" << matchString << "\"" << " matched in device name: " << probe.inputName;
+        return true;
+    }
+    return false;
 }
 
 unsigned int InputDevAdaptor::interval() const
@@ -194,7 +286,23 @@ bool InputDevAdaptor::setInterval(const int sessionId, const unsigned int interv
 void InputDevAdaptor::init()
 {
     qDebug() << id() << Q_FUNC_INFO << name();
-    if (!getInputDevices(SensorFrameworkConfig::configuration()->value<QString>(name() + "/input_match", name()))) {
+
+    QString clock = SensorFrameworkConfig::configuration()->value<QString>(configKey(name(), "input_clock"),
+                        SensorFrameworkConfig::configuration()->value<QString>("global/input_clock", "monotonic"));
+    if (clock == "boottime") {
+        m_clockId = CLOCK_BOOTTIME;
+    } else if (clock == "realtime") {
+        m_clockId = CLOCK_REALTIME;
+    } else {
+        if (clock != "monotonic") {
+            sensordLogW() << id() << "Unknown input_clock" << clock << ", using monotonic";
+        }
+        clock = "monotonic";
+        m_clockId = CLOCK_MONOTONIC;
+    }
+    setTimeBase(clock);
+    m_useMscTimestamp = SensorFrameworkConfig::configuration()->value<bool>(configKey(name(), "msc_timestamp"), true);
+    if (!getInputDevices(SensorFrameworkConfig::configuration()->value<QString>(configKey(name(), "input_match"), name()))) {
         sensordLogW() << id() << "Input device not found.";
         SysfsAdaptor::init();
     }
@@ -30,7 +30,10 @@
 #define INPUTDEVADAPTOR_H
 
 #include "sysfsadaptor.h"
+#include "msctimestamp.h"
+#include "inputeventmask.h"
 #include <QString>
+#include <QMap>
 #include <QStringList>
 #include <QFile>
 #include <linux/input.h>
@@ -104,8 +107,32 @@ protected:
      */
     int getInputDevices(const QString& typeName);
 
+    /**
+     * Declare an event consumed by #interpretEvent. Once any event is
+     * declared, the kernel is asked to drop all other events of the
+     * device with \c EVIOCSMASK, and frames which would only contain
+     * them no longer wake sensord up. \c MSC_TIMESTAMP is passed as an
+     * auxiliary event, so on devices reporting it such frames still
+     * wake sensord, but are dropped before interpretation. Adaptors
+     * should declare their events in the constructor.
+     *
+     * @param type Event type, e.g. \c EV_ABS.
+     * @param code Event code, e.g. \c ABS_X, or -1 for all codes of
+     *             the type.
+     */
+    void addEventFilter(unsigned int type, int code = -1);
+
     void processSample(int pathId, int fd);
 
+    /**
+     * Switch the event clock of the opened device to the configured
+     * one with \c EVIOCSCLOCKID, and program the event mask.
+     *
+     * @param pathId Path ID of the device.
+     * @param fd Open device file descriptor.
+     */
+    virtual void fdOpened(int pathId, int fd);
+
     virtual unsigned int interval() const;
 
     virtual bool setInterval(const int sessionId, const unsigned int interval_us);
@@ -120,12 +147,26 @@ private:
      */
     int getEvents(int fd);
 
+    /**
+     * Replace the timestamps of complete frames in #m_evlist which carry
+     * \c MSC_TIMESTAMP with the mapped hardware timestamp.
+     *
+     * @param pathId Path ID of the device the events were read from.
+     * @param numEvents Number of events in #m_evlist.
+     */
+    void applyMscTimestamps(int pathId, int numEvents);
+
     QString m_usedDevicePollFilePath; /**< sysfs path to input device poll file */
     QString m_deviceString;           /**< input device name */
     int m_deviceCount;                /**< number of available input devices */
     const int m_maxDeviceCount;       /**< maximum number of supported devices */
     input_event m_evlist[64];         /**< input event buffer */
     unsigned int m_cachedInterval_us; /**< cached interval reading */
+    int m_clockId;                    /**< requested event clock */
+    bool m_useMscTimestamp;           /**< prefer MSC_TIMESTAMP over event time */
+    QMap<int, MscTimestamp> m_mscTimestamps; /**< hardware clock mapping per path */
+    InputEventMask m_eventMask;       /**< events consumed by the adaptor */
+    bool m_filterInUserspace;         /**< kernel could not apply #m_eventMask */
 };
 
 #endif
@@ -0,0 +1,169 @@
+/**
+   @file inputeventmask.cpp
+   @brief Filter for input events consumed by an adaptor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "inputeventmask.h"
+#include "logging.h"
+
+#include <QVector>
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <string.h>
+
+void InputEventMask::add(unsigned int type)
+{
+    types_[type].clear();
+}
+
+void InputEventMask::add(unsigned int type, unsigned int code)
+{
+    QMap<unsigned int, QSet<unsigned int> >::iterator it = types_.find(type);
+    if (it == types_.end()) {
+        types_[type].insert(code);
+    } else if (!it->isEmpty()) {
+        it->insert(code);
+    }
+}
+
+void InputEventMask::addAuxiliary(unsigned int type, unsigned int code)
+{
+    add(type, code);
+    auxiliary_.insert(type << 16 | code);
+}
+
+bool InputEventMask::accepts(unsigned int type, unsigned int code) const
+{
+    if (type == EV_SYN || types_.isEmpty()) {
+        return true;
+    }
+    QMap<unsigned int, QSet<unsigned int> >::const_iterator it = types_.constFind(type);
+    if (it == types_.constEnd()) {
+        return false;
+    }
+    return it->isEmpty() || it->contains(code);
+}
+
+#ifdef EVIOCSMASK
+static bool setMask(int fd, unsigned int type, const QVector<quint8>& bits)
+{
+    struct input_mask mask;
+    mask.type = type;
+    mask.codes_size = bits.size();
+    mask.codes_ptr = (quint64)(quintptr)bits.constData();
+    return ioctl(fd, EVIOCSMASK, &mask) == 0;
+}
+
+static QVector<quint8> bitmap(unsigned int count)
+{
+    return QVector<quint8>((count + 7) / 8, 0);
+}
+
+static void setBit(QVector<quint8>& bits, unsigned int bit)
+{
+    if (bit / 8 < (unsigned int)bits.size()) {
+        bits[bit / 8] |= 1 << (bit % 8);
+    }
+}
+
+static unsigned int codeCount(unsigned int type)
+{
+    switch (type) {
+    case EV_KEY: return KEY_CNT;
+    case EV_REL: return REL_CNT;
+    case EV_ABS: return ABS_CNT;
+    case EV_MSC: return MSC_CNT;
+    case EV_SW:  return SW_CNT;
+    case EV_LED: return LED_CNT;
+    case EV_SND: return SND_CNT;
+    case EV_FF:  return FF_CNT;
+    default:     return 0;
+    }
+}
+#endif
+
+bool InputEventMask::apply(int fd) const
+{
+#ifdef EVIOCSMASK
+    if (types_.isEmpty()) {
+        return true;
+    }
+
+    // Type 0 (EV_SYN) holds the mask of event types
+    QVector<quint8> typeBits = bitmap(EV_CNT);
+    for (QMap<unsigned int, QSet<unsigned int> >::const_iterator it = types_.constBegin(); it != types_.constEnd(); ++it) {
+        setBit(typeBits, it.key());
+    }
+    if (!setMask(fd, EV_SYN, typeBits)) {
+        sensordLogD() << "EVIOCSMASK not supported:" << strerror(errno);
+        return false;
+    }
+
+    for (QMap<unsigned int, QSet<unsigned int> >::const_iterator it = types_.constBegin(); it != types_.constEnd(); ++it) {
+        unsigned int count = codeCount(it.key());
+        if (it->isEmpty() || !count) {
+            continue;
+        }
+        QVector<quint8> codeBits = bitmap(count);
+        foreach (unsigned int code, *it) {
+            setBit(codeBits, code);
+        }
+        if (!setMask(fd, it.key(), codeBits)) {
+            sensordLogW() << "EVIOCSMASK failed for event type" << it.key() << ":" << strerror(errno);
+            return false;
+        }
+    }
+    return true;
+#else
+    Q_UNUSED(fd);
+    return false;
+#endif
+}
+
+int InputEventMask::filter(struct input_event* events, int count) const
+{
+    if (types_.isEmpty()) {
+        return count;
+    }
+
+    int out = 0;
+    int frameStart = 0;
+    bool payload = false;
+    for (int i = 0; i < count; ++i) {
+        const input_event& ev = events[i];
+        if (!accepts(ev.type, ev.code)) {
+            continue;
+        }
+        if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+            if (!payload) {
+                out = frameStart;
+                continue;
+            }
+            events[out++] = ev;
+            frameStart = out;
+            payload = false;
+            continue;
+        }
+        if (!auxiliary_.contains(ev.type << 16 | ev.code)) {
+            payload = true;
+        }
+        events[out++] = ev;
+    }
+    return out;
+}
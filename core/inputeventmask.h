@@ -0,0 +1,118 @@
+/**
+   @file inputeventmask.h
+   @brief Filter for input events consumed by an adaptor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef INPUTEVENTMASK_H
+#define INPUTEVENTMASK_H
+
+#include <QMap>
+#include <QSet>
+#include <linux/input.h>
+
+/**
+ * Set of input event types and codes an adaptor interprets.
+ *
+ * An empty mask accepts every event. Otherwise only events of added
+ * types are accepted, restricted to the added codes for types that
+ * have any. \c EV_SYN events are always accepted.
+ *
+ * The mask is programmed into the kernel with \c EVIOCSMASK, so that
+ * other events never reach sensord, and frames left without events
+ * do not wake it up. filter() applies the same rules in user space
+ * for kernels without \c EVIOCSMASK.
+ *
+ * Auxiliary events, e.g. \c MSC_TIMESTAMP, are accepted but do not
+ * make a frame worth interpreting on their own. The kernel cannot tell
+ * them apart, so frames carrying only auxiliary events still wake
+ * sensord up, but filter() drops them before they are interpreted.
+ */
+class InputEventMask
+{
+public:
+    /**
+     * Accept all codes of given event type.
+     *
+     * @param type Event type, e.g. \c EV_ABS.
+     */
+    void add(unsigned int type);
+
+    /**
+     * Accept given event code.
+     *
+     * @param type Event type, e.g. \c EV_ABS.
+     * @param code Event code, e.g. \c ABS_X.
+     */
+    void add(unsigned int type, unsigned int code);
+
+    /**
+     * Accept given event code as auxiliary to the other events of a
+     * frame.
+     *
+     * @param type Event type, e.g. \c EV_MSC.
+     * @param code Event code, e.g. \c MSC_TIMESTAMP.
+     */
+    void addAuxiliary(unsigned int type, unsigned int code);
+
+    /**
+     * Is mask empty, i.e. are all events accepted.
+     */
+    bool isEmpty() const { return types_.isEmpty(); }
+
+    /**
+     * Does the mask have auxiliary events, i.e. does filter() need to
+     * run also when the kernel applies the mask.
+     */
+    bool hasAuxiliary() const { return !auxiliary_.isEmpty(); }
+
+    /**
+     * Is an event accepted by the mask.
+     *
+     * @param type Event type.
+     * @param code Event code.
+     * @return is event accepted.
+     */
+    bool accepts(unsigned int type, unsigned int code) const;
+
+    /**
+     * Program the mask into the kernel for an evdev file descriptor.
+     *
+     * @param fd Open evdev file descriptor.
+     * @return was mask set. \c false if the kernel does not support
+     *         \c EVIOCSMASK.
+     */
+    bool apply(int fd) const;
+
+    /**
+     * Remove events not accepted by the mask, and \c SYN_REPORT events
+     * of frames left empty, like the kernel does. Frames left with only
+     * auxiliary events are removed as a whole.
+     *
+     * @param events Event array, compacted in place.
+     * @param count Number of events in the array.
+     * @return Number of remaining events.
+     */
+    int filter(struct input_event* events, int count) const;
+
+private:
+    QMap<unsigned int, QSet<unsigned int> > types_; /**< accepted codes per type, empty for all */
+    QSet<quint32> auxiliary_;                       /**< auxiliary events as type << 16 | code */
+};
+
+#endif // INPUTEVENTMASK_H
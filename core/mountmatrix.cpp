@@ -0,0 +1,194 @@
+/**
+   @file mountmatrix.cpp
+   @brief Sensor mounting matrix discovery
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "mountmatrix.h"
+#include "config.h"
+#include "logging.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QRegularExpression>
+#include <string.h>
+
+MountMatrix::MountMatrix() :
+    origin_(OriginDefault)
+{
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            data_[i][j] = (i == j) ? 1 : 0;
+        }
+    }
+}
+
+MountMatrix MountMatrix::forSensor(const QString& group, const QString& channel, const QString& iioDevice)
+{
+    MountMatrix matrix;
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    if (!config) {
+        return matrix;
+    }
+
+    QString key = group + "/transformation_matrix";
+    QString value = config->value<QString>(key, "");
+    if (!value.isEmpty()) {
+        if (parse(value, matrix)) {
+            matrix.origin_ = OriginConfig;
+            matrix.source_ = key;
+            return matrix;
+        }
+        sensordLogW() << "Failed to parse" << key << "configuration key. Coordinate alignment may be invalid";
+    }
+
+    QString devicePath = findIioDevice(group, iioDevice);
+    if (devicePath.isEmpty()) {
+        return matrix;
+    }
+
+    value = readUdevProperty(devicePath, channel.toUpper() + "_MOUNT_MATRIX");
+    if (!value.isEmpty()) {
+        if (parse(value, matrix)) {
+            matrix.origin_ = OriginUdev;
+            matrix.source_ = devicePath;
+            sensordLogD() << group << "mounting matrix from udev:" << matrix.toString();
+            return matrix;
+        }
+        sensordLogW() << "Invalid udev mounting matrix for" << devicePath << ":" << value;
+    }
+
+    QStringList attributes;
+    attributes << "in_" + channel + "_mount_matrix" << "mount_matrix";
+    foreach (const QString& attribute, attributes) {
+        QString path = devicePath + "/" + attribute;
+        value = readAttribute(path);
+        if (value.isEmpty()) {
+            continue;
+        }
+        if (parse(value, matrix)) {
+            matrix.origin_ = OriginSysfs;
+            matrix.source_ = path;
+            sensordLogD() << group << "mounting matrix from" << path << ":" << matrix.toString();
+            return matrix;
+        }
+        sensordLogW() << "Invalid mounting matrix in" << path << ":" << value;
+    }
+
+    return matrix;
+}
+
+bool MountMatrix::parse(const QString& str, MountMatrix& matrix)
+{
+    QString stripped = str.trimmed();
+    if (stripped.startsWith('"') && stripped.endsWith('"')) {
+        stripped = stripped.mid(1, stripped.size() - 2);
+    }
+
+    QStringList cells = stripped.split(QRegularExpression("[,;]"));
+    if (cells.size() != 9) {
+        return false;
+    }
+
+    double m[3][3];
+    for (int i = 0; i < 9; ++i) {
+        bool ok;
+        m[i / 3][i % 3] = cells.at(i).trimmed().toDouble(&ok);
+        if (!ok) {
+            return false;
+        }
+    }
+    memcpy(matrix.data_, m, sizeof(m));
+    return true;
+}
+
+bool MountMatrix::isIdentity() const
+{
+    return isIdentity(data_);
+}
+
+bool MountMatrix::isIdentity(const double matrix[3][3])
+{
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            if (matrix[i][j] != ((i == j) ? 1 : 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QString MountMatrix::toString() const
+{
+    QStringList cells;
+    for (int i = 0; i < 9; ++i) {
+        cells << QString::number(data_[i / 3][i % 3]);
+    }
+    return cells.join(",");
+}
+
+QString MountMatrix::findIioDevice(const QString& group, const QString& iioDevice)
+{
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    QDir iioDir(config->value<QString>("global/iio_sysfs_path", "/sys/bus/iio/devices"));
+
+    QString device = config->value<QString>(group + "/iio_device", "");
+    if (!device.isEmpty()) {
+        return QDir(device).isAbsolute() ? device : iioDir.absoluteFilePath(device);
+    }
+
+    // Data of other adaptors may already be aligned, the matrix of some
+    // unrelated IIO device must not be applied to it
+    return iioDevice;
+}
+
+QString MountMatrix::readUdevProperty(const QString& devicePath, const QString& property)
+{
+    // udev keeps device properties in a database file named after the
+    // device number, with lines like "E:KEY=value"
+    QString devNumber = readAttribute(devicePath + "/dev");
+    if (devNumber.isEmpty()) {
+        return QString();
+    }
+
+    QString udevDataPath = SensorFrameworkConfig::configuration()->value<QString>("global/udev_data_path", "/run/udev/data");
+    QFile file(udevDataPath + "/c" + devNumber);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QString();
+    }
+
+    QByteArray prefix = QString("E:" + property + "=").toLatin1();
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        if (line.startsWith(prefix)) {
+            return QString::fromLatin1(line.mid(prefix.size()));
+        }
+    }
+    return QString();
+}
+
+QString MountMatrix::readAttribute(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromLatin1(file.readAll()).trimmed();
+}
@@ -0,0 +1,128 @@
+/**
+   @file mountmatrix.h
+   @brief Sensor mounting matrix discovery
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef MOUNTMATRIX_H
+#define MOUNTMATRIX_H
+
+#include <QString>
+
+/**
+ * Mounting matrix of a sensor, mapping sensor axes to device axes.
+ *
+ * The matrix for a sensor is looked up with forSensor() from, in order
+ * of precedence:
+ * <ol>
+ * <li>configuration key \c <group>/transformation_matrix,</li>
+ * <li>udev property \c <CHANNEL>_MOUNT_MATRIX of the IIO device, as set
+ *     by hwdb (e.g. \c ACCEL_MOUNT_MATRIX),</li>
+ * <li>IIO sysfs attribute \c in_<channel>_mount_matrix or \c mount_matrix
+ *     of the device, usually from device tree,</li>
+ * <li>identity.</li>
+ * </ol>
+ * The IIO device is the one named by \c <group>/iio_device, relative to
+ * \c global/iio_sysfs_path (default \c /sys/bus/iio/devices), or else
+ * the one read by the adaptor. Without either only the configuration is
+ * used. Groups of further instances, like \c accelerometer@1, are not
+ * inherited from the primary instance, as they describe another
+ * device. udev data
+ * is read from \c global/udev_data_path (default \c /run/udev/data).
+ */
+class MountMatrix
+{
+public:
+    /**
+     * Where the matrix came from.
+     */
+    enum Origin
+    {
+        OriginDefault = 0, /**< nothing found, identity */
+        OriginConfig,      /**< configuration override */
+        OriginUdev,        /**< udev hwdb property */
+        OriginSysfs        /**< IIO sysfs attribute */
+    };
+
+    /**
+     * Constructor. Creates identity matrix.
+     */
+    MountMatrix();
+
+    /**
+     * Find mounting matrix of a sensor.
+     *
+     * @param group Configuration group of the sensor instance, e.g.
+     *              \c accelerometer or \c accelerometer@1.
+     * @param channel IIO channel type, e.g. \c accel, \c anglvel or \c magn.
+     * @param iioDevice Sysfs path of the IIO device the adaptor reads,
+     *                  see DeviceAdaptor::iioDevicePath().
+     * @return Mounting matrix.
+     */
+    static MountMatrix forSensor(const QString& group, const QString& channel, const QString& iioDevice = QString());
+
+    /**
+     * Parse a 3x3 matrix. Accepts the sensorfw format of nine comma
+     * separated values as well as the IIO and udev format, where rows
+     * are separated by semicolons.
+     *
+     * @param str String to parse.
+     * @param matrix Parsed matrix.
+     * @return was string a valid matrix.
+     */
+    static bool parse(const QString& str, MountMatrix& matrix);
+
+    /**
+     * Is this the identity matrix, i.e. alignment is a no-op.
+     */
+    bool isIdentity() const;
+
+    /**
+     * Is given 3x3 matrix the identity matrix.
+     *
+     * @param matrix Row major matrix.
+     */
+    static bool isIdentity(const double matrix[3][3]);
+
+    /**
+     * Where the matrix was found.
+     */
+    Origin origin() const { return origin_; }
+
+    /**
+     * Configuration key or file the matrix was read from.
+     */
+    const QString& source() const { return source_; }
+
+    /**
+     * Matrix as string in sensorfw configuration format.
+     */
+    QString toString() const;
+
+    double data_[3][3]; /**< matrix, row major */
+
+private:
+    static QString findIioDevice(const QString& group, const QString& iioDevice);
+    static QString readUdevProperty(const QString& devicePath, const QString& property);
+    static QString readAttribute(const QString& path);
+
+    Origin origin_;
+    QString source_;
+};
+
+#endif // MOUNTMATRIX_H
@@ -0,0 +1,65 @@
+/**
+   @file msctimestamp.cpp
+   @brief Mapping of evdev hardware timestamps to system time
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "msctimestamp.h"
+#include "logging.h"
+
+MscTimestamp::MscTimestamp(quint64 resyncThreshold_us) :
+    resyncThreshold_(resyncThreshold_us),
+    synced_(false),
+    lastRaw_(0),
+    extended_(0),
+    offset_(0)
+{
+}
+
+void MscTimestamp::reset()
+{
+    synced_ = false;
+}
+
+quint64 MscTimestamp::map(quint32 raw, quint64 eventTime_us)
+{
+    if (!synced_) {
+        synced_ = true;
+        lastRaw_ = raw;
+        extended_ = 0;
+        offset_ = eventTime_us;
+        return eventTime_us;
+    }
+
+    // Unsigned 32-bit difference handles counter wraparound
+    extended_ += (quint32)(raw - lastRaw_);
+    lastRaw_ = raw;
+
+    quint64 mapped = offset_ + extended_;
+    qint64 latency = (qint64)(eventTime_us - mapped);
+    if (latency < 0 && (quint64)-latency <= resyncThreshold_) {
+        // Less latency than the offset was taken with
+        offset_ += latency;
+        mapped = eventTime_us;
+    } else if ((quint64)qAbs(latency) > resyncThreshold_) {
+        sensordLogD() << "MSC_TIMESTAMP off by" << latency << "us, resyncing";
+        offset_ = eventTime_us - extended_;
+        mapped = eventTime_us;
+    }
+    return mapped;
+}
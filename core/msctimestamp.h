@@ -0,0 +1,79 @@
+/**
+   @file msctimestamp.h
+   @brief Mapping of evdev hardware timestamps to system time
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef MSCTIMESTAMP_H
+#define MSCTIMESTAMP_H
+
+#include <QtGlobal>
+
+/**
+ * Maps \c MSC_TIMESTAMP values of an input device to the clock of the
+ * input events.
+ *
+ * \c MSC_TIMESTAMP is a free running 32-bit microsecond counter of the
+ * device with an unspecified epoch, wrapping about every 71 minutes.
+ * Counter values are extended to 64 bits, and offset to the event clock
+ * using the event timestamp of the first frame. The event timestamp
+ * includes interrupt latency, so whenever a frame arrives with less
+ * latency than the one the offset was taken from, the offset is
+ * lowered. When mapped and event time differ by more than the resync
+ * threshold, e.g. after the device was reset or suspended, the offset
+ * is taken again.
+ */
+class MscTimestamp
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param resyncThreshold_us Largest accepted difference between
+     *                           mapped and event time.
+     */
+    MscTimestamp(quint64 resyncThreshold_us = 100000);
+
+    /**
+     * Forget the offset, e.g. after events were dropped.
+     */
+    void reset();
+
+    /**
+     * Map hardware timestamp of a frame to event clock.
+     *
+     * @param raw \c MSC_TIMESTAMP value of the frame.
+     * @param eventTime_us Event timestamp of the frame.
+     * @return Frame timestamp in event clock, microseconds.
+     */
+    quint64 map(quint32 raw, quint64 eventTime_us);
+
+    /**
+     * Is an offset established.
+     */
+    bool isSynced() const { return synced_; }
+
+private:
+    quint64 resyncThreshold_;
+    bool synced_;
+    quint32 lastRaw_;
+    quint64 extended_;
+    qint64 offset_;
+};
+
+#endif // MSCTIMESTAMP_H
@@ -28,6 +28,7 @@
 #include "logging.h"
 #include "ringbuffer.h"
 #include "config.h"
+#include "idutils.h"
 
 NodeBase::NodeBase(const QString& id, QObject* parent) :
     QObject(parent),
@@ -54,6 +55,16 @@ bool NodeBase::isValid() const
     return m_isValid;
 }
 
+int NodeBase::instance() const
+{
+    return getInstanceIndex(m_id);
+}
+
+QString NodeBase::instanceId(const QString& baseId) const
+{
+    return getInstanceId(baseId, instance());
+}
+
 bool NodeBase::isMetadataValid() const
 {
     if (!hasLocalRange())
@@ -73,6 +84,28 @@ void NodeBase::setDescription(const QString& str)
     m_description = str;
 }
 
+QString NodeBase::timeBase() const
+{
+    if (!m_timeBase.isEmpty())
+        return m_timeBase;
+    if (m_intervalSource)
+        return m_intervalSource->timeBase();
+    return "monotonic";
+}
+
+QString NodeBase::location() const
+{
+    QString location = SensorFrameworkConfig::configuration()->value<QString>(m_id + "/location", "");
+    if (location.isEmpty() && m_intervalSource)
+        return m_intervalSource->location();
+    return location;
+}
+
+void NodeBase::setTimeBase(const QString& timeBase)
+{
+    m_timeBase = timeBase;
+}
+
 void NodeBase::introduceAvailableDataRange(const DataRange& range)
 {
     if (!m_dataRangeList.contains(range))
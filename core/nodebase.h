@@ -45,6 +45,8 @@ class NodeBase : public QObject
     Q_OBJECT
     Q_DISABLE_COPY(NodeBase)
     Q_PROPERTY(QString description READ description)
+    Q_PROPERTY(QString timeBase READ timeBase)
+    Q_PROPERTY(QString location READ location)
     Q_PROPERTY(bool standbyOverride READ standbyOverride)
     Q_PROPERTY(unsigned int interval READ getInterval)
     Q_PROPERTY(QString id READ id)
@@ -79,6 +81,14 @@ public:
      */
     bool isValid() const;
 
+    /**
+     * Instance index of the node, 0 for the primary instance. Further
+     * instances have IDs like \c accelerometeradaptor@1.
+     *
+     * @return instance index.
+     */
+    int instance() const;
+
 public Q_SLOTS:
     /**
      * Get the description for this node.
@@ -87,6 +97,23 @@ public Q_SLOTS:
      */
     const QString& description() const;
 
+    /**
+     * Get the clock sample timestamps of this node are in. Nodes without
+     * a time base of their own report the one of their interval source.
+     *
+     * @return \c "monotonic", \c "boottime" or \c "realtime".
+     */
+    QString timeBase() const;
+
+    /**
+     * Get physical location of the sensor, e.g. \c base or \c lid, as
+     * set with \c <id>/location. Nodes without a location of their own
+     * report the one of their interval source.
+     *
+     * @return Location, empty if unknown.
+     */
+    QString location() const;
+
     /**
      * Remove a range request.
      *
@@ -351,6 +378,22 @@ protected:
      */
     void setDescription(const QString& str);
 
+    /**
+     * Set the clock sample timestamps of this node are in.
+     *
+     * @param timeBase Clock name, see timeBase().
+     */
+    void setTimeBase(const QString& timeBase);
+
+    /**
+     * ID of the same instance of another node, for requesting the
+     * chains and adaptors this node reads from.
+     *
+     * @param baseId ID of the other node, e.g. \c accelerometerchain.
+     * @return e.g. \c accelerometerchain@1 for instance 1.
+     */
+    QString instanceId(const QString& baseId) const;
+
     /**
      * Introduce a new available range. Locally defined range will
      * override any ranges given by previous layers in the filtering
@@ -545,6 +588,7 @@ private:
     bool updateBufferInterval();
 
     QString                 m_description; /**< node description */
+    QString                 m_timeBase;    /**< timestamp clock, empty if inherited */
 
     QList<DataRange>        m_dataRangeList; /**< available data ranges */
     QList<DataRangeRequest> m_dataRangeQueue; /**< data range requests */
@@ -29,6 +29,7 @@
 
 #include <QString>
 #include <QHash>
+#include <QList>
 
 class SourceBase;
 
@@ -46,6 +47,21 @@ public:
      */
     SourceBase* source(const QString& name);
 
+    /**
+     * All sources of the producer.
+     *
+     * @return sources, in no particular order.
+     */
+    QList<SourceBase*> sources() const { return sources_.values(); }
+
+    /**
+     * Called when the data has a gap, e.g. after system suspend, before
+     * the first sample after the gap reaches the node. Nodes keeping
+     * state from earlier samples, like averaging windows, drop it here.
+     * See Scheduler::discontinuity().
+     */
+    virtual void discontinuity() {}
+
 protected:
     /**
      * Destructor.
@@ -29,7 +29,8 @@
 
 Pusher::Pusher() :
     ready_(0),
-    signalNewEvent_(this, &Pusher::signalNewEvent)
+    signalNewEvent_(this, &Pusher::signalNewEvent),
+    cpuNode_(0)
 {
     setReadyCallback(&signalNewEvent_);
 }
@@ -42,6 +43,7 @@ void Pusher::setReadyCallback(const CallbackBase* ready)
 void Pusher::wakeup() const
 {
     if (ready_) {
+        CpuAccounting::Scope scope(cpuNode_);
         (*ready_)();
     }
 }
@@ -29,6 +29,7 @@
 
 #include "producer.h"
 #include "callback.h"
+#include "cpuaccounting.h"
 
 /**
  * Base-class for pusher type of data producers.
@@ -53,6 +54,13 @@ public:
      */
     void wakeup() const;
 
+    /**
+     * Set node CPU time of wakeups is accounted to.
+     *
+     * @param node accounting node, or \c NULL.
+     */
+    void setCpuNode(CpuAccounting::Node* node) { cpuNode_ = node; }
+
     /**
      * Push new data.
      */
@@ -66,6 +74,7 @@ protected:
 
     const CallbackBase*    ready_; /**< callback */
     const Callback<Pusher> signalNewEvent_; /**< Event handler */
+    CpuAccounting::Node*   cpuNode_; /**< CPU accounting node, if any */
 };
 
 #endif
@@ -26,6 +26,7 @@
  */
 
 #include "ringbuffer.h"
+#include "scheduler.h"
 
 RingBufferReaderBase::~RingBufferReaderBase()
 {
@@ -33,10 +34,14 @@ RingBufferReaderBase::~RingBufferReaderBase()
 
 bool RingBufferBase::join(RingBufferReaderBase* reader)
 {
-    return joinTypeChecked(reader);
+    bool joined = joinTypeChecked(reader);
+    Scheduler::invalidate();
+    return joined;
 }
 
 bool RingBufferBase::unjoin(RingBufferReaderBase* reader)
 {
-    return unjoinTypeChecked(reader);
+    bool unjoined = unjoinTypeChecked(reader);
+    Scheduler::invalidate();
+    return unjoined;
 }
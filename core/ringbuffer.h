@@ -33,7 +33,12 @@
 #include "sink.h"
 #include "pusher.h"
 #include "logging.h"
-#include <QSet>
+#include "scheduler.h"
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInteger>
+#include <atomic>
 
 template <class TYPE>
 class RingBuffer;
@@ -53,6 +58,10 @@ protected:
 /**
  * Ring buffer reader.
  *
+ * Each reader keeps its own read position and statistics, so any number
+ * of readers can consume the same buffer independently. Statistics are
+ * updated by the thread calling read().
+ *
  * @tparam TYPE datatype to reader from buffer.
  */
 template <class TYPE>
@@ -62,13 +71,34 @@ public:
     /**
      * Constructor.
      */
-    RingBufferReader() : readCount_(0) {}
+    RingBufferReader() : readCount_(0), buffer_(NULL), overruns_(0), maxLag_(0) {}
 
     /**
      * Destructor
      */
     virtual ~RingBufferReader() {}
 
+    /**
+     * Number of samples overwritten by the writer before this reader
+     * got to them.
+     */
+    unsigned overruns() const { return overruns_; }
+
+    /**
+     * Largest number of unread samples seen by this reader, including
+     * ones already overwritten.
+     */
+    unsigned maxLag() const { return maxLag_; }
+
+    /**
+     * Reset overrun and lag statistics.
+     */
+    void resetStatistics()
+    {
+        overruns_ = 0;
+        maxLag_ = 0;
+    }
+
 protected:
     /**
      * Read data from buffer.
@@ -86,7 +116,9 @@ private:
     friend class RingBuffer<TYPE>;
 
     unsigned                readCount_; /**< how many objects have been read */
-    const RingBuffer<TYPE>* buffer_; /**< buffer associated with this reader */
+    const RingBuffer<TYPE>* buffer_;    /**< buffer associated with this reader */
+    unsigned                overruns_;  /**< samples lost to overwrite */
+    unsigned                maxLag_;    /**< largest backlog seen */
 };
 
 /**
@@ -137,6 +169,18 @@ private:
 /**
  * Ring buffer implementation.
  *
+ * Single writer, any number of readers, which may live in other threads.
+ * Each slot carries a sequence number working as a seqlock: the writer
+ * marks the slot odd while filling it and publishes it with the even
+ * value <tt>2 * (index + 1)</tt> on commit. Readers copy a slot and
+ * check the sequence again afterwards; a slot overwritten meanwhile is
+ * dropped and counted as an overrun. Neither side ever blocks, and the
+ * writer does not wait for slow readers: a reader that falls more than
+ * the buffer size behind skips to the oldest sample still available.
+ *
+ * Because a reader may copy a slot while it is being written, \c TYPE
+ * must be plain data that is safe to copy in a torn state.
+ *
  * @tparam TYPE data type in buffer.
  */
 template <class TYPE>
@@ -149,11 +193,12 @@ public:
      * @param size how many elements can be buffered.
      */
     RingBuffer(unsigned size) :
-        sink_(this, &RingBuffer::write),
+        sink_(this),
         bufferSize_(size),
-        writeCount_()
+        writeCount_(0),
+        readersMutex_(QMutex::Recursive)
     {
-        buffer_ = new TYPE[size];
+        buffer_ = new Slot[size];
         addSink(&sink_, "sink");
     }
 
@@ -178,11 +223,34 @@ public:
                   RingBufferReader<TYPE>& reader) const
     {
         unsigned itemsRead = 0;
-        while (itemsRead < n && reader.readCount_ != (unsigned)writeCount_) {
-
-            *values++ = buffer_[reader.readCount_++ % bufferSize_];
-
-            ++itemsRead;
+        unsigned written = writeCount_.loadAcquire();
+        while (itemsRead < n && reader.readCount_ != written) {
+            unsigned lag = written - reader.readCount_;
+            if (lag > reader.maxLag_) {
+                reader.maxLag_ = lag;
+            }
+            if (lag > bufferSize_) {
+                reader.overruns_ += lag - bufferSize_;
+                reader.readCount_ = written - bufferSize_;
+            }
+
+            const Slot& slot = buffer_[reader.readCount_ % bufferSize_];
+            const unsigned expected = (reader.readCount_ + 1) << 1;
+            if (slot.seq_.loadAcquire() == expected) {
+                *values = slot.value_;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq_.loadRelaxed() == expected) {
+                    ++values;
+                    ++itemsRead;
+                    ++reader.readCount_;
+                    continue;
+                }
+            }
+
+            // Writer lapped us while copying
+            ++reader.overruns_;
+            ++reader.readCount_;
+            written = writeCount_.loadAcquire();
         }
 
         return itemsRead;
@@ -190,13 +258,18 @@ public:
 
 protected:
     /**
-     * Get next slot in the ring buffer.
+     * Get next slot in the ring buffer. The slot is marked as being
+     * written until commit().
      *
      * @return next slot.
      */
     TYPE* nextSlot()
     {
-        return &buffer_[writeCount_ % bufferSize_];
+        const unsigned index = writeCount_.loadRelaxed();
+        Slot& slot = buffer_[index % bufferSize_];
+        slot.seq_.storeRelaxed((index << 1) | 1);
+        std::atomic_thread_fence(std::memory_order_release);
+        return &slot.value_;
     }
 
     /**
@@ -204,17 +277,25 @@ protected:
      */
     void commit()
     {
-        ++writeCount_;
+        const unsigned index = writeCount_.loadRelaxed();
+        buffer_[index % bufferSize_].seq_.storeRelease((index + 1) << 1);
+        writeCount_.storeRelease(index + 1);
     }
 
     /**
-     * Wake up connected buffer readers.
+     * Wake up connected buffer readers through the Scheduler, which
+     * runs them in topological order with the rest of the graph.
+     *
+     * Readers are queued with the reader list locked. Queueing pins
+     * them, so a reader unjoined meanwhile in another thread is not
+     * deleted before it has run, see Scheduler::retire().
      */
     void wakeUpReaders()
     {
-        RingBufferReader<TYPE>* reader;
-        foreach (reader, readers_) {
-            reader->wakeup();
+        Scheduler::Epoch epoch;
+        QMutexLocker locker(&readersMutex_);
+        foreach (RingBufferReader<TYPE>* reader, readers_) {
+            Scheduler::wakeup(reader);
         }
     }
 
@@ -250,10 +331,15 @@ protected:
             return false;
         }
 
-        r->readCount_ = writeCount_;
+        QMutexLocker locker(&readersMutex_);
+        if (readers_.contains(r)) {
+            return true;
+        }
+        r->readCount_ = writeCount_.loadAcquire();
         r->buffer_    = this;
+        r->resetStatistics();
 
-        readers_.insert(r);
+        readers_.append(r);
         return true;
     }
 
@@ -270,17 +356,80 @@ protected:
             return false;
         }
 
-        readers_.remove(r);
+        {
+            QMutexLocker locker(&readersMutex_);
+            readers_.removeAll(r);
+        }
+        // Writer thread may have queued the reader just before
+        Scheduler::retire(r);
         return true;
     }
 
 private:
+    /**
+     * Connected readers, in join order.
+     */
+    QList<RingBufferReader<TYPE>*> readers() const
+    {
+        QMutexLocker locker(&readersMutex_);
+        return readers_;
+    }
+
+    /**
+     * Buffer slot with its seqlock sequence number.
+     */
+    struct Slot
+    {
+        Slot() : seq_(0), value_() {}
+
+        QAtomicInteger<unsigned> seq_; /**< odd while written, 2 * (index + 1) when committed */
+        TYPE                     value_;
+    };
+
+    /**
+     * Sink writing to the buffer. Sources using Source::nextSlot()
+     * write directly into the next buffer slot.
+     */
+    class BufferSink : public SinkTyped<TYPE>
+    {
+    public:
+        BufferSink(RingBuffer* buffer) : buffer_(buffer) {}
+
+        QList<const Producer*> downstream() const
+        {
+            QList<const Producer*> nodes;
+            foreach (RingBufferReader<TYPE>* reader, buffer_->readers()) {
+                nodes << reader;
+            }
+            return nodes;
+        }
+
+        void collect(int n, const TYPE* values)
+        {
+            buffer_->write(n, values);
+        }
+
+        TYPE* reserve()
+        {
+            return buffer_->nextSlot();
+        }
+
+        void commit()
+        {
+            buffer_->commit();
+            buffer_->wakeUpReaders();
+        }
+
+    private:
+        RingBuffer* buffer_;
+    };
 
-    Sink<RingBuffer, TYPE>        sink_;       /**< data sink */
-    const unsigned                bufferSize_; /**< buffer size */
-    TYPE*                         buffer_;     /**< buffer */
-    unsigned int                  writeCount_; /**< how many objects have been written */
-    QSet<RingBufferReader<TYPE>*> readers_;    /**< connected readers */
+    BufferSink                     sink_;         /**< data sink */
+    const unsigned                 bufferSize_;   /**< buffer size */
+    Slot*                          buffer_;       /**< buffer */
+    QAtomicInteger<unsigned>       writeCount_;   /**< how many objects have been written */
+    QList<RingBufferReader<TYPE>*> readers_;      /**< connected readers */
+    mutable QMutex                 readersMutex_; /**< guards readers_, recursive as height computation may revisit the buffer */
 };
 
 #endif
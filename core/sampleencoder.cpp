@@ -0,0 +1,131 @@
+/**
+   @file sampleencoder.cpp
+   @brief Encoders for samples written to session sockets
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "sampleencoder.h"
+
+#include <QtEndian>
+#include <string.h>
+
+SampleEncoder* SampleEncoder::create(const QString& format)
+{
+    if (format == "raw") {
+        return new RawSampleEncoder;
+    } else if (format == "flat") {
+        return new FlatSampleEncoder;
+    } else if (format == "json") {
+        return new JsonSampleEncoder;
+    }
+    return 0;
+}
+
+QStringList SampleEncoder::formats()
+{
+    return QStringList() << "raw" << "flat" << "json";
+}
+
+QByteArray SampleEncoder::header(const SampleSchema& schema) const
+{
+    Q_UNUSED(schema);
+    return QByteArray();
+}
+
+void RawSampleEncoder::encode(const SampleSchema& schema, const void* sample, QByteArray& out) const
+{
+    out.append(static_cast<const char*>(sample), schema.size());
+}
+
+QByteArray FlatSampleEncoder::header(const SampleSchema& schema) const
+{
+    QByteArray description = schema.describe().toLatin1();
+    QByteArray header("SFWF");
+    char length[4];
+    qToLittleEndian<quint32>(description.size(), (uchar*)length);
+    header.append(length, sizeof(length));
+    header.append(description);
+    return header;
+}
+
+void FlatSampleEncoder::encode(const SampleSchema& schema, const void* sample, QByteArray& out) const
+{
+    int pos = out.size();
+    out.resize(pos + schema.packedSize());
+    uchar* dst = (uchar*)out.data() + pos;
+    const char* src = static_cast<const char*>(sample);
+
+    for (int i = 0; i < schema.fieldCount(); ++i) {
+        const SampleSchema::Field& field = schema.field(i);
+        const char* value = src + field.offset;
+        switch (field.type) {
+        case SampleSchema::UInt64: {
+            quint64 v;
+            memcpy(&v, value, sizeof(v));
+            qToLittleEndian<quint64>(v, dst);
+            break;
+        }
+        case SampleSchema::Int32:
+        case SampleSchema::UInt32:
+        case SampleSchema::Float: {
+            quint32 v;
+            memcpy(&v, value, sizeof(v));
+            qToLittleEndian<quint32>(v, dst);
+            break;
+        }
+        case SampleSchema::Bool:
+            *dst = *reinterpret_cast<const bool*>(value) ? 1 : 0;
+            break;
+        }
+        dst += SampleSchema::typeSize(field.type);
+    }
+}
+
+void JsonSampleEncoder::encode(const SampleSchema& schema, const void* sample, QByteArray& out) const
+{
+    const char* src = static_cast<const char*>(sample);
+
+    out.append("{\"type\":\"");
+    out.append(schema.name());
+    out.append('"');
+    for (int i = 0; i < schema.fieldCount(); ++i) {
+        const SampleSchema::Field& field = schema.field(i);
+        const char* value = src + field.offset;
+        out.append(",\"");
+        out.append(field.name);
+        out.append("\":");
+        switch (field.type) {
+        case SampleSchema::UInt64:
+            out.append(QByteArray::number(*reinterpret_cast<const quint64*>(value)));
+            break;
+        case SampleSchema::Int32:
+            out.append(QByteArray::number(*reinterpret_cast<const qint32*>(value)));
+            break;
+        case SampleSchema::UInt32:
+            out.append(QByteArray::number(*reinterpret_cast<const quint32*>(value)));
+            break;
+        case SampleSchema::Float:
+            out.append(QByteArray::number(*reinterpret_cast<const float*>(value), 'g', 7));
+            break;
+        case SampleSchema::Bool:
+            out.append(*reinterpret_cast<const bool*>(value) ? "true" : "false");
+            break;
+        }
+    }
+    out.append("}\n");
+}
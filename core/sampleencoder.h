@@ -0,0 +1,138 @@
+/**
+   @file sampleencoder.h
+   @brief Encoders for samples written to session sockets
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SAMPLEENCODER_H
+#define SAMPLEENCODER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include "datatypes/sampleschema.h"
+
+/**
+ * Encodes samples for a session data socket. Each session uses one
+ * encoder, selected by the client with a data format name:
+ *
+ * <ul>
+ * <li>\c raw: samples are written as in-memory structs, in frames of a
+ *     native \c unsigned \c int sample count followed by the samples.
+ *     This is the legacy format read by the Qt client library, and the
+ *     default.</li>
+ * <li>\c flat: the stream starts with a schema record, the magic
+ *     \c "SFWF", a little-endian 32-bit length and SampleSchema::describe()
+ *     of the sample type. Samples follow in the same frames as \c raw,
+ *     but with fields packed without padding in little-endian byte
+ *     order, in schema order.</li>
+ * <li>\c json: one JSON object per sample and line, for debugging.</li>
+ * </ul>
+ *
+ * Sessions with clock sync also get ClockOffsets records in the stream.
+ * In the framed formats they are sent as frames whose sample count is
+ * ClockOffsets::FrameTag, holding one ClockOffsets encoded like a sample;
+ * see SessionData::write(const ClockOffsets&).
+ *
+ * Encoders are table driven by the SampleSchema of the sample type.
+ */
+class SampleEncoder
+{
+public:
+    virtual ~SampleEncoder() {}
+
+    /**
+     * Create an encoder.
+     *
+     * @param format Data format name.
+     * @return New encoder, or \c NULL if format is unknown.
+     */
+    static SampleEncoder* create(const QString& format);
+
+    /**
+     * Names of the supported data formats.
+     */
+    static QStringList formats();
+
+    /**
+     * Data format name of the encoder.
+     */
+    virtual QString format() const = 0;
+
+    /**
+     * Size of an encoded sample.
+     *
+     * @param schema Schema of the sample type.
+     * @return Size in bytes, or 0 if samples are of variable size and
+     *         written unframed.
+     */
+    virtual int sampleSize(const SampleSchema& schema) const = 0;
+
+    /**
+     * Data written to the stream before the first sample.
+     *
+     * @param schema Schema of the sample type.
+     * @return Header, or empty.
+     */
+    virtual QByteArray header(const SampleSchema& schema) const;
+
+    /**
+     * Encode a sample.
+     *
+     * @param schema Schema of the sample type.
+     * @param sample Sample struct.
+     * @param out Buffer the encoded sample is appended to.
+     */
+    virtual void encode(const SampleSchema& schema, const void* sample, QByteArray& out) const = 0;
+};
+
+/**
+ * Encoder for the \c raw data format.
+ */
+class RawSampleEncoder : public SampleEncoder
+{
+public:
+    QString format() const { return "raw"; }
+    int sampleSize(const SampleSchema& schema) const { return schema.size(); }
+    void encode(const SampleSchema& schema, const void* sample, QByteArray& out) const;
+};
+
+/**
+ * Encoder for the \c flat data format.
+ */
+class FlatSampleEncoder : public SampleEncoder
+{
+public:
+    QString format() const { return "flat"; }
+    int sampleSize(const SampleSchema& schema) const { return schema.packedSize(); }
+    QByteArray header(const SampleSchema& schema) const;
+    void encode(const SampleSchema& schema, const void* sample, QByteArray& out) const;
+};
+
+/**
+ * Encoder for the \c json data format.
+ */
+class JsonSampleEncoder : public SampleEncoder
+{
+public:
+    QString format() const { return "json"; }
+    int sampleSize(const SampleSchema&) const { return 0; }
+    void encode(const SampleSchema& schema, const void* sample, QByteArray& out) const;
+};
+
+#endif // SAMPLEENCODER_H
@@ -0,0 +1,127 @@
+/**
+   @file samplepredictor.cpp
+   @brief Short term extrapolation of sensor samples
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "samplepredictor.h"
+
+const quint64 SamplePredictor::MAX_GAP = 1000000;
+
+SamplePredictor::SamplePredictor(Model model, int history, quint64 maxHorizon_us) :
+    model_(model),
+    history_(qMax(history, 1)),
+    maxHorizon_(maxHorizon_us)
+{
+}
+
+void SamplePredictor::setModel(Model model)
+{
+    model_ = model;
+    reset();
+}
+
+void SamplePredictor::setHistory(int history)
+{
+    history_ = qMax(history, 1);
+    while (samples_.size() > history_) {
+        samples_.removeFirst();
+    }
+}
+
+void SamplePredictor::reset()
+{
+    samples_.clear();
+}
+
+void SamplePredictor::update(const TimedXyzData& sample)
+{
+    if (!samples_.isEmpty()) {
+        quint64 last = samples_.last().timestamp_;
+        if (sample.timestamp_ <= last || sample.timestamp_ - last > MAX_GAP) {
+            samples_.clear();
+        }
+    }
+    samples_.append(sample);
+    if (samples_.size() > history_) {
+        samples_.removeFirst();
+    }
+}
+
+float SamplePredictor::wrap(float degrees)
+{
+    while (degrees > 180) {
+        degrees -= 360;
+    }
+    while (degrees <= -180) {
+        degrees += 360;
+    }
+    return degrees;
+}
+
+bool SamplePredictor::predict(quint64 timestamp, TimedXyzData& predicted) const
+{
+    if (model_ == None || samples_.isEmpty()) {
+        return false;
+    }
+
+    const TimedXyzData& last = samples_.last();
+    qint64 dt = (qint64)(timestamp - last.timestamp_);
+    dt = qBound(-(qint64)maxHorizon_, dt, (qint64)maxHorizon_);
+    predicted = last;
+    predicted.timestamp_ = last.timestamp_ + dt;
+
+    int n = samples_.size();
+    if (model_ == ConstantValue || n < 2) {
+        return true;
+    }
+
+    // Least squares line per axis. Times are relative to the latest
+    // sample, and angles are unwrapped around it.
+    const float ref[3] = { last.x_, last.y_, last.z_ };
+    double tSum = 0, ttSum = 0;
+    double vSum[3] = { 0, 0, 0 }, tvSum[3] = { 0, 0, 0 };
+    foreach (const TimedXyzData& s, samples_) {
+        double t = -(double)(last.timestamp_ - s.timestamp_);
+        const float axes[3] = { s.x_, s.y_, s.z_ };
+        tSum += t;
+        ttSum += t * t;
+        for (int a = 0; a < 3; ++a) {
+            double v = (model_ == Angular) ? ref[a] + wrap(axes[a] - ref[a]) : axes[a];
+            vSum[a] += v;
+            tvSum[a] += t * v;
+        }
+    }
+
+    // Timestamps are strictly increasing, so the denominator is positive
+    double tMean = tSum / n;
+    double denominator = ttSum - tSum * tMean;
+    float result[3];
+    for (int a = 0; a < 3; ++a) {
+        double vMean = vSum[a] / n;
+        double slope = (tvSum[a] - tSum * vMean) / denominator;
+        result[a] = vMean + slope * (dt - tMean);
+        if (model_ == Angular) {
+            result[a] = wrap(result[a]);
+        }
+    }
+    predicted.x_ = result[0];
+    predicted.y_ = result[1];
+    predicted.z_ = result[2];
+    return true;
+}
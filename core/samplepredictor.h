@@ -0,0 +1,104 @@
+/**
+   @file samplepredictor.h
+   @brief Short term extrapolation of sensor samples
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SAMPLEPREDICTOR_H
+#define SAMPLEPREDICTOR_H
+
+#include <QList>
+#include "genericdata.h"
+
+/**
+ * Extrapolates the latest samples of a sensor to a later timestamp, so
+ * that consumers can get the value at the time it is used rather than
+ * the time it was measured.
+ *
+ * A line is fitted by least squares to each axis of the last \c history
+ * samples and evaluated at the target time, which is limited to
+ * \c maxHorizon microseconds from the latest sample. History is
+ * restarted when timestamps go backwards or samples are more than
+ * MAX_GAP apart, e.g. after suspend.
+ */
+class SamplePredictor
+{
+public:
+    /**
+     * How sample values evolve between samples.
+     */
+    enum Model
+    {
+        None = 0,      /**< prediction not supported */
+        ConstantValue, /**< latest value holds, e.g. angular rate of a gyroscope */
+        Linear,        /**< values change at constant rate, e.g. acceleration */
+        Angular        /**< angles in degrees change at constant angular velocity, wrapping at +-180 */
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param model Model of the samples.
+     * @param history Number of samples the rate is estimated from.
+     * @param maxHorizon_us Furthest extrapolation from the latest sample.
+     */
+    SamplePredictor(Model model = None, int history = 4, quint64 maxHorizon_us = 100000);
+
+    Model model() const { return model_; }
+    void setModel(Model model);
+
+    void setHistory(int history);
+    void setMaxHorizon(quint64 maxHorizon_us) { maxHorizon_ = maxHorizon_us; }
+
+    /**
+     * Forget all samples.
+     */
+    void reset();
+
+    /**
+     * Add a sample.
+     *
+     * @param sample Latest sample.
+     */
+    void update(const TimedXyzData& sample);
+
+    /**
+     * Extrapolate to given time.
+     *
+     * @param timestamp Target time, in the time base of the samples.
+     * @param predicted Predicted sample. Timestamp is the target time,
+     *                  limited to the horizon.
+     * @return was there a sample to extrapolate from.
+     */
+    bool predict(quint64 timestamp, TimedXyzData& predicted) const;
+
+    /**
+     * Largest accepted interval between samples (microsec).
+     */
+    static const quint64 MAX_GAP;
+
+private:
+    static float wrap(float degrees);
+
+    Model model_;
+    int history_;
+    quint64 maxHorizon_;
+    QList<TimedXyzData> samples_;
+};
+
+#endif // SAMPLEPREDICTOR_H
@@ -0,0 +1,277 @@
+/**
+   @file scheduler.cpp
+   @brief Topological scheduling of dataflow propagation
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "scheduler.h"
+#include "pusher.h"
+#include "producer.h"
+#include "source.h"
+#include "callback.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+namespace {
+
+/**
+ * Queue position: highest nodes first, then in queueing order.
+ */
+struct Key
+{
+    int height;
+    quint64 seq;
+
+    bool operator<(const Key& other) const
+    {
+        if (height != other.height) {
+            return height > other.height;
+        }
+        return seq < other.seq;
+    }
+};
+
+/**
+ * Queued work, either a pusher to wake up or a deferred callback.
+ */
+struct Task
+{
+    const Pusher* pusher;
+    const CallbackBase* callback;
+};
+
+struct State
+{
+    State() : depth(0), epoch(0), seq(0), generation(-1) {}
+
+    int depth;
+    quint64 epoch;
+    quint64 seq;
+    QMap<Key, Task> queue;
+    QSet<const void*> pending;
+    QSet<const Pusher*> pinned;
+    QHash<const Producer*, int> heights;
+    int generation;
+};
+
+QAtomicInt generation(0);
+
+/**
+ * Pins of all threads, see Scheduler::retire().
+ */
+QMutex pinMutex;
+QWaitCondition unpinned;
+QHash<const Pusher*, int> pins;
+
+void unpin(const Pusher* pusher)
+{
+    // Called with pinMutex held
+    QHash<const Pusher*, int>::iterator it = pins.find(pusher);
+    if (it != pins.end() && --it.value() == 0) {
+        pins.erase(it);
+        unpinned.wakeAll();
+    }
+}
+
+State& threadState()
+{
+    static thread_local State state;
+    return state;
+}
+
+int computeHeight(const Producer* node, QHash<const Producer*, int>& heights, QSet<const Producer*>& visiting)
+{
+    QHash<const Producer*, int>::const_iterator it = heights.constFind(node);
+    if (it != heights.constEnd()) {
+        return it.value();
+    }
+    if (visiting.contains(node)) {
+        // Cycle, cut it here
+        return 0;
+    }
+
+    visiting.insert(node);
+    int height = 0;
+    foreach (SourceBase* source, node->sources()) {
+        foreach (SinkBase* sink, source->sinks()) {
+            foreach (const Producer* next, sink->downstream()) {
+                height = qMax(height, computeHeight(next, heights, visiting) + 1);
+            }
+        }
+    }
+    visiting.remove(node);
+    heights.insert(node, height);
+    return height;
+}
+
+void enqueue(State& state, int height, const void* id, const Pusher* pusher, const CallbackBase* callback)
+{
+    if (state.pending.contains(id)) {
+        return;
+    }
+    state.pending.insert(id);
+    if (pusher && !state.pinned.contains(pusher)) {
+        state.pinned.insert(pusher);
+        QMutexLocker locker(&pinMutex);
+        ++pins[pusher];
+    }
+
+    Key key = { height, state.seq++ };
+    Task task = { pusher, callback };
+    state.queue.insert(key, task);
+}
+
+}
+
+Scheduler::Epoch::Epoch()
+{
+    State& state = threadState();
+    outermost_ = (state.depth++ == 0);
+    if (outermost_) {
+        ++state.epoch;
+    }
+}
+
+Scheduler::Epoch::~Epoch()
+{
+    State& state = threadState();
+    if (outermost_) {
+        while (!state.queue.isEmpty()) {
+            QMap<Key, Task>::iterator it = state.queue.begin();
+            Task task = it.value();
+            state.queue.erase(it);
+            if (task.pusher) {
+                state.pending.remove(task.pusher);
+                task.pusher->wakeup();
+            } else {
+                state.pending.remove(task.callback);
+                (*task.callback)();
+            }
+        }
+        if (!state.pinned.isEmpty()) {
+            QMutexLocker locker(&pinMutex);
+            foreach (const Pusher* pusher, state.pinned) {
+                unpin(pusher);
+            }
+            state.pinned.clear();
+        }
+    }
+    --state.depth;
+}
+
+void Scheduler::wakeup(const Pusher* pusher)
+{
+    Epoch epoch;
+    enqueue(threadState(), height(pusher), pusher, pusher, 0);
+}
+
+void Scheduler::defer(const Producer* node, const CallbackBase* callback)
+{
+    State& state = threadState();
+    if (state.depth == 0) {
+        (*callback)();
+        return;
+    }
+    enqueue(state, height(node), callback, 0, callback);
+}
+
+void Scheduler::retire(const Pusher* pusher)
+{
+    State& state = threadState();
+    if (state.pinned.remove(pusher)) {
+        QMap<Key, Task>::iterator it = state.queue.begin();
+        while (it != state.queue.end()) {
+            if (it.value().pusher == pusher) {
+                it = state.queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        state.pending.remove(pusher);
+        QMutexLocker locker(&pinMutex);
+        unpin(pusher);
+    }
+
+    QMutexLocker locker(&pinMutex);
+    while (pins.contains(pusher)) {
+        unpinned.wait(&pinMutex);
+    }
+}
+
+bool Scheduler::inEpoch()
+{
+    return threadState().depth > 0;
+}
+
+quint64 Scheduler::epoch()
+{
+    return threadState().epoch;
+}
+
+int Scheduler::height(const Producer* node)
+{
+    State& state = threadState();
+    int current = generation.loadAcquire();
+    if (state.generation != current) {
+        state.heights.clear();
+        state.generation = current;
+    }
+
+    QSet<const Producer*> visiting;
+    return computeHeight(node, state.heights, visiting);
+}
+
+void Scheduler::invalidate()
+{
+    generation.fetchAndAddRelease(1);
+}
+
+void Scheduler::discontinuity(const QList<const Producer*>& nodes)
+{
+    QSet<const Producer*> seen;
+    QList<const Producer*> pending(nodes);
+    QMap<Key, const Producer*> ordered;
+    quint64 seq = 0;
+
+    while (!pending.isEmpty()) {
+        const Producer* node = pending.takeFirst();
+        if (seen.contains(node)) {
+            continue;
+        }
+        seen.insert(node);
+
+        Key key = { height(node), seq++ };
+        ordered.insert(key, node);
+        foreach (SourceBase* source, node->sources()) {
+            foreach (SinkBase* sink, source->sinks()) {
+                pending << sink->downstream();
+            }
+        }
+    }
+
+    foreach (const Producer* node, ordered) {
+        // Graph accessors hand out const nodes, the nodes are ours to reset
+        const_cast<Producer*>(node)->discontinuity();
+    }
+}
@@ -0,0 +1,148 @@
+/**
+   @file scheduler.h
+   @brief Topological scheduling of dataflow propagation
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QtGlobal>
+
+class Pusher;
+class Producer;
+class CallbackBase;
+
+/**
+ * Topological scheduling of dataflow propagation.
+ *
+ * Without scheduling, a commit to a ring buffer wakes each reader in turn
+ * and every reader pushes its data depth first through the graph below
+ * it. When two paths from one adaptor meet again in a filter with
+ * several inputs, e.g. accelerometer data reaching \c RotationFilter
+ * both directly and through the compass chain, the filter is invoked
+ * once per path, in an order depending on how the graph was joined,
+ * and the first invocation works on partially updated state.
+ *
+ * Instead, the first buffer commit of a thread opens an epoch. Readers
+ * woken during the epoch are queued, each at most once, and run in
+ * topological order when the commit returns: a node only runs after
+ * every node upstream of it that was affected by the commit. Order is
+ * by height, the length of the longest path from the node down to a
+ * node with no outputs, ties broken by queueing order, which follows
+ * join order and so is deterministic.
+ *
+ * Filters with several inputs call defer() instead of producing output
+ * from each sink. The deferred callback runs once per epoch, after all
+ * input readers of the filter have run. Outside an epoch, for example
+ * when a sink is called directly, the callback runs immediately, so
+ * filters behave as before when fed by hand.
+ *
+ * Each thread has its own epoch and queue. Heights are cached per
+ * thread and recomputed after any source, sink or buffer join.
+ *
+ * A pusher is pinned from the moment it is queued until the outermost
+ * epoch which ran it has finished, including deferred callbacks of the
+ * nodes below it. retire() waits for the pins of other threads to go
+ * away, so a reader unjoined in one thread is not deleted while the
+ * writer thread is about to wake it.
+ */
+class Scheduler
+{
+public:
+    /**
+     * Opens an epoch, unless one is already open in this thread. When
+     * the outermost epoch is closed, queued work is run until the queue
+     * is empty.
+     */
+    class Epoch
+    {
+    public:
+        Epoch();
+        ~Epoch();
+
+    private:
+        Epoch(const Epoch&);
+        Epoch& operator=(const Epoch&);
+
+        bool outermost_;
+    };
+
+    /**
+     * Wake up a pusher. Inside an epoch the pusher is queued, otherwise
+     * it is woken immediately in a new epoch.
+     *
+     * @param pusher pusher to wake up.
+     */
+    static void wakeup(const Pusher* pusher);
+
+    /**
+     * Run callback once all nodes upstream of \c node have run in the
+     * current epoch. A callback already queued is not queued again.
+     *
+     * @param node node the callback belongs to.
+     * @param callback callback to run.
+     */
+    static void defer(const Producer* node, const CallbackBase* callback);
+
+    /**
+     * Wait until no thread has a pusher queued or running, so that it
+     * can be deleted. Call after the pusher has been disconnected from
+     * everything that wakes it. If the calling thread has the pusher
+     * queued, it is dropped from the queue.
+     *
+     * @param pusher pusher to retire.
+     */
+    static void retire(const Pusher* pusher);
+
+    /**
+     * Is an epoch open in this thread.
+     */
+    static bool inEpoch();
+
+    /**
+     * Number of epochs opened in this thread so far.
+     */
+    static quint64 epoch();
+
+    /**
+     * Height of node in the dataflow graph: zero when nothing is joined
+     * to its sources, otherwise one more than the highest node joined.
+     *
+     * @param node node.
+     * @return height.
+     */
+    static int height(const Producer* node);
+
+    /**
+     * Forget cached heights after the graph has changed.
+     */
+    static void invalidate();
+
+    /**
+     * Notify nodes and every node downstream of them of a gap in the
+     * data, see Producer::discontinuity(). Nodes are notified once each,
+     * upstream nodes first. Called in the thread producing the data,
+     * before writing the first sample after the gap, so it is ordered
+     * with the samples for readers in the same thread.
+     * @param nodes nodes where the gap starts.
+     */
+    static void discontinuity(const QList<const Producer*>& nodes);
+};
+
+#endif // SCHEDULER_H
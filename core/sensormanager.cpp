@@ -33,6 +33,8 @@
 #include "loader.h"
 #include "idutils.h"
 #include "logging.h"
+#include "config.h"
+#include "cpuaccounting.h"
 #ifdef SENSORFW_MCE_WATCHER
 #include "mcewatcher.h"
 #endif // SENSORFW_MCE_WATCHER
@@ -40,6 +42,8 @@
 #include "lsclient.h"
 #endif // SENSORFW_LUNA_SERVICE_CLIENT
 #include <QSocketNotifier>
+#include <QDBusConnectionInterface>
+#include <QDBusReply>
 #include <errno.h>
 #include <functional>
 #include "sockethandler.h"
@@ -49,12 +53,15 @@
 #include <unistd.h>
 #include <QTimer>
 #include <QSettings>
+#include <QFile>
+#include <malloc.h>
 
 
 typedef struct {
         int id;
         int size;
         void* buffer;
+        const SampleSchema* schema;
 } PipeData;
 
 const int SensorManager::SOCKET_CONNECTION_TIMEOUT_MS = 10000;
@@ -62,9 +69,43 @@ const int SensorManager::SOCKET_CONNECTION_TIMEOUT_MS = 10000;
 SensorManager* SensorManager::instance_ = NULL;
 int SensorManager::sessionIdCount_ = 0;
 
+/**
+ * Bytes of heap in use by the process, or -1 if unknown.
+ */
+static qint64 heapInUse()
+{
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 info = mallinfo2();
+#else
+    struct mallinfo info = mallinfo();
+#endif
+    return (qint64)info.uordblks + info.hblkhd;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Resident set size of the process in bytes, or -1 if unknown.
+ */
+static qint64 residentSetSize()
+{
+    QFile file("/proc/self/statm");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    QList<QByteArray> fields = file.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+}
+
 SensorInstanceEntry::SensorInstanceEntry(const QString& type) :
     sensor_(0),
-    type_(type)
+    type_(type),
+    heapBytes_(0)
 {
 }
 
@@ -75,7 +116,8 @@ SensorInstanceEntry::~SensorInstanceEntry()
 ChainInstanceEntry::ChainInstanceEntry(const QString& type) :
     cnt_(0),
     chain_(0),
-    type_(type)
+    type_(type),
+    heapBytes_(0)
 {
 }
 
@@ -86,7 +128,8 @@ ChainInstanceEntry::~ChainInstanceEntry()
 DeviceAdaptorInstanceEntry::DeviceAdaptorInstanceEntry(const QString& type, const QString& id) :
     adaptor_(0),
     cnt_(0),
-    type_(type)
+    type_(type),
+    heapBytes_(0)
 {
     propertyMap_ = ParameterParser::getPropertyMap(id);
 }
@@ -100,6 +143,11 @@ SessionInstanceEntry::SessionInstanceEntry(QObject* parent, int sessionId, const
     , m_sessionId(sessionId)
     , m_clientName(clientName)
     , m_timer(nullptr)
+    , m_pid(0)
+    , m_uid((uid_t)-1)
+    , m_clampedRequests(0)
+    , m_lastRequested_us(0)
+    , m_lastGranted_us(0)
 {
 }
 
@@ -166,6 +214,7 @@ SensorManager& SensorManager::instance()
 SensorManager::SensorManager()
     : errorCode_(SmNoError),
     pipeNotifier_(0),
+    reclaiming_(false),
     deviation(0)
 {
     QString pluginPath;
@@ -195,6 +244,11 @@ SensorManager::SensorManager()
         sensordLogW() << "Error setting socket permissions! " << SOCKET_NAME;
     }
 
+    idleTimer_ = new QTimer(this);
+    idleTimer_->setSingleShot(true);
+    connect(idleTimer_, &QTimer::timeout, this, &SensorManager::reclaimIdle);
+    idleClock_.start();
+
     serviceWatcher_ = new QDBusServiceWatcher(this);
     serviceWatcher_->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
     QObject::connect(serviceWatcher_, &QDBusServiceWatcher::serviceUnregistered,
@@ -360,12 +414,12 @@ AbstractSensorChannel* SensorManager::addSensor(const QString& id)
         return NULL;
     }
 
-    bool ok = bus().registerObject(OBJECT_PATH + "/" + sensorChannel->id(), sensorChannel);
+    bool ok = bus().registerObject(OBJECT_PATH + "/" + getObjectPathId(sensorChannel->id()), sensorChannel);
     if ( !ok )
     {
         QDBusError error = bus().lastError();
         setError(SmCanNotRegisterObject, error.message());
-        sensordLogC() << "Failed to register sensor '" << OBJECT_PATH + "/" + sensorChannel->id() << "'";
+        sensordLogC() << "Failed to register sensor '" << OBJECT_PATH + "/" + getObjectPathId(sensorChannel->id()) << "'";
         delete sensorChannel;
         return NULL;
     }
@@ -377,7 +431,7 @@ void SensorManager::removeSensor(const QString& id)
     sensordLogD() << "SensorManager removing sensor:" << id;
 
     QMap<QString, SensorInstanceEntry>::iterator entryIt = sensorInstanceMap_.find(id);
-    bus().unregisterObject(OBJECT_PATH + "/" + id);
+    bus().unregisterObject(OBJECT_PATH + "/" + getObjectPathId(id));
     delete entryIt.value().sensor_;
     entryIt.value().sensor_ = 0;
     sensorInstanceMap_.remove(id);
@@ -415,7 +469,75 @@ QStringList SensorManager::availableSensorPlugins() const
     return l.availableSensorPlugins();
 }
 
-int SensorManager::requestSensor(const QString& id)
+QStringList SensorManager::availableSensorInstances(const QString& id) const
+{
+    QStringList instances;
+    instances << id;
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    if (!config)
+        return instances;
+
+    QMap<int, QString> configured;
+    foreach (const QString& group, config->groups()) {
+        int index = getInstanceIndex(group);
+        if (index > 0 && getBaseId(group) == id)
+            configured.insert(index, group);
+    }
+    instances << configured.values();
+    return instances;
+}
+
+void SensorManager::registerSensorInstances(const QString& sensorName, const QString& typeName)
+{
+    QStringList instances = availableSensorInstances(getCleanId(sensorName));
+    instances.removeFirst();
+    foreach (const QString& instance, instances) {
+        if (!sensorInstanceMap_.contains(instance)) {
+            sensordLogD() << "Registering sensor instance" << instance;
+            sensorInstanceMap_.insert(instance, SensorInstanceEntry(typeName));
+        }
+    }
+}
+
+bool SensorManager::addSensorInstanceEntry(const QString& id)
+{
+    if (getInstanceIndex(id) == 0)
+        return false;
+    QMap<QString, SensorInstanceEntry>::const_iterator base = sensorInstanceMap_.constFind(getBaseId(id));
+    if (base == sensorInstanceMap_.constEnd())
+        return false;
+    sensordLogD() << "Adding sensor instance" << id;
+    sensorInstanceMap_.insert(id, SensorInstanceEntry(base.value().type_));
+    return true;
+}
+
+bool SensorManager::addChainInstanceEntry(const QString& id)
+{
+    if (getInstanceIndex(id) == 0)
+        return false;
+    QMap<QString, ChainInstanceEntry>::const_iterator base = chainInstanceMap_.constFind(getBaseId(id));
+    if (base == chainInstanceMap_.constEnd())
+        return false;
+    sensordLogD() << "Adding chain instance" << id;
+    chainInstanceMap_.insert(id, ChainInstanceEntry(base.value().type_));
+    return true;
+}
+
+bool SensorManager::addDeviceAdaptorInstanceEntry(const QString& id)
+{
+    if (getInstanceIndex(id) == 0)
+        return false;
+    QMap<QString, DeviceAdaptorInstanceEntry>::const_iterator base = deviceAdaptorInstanceMap_.constFind(getBaseId(id));
+    if (base == deviceAdaptorInstanceMap_.constEnd())
+        return false;
+    sensordLogD() << "Adding adaptor instance" << id;
+    DeviceAdaptorInstanceEntry entry(base.value().type_, id);
+    entry.propertyMap_ = base.value().propertyMap_;
+    deviceAdaptorInstanceMap_.insert(id, entry);
+    return true;
+}
+
+int SensorManager::requestSensor(const QString& id, qint64 claimedPid)
 {
     sensordLogD() << "Requesting sensor:" << id;
 
@@ -425,6 +547,9 @@ int SensorManager::requestSensor(const QString& id)
 
     qDebug() << sensorInstanceMap_.keys();
 
+    if (!sensorInstanceMap_.contains(cleanId))
+        addSensorInstanceEntry(cleanId);
+
     QMap<QString, SensorInstanceEntry>::iterator entryIt = sensorInstanceMap_.find(cleanId);
     if ( entryIt == sensorInstanceMap_.end() )
     {
@@ -433,12 +558,57 @@ int SensorManager::requestSensor(const QString& id)
     }
 
     QString clientName = "";
+    pid_t clientPid = 0;
+    uid_t clientUid = (uid_t)-1;
+    QString clientExecutable;
+    ClientQuota quota;
     if ( calledFromDBus() )
+    {
         clientName = message().service();
+        QDBusConnectionInterface* busInterface = connection().interface();
+        QDBusReply<uint> pidReply = busInterface->servicePid(clientName);
+        QDBusReply<uint> uidReply = busInterface->serviceUid(clientName);
+        if (pidReply.isValid())
+            clientPid = pidReply.value();
+        else
+            sensordLogD() << "PID of D-Bus client" << clientName << "is not available";
+        if (!uidReply.isValid())
+        {
+            sensordLogW() << "Unable to resolve UID of D-Bus client" << clientName;
+            setError(SmCredentialsMismatch, tr("client credentials can not be resolved"));
+            return INVALID_SESSION;
+        }
+        clientUid = uidReply.value();
+        // PIDs differ legitimately for clients in PID namespaces or
+        // behind D-Bus proxies, so they are compared only when asked to.
+        bool pidCheck = SensorFrameworkConfig::configuration()->value<bool>("global/session_pid_check", false);
+        if (pidCheck && claimedPid > 0 && clientPid > 0 && claimedPid != clientPid)
+        {
+            sensordLogW() << "D-Bus client" << clientName << "claims PID" << claimedPid
+                          << "but is PID" << clientPid << ". Rejecting sensor request.";
+            setError(SmCredentialsMismatch, tr("claimed PID does not match the caller"));
+            return INVALID_SESSION;
+        }
+        clientExecutable = ClientQuota::executableForPid(clientPid);
+        quota = ClientQuota::forClient(clientUid, clientExecutable);
+
+        QList<QPair<uid_t, QString> > sessions;
+        foreach (const SessionInstanceEntry* session, sessionInstanceMap_)
+            sessions.append(qMakePair(session->m_uid, session->m_executable));
+        if (!quota.admitSession(clientUid, clientExecutable, sessions))
+        {
+            QString client = QString("%1 (uid %2)").arg(clientExecutable.isEmpty() ? clientName : clientExecutable).arg(clientUid);
+            ++quotaRejections_[client];
+            sensordLogW() << "Rejecting session for" << client << ": session quota is" << quota.maxSessions;
+            setError(SmQuotaExceeded, tr("client session quota exceeded"));
+            return INVALID_SESSION;
+        }
+    }
 
     int sessionId = createNewSessionId();
     if (!entryIt.value().sensor_)
     {
+        qint64 heap = heapInUse();
         AbstractSensorChannel* sensor = addSensor(id);
         if ( sensor == NULL )
         {
@@ -446,12 +616,27 @@ int SensorManager::requestSensor(const QString& id)
             return INVALID_SESSION;
         }
         entryIt.value().sensor_ = sensor;
+        entryIt.value().heapBytes_ = heapInUse() - heap;
     }
+    idleSensors_.remove(cleanId);
     entryIt.value().sessions_.insert(sessionId);
-    if ( !clientName.isEmpty() )
+    if ( clientName.isEmpty() )
+    {
+        // In-process clients connect from sensord itself
+        socketHandler_->setSessionOwner(sessionId, getpid(), geteuid());
+    }
+    else
     {
         QMap<int, SessionInstanceEntry*>::iterator sessionIt = sessionInstanceMap_.insert(
             sessionId, new SessionInstanceEntry(this, sessionId, clientName));
+        sessionIt.value()->m_pid = clientPid;
+        sessionIt.value()->m_uid = clientUid;
+        sessionIt.value()->m_executable = clientExecutable;
+        sessionIt.value()->m_quota = quota;
+        socketHandler_->setMaxBufferedBytes(sessionId, quota.maxBufferedBytes);
+        // Also sessions which never request an interval stay within the rate
+        socketHandler_->setMinInterval(sessionId, quota.minInterval_us);
+        socketHandler_->setSessionOwner(sessionId, clientPid, clientUid);
         serviceWatcher_->addWatchedService(clientName);
         sessionIt.value()->expectConnection(SOCKET_CONNECTION_TIMEOUT_MS);
     }
@@ -505,12 +690,12 @@ bool SensorManager::releaseSensor(const QString& id, int sessionId)
 
     if(entryIt.value().sessions_.remove( sessionId ))
     {
-        /** Fix for NB#242237
+        /** Fix for NB#242237: sensor is not removed with its last
+            session, only after being idle for global/idle_timeout */
         if ( entryIt.value().sessions_.empty() )
         {
-            removeSensor(id);
+            markIdle(idleSensors_, id);
         }
-        */
         returnValue = true;
     }
     else
@@ -546,12 +731,34 @@ bool SensorManager::releaseSensor(const QString& id, int sessionId)
     return returnValue;
 }
 
+unsigned int SensorManager::grantInterval(int sessionId, unsigned int interval_us)
+{
+    QMap<int, SessionInstanceEntry*>::iterator sessionIt = sessionInstanceMap_.find(sessionId);
+    if (sessionIt == sessionInstanceMap_.end())
+        return interval_us;
+
+    SessionInstanceEntry* session = sessionIt.value();
+    unsigned int granted_us = session->m_quota.grantInterval(interval_us);
+    session->m_lastRequested_us = interval_us;
+    session->m_lastGranted_us = granted_us;
+    if (granted_us != interval_us)
+    {
+        ++session->m_clampedRequests;
+        sensordLogD() << "Session" << sessionId << "requested interval" << interval_us
+                      << "us, limited by quota to" << granted_us << "us";
+    }
+    return granted_us;
+}
+
 AbstractChain* SensorManager::requestChain(const QString& id)
 {
     sensordLogD() << "Requesting chain: " << id;
     clearError();
 
     AbstractChain* chain = NULL;
+    if (!chainInstanceMap_.contains(id))
+        addChainInstanceEntry(id);
+
     QMap<QString, ChainInstanceEntry>::iterator entryIt = chainInstanceMap_.find(id);
     if (entryIt != chainInstanceMap_.end())
     {
@@ -559,6 +766,7 @@ AbstractChain* SensorManager::requestChain(const QString& id)
         {
             chain = entryIt.value().chain_;
             entryIt.value().cnt_++;
+            idleChains_.remove(id);
             sensordLogD() << "Found chain '" << id << "'. Ref count: " << entryIt.value().cnt_;
         }
         else
@@ -566,12 +774,14 @@ AbstractChain* SensorManager::requestChain(const QString& id)
             QString type = entryIt.value().type_;
             if (chainFactoryMap_.contains(type))
             {
+                qint64 heap = heapInUse();
                 chain = chainFactoryMap_[type](id);
                 Q_ASSERT(chain);
                 sensordLogD() << "Instantiated chain '" << id << "'. Valid =" << chain->isValid();
 
                 entryIt.value().cnt_++;
                 entryIt.value().chain_ = chain;
+                entryIt.value().heapBytes_ = heapInUse() - heap;
             }
             else
             {
@@ -600,14 +810,12 @@ void SensorManager::releaseChain(const QString& id)
         {
             entryIt.value().cnt_--;
 
-            /** Fix for NB#242237
+            /** Fix for NB#242237: chain is not deleted with its last
+                reference, only after being idle for global/idle_timeout */
             if (entryIt.value().cnt_ == 0)
-            */
-            if (false)
             {
-                sensordLogD() << "Chain '" << id << "' has no more references. Deleting it.";
-                delete entryIt.value().chain_;
-                entryIt.value().chain_ = 0;
+                sensordLogD() << "Chain '" << id << "' has no more references.";
+                markIdle(idleChains_, id);
             }
             else
             {
@@ -637,6 +845,9 @@ DeviceAdaptor* SensorManager::requestDeviceAdaptor(const QString& id)
     }
 
     DeviceAdaptor* da = NULL;
+    if (!deviceAdaptorInstanceMap_.contains(id))
+        addDeviceAdaptorInstanceEntry(id);
+
     QMap<QString, DeviceAdaptorInstanceEntry>::iterator entryIt = deviceAdaptorInstanceMap_.find(id);
     if ( entryIt != deviceAdaptorInstanceMap_.end() )
     {
@@ -645,6 +856,7 @@ DeviceAdaptor* SensorManager::requestDeviceAdaptor(const QString& id)
             Q_ASSERT( entryIt.value().adaptor_ );
             da = entryIt.value().adaptor_;
             entryIt.value().cnt_++;
+            idleAdaptors_.remove(id);
             sensordLogD() << "Found adaptor '" << id << "'. Ref count:" << entryIt.value().cnt_;
         }
         else
@@ -652,6 +864,7 @@ DeviceAdaptor* SensorManager::requestDeviceAdaptor(const QString& id)
             QString type = entryIt.value().type_;
             if ( deviceAdaptorFactoryMap_.contains(type) )
             {
+                qint64 heap = heapInUse();
                 da = deviceAdaptorFactoryMap_[type](id);
                 Q_ASSERT( da );
                 bool ok = da->isValid();
@@ -666,6 +879,7 @@ DeviceAdaptor* SensorManager::requestDeviceAdaptor(const QString& id)
                 {
                     entryIt.value().adaptor_ = da;
                     entryIt.value().cnt_++;
+                    entryIt.value().heapBytes_ = heapInUse() - heap;
                     sensordLogD() << "Instantiated adaptor '" << id << "'. Valid =" << da->isValid();
                 }
                 else
@@ -715,10 +929,10 @@ void SensorManager::releaseDeviceAdaptor(const QString& id)
                 Q_ASSERT( entryIt.value().adaptor_ );
 
                 entryIt.value().adaptor_->stopAdaptor();
-                /** Fix for NB#242237
-                delete entryIt.value().adaptor_;
-                entryIt.value().adaptor_ = 0;
-                */
+                /** Fix for NB#242237: adaptor is not deleted with its
+                    last reference, only after being idle for
+                    global/idle_timeout */
+                markIdle(idleAdaptors_, id);
             }
             else
             {
@@ -749,7 +963,7 @@ FilterBase* SensorManager::instantiateFilter(const QString& id)
     return it.value()();
 }
 
-bool SensorManager::write(int id, const void* source, int size)
+bool SensorManager::write(int id, const void* source, int size, const SampleSchema* schema)
 {
     void* buffer = malloc(size);
     if(!buffer) {
@@ -760,6 +974,7 @@ bool SensorManager::write(int id, const void* source, int size)
     pipeData.id = id;
     pipeData.size = size;
     pipeData.buffer = buffer;
+    pipeData.schema = schema;
 
     memcpy(buffer, source, size);
 
@@ -772,10 +987,13 @@ bool SensorManager::write(int id, const void* source, int size)
 
 void SensorManager::sensorDataHandler(int)
 {
+    static CpuAccounting::Node* const cpuNode = CpuAccounting::node("socket/write");
+    CpuAccounting::Scope scope(cpuNode);
+
     PipeData pipeData;
     ssize_t bytesRead = read(pipefds_[0], &pipeData, sizeof(pipeData));
 
-    if (!bytesRead || !socketHandler_->write(pipeData.id, pipeData.buffer, pipeData.size)) {
+    if (!bytesRead || !socketHandler_->write(pipeData.id, pipeData.buffer, pipeData.size, pipeData.schema)) {
         sensordLogW() << "Failed to write data to socket.";
     }
 
@@ -857,6 +1075,10 @@ void SensorManager::printStatus(QStringList& output) const
 {
     output.append("  Adaptors:");
     for (QMap<QString, DeviceAdaptorInstanceEntry>::const_iterator it = deviceAdaptorInstanceMap_.constBegin(); it != deviceAdaptorInstanceMap_.constEnd(); ++it) {
+        if (!it.value().adaptor_) {
+            output.append(QString("    %1 [%2 listener(s)] Not instantiated").arg(it.value().type_).arg(it.value().cnt_));
+            continue;
+        }
         output.append(QString("    %1 [%2 listener(s)] %3").arg(it.value().type_).arg(it.value().cnt_).arg(it.value().adaptor_->deviceStandbyOverride() ? "Standby Overriden" : "No standby override"));
     }
 
@@ -877,20 +1099,49 @@ void SensorManager::printStatus(QStringList& output) const
         str.append(QString(". %1").arg((it.value().sensor_ && it.value().sensor_->running()) ? "Running" : "Stopped"));
         output.append(str);
     }
+
+    output.append("  Client quotas:");
+    for (QMap<int, SessionInstanceEntry*>::const_iterator it = sessionInstanceMap_.constBegin(); it != sessionInstanceMap_.constEnd(); ++it) {
+        const SessionInstanceEntry* session = it.value();
+        QString str = QString("    session %1: %2 PID %3 UID %4 [%5]")
+            .arg(session->m_sessionId)
+            .arg(session->m_executable.isEmpty() ? session->m_clientName : session->m_executable)
+            .arg(session->m_pid)
+            .arg(session->m_uid)
+            .arg(session->m_quota.toString());
+        if (session->m_clampedRequests)
+            str.append(QString(", %1 interval request(s) limited, last %2 us -> %3 us (downsampled)")
+                       .arg(session->m_clampedRequests)
+                       .arg(session->m_lastRequested_us)
+                       .arg(session->m_lastGranted_us));
+        unsigned int dropped = socketHandler_->droppedSamples(session->m_sessionId);
+        if (dropped)
+            str.append(QString(", %1 sample(s) dropped over buffered bytes quota").arg(dropped));
+        output.append(str);
+    }
+    for (QMap<QString, unsigned int>::const_iterator it = quotaRejections_.constBegin(); it != quotaRejections_.constEnd(); ++it) {
+        output.append(QString("    %1: %2 session request(s) rejected").arg(it.key()).arg(it.value()));
+    }
+
+    output.append("  Memory usage:");
+    foreach (const QString& line, memoryUsage()) {
+        output.append("    " + line);
+    }
+
+    if (CpuAccounting::isEnabled()) {
+        output.append("  CPU usage:");
+        foreach (const QString& line, CpuAccounting::report()) {
+            output.append("    " + line);
+        }
+    }
 }
 
 QString SensorManager::socketToPid(int id) const
 {
-    struct ucred cr;
-    socklen_t len = sizeof(cr);
-    int fd = socketHandler_->getSocketFd(id);
-    if (fd)
-    {
-        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cr, &len) == 0)
-            return QString("%1").arg(cr.pid);
-        else
-            return strerror(errno);
-    }
+    pid_t pid;
+    uid_t uid;
+    if (socketHandler_->peerCredentials(id, pid, uid))
+        return QString("%1").arg(pid);
     return "n/a";
 }
 
@@ -1005,6 +1256,165 @@ double SensorManager::magneticDeviation()
     return deviation;
 }
 
+bool SensorManager::reloadConfig()
+{
+    clearError();
+
+    if (calledFromDBus())
+    {
+        QDBusReply<uint> uidReply = connection().interface()->serviceUid(message().service());
+        if (!uidReply.isValid() || (uidReply.value() != 0 && uidReply.value() != getuid()))
+        {
+            sensordLogW() << "Configuration reload denied for" << message().service();
+            setError(SmNotPermitted, tr("not permitted to reload configuration"));
+            return false;
+        }
+    }
+
+    sensordLogD() << "Reloading configuration";
+    return SensorFrameworkConfig::reloadConfig();
+}
+
+void SensorManager::markIdle(QMap<QString, qint64>& idle, const QString& id)
+{
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    int timeout = config ? config->value<int>("global/idle_timeout", 0) : 0;
+    if (timeout <= 0)
+        return;
+
+    // Nodes released while reclaiming are due right away
+    qint64 now = idleClock_.elapsed();
+    idle.insert(id, reclaiming_ ? now - timeout : now);
+    if (!reclaiming_)
+        scheduleReclaim();
+}
+
+void SensorManager::scheduleReclaim()
+{
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    int timeout = config ? config->value<int>("global/idle_timeout", 0) : 0;
+
+    qint64 oldest = -1;
+    QList<const QMap<QString, qint64>*> maps;
+    maps << &idleSensors_ << &idleChains_ << &idleAdaptors_;
+    foreach (const QMap<QString, qint64>* idle, maps) {
+        foreach (qint64 since, *idle) {
+            if (oldest < 0 || since < oldest)
+                oldest = since;
+        }
+    }
+
+    if (oldest < 0 || timeout <= 0) {
+        idleTimer_->stop();
+        return;
+    }
+    idleTimer_->start(qMax<qint64>(0, oldest + timeout - idleClock_.elapsed()));
+}
+
+void SensorManager::reclaimIdle()
+{
+    SensorFrameworkConfig* config = SensorFrameworkConfig::configuration();
+    int timeout = config ? config->value<int>("global/idle_timeout", 0) : 0;
+    if (timeout <= 0) {
+        idleSensors_.clear();
+        idleChains_.clear();
+        idleAdaptors_.clear();
+        return;
+    }
+
+    qint64 due = idleClock_.elapsed() - timeout;
+    qint64 heap = heapInUse();
+    reclaiming_ = true;
+
+    // Sensors release their chains and chains their adaptors and other
+    // chains when deleted, so reclaim top down until nothing is due
+    foreach (const QString& id, idleSensors_.keys()) {
+        if (idleSensors_.value(id) > due)
+            continue;
+        idleSensors_.remove(id);
+
+        QMap<QString, SensorInstanceEntry>::iterator entryIt = sensorInstanceMap_.find(id);
+        if (entryIt == sensorInstanceMap_.end() || !entryIt.value().sensor_ || !entryIt.value().sessions_.empty())
+            continue;
+
+        sensordLogD() << "Reclaiming idle sensor" << id;
+        bus().unregisterObject(OBJECT_PATH + "/" + getObjectPathId(id));
+        delete entryIt.value().sensor_;
+        entryIt.value().sensor_ = 0;
+        entryIt.value().heapBytes_ = 0;
+    }
+
+    bool reclaimed = true;
+    while (reclaimed) {
+        reclaimed = false;
+        foreach (const QString& id, idleChains_.keys()) {
+            if (idleChains_.value(id) > due)
+                continue;
+            idleChains_.remove(id);
+
+            QMap<QString, ChainInstanceEntry>::iterator entryIt = chainInstanceMap_.find(id);
+            if (entryIt == chainInstanceMap_.end() || !entryIt.value().chain_ || entryIt.value().cnt_ > 0)
+                continue;
+
+            sensordLogD() << "Reclaiming idle chain" << id;
+            AbstractChain* chain = entryIt.value().chain_;
+            entryIt.value().chain_ = 0;
+            entryIt.value().cnt_ = 0;
+            entryIt.value().heapBytes_ = 0;
+            delete chain;
+            reclaimed = true;
+        }
+    }
+
+    foreach (const QString& id, idleAdaptors_.keys()) {
+        if (idleAdaptors_.value(id) > due)
+            continue;
+        idleAdaptors_.remove(id);
+
+        QMap<QString, DeviceAdaptorInstanceEntry>::iterator entryIt = deviceAdaptorInstanceMap_.find(id);
+        if (entryIt == deviceAdaptorInstanceMap_.end() || !entryIt.value().adaptor_ || entryIt.value().cnt_ > 0)
+            continue;
+
+        sensordLogD() << "Reclaiming idle adaptor" << id;
+        delete entryIt.value().adaptor_;
+        entryIt.value().adaptor_ = 0;
+        entryIt.value().cnt_ = 0;
+        entryIt.value().heapBytes_ = 0;
+    }
+
+    reclaiming_ = false;
+    if (heap >= 0)
+        sensordLogD() << "Idle reclaim freed" << (heap - heapInUse()) / 1024 << "kB of heap";
+    scheduleReclaim();
+}
+
+QStringList SensorManager::memoryUsage() const
+{
+    QStringList output;
+    qint64 heap = heapInUse();
+    qint64 rss = residentSetSize();
+    output.append(QString("heap: %1 kB, resident: %2 kB")
+                  .arg(heap < 0 ? QString("unknown") : QString::number(heap / 1024))
+                  .arg(rss < 0 ? QString("unknown") : QString::number(rss / 1024)));
+
+    for (QMap<QString, SensorInstanceEntry>::const_iterator it = sensorInstanceMap_.constBegin(); it != sensorInstanceMap_.constEnd(); ++it) {
+        if (it.value().sensor_)
+            output.append(QString("sensor %1: %2 kB%3").arg(it.key()).arg(it.value().heapBytes_ / 1024)
+                          .arg(idleSensors_.contains(it.key()) ? ", idle" : ""));
+    }
+    for (QMap<QString, ChainInstanceEntry>::const_iterator it = chainInstanceMap_.constBegin(); it != chainInstanceMap_.constEnd(); ++it) {
+        if (it.value().chain_)
+            output.append(QString("chain %1: %2 kB%3").arg(it.key()).arg(it.value().heapBytes_ / 1024)
+                          .arg(idleChains_.contains(it.key()) ? ", idle" : ""));
+    }
+    for (QMap<QString, DeviceAdaptorInstanceEntry>::const_iterator it = deviceAdaptorInstanceMap_.constBegin(); it != deviceAdaptorInstanceMap_.constEnd(); ++it) {
+        if (it.value().adaptor_)
+            output.append(QString("adaptor %1: %2 kB%3").arg(it.key()).arg(it.value().heapBytes_ / 1024)
+                          .arg(idleAdaptors_.contains(it.key()) ? ", idle" : ""));
+    }
+    return output;
+}
+
 void SensorManager::setMagneticDeviation(double level)
 {
     if (level != deviation) {
@@ -32,6 +32,8 @@
 
 #include <QDBusContext>
 #include <QDBusServiceWatcher>
+#include <QSet>
+#include <QElapsedTimer>
 
 #include "abstractsensor.h"
 #include "abstractchain.h"
@@ -40,6 +42,7 @@
 #include "sfwerror.h"
 #include "idutils.h"
 #include "parameterparser.h"
+#include "clientquota.h"
 #include "logging.h"
 
 #ifdef SENSORFW_MCE_WATCHER
@@ -55,6 +58,7 @@ class MceWatcher;
 class QSocketNotifier;
 class QTimer;
 class SocketHandler;
+class SampleSchema;
 
 /**
  * Sensor instance entry. Contains list of connected sessions.
@@ -74,9 +78,10 @@ public:
      */
     ~SensorInstanceEntry();
 
-    QSet<int>               sessions_; /**< connected sessions. */
-    AbstractSensorChannel*  sensor_;   /**< sensor channel */
-    QString                 type_;     /**< type */
+    QSet<int>               sessions_;  /**< connected sessions. */
+    AbstractSensorChannel*  sensor_;    /**< sensor channel */
+    QString                 type_;      /**< type */
+    qint64                  heapBytes_; /**< heap allocated by instantiation */
 };
 
 /**
@@ -97,9 +102,10 @@ public:
      */
     ~ChainInstanceEntry();
 
-    int                     cnt_;   /**< Reference count */
-    AbstractChain*          chain_; /**< Chain pointer  */
-    QString                 type_;  /**< Type */
+    int                     cnt_;       /**< Reference count */
+    AbstractChain*          chain_;     /**< Chain pointer  */
+    QString                 type_;      /**< Type */
+    qint64                  heapBytes_; /**< heap allocated by instantiation */
 };
 
 /**
@@ -125,11 +131,13 @@ public:
     DeviceAdaptor*          adaptor_;     /**< Adaptor pointer */
     int                     cnt_;         /**< Reference count */
     QString                 type_;        /**< Type */
+    qint64                  heapBytes_;   /**< heap allocated by instantiation */
 };
 
 /**
  * Sensor session instance entry. Contains session ID, D-Bus service name of
- * connecting side and timer for initial connection timeout.
+ * connecting side, identity and quota of the client process and timer for
+ * initial connection timeout.
  */
 class SessionInstanceEntry : public QObject
 {
@@ -159,6 +167,13 @@ public:
     int                     m_sessionId;   /**< Session ID */
     QString                 m_clientName;  /**< D-Bus private client name */
     QTimer*                 m_timer;       /**< timer for initial connection */
+    pid_t                   m_pid;         /**< client process ID */
+    uid_t                   m_uid;         /**< client user ID */
+    QString                 m_executable;  /**< client executable name */
+    ClientQuota             m_quota;       /**< client resource quota */
+    unsigned int            m_clampedRequests; /**< interval requests limited by quota */
+    unsigned int            m_lastRequested_us; /**< last interval requested by client */
+    unsigned int            m_lastGranted_us;   /**< last interval granted to client */
 
 public slots:
 
@@ -315,8 +330,9 @@ public:
      * @param id Session ID.
      * @param source Source from where to write.
      * @param size How many bytes to write.
+     * @param schema Schema of the written sample, if known.
      */
-    bool write(int id, const void* source, int size);
+    bool write(int id, const void* source, int size, const SampleSchema* schema = 0);
 
     /**
      * Load plugin.
@@ -348,12 +364,30 @@ public:
     QStringList availableSensorPlugins() const;
 
     /**
-     * Request sensor.
+     * List instances of a sensor declared in configuration with
+     * \c [<id>@<n>] groups, e.g. a second accelerometer in the lid of a
+     * convertible. Other instances can still be requested by ID; they
+     * are valid when their adaptor finds a device.
+     *
+     * @param id Sensor ID, e.g. \c accelerometersensor.
+     * @return \c id followed by IDs of its configured instances.
+     */
+    QStringList availableSensorInstances(const QString& id) const;
+
+    /**
+     * Request sensor. When called over D-Bus, the user ID reported by
+     * the bus for the caller is bound to the session, and only that
+     * user is allowed to connect to the session data socket. With
+     * \c global/session_pid_check the process ID is bound as well.
      *
      * @param id Sensor ID.
+     * @param claimedPid Process ID the client claims to have, 0 if not
+     *                   given. With \c global/session_pid_check the
+     *                   request is rejected if it does not match the PID
+     *                   the bus reports for the caller.
      * @return new session ID for the sensor.
      */
-    int requestSensor(const QString& id);
+    int requestSensor(const QString& id, qint64 claimedPid = 0);
 
     /**
      * Release sensor.
@@ -363,6 +397,16 @@ public:
      */
     bool releaseSensor(const QString& id, int sessionId);
 
+    /**
+     * Apply client quota to an interval request of a session. Sessions
+     * exceeding their rate quota are downsampled to the granted rate.
+     *
+     * @param sessionId Session ID.
+     * @param interval_us Requested interval in microseconds.
+     * @return Interval the session is allowed to use.
+     */
+    unsigned int grantInterval(int sessionId, unsigned int interval_us);
+
     /**
      * Get sensor instance.
      *
@@ -409,6 +453,24 @@ public:
     double magneticDeviation();
     void setMagneticDeviation(double level);
 
+    /**
+     * Reload configuration files. Running sessions are kept; nodes which
+     * subscribed to changed keys apply the new values. Over D-Bus only
+     * root and the user running sensord may reload configuration.
+     *
+     * @return was configuration reloaded.
+     */
+    bool reloadConfig();
+
+    /**
+     * Heap and resident memory usage: process totals and, for each
+     * instantiated node, the heap allocated while creating it, which
+     * includes nodes it created in turn.
+     *
+     * @return one line per entry.
+     */
+    QStringList memoryUsage() const;
+
 private Q_SLOTS:
     /**
      * Callback for lost session connections.
@@ -444,6 +506,12 @@ private Q_SLOTS:
      */
     void sensorDataHandler(int);
 
+    /**
+     * Delete sensors, chains and adaptors which have been idle for
+     * longer than \c global/idle_timeout.
+     */
+    void reclaimIdle();
+
 Q_SIGNALS:
     /**
      * Signal for occured errors.
@@ -505,6 +573,40 @@ private:
      */
     void removeSensor(const QString& id);
 
+    /**
+     * Register instances of a sensor declared in configuration.
+     *
+     * @param sensorName Sensor ID.
+     * @param typeName Sensor class name.
+     */
+    void registerSensorInstances(const QString& sensorName, const QString& typeName);
+
+    /**
+     * Add entry for an instance of a registered sensor on first request,
+     * with the type of the sensor. Instance 0 is never added.
+     *
+     * @param id Instance ID, e.g. \c accelerometersensor@1.
+     * @return was entry added.
+     */
+    bool addSensorInstanceEntry(const QString& id);
+
+    /**
+     * Add entry for an instance of a registered chain on first request.
+     *
+     * @param id Instance ID, e.g. \c accelerometerchain@1.
+     * @return was entry added.
+     */
+    bool addChainInstanceEntry(const QString& id);
+
+    /**
+     * Add entry for an instance of a registered adaptor on first
+     * request. The instance gets the properties of the adaptor.
+     *
+     * @param id Instance ID, e.g. \c accelerometeradaptor@1.
+     * @return was entry added.
+     */
+    bool addDeviceAdaptorInstanceEntry(const QString& id);
+
     /**
      * Generate new unique session ID.
      *
@@ -528,9 +630,25 @@ private:
      */
     QString socketToPid(const QSet<int>& ids) const;
 
+    /**
+     * Mark node idle, to be reclaimed after \c global/idle_timeout
+     * milliseconds unless used again. Zero timeout, the default, keeps
+     * idle nodes for the daemon lifetime.
+     *
+     * @param idle idle nodes of the kind.
+     * @param id node ID.
+     */
+    void markIdle(QMap<QString, qint64>& idle, const QString& id);
+
+    /**
+     * Start idle timer for the next node to reclaim.
+     */
+    void scheduleReclaim();
+
     QMap<QString, SensorChannelFactoryMethod>      sensorFactoryMap_; /**< factories for sensor types */
     QMap<QString, SensorInstanceEntry>             sensorInstanceMap_; /**< sensor instances */
     QMap<int,     SessionInstanceEntry*>           sessionInstanceMap_; /**< sensor session instances */
+    QMap<QString, unsigned int>                    quotaRejections_; /**< rejected session requests per client */
 
     QMap<QString, DeviceAdaptorFactoryMethod>      deviceAdaptorFactoryMap_; /**< factories for adaptor types. */
     QMap<QString, DeviceAdaptorInstanceEntry>      deviceAdaptorInstanceMap_; /**< adaptor instances */
@@ -551,6 +669,13 @@ private:
     int                                            pipefds_[2]; /** pipe for sensor samples */
     QSocketNotifier*                               pipeNotifier_; /** notifier for pipe stream */
 
+    QTimer*                                        idleTimer_; /**< fires when next idle node is due */
+    QElapsedTimer                                  idleClock_; /**< time base of idle timestamps */
+    QMap<QString, qint64>                          idleSensors_; /**< idle sensors, by time they became idle */
+    QMap<QString, qint64>                          idleChains_; /**< idle chains, by time they became idle */
+    QMap<QString, qint64>                          idleAdaptors_; /**< idle adaptors, by time they became idle */
+    bool                                           reclaiming_; /**< reclaiming, cascade without waiting */
+
     static SensorManager*                          instance_; /** singleton */
     static int                                     sessionIdCount_; /** session ID counter */
 
@@ -580,6 +705,8 @@ void SensorManager::registerSensor(const QString& sensorName)
         sensordLogW() << "Sensor type doesn't match!";
         return;
     }
+
+    registerSensorInstances(sensorName, typeName);
 }
 
 template<class CHAIN_TYPE>
@@ -29,6 +29,7 @@
 
 #include "sensormanager_a.h"
 #include "logging.h"
+#include "cpuaccounting.h"
 
 /*
  * Implementation of adaptor class SensorManagerAdaptor
@@ -69,9 +70,14 @@ QStringList SensorManagerAdaptor::availableSensorPlugins() const
     return sensorManager()->availableSensorPlugins();
 }
 
+QStringList SensorManagerAdaptor::availableSensorInstances(const QString& id) const
+{
+    return sensorManager()->availableSensorInstances(id);
+}
+
 int SensorManagerAdaptor::requestSensor(const QString &id, qint64 pid)
 {
-    int session = sensorManager()->requestSensor(id);
+    int session = sensorManager()->requestSensor(id, pid);
     sensordLogD() << "Sensor '" << id << "' requested. Created session: " << session << ". Client PID: " << pid;
     return session;
 }
@@ -87,6 +93,36 @@ void SensorManagerAdaptor::setMagneticDeviation(double level)
     sensorManager()->setMagneticDeviation(level);
 }
 
+bool SensorManagerAdaptor::reloadConfig()
+{
+    return sensorManager()->reloadConfig();
+}
+
+bool SensorManagerAdaptor::cpuAccounting() const
+{
+    return CpuAccounting::isEnabled();
+}
+
+void SensorManagerAdaptor::setCpuAccounting(bool enabled)
+{
+    CpuAccounting::setEnabled(enabled);
+}
+
+QStringList SensorManagerAdaptor::cpuUsage() const
+{
+    return CpuAccounting::report();
+}
+
+QStringList SensorManagerAdaptor::memoryUsage() const
+{
+    return sensorManager()->memoryUsage();
+}
+
+void SensorManagerAdaptor::resetCpuAccounting()
+{
+    CpuAccounting::reset();
+}
+
 double SensorManagerAdaptor::magneticDeviation()
 {
     return sensorManager()->magneticDeviation();
@@ -42,6 +42,9 @@ class SensorManagerAdaptor : public QDBusAbstractAdaptor
     Q_PROPERTY(QString errorString READ errorString)
     Q_PROPERTY(int errorCodeInt READ errorCodeInt)
     Q_PROPERTY(int magneticDeviation READ magneticDeviation WRITE setMagneticDeviation)
+    Q_PROPERTY(bool cpuAccounting READ cpuAccounting WRITE setCpuAccounting)
+    Q_PROPERTY(QStringList cpuUsage READ cpuUsage)
+    Q_PROPERTY(QStringList memoryUsage READ memoryUsage)
 
 public:
     /**
@@ -71,6 +74,31 @@ private:
      */
     int errorCodeInt() const;
 
+    /**
+     * Is CPU time accounting of dataflow nodes enabled.
+     */
+    bool cpuAccounting() const;
+
+    /**
+     * Enable or disable CPU time accounting of dataflow nodes.
+     */
+    void setCpuAccounting(bool enabled);
+
+    /**
+     * CPU time and call count of dataflow nodes, busiest first.
+     *
+     * @return one line per node.
+     */
+    QStringList cpuUsage() const;
+
+    /**
+     * Heap and resident memory of the daemon, and heap allocated by
+     * each instantiated sensor, chain and adaptor.
+     *
+     * @return one line per entry.
+     */
+    QStringList memoryUsage() const;
+
     /**
      * Get sensor manager instance.
      *
@@ -108,6 +136,14 @@ public Q_SLOTS:
      */
     QStringList availableSensorPlugins() const;
 
+    /**
+     * List configured instances of a sensor.
+     *
+     * @param id Sensor ID.
+     * @return array of sensor IDs, starting with \c id.
+     */
+    QStringList availableSensorInstances(const QString& id) const;
+
     /**
      * Request new sensor session to be created.
      *
@@ -130,6 +166,18 @@ public Q_SLOTS:
     double magneticDeviation();
     void setMagneticDeviation(double level);
 
+    /**
+     * Reload configuration files without restarting the daemon.
+     *
+     * @return was configuration reloaded succesfully.
+     */
+    bool reloadConfig();
+
+    /**
+     * Clear CPU time accounting counters of all dataflow nodes.
+     */
+    void resetCpuAccounting();
+
 Q_SIGNALS:
     /**
      * Signal which is emitted for occured errors.
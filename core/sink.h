@@ -28,11 +28,24 @@
 #ifndef SINK_H
 #define SINK_H
 
+#include "producer.h"
+#include <QList>
+#include <type_traits>
+
 /**
  * Data sink base class.
  */
 class SinkBase
 {
+public:
+    /**
+     * Nodes receiving the data collected by this sink, used to order
+     * propagation. See Scheduler.
+     *
+     * @return downstream nodes, empty if data ends here.
+     */
+    virtual QList<const Producer*> downstream() const { return QList<const Producer*>(); }
+
 protected:
     /**
      * Destructor.
@@ -56,6 +69,35 @@ public:
      * @param values Data source location.
      */
     virtual void collect(int n, const TYPE* values) = 0;
+
+    /**
+     * Reserve storage for one element, to be written in place by the
+     * source and accepted with commit(). Sinks owning storage for the
+     * data, such as ring buffers, override this to spare a copy.
+     *
+     * @return location to write to, or \c NULL if sink has no storage.
+     */
+    virtual TYPE* reserve() { return 0; }
+
+    /**
+     * Accept the element written to the location given by reserve().
+     */
+    virtual void commit() {}
+};
+
+/**
+ * Producer base of a sink implementor, if it has one.
+ */
+template <class T, bool IS_PRODUCER = std::is_base_of<Producer, T>::value>
+struct SinkProducer
+{
+    static const Producer* get(const T*) { return 0; }
+};
+
+template <class T>
+struct SinkProducer<T, true>
+{
+    static const Producer* get(const T* instance) { return instance; }
 };
 
 /**
@@ -84,6 +126,18 @@ public:
         member_(member)
     {}
 
+    /**
+     * Sink implementor, when it produces data of its own.
+     */
+    QList<const Producer*> downstream() const
+    {
+        QList<const Producer*> nodes;
+        if (const Producer* node = SinkProducer<DERIVED>::get(instance_)) {
+            nodes << node;
+        }
+        return nodes;
+    }
+
 private:
     void collect(int n, const TYPE* values)
     {
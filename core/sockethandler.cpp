@@ -32,10 +32,15 @@
 #include <sys/time.h>
 #include "logging.h"
 #include "sockethandler.h"
+#include "sampleencoder.h"
+#include "config.h"
+#include "datatypes/clockoffsets.h"
 #include <unistd.h>
 #include <limits.h>
+#include <errno.h>
+#include <string.h>
 
-SessionData::SessionData(QLocalSocket* socket, QObject* parent) : QObject(parent),
+SessionData::SessionData(QLocalSocket* socket, pid_t pid, uid_t uid, QObject* parent) : QObject(parent),
                                                                   m_socket(socket),
                                                                   m_interval_us(-1),
                                                                   m_buffer(nullptr),
@@ -43,12 +48,21 @@ SessionData::SessionData(QLocalSocket* socket, QObject* parent) : QObject(parent
                                                                   m_count(0),
                                                                   m_bufferSize(1),
                                                                   m_bufferInterval_us(0),
-                                                                  m_downsampling(false)
+                                                                  m_downsampling(false),
+                                                                  m_maxBufferedBytes(0),
+                                                                  m_droppedSamples(0),
+                                                                  m_minInterval_us(0),
+                                                                  m_nextSample_us(0),
+                                                                  m_pid(pid),
+                                                                  m_uid(uid),
+                                                                  m_encoder(nullptr),
+                                                                  m_schema(nullptr)
 {
     m_lastWrite.tv_sec = 0;
     m_lastWrite.tv_usec = 0;
     m_timer.setSingleShot(true);
     connect(&m_timer, SIGNAL(timeout()), this, SLOT(timerTimeout()));
+    m_rateClock.start();
 }
 
 SessionData::~SessionData()
@@ -56,6 +70,7 @@ SessionData::~SessionData()
     m_timer.stop();
     delete m_socket;
     delete[] m_buffer;
+    delete m_encoder;
 }
 
 void SessionData::timerTimeout()
@@ -91,20 +106,67 @@ bool SessionData::write(void* source, int size, unsigned int count)
     return false;
 }
 
+bool SessionData::rateLimited()
+{
+    if(!m_minInterval_us)
+        return false;
+    // Schedule advances by the limit for every sample let through, so
+    // jitter around the limit does not halve the rate
+    qint64 now_us = m_rateClock.nsecsElapsed() / 1000;
+    qint64 slack_us = m_minInterval_us / 4;
+    if(now_us + slack_us < m_nextSample_us)
+        return true;
+    if(m_nextSample_us < now_us - slack_us)
+        m_nextSample_us = now_us;
+    m_nextSample_us += m_minInterval_us;
+    return false;
+}
+
+bool SessionData::overQuota(int pending)
+{
+    if(!m_maxBufferedBytes || !m_socket)
+        return false;
+    if(m_socket->bytesToWrite() + pending <= m_maxBufferedBytes)
+        return false;
+    if(!m_droppedSamples)
+        sensordLogW() << "[SocketHandler]: client is over its buffered bytes quota, dropping samples";
+    ++m_droppedSamples;
+    return true;
+}
+
 bool SessionData::write(const void* source, int size)
 {
-    long since_us = sinceLastWrite();
-    int allocSize = m_bufferSize * size + sizeof(unsigned int);
-    if(!m_buffer)
+    if(rateLimited())
+        return true;
+    return writeSample(source, size);
+}
+
+bool SessionData::writeSample(const void* source, int size)
+{
+    // Batch of different sized samples can not be continued
+    if(m_buffer && size != m_size)
     {
-        m_buffer = new char[allocSize];
+        if(m_count)
+            delayedWrite();
+        delete[] m_buffer;
+        m_buffer = nullptr;
     }
-    else if(size != m_size)
+
+    // Batches are capped to what fits in the quota, so that a full batch
+    // can be written as soon as the client has caught up
+    unsigned int batch = m_bufferSize;
+    if(m_maxBufferedBytes)
     {
-        m_socket->waitForBytesWritten();
-        delete[] m_buffer;
-        m_buffer = new char[allocSize];
+        unsigned int fitting = (m_maxBufferedBytes - qMin<unsigned int>(m_maxBufferedBytes, sizeof(unsigned int))) / size;
+        batch = qMax(1u, qMin(batch, fitting));
     }
+    unsigned int queued = m_bufferSize > 1 ? m_count + 1 : 1;
+    if(overQuota(queued * size + sizeof(unsigned int)))
+        return true;
+
+    long since_us = sinceLastWrite();
+    if(!m_buffer)
+        m_buffer = new char[m_bufferSize * size + sizeof(unsigned int)];
     m_size = size;
     if(m_bufferSize <= 1)
     {
@@ -119,7 +181,7 @@ bool SessionData::write(const void* source, int size)
     {
         memcpy(m_buffer + sizeof(unsigned int) + size * m_count, source, size);
         ++m_count;
-        if(m_bufferSize == m_count)
+        if(m_count >= batch)
         {
             return delayedWrite();
         }
@@ -140,6 +202,100 @@ bool SessionData::write(const void* source, int size)
     return true;
 }
 
+bool SessionData::write(const void* source, int size, const SampleSchema* schema)
+{
+    if(!m_encoder || !schema)
+        return write(source, size);
+    if(rateLimited())
+        return true;
+
+    if(schema != m_schema)
+    {
+        // Samples batched under the old schema go out before its successor
+        if(m_count)
+            delayedWrite();
+        m_schema = schema;
+        QByteArray header = m_encoder->header(*schema);
+        if(m_socket && !header.isEmpty() && m_socket->write(header) < 0)
+        {
+            sensordLogW() << "[SocketHandler]: failed to write stream header to the socket: " << m_socket->errorString();
+            return false;
+        }
+    }
+
+    m_encoded.resize(0);
+    m_encoder->encode(*schema, source, m_encoded);
+
+    // Fixed size encodings share the framing and buffering of raw structs
+    if(m_encoder->sampleSize(*schema))
+        return writeSample(m_encoded.constData(), m_encoded.size());
+
+    if(!m_socket)
+        return false;
+    if(overQuota(m_encoded.size()))
+        return true;
+    if(m_downsampling && sinceLastWrite() < m_interval_us)
+        return true;
+    gettimeofday(&m_lastWrite, 0);
+    if(m_socket->write(m_encoded) < 0)
+    {
+        sensordLogW() << "[SocketHandler]: failed to write payload to the socket: " << m_socket->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SessionData::write(const ClockOffsets& offsets)
+{
+    if(!m_socket)
+        return false;
+
+    const SampleSchema* schema = sampleSchema<ClockOffsets>();
+    QByteArray frame;
+    if(!m_encoder || m_encoder->sampleSize(*schema))
+    {
+        unsigned int tag = ClockOffsets::FrameTag;
+        frame.append((const char*)&tag, sizeof(tag));
+    }
+    if(m_encoder)
+        m_encoder->encode(*schema, &offsets, frame);
+    else
+        frame.append((const char*)&offsets, sizeof(offsets));
+
+    // Readings are sent again on the next round, no need to count a drop
+    if(m_maxBufferedBytes && m_socket->bytesToWrite() + frame.size() > m_maxBufferedBytes)
+        return true;
+    if(m_socket->write(frame) < 0)
+    {
+        sensordLogW() << "[SocketHandler]: failed to write clock frame to the socket: " << m_socket->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SessionData::setDataFormat(const QString& format)
+{
+    SampleEncoder* encoder = SampleEncoder::create(format);
+    if(!encoder)
+        return false;
+    if(m_count)
+        delayedWrite();
+    delete m_encoder;
+    m_encoder = nullptr;
+    m_schema = nullptr;
+    // Raw structs are written without encoding
+    if(format == "raw")
+        delete encoder;
+    else
+        m_encoder = encoder;
+    return true;
+}
+
+QString SessionData::getDataFormat() const
+{
+    return m_encoder ? m_encoder->format() : QString("raw");
+}
+
 bool SessionData::delayedWrite()
 {
     if(m_timer.isActive())
@@ -186,9 +342,10 @@ void SessionData::setBufferSize(unsigned int size)
 {
     if(size != m_bufferSize)
     {
-        if(m_timer.isActive())
+        if(m_count)
+            delayedWrite();
+        else if(m_timer.isActive())
             m_timer.stop();
-        m_socket->waitForBytesWritten();
         delete[] m_buffer;
         m_buffer = 0;
         m_count = 0;
@@ -219,10 +376,47 @@ bool SessionData::getDownsampling() const
     return m_downsampling;
 }
 
+void SessionData::setMaxBufferedBytes(unsigned int bytes)
+{
+    m_maxBufferedBytes = bytes;
+}
+
+unsigned int SessionData::getMaxBufferedBytes() const
+{
+    return m_maxBufferedBytes;
+}
+
+unsigned int SessionData::getDroppedSamples() const
+{
+    return m_droppedSamples;
+}
+
+void SessionData::setMinInterval(unsigned int interval_us)
+{
+    m_minInterval_us = interval_us;
+    m_nextSample_us = 0;
+}
+
+unsigned int SessionData::getMinInterval() const
+{
+    return m_minInterval_us;
+}
+
+pid_t SessionData::getPid() const
+{
+    return m_pid;
+}
+
+uid_t SessionData::getUid() const
+{
+    return m_uid;
+}
+
 SocketHandler::SocketHandler(QObject* parent) : QObject(parent), m_server(NULL)
 {
     m_server = new QLocalServer(this);
     connect(m_server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+    connect(&m_clockTimer, SIGNAL(timeout()), this, SLOT(publishClockOffsets()));
 }
 
 SocketHandler::~SocketHandler()
@@ -252,7 +446,7 @@ bool SocketHandler::listen(const QString& serverName)
     return m_server->isListening();
 }
 
-bool SocketHandler::write(int id, const void* source, int size)
+bool SocketHandler::write(int id, const void* source, int size, const SampleSchema* schema)
 {
     QMap<int, SessionData*>::iterator it = m_idMap.find(id);
     if (it == m_idMap.end())
@@ -260,11 +454,25 @@ bool SocketHandler::write(int id, const void* source, int size)
         sensordLogD() << "[SocketHandler]: Trying to write to nonexistent session (normal, no panic).";
         return false;
     }
-    return (*it)->write(source, size);
+    // Gap markers from the channels are clock readings, which only
+    // sessions with clock sync understand
+    if (schema && schema == sampleSchema<ClockOffsets>()) {
+        if (!m_clockSync.contains(id))
+            return true;
+        return (*it)->write(*static_cast<const ClockOffsets*>(source));
+    }
+    return (*it)->write(source, size, schema);
 }
 
 bool SocketHandler::removeSession(int sessionId)
 {
+    m_maxBufferedBytes.remove(sessionId);
+    m_minIntervals.remove(sessionId);
+    m_dataFormats.remove(sessionId);
+    m_ownerMap.remove(sessionId);
+    if (m_clockSync.remove(sessionId) && m_clockSync.isEmpty())
+        m_clockTimer.stop();
+
     if (!(m_idMap.keys().contains(sessionId))) {
         sensordLogW() << "[SocketHandler]: Trying to remove nonexistent session.";
         return false;
@@ -318,13 +526,51 @@ void SocketHandler::socketReadable()
 
     disconnect(socket, SIGNAL(readyRead()), this, SLOT(socketReadable()));
 
-    if (sessionId >= 0) {
-        if(!m_idMap.contains(sessionId))
-            m_idMap.insert(sessionId, new SessionData((QLocalSocket*)sender(), this));
-    } else {
+    if (sessionId < 0) {
         sensordLogC() << "[SocketHandler]: Failed to read valid session ID from client. Closing socket.";
         socket->abort();
+        return;
     }
+
+    struct ucred cr;
+    socklen_t len = sizeof(cr);
+    if (getsockopt(socket->socketDescriptor(), SOL_SOCKET, SO_PEERCRED, &cr, &len) != 0) {
+        sensordLogC() << "[SocketHandler]: Failed to read peer credentials for session" << sessionId << ":" << strerror(errno) << ". Closing socket.";
+        socket->abort();
+        return;
+    }
+
+    // Session IDs are sequential, so an ID without an owner may be one
+    // that is about to be handed out to somebody else
+    QMap<int, QPair<pid_t, uid_t> >::const_iterator owner = m_ownerMap.constFind(sessionId);
+    if (owner == m_ownerMap.constEnd()) {
+        sensordLogC() << "[SocketHandler]: PID" << cr.pid << "UID" << cr.uid << "claims unknown session" << sessionId << ". Closing socket.";
+        socket->abort();
+        return;
+    }
+    bool pidCheck = SensorFrameworkConfig::configuration()->value<bool>("global/session_pid_check", false);
+    bool pidMismatch = pidCheck && owner.value().first > 0 && owner.value().first != cr.pid;
+    if (owner.value().second != cr.uid || pidMismatch) {
+        sensordLogC() << "[SocketHandler]: PID" << cr.pid << "UID" << cr.uid << "claims session" << sessionId
+                      << "owned by PID" << owner.value().first << "UID" << owner.value().second << ". Closing socket.";
+        socket->abort();
+        return;
+    }
+    if (m_idMap.contains(sessionId)) {
+        sensordLogW() << "[SocketHandler]: Session" << sessionId << "is already connected. Closing socket.";
+        socket->abort();
+        return;
+    }
+
+    SessionData* session = new SessionData(socket, cr.pid, cr.uid, this);
+    session->setMaxBufferedBytes(m_maxBufferedBytes.value(sessionId, 0));
+    session->setMinInterval(m_minIntervals.value(sessionId, 0));
+    if (m_dataFormats.contains(sessionId))
+        session->setDataFormat(m_dataFormats.value(sessionId));
+    m_idMap.insert(sessionId, session);
+    if (m_clockSync.contains(sessionId))
+        session->write(ClockOffsets::sample());
+    emit connectedSession(sessionId);
 }
 
 void SocketHandler::socketDisconnected()
@@ -427,13 +673,108 @@ bool SocketHandler::downsampling(int sessionId) const
 {
     QMap<int, SessionData*>::const_iterator it = m_idMap.find(sessionId);
     if (it != m_idMap.end())
-        return (*it)->getBufferSize();
-    return 0;
+        return (*it)->getDownsampling();
+    return false;
 }
 
 void SocketHandler::setDownsampling(int sessionId, bool value)
 {
     QMap<int, SessionData*>::iterator it = m_idMap.find(sessionId);
     if (it != m_idMap.end())
-        (*it)->setBufferInterval(value);
+        (*it)->setDownsampling(value);
+}
+
+bool SocketHandler::setDataFormat(int sessionId, const QString& format)
+{
+    if (!SampleEncoder::formats().contains(format)) {
+        sensordLogW() << "[SocketHandler]: Unknown data format" << format << "requested for session" << sessionId;
+        return false;
+    }
+    m_dataFormats.insert(sessionId, format);
+    QMap<int, SessionData*>::iterator it = m_idMap.find(sessionId);
+    if (it != m_idMap.end())
+        (*it)->setDataFormat(format);
+    return true;
+}
+
+void SocketHandler::setClockSync(int sessionId, bool enable)
+{
+    if (!enable) {
+        if (m_clockSync.remove(sessionId) && m_clockSync.isEmpty())
+            m_clockTimer.stop();
+        return;
+    }
+    // Readings are written again when already enabled, for clients
+    // that flushed their socket
+    m_clockSync.insert(sessionId);
+    if (!m_clockTimer.isActive()) {
+        int interval_ms = SensorFrameworkConfig::configuration()->value<int>("global/clock_sync_interval", 10000);
+        m_clockTimer.start(qMax(interval_ms, 100));
+    }
+    QMap<int, SessionData*>::iterator it = m_idMap.find(sessionId);
+    if (it != m_idMap.end())
+        (*it)->write(ClockOffsets::sample());
+}
+
+bool SocketHandler::clockSync(int sessionId) const
+{
+    return m_clockSync.contains(sessionId);
+}
+
+void SocketHandler::publishClockOffsets()
+{
+    // Every session gets the same readings
+    ClockOffsets offsets = ClockOffsets::sample();
+    foreach (int sessionId, m_clockSync) {
+        QMap<int, SessionData*>::iterator it = m_idMap.find(sessionId);
+        if (it != m_idMap.end())
+            (*it)->write(offsets);
+    }
+}
+
+void SocketHandler::setMaxBufferedBytes(int sessionId, unsigned int bytes)
+{
+    if (bytes)
+        m_maxBufferedBytes.insert(sessionId, bytes);
+    else
+        m_maxBufferedBytes.remove(sessionId);
+
+    QMap<int, SessionData*>::iterator it = m_idMap.find(sessionId);
+    if (it != m_idMap.end())
+        (*it)->setMaxBufferedBytes(bytes);
+}
+
+void SocketHandler::setMinInterval(int sessionId, unsigned int interval_us)
+{
+    if (interval_us)
+        m_minIntervals.insert(sessionId, interval_us);
+    else
+        m_minIntervals.remove(sessionId);
+
+    QMap<int, SessionData*>::iterator it = m_idMap.find(sessionId);
+    if (it != m_idMap.end())
+        (*it)->setMinInterval(interval_us);
+}
+
+void SocketHandler::setSessionOwner(int sessionId, pid_t pid, uid_t uid)
+{
+    m_ownerMap.insert(sessionId, qMakePair(pid, uid));
+}
+
+bool SocketHandler::peerCredentials(int sessionId, pid_t& pid, uid_t& uid) const
+{
+    QMap<int, SessionData*>::const_iterator it = m_idMap.find(sessionId);
+    if (it == m_idMap.end())
+        return false;
+    pid = (*it)->getPid();
+    uid = (*it)->getUid();
+    return true;
+}
+
+unsigned int SocketHandler::droppedSamples(int sessionId) const
+{
+    QMap<int, SessionData*>::const_iterator it = m_idMap.find(sessionId);
+    if (it != m_idMap.end())
+        return (*it)->getDroppedSamples();
+    return 0;
 }
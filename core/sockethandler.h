@@ -31,12 +31,18 @@
 #include <QObject>
 #include <QMap>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QList>
+#include <QSet>
 #include <QMutex>
 #include <QLocalSocket>
 #include <sys/time.h>
+#include <sys/types.h>
 
 class QLocalServer;
+class SampleEncoder;
+class SampleSchema;
+class ClockOffsets;
 
 /**
  * Class contains data for single sensor session related data socket
@@ -53,9 +59,11 @@ public:
      *
      * @param socket Established socket connection. SessionData will take
      *               the ownership of it.
+     * @param pid Process ID of the connected peer.
+     * @param uid User ID of the connected peer.
      * @param parent Parent object.
      */
-    SessionData(QLocalSocket* socket, QObject* parent = 0);
+    SessionData(QLocalSocket* socket, pid_t pid, uid_t uid, QObject* parent = 0);
 
     /**
      * Destructor.
@@ -71,6 +79,47 @@ public:
      */
     bool write(const void* source, int size);
 
+    /**
+     * Write a sample to socket, encoded in the data format of the
+     * session. The data might be queued before written. A change of
+     * schema flushes the queued samples before the new stream header.
+     *
+     * @param source Sample to write.
+     * @param size Size of the sample struct.
+     * @param schema Schema of the sample type. Without a schema the
+     *               sample is written as is.
+     * @return was data succesfully written.
+     */
+    bool write(const void* source, int size, const SampleSchema* schema);
+
+    /**
+     * Write clock readings to socket as a clock frame. In the \c raw
+     * and \c flat formats the frame starts with ClockOffsets::FrameTag
+     * in place of the sample count, followed by the readings encoded
+     * like a sample. The \c json format writes a ClockOffsets object.
+     * Samples already buffered are not affected.
+     * @param offsets Clock readings.
+     * @return was data succesfully written.
+     */
+    bool write(const ClockOffsets& offsets);
+
+    /**
+     * Set data format of the stream. For supported formats see
+     * SampleEncoder. Pending samples are written in the previous
+     * format first.
+     *
+     * @param format Data format name.
+     * @return was format known.
+     */
+    bool setDataFormat(const QString& format);
+
+    /**
+     * Get data format of the stream.
+     *
+     * @return data format name.
+     */
+    QString getDataFormat() const;
+
     /**
      * Get used local socket pointer.
      *
@@ -146,6 +195,60 @@ public:
      */
     bool getDownsampling() const;
 
+    /**
+     * Limit how many bytes may be pending for the client. Samples are
+     * dropped while the limit would be exceeded, and batches are
+     * written early when a full buffer would not fit in the limit.
+     * Writing never waits for the client to catch up.
+     *
+     * @param bytes byte limit, 0 for unlimited.
+     */
+    void setMaxBufferedBytes(unsigned int bytes);
+
+    /**
+     * Get pending bytes limit.
+     *
+     * @return byte limit, 0 for unlimited.
+     */
+    unsigned int getMaxBufferedBytes() const;
+
+    /**
+     * How many samples have been dropped due to pending bytes limit.
+     *
+     * @return dropped sample count.
+     */
+    unsigned int getDroppedSamples() const;
+
+    /**
+     * Limit the rate of samples written to the client. Samples arriving
+     * faster are skipped, whatever interval the sensor runs at.
+     *
+     * @param interval_us smallest average interval between samples,
+     *                    0 for unlimited.
+     */
+    void setMinInterval(unsigned int interval_us);
+
+    /**
+     * Get sample rate limit.
+     *
+     * @return smallest interval in microseconds, 0 for unlimited.
+     */
+    unsigned int getMinInterval() const;
+
+    /**
+     * Get process ID of the connected peer.
+     *
+     * @return peer process ID.
+     */
+    pid_t getPid() const;
+
+    /**
+     * Get user ID of the connected peer.
+     *
+     * @return peer user ID.
+     */
+    uid_t getUid() const;
+
 private:
     /**
      * How many milliseconds since last time data was written to socket.
@@ -164,6 +267,33 @@ private:
      */
     bool write(void* source, int size, unsigned int count);
 
+    /**
+     * Queue or write a fixed size sample which has passed the rate
+     * limit.
+     *
+     * @param source Sample to write.
+     * @param size Size of the sample.
+     * @return was data succesfully written.
+     */
+    bool writeSample(const void* source, int size);
+
+    /**
+     * Check sample against the rate limit.
+     *
+     * @return \c true if the sample must be skipped.
+     */
+    bool rateLimited();
+
+    /**
+     * Check sample against the pending bytes limit. Counts dropped
+     * samples.
+     *
+     * @param pending Bytes of the sample, its batch and framing which
+     *                are not yet handed to the socket.
+     * @return \c true if the sample must be dropped.
+     */
+    bool overQuota(int pending);
+
     /**
      * Delayed write invocation.
      *
@@ -181,6 +311,16 @@ private:
     unsigned int m_bufferSize;        /**< buffer size */
     unsigned int m_bufferInterval_us; /**< buffer interval in milliseconds */
     bool m_downsampling;              /**< sample dropping */
+    unsigned int m_maxBufferedBytes;  /**< pending bytes limit */
+    unsigned int m_droppedSamples;    /**< samples dropped due to limit */
+    unsigned int m_minInterval_us;    /**< sample rate limit */
+    QElapsedTimer m_rateClock;        /**< clock for the rate limit */
+    qint64 m_nextSample_us;           /**< when rate limit lets the next sample through */
+    pid_t m_pid;                      /**< peer process ID */
+    uid_t m_uid;                      /**< peer user ID */
+    SampleEncoder* m_encoder;         /**< sample encoder, NULL for raw structs */
+    const SampleSchema* m_schema;     /**< schema of the samples written so far */
+    QByteArray m_encoded;             /**< encoding buffer */
 
 private slots:
 
@@ -225,8 +365,12 @@ public:
      * @param id Session ID.
      * @param source Location from where to write.
      * @param size How many bytes to write.
+     * @param schema Schema of the written sample, used to encode it
+     *               for sessions not using the raw data format. A
+     *               ClockOffsets is written as a clock frame to sessions
+     *               with clock sync and dropped for others.
      */
-    bool write(int id, const void* source, int size);
+    bool write(int id, const void* source, int size, const SampleSchema* schema = 0);
 
     /**
      * Close related socket connection for session.
@@ -346,6 +490,90 @@ public:
      */
     void setDownsampling(int sessionId, bool value);
 
+    /**
+     * Set pending bytes limit for given session. Limit is stored and
+     * applied also if the socket connection is established later. For
+     * more details see #SessionData::setMaxBufferedBytes(unsigned int).
+     *
+     * @param sessionId Session ID.
+     * @param bytes byte limit, 0 for unlimited.
+     */
+    void setMaxBufferedBytes(int sessionId, unsigned int bytes);
+
+    /**
+     * Set sample rate limit for given session. Limit is stored and
+     * applied also if the socket connection is established later. For
+     * more details see #SessionData::setMinInterval(unsigned int).
+     *
+     * @param sessionId Session ID.
+     * @param interval_us smallest interval in microseconds, 0 for unlimited.
+     */
+    void setMinInterval(int sessionId, unsigned int interval_us);
+
+    /**
+     * Set data format for given session. Format is stored and applied
+     * also if the socket connection is established later. For more
+     * details see #SessionData::setDataFormat(const QString&).
+     *
+     * @param sessionId Session ID.
+     * @param format Data format name.
+     * @return was format known.
+     */
+    bool setDataFormat(int sessionId, const QString& format);
+
+    /**
+     * Enable or disable clock sync for given session. Sessions with
+     * clock sync get ClockOffsets in their data stream when it is
+     * enabled or connected, and then every \c global/clock_sync_interval
+     * milliseconds (default 10000), and again whenever it is enabled.
+     * Setting is stored and applied also if the socket connection is
+     * established later.
+     *
+     * @param sessionId Session ID.
+     * @param enable enable clock sync.
+     */
+    void setClockSync(int sessionId, bool enable);
+
+    /**
+     * Is clock sync enabled for given session.
+     *
+     * @param sessionId Session ID.
+     * @return is clock sync enabled.
+     */
+    bool clockSync(int sessionId) const;
+
+    /**
+     * Get how many samples have been dropped for given session due to
+     * pending bytes limit.
+     *
+     * @param sessionId Session ID.
+     * @return dropped sample count.
+     */
+    unsigned int droppedSamples(int sessionId) const;
+
+    /**
+     * Bind session to the user which created it. Socket connection
+     * for the session is accepted only from a peer with the same UID,
+     * and also the same PID when global/session_pid_check is set and
+     * the owner PID is known. Sessions without an owner are not
+     * accepted at all.
+     *
+     * @param sessionId Session ID.
+     * @param pid Process ID of the owner, 0 if not known.
+     * @param uid User ID of the owner.
+     */
+    void setSessionOwner(int sessionId, pid_t pid, uid_t uid);
+
+    /**
+     * Get credentials of the peer connected to given session.
+     *
+     * @param sessionId Session ID.
+     * @param pid Set to peer process ID.
+     * @param uid Set to peer user ID.
+     * @return \c true if session has a connected peer.
+     */
+    bool peerCredentials(int sessionId, pid_t& pid, uid_t& uid) const;
+
 Q_SIGNALS:
     /**
      * Signal is emitted for new client connection after it sent the
@@ -386,10 +614,21 @@ private slots:
      */
     void socketError(QLocalSocket::LocalSocketError socketError);
 
+    /**
+     * Write current clock readings to sessions with clock sync.
+     */
+    void publishClockOffsets();
+
 private:
 
     QLocalServer*            m_server; /**< listening server socket. */
     QMap<int, SessionData*>  m_idMap;  /**< map of client sessions. */
+    QMap<int, unsigned int>  m_maxBufferedBytes; /**< pending bytes limits. */
+    QMap<int, unsigned int>  m_minIntervals; /**< sample rate limits. */
+    QMap<int, QString>       m_dataFormats; /**< session data formats. */
+    QMap<int, QPair<pid_t, uid_t> > m_ownerMap; /**< session owner credentials. */
+    QSet<int>                m_clockSync; /**< sessions with clock sync. */
+    QTimer                   m_clockTimer; /**< timer for publishing clock readings. */
 };
 
 #endif // SOCKETHANDLER_H
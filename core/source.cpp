@@ -27,15 +27,18 @@
  */
 
 #include "source.h"
+#include "scheduler.h"
 
 bool SourceBase::join(SinkBase* sink)
 {
     joinTypeChecked(sink);
+    Scheduler::invalidate();
     return true;
 }
 
 bool SourceBase::unjoin(SinkBase* sink)
 {
     unjoinTypeChecked(sink);
+    Scheduler::invalidate();
     return true;
 }
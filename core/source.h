@@ -31,8 +31,9 @@
 
 #include "sink.h"
 #include "logging.h"
+#include "cpuaccounting.h"
 #include <typeinfo>
-#include <QSet>
+#include <QList>
 
 class SinkBase;
 
@@ -42,6 +43,11 @@ class SinkBase;
 class SourceBase
 {
 public:
+    /**
+     * Constructor.
+     */
+    SourceBase() : cpuNode_(0) {}
+
     /**
      * Connect sink to the source.
      *
@@ -58,12 +64,26 @@ public:
      */
     bool unjoin(SinkBase* sink);
 
+    /**
+     * Set node CPU time of propagation is accounted to.
+     *
+     * @param node accounting node, or \c NULL.
+     */
+    void setCpuNode(CpuAccounting::Node* node) { cpuNode_ = node; }
+
+    /**
+     * Connected sinks, in join order.
+     */
+    virtual QList<SinkBase*> sinks() const = 0;
+
 protected:
     /**
      * Destructor.
      */
     virtual ~SourceBase() {}
 
+    CpuAccounting::Node* cpuNode_; /**< CPU accounting node, if any. */
+
 private:
     /**
      * Connect and check that sink is compatible with source.
@@ -92,24 +112,75 @@ class Source : public SourceBase
 {
 public:
     /**
-     * Propagate data to connected sinks.
+     * Constructor.
+     */
+    Source() : reserved_(0) {}
+
+    QList<SinkBase*> sinks() const
+    {
+        QList<SinkBase*> list;
+        foreach (SinkTyped<TYPE>* sink, sinks_) {
+            list << sink;
+        }
+        return list;
+    }
+
+    /**
+     * Propagate data to connected sinks, in join order.
      *
      * @param n how many elements to stream.
      * @param values source from where to stream data.
      */
     void propagate(int n, const TYPE* values)
     {
+        CpuAccounting::Scope scope(cpuNode_);
         foreach (SinkTyped<TYPE>* sink, sinks_) {
             sink->collect(n, values);
         }
     }
+
+    /**
+     * Get location for the next element. The element is passed to sinks
+     * with commit(). When the only connected sink has storage of its
+     * own, e.g. a ring buffer, the location is in that storage and the
+     * element is never copied. Otherwise it is a slot of the source.
+     *
+     * The location may hold a previous element, so every member must
+     * be written before commit().
+     *
+     * @return location to write next element to.
+     */
+    TYPE* nextSlot()
+    {
+        reserved_ = 0;
+        if (sinks_.size() == 1) {
+            reserved_ = (*sinks_.constBegin())->reserve();
+        }
+        return reserved_ ? reserved_ : &slot_;
+    }
+
+    /**
+     * Pass the element written to nextSlot() to connected sinks.
+     */
+    void commit()
+    {
+        if (reserved_) {
+            CpuAccounting::Scope scope(cpuNode_);
+            reserved_ = 0;
+            (*sinks_.constBegin())->commit();
+        } else {
+            propagate(1, &slot_);
+        }
+    }
 private:
     bool joinTypeChecked(SinkBase* sink)
     {
         SinkTyped<TYPE>* type = dynamic_cast<SinkTyped<TYPE>*>(sink);
         if(type)
         {
-            sinks_.insert(type);
+            if (!sinks_.contains(type)) {
+                sinks_.append(type);
+            }
             return true;
         }
         sensordLogC() << "Failed to join type '" << typeid(type).name() << " to source!";
@@ -121,14 +192,16 @@ private:
         SinkTyped<TYPE>* type = dynamic_cast<SinkTyped<TYPE>*>(sink);
         if(type)
         {
-            sinks_.remove(type);
+            sinks_.removeAll(type);
             return true;
         }
         sensordLogC() << "Failed to unjoin type '" << typeid(type).name() << " from source!";
         return false;
     }
 
-    QSet<SinkTyped<TYPE>*> sinks_; /**< connected sinks. */
+    QList<SinkTyped<TYPE>*> sinks_;    /**< connected sinks, in join order. */
+    TYPE*                   reserved_; /**< location reserved from sink, if any. */
+    TYPE                    slot_;     /**< location used when no sink reserves. */
 };
 
 #endif
@@ -0,0 +1,75 @@
+/**
+   @file suspendmonitor.cpp
+   @brief Detection of system suspend from clock divergence
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "suspendmonitor.h"
+#include "config.h"
+#include "logging.h"
+
+#include <QMutexLocker>
+
+SuspendMonitor& SuspendMonitor::instance()
+{
+    static SuspendMonitor monitor(SensorFrameworkConfig::configuration() ?
+        SensorFrameworkConfig::configuration()->value<int>("global/suspend_threshold", 100) * 1000ULL :
+        100000ULL);
+    return monitor;
+}
+
+SuspendMonitor::SuspendMonitor(quint64 threshold_us) :
+    threshold_(threshold_us * 1000),
+    hasOffset_(false),
+    offset_(0),
+    resumes_(0),
+    lastGap_(0)
+{
+}
+
+unsigned SuspendMonitor::check()
+{
+    return check(ClockOffsets::sample());
+}
+
+unsigned SuspendMonitor::check(const ClockOffsets& now)
+{
+    qint64 offset = now.offset(ClockOffsets::Monotonic, ClockOffsets::Boottime);
+
+    QMutexLocker locker(&mutex_);
+    if (hasOffset_ && offset - offset_ > (qint64)threshold_) {
+        ++resumes_;
+        lastGap_ = (offset - offset_) / 1000;
+        sensordLogD() << "[SuspendMonitor]: Resumed after" << lastGap_ / 1000 << "ms in suspend";
+    }
+    offset_ = offset;
+    hasOffset_ = true;
+    return resumes_;
+}
+
+unsigned SuspendMonitor::resumeCount() const
+{
+    QMutexLocker locker(&mutex_);
+    return resumes_;
+}
+
+quint64 SuspendMonitor::lastGap() const
+{
+    QMutexLocker locker(&mutex_);
+    return lastGap_;
+}
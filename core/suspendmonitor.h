@@ -0,0 +1,91 @@
+/**
+   @file suspendmonitor.h
+   @brief Detection of system suspend from clock divergence
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SUSPENDMONITOR_H
+#define SUSPENDMONITOR_H
+
+#include <QMutex>
+#include "datatypes/clockoffsets.h"
+
+/**
+ * Detects system suspend after the fact.
+ *
+ * CLOCK_MONOTONIC stops while the system is suspended and CLOCK_BOOTTIME
+ * does not, so their difference grows by exactly the time spent in
+ * suspend and stays constant otherwise. Each check() compares the
+ * difference to the one seen by the previous check; growth of more than
+ * \c global/suspend_threshold milliseconds (default 100) counts as a
+ * resume. This works without a logind inhibitor or any D-Bus traffic,
+ * and in whichever thread notices the gap first.
+ *
+ * Adaptor threads check after waking up, see DeviceAdaptor::checkSuspend().
+ * Sample timestamps are monotonic, so without this a sample after resume
+ * looks like it directly follows the last one before suspend.
+ */
+class SuspendMonitor
+{
+public:
+    /**
+     * Monitor shared by all adaptors.
+     */
+    static SuspendMonitor& instance();
+
+    /**
+     * Constructor.
+     * @param threshold_us shortest suspend detected (microsec).
+     */
+    SuspendMonitor(quint64 threshold_us);
+
+    /**
+     * Read the clocks and check for a suspend since the previous check.
+     * @return number of resumes seen so far.
+     */
+    unsigned check();
+
+    /**
+     * Check for a suspend given clock readings, e.g. from a virtual
+     * clock. Readings must not go back in time.
+     * @param now clock readings.
+     * @return number of resumes seen so far.
+     */
+    unsigned check(const ClockOffsets& now);
+
+    /**
+     * Number of resumes seen so far.
+     */
+    unsigned resumeCount() const;
+
+    /**
+     * How long the last suspend lasted.
+     * @return suspend time (microsec), zero if none seen.
+     */
+    quint64 lastGap() const;
+
+private:
+    mutable QMutex mutex_;
+    quint64 threshold_;  /**< shortest suspend detected (nanosec) */
+    bool hasOffset_;     /**< has a check been made */
+    qint64 offset_;      /**< boottime - monotonic at last check (nanosec) */
+    unsigned resumes_;   /**< resumes seen */
+    quint64 lastGap_;    /**< last suspend time (microsec) */
+};
+
+#endif // SUSPENDMONITOR_H
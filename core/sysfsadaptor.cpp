@@ -226,6 +226,7 @@ bool SysfsAdaptor::openFds()
             return false;
         }
         m_sysfsDescriptors.append(fd);
+        fdOpened(m_pathIds.at(i), fd);
     }
 
     // Set up epoll for select mode
@@ -271,6 +272,10 @@ bool SysfsAdaptor::openFds()
     return true;
 }
 
+void SysfsAdaptor::fdOpened(int, int)
+{
+}
+
 void SysfsAdaptor::closeAllFds()
 {
     QMutexLocker locker(&m_mutex);
@@ -428,6 +433,7 @@ void SysfsAdaptorReader::run()
                 sensordLogD() << m_parent->id() << "epoll_wait(): " << strerror(errno);
                 QThread::msleep(1000);
             } else {
+                m_parent->checkSuspend();
                 bool errorInInput = false;
                 for (int i = 0; i < descriptors; ++i) {
                     if (events[i].events & (EPOLLHUP | EPOLLERR)) {
@@ -437,7 +443,10 @@ void SysfsAdaptorReader::run()
                     }
                     int index = m_parent->m_sysfsDescriptors.lastIndexOf(events[i].data.fd);
                     if (index != -1) {
-                        m_parent->processSample(m_parent->m_pathIds.at(index), events[i].data.fd);
+                        {
+                            CpuAccounting::Scope scope(m_parent->cpuNode());
+                            m_parent->processSample(m_parent->m_pathIds.at(index), events[i].data.fd);
+                        }
 
                         if (m_parent->m_doSeek)
                         {
@@ -456,9 +465,15 @@ void SysfsAdaptorReader::run()
             }
         } else { //IntervalMode
 
+            // Sleep may have spanned a suspend
+            m_parent->checkSuspend();
+
             // Read through all fds.
             for (int i = 0; i < m_parent->m_sysfsDescriptors.size(); ++i) {
-                m_parent->processSample(m_parent->m_pathIds.at(i), m_parent->m_sysfsDescriptors.at(i));
+                {
+                    CpuAccounting::Scope scope(m_parent->cpuNode());
+                    m_parent->processSample(m_parent->m_pathIds.at(i), m_parent->m_sysfsDescriptors.at(i));
+                }
 
                 if (m_parent->m_doSeek)
                 {
@@ -479,7 +494,7 @@ void SysfsAdaptorReader::run()
 
 void SysfsAdaptor::init()
 {
-    QString path = SensorFrameworkConfig::configuration()->value(name() + "/path").toString();
+    QString path = SensorFrameworkConfig::configuration()->value(configKey(name(), "path", false)).toString();
     if(!path.isEmpty())
     {
         addPath(path);
@@ -488,14 +503,23 @@ void SysfsAdaptor::init()
     {
         sensordLogW() << id() << "No sysfs path defined for: " << name();
     }
-    m_mode = (PollMode)SensorFrameworkConfig::configuration()->value<int>(name() + "/mode", m_mode);
-    m_doSeek = SensorFrameworkConfig::configuration()->value<bool>(name() + "/seek", m_doSeek);
+    m_mode = (PollMode)SensorFrameworkConfig::configuration()->value<int>(configKey(name(), "mode"), m_mode);
+    m_doSeek = SensorFrameworkConfig::configuration()->value<bool>(configKey(name(), "seek"), m_doSeek);
 
     introduceAvailableDataRanges(name());
     introduceAvailableIntervals(name());
-    int interval_ms = SensorFrameworkConfig::configuration()->value<int>(name() + "/default_interval", 0);
+    int interval_ms = SensorFrameworkConfig::configuration()->value<int>(configKey(name(), "default_interval"), 0);
     if (interval_ms > 0) {
         unsigned int interval_us = (unsigned int)interval_ms * 1000u;
         setDefaultInterval(interval_us);
     }
+
+    // Reloaded default applies to sessions requesting the default from now on
+    disconnect(m_intervalSubscription);
+    m_intervalSubscription = SensorFrameworkConfig::subscribe<int>(configKey(name(), "default_interval"), 0, this,
+                                                                   [this](int interval_ms) {
+        if (interval_ms > 0) {
+            setDefaultInterval((unsigned int)interval_ms * 1000u);
+        }
+    });
 }
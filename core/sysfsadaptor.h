@@ -163,6 +163,16 @@ protected:
      */
     virtual void processSample(int pathId, int fd) = 0;
 
+    /**
+     * Called for each file descriptor right after it has been opened,
+     * before the reader thread starts. Adaptors can configure the
+     * device here. Default implementation does nothing.
+     *
+     * @param pathId Path ID of the file.
+     * @param fd     Open file descriptor. Must not be closed.
+     */
+    virtual void fdOpened(int pathId, int fd);
+
     /**
      * Utility function for writing to files. Can be used to control
      * sensor driver parameters (setting to powersave mode etc.)
@@ -258,6 +268,7 @@ private:
     bool m_doSeek;           /**< should lseek() be performed after reading */
     QList<int> m_sysfsDescriptors; /**< List of open file descriptors. */
     QMutex m_mutex;          /**< mutex protecting starting and stopping. */
+    QMetaObject::Connection m_intervalSubscription; /**< default interval config subscription */
 
     friend class SysfsAdaptorReader;
 };
@@ -0,0 +1,288 @@
+/**
+   @file touchtracker.cpp
+   @brief Multi-touch protocol B contact tracking
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "touchtracker.h"
+#include <sys/ioctl.h>
+#include <string.h>
+
+namespace {
+
+struct input_event stateEvent(unsigned int type, unsigned int code, int value)
+{
+    struct input_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    return ev;
+}
+
+}
+
+TouchTracker::TouchTracker(int maxSlots) :
+    slots_(maxSlots),
+    current_(0),
+    multiTouch_(false),
+    dropping_(false),
+    resync_(false),
+    transitions_(false),
+    changed_(0)
+{
+}
+
+void TouchTracker::reset()
+{
+    slots_.fill(Slot());
+    current_ = 0;
+    dropping_ = false;
+    resync_ = false;
+    transitions_ = false;
+    changed_ = 0;
+}
+
+void TouchTracker::setValue(int Slot::*field, int value)
+{
+    if (current_ < 0 || current_ >= slots_.size()) {
+        return;
+    }
+    Slot& slot = slots_[current_];
+    if (slot.*field != value) {
+        slot.*field = value;
+        slot.pending = true;
+    }
+}
+
+void TouchTracker::setTrackingId(int value)
+{
+    if (current_ < 0 || current_ >= slots_.size()) {
+        return;
+    }
+    Slot& slot = slots_[current_];
+    if ((slot.trackingId < 0) != (value < 0)) {
+        transitions_ = true;
+    }
+    setValue(&Slot::trackingId, value);
+}
+
+void TouchTracker::handleEvent(const struct input_event& ev)
+{
+    if (ev.type == EV_SYN) {
+        if (ev.code == SYN_DROPPED) {
+            dropping_ = true;
+        } else if (ev.code == SYN_REPORT) {
+            if (dropping_) {
+                dropping_ = false;
+                resync_ = true;
+                return;
+            }
+            sync();
+        }
+        return;
+    }
+    if (dropping_) {
+        return;
+    }
+
+    if (ev.type == EV_ABS) {
+        switch (ev.code) {
+        case ABS_MT_SLOT:
+            multiTouch_ = true;
+            current_ = ev.value;
+            return;
+        case ABS_MT_TRACKING_ID:
+            multiTouch_ = true;
+            setTrackingId(ev.value);
+            return;
+        case ABS_MT_POSITION_X:
+            multiTouch_ = true;
+            setValue(&Slot::x, ev.value);
+            return;
+        case ABS_MT_POSITION_Y:
+            multiTouch_ = true;
+            setValue(&Slot::y, ev.value);
+            return;
+        case ABS_MT_PRESSURE:
+            multiTouch_ = true;
+            setValue(&Slot::z, ev.value);
+            return;
+        }
+    }
+
+    // Single touch events duplicate slot data on multi-touch devices
+    if (multiTouch_) {
+        return;
+    }
+    current_ = 0;
+    switch (ev.type) {
+    case EV_ABS:
+        switch (ev.code) {
+        case ABS_X:
+            setValue(&Slot::x, ev.value);
+            break;
+        case ABS_Y:
+            setValue(&Slot::y, ev.value);
+            break;
+        case ABS_Z:
+        case ABS_PRESSURE:
+            setValue(&Slot::z, ev.value);
+            break;
+        }
+        break;
+    case EV_KEY:
+        switch (ev.code) {
+        case BTN_TOUCH:
+            setTrackingId(ev.value ? 0 : -1);
+            if (!ev.value) {
+                slots_[0].inaccurate = false;
+            }
+            break;
+        case BTN_MODE:
+            if (ev.value && !slots_[0].inaccurate) {
+                slots_[0].inaccurate = true;
+                slots_[0].pending = true;
+            }
+            break;
+        }
+        break;
+    }
+}
+
+void TouchTracker::sync()
+{
+    for (int i = 0; i < slots_.size(); ++i) {
+        Slot& slot = slots_[i];
+        if (!slot.pending) {
+            continue;
+        }
+        slot.pending = false;
+        // Motion of a released slot is not a change
+        if (slot.trackingId < 0 && !slot.reported) {
+            continue;
+        }
+        if (!slot.dirty) {
+            slot.dirty = true;
+            ++changed_;
+        }
+    }
+}
+
+bool TouchTracker::resync(int fd)
+{
+    QVector<struct input_event> state;
+    bool ok = fd >= 0;
+    if (ok && multiTouch_) {
+        static const unsigned int codes[] = {
+            ABS_MT_TRACKING_ID, ABS_MT_POSITION_X, ABS_MT_POSITION_Y, ABS_MT_PRESSURE
+        };
+        const int count = slots_.size();
+        QVector<__s32> request(count + 1);
+        QVector<QVector<__s32> > values;
+        for (unsigned int i = 0; i < sizeof(codes) / sizeof(codes[0]); ++i) {
+            request.fill(0);
+            request[0] = codes[i];
+            if (ioctl(fd, EVIOCGMTSLOTS(request.size() * sizeof(__s32)), request.data()) < 0) {
+                // Without tracking IDs nothing can be restored
+                ok = i > 0;
+                break;
+            }
+            values.append(request.mid(1));
+        }
+        struct input_absinfo slot;
+        if (ok && ioctl(fd, EVIOCGABS(ABS_MT_SLOT), &slot) < 0) {
+            ok = false;
+        }
+        if (ok) {
+            for (int s = 0; s < count; ++s) {
+                state.append(stateEvent(EV_ABS, ABS_MT_SLOT, s));
+                for (int i = 0; i < values.size(); ++i) {
+                    state.append(stateEvent(EV_ABS, codes[i], values.at(i).at(s)));
+                }
+            }
+            state.append(stateEvent(EV_ABS, ABS_MT_SLOT, slot.value));
+        }
+    } else if (ok) {
+        unsigned char keys[KEY_MAX / 8 + 1];
+        memset(keys, 0, sizeof(keys));
+        ok = ioctl(fd, EVIOCGKEY(sizeof(keys)), keys) >= 0;
+        if (ok) {
+            static const unsigned int codes[] = { ABS_X, ABS_Y, ABS_PRESSURE };
+            for (unsigned int i = 0; i < sizeof(codes) / sizeof(codes[0]); ++i) {
+                struct input_absinfo info;
+                if (ioctl(fd, EVIOCGABS(codes[i]), &info) == 0) {
+                    state.append(stateEvent(EV_ABS, codes[i], info.value));
+                }
+            }
+            state.append(stateEvent(EV_KEY, BTN_TOUCH, (keys[BTN_TOUCH / 8] >> (BTN_TOUCH % 8)) & 1));
+        }
+    }
+
+    if (!ok) {
+        // Releasing is better than leaving a contact present forever
+        state.clear();
+        if (multiTouch_) {
+            for (int s = 0; s < slots_.size(); ++s) {
+                state.append(stateEvent(EV_ABS, ABS_MT_SLOT, s));
+                state.append(stateEvent(EV_ABS, ABS_MT_TRACKING_ID, -1));
+            }
+            state.append(stateEvent(EV_ABS, ABS_MT_SLOT, current_));
+        } else {
+            state.append(stateEvent(EV_KEY, BTN_TOUCH, 0));
+        }
+    }
+    state.append(stateEvent(EV_SYN, SYN_REPORT, 0));
+    resync(state);
+    return ok;
+}
+
+void TouchTracker::resync(const QVector<struct input_event>& state)
+{
+    resync_ = false;
+    dropping_ = false;
+    foreach (const struct input_event& ev, state) {
+        handleEvent(ev);
+    }
+}
+
+QVector<TouchData> TouchTracker::takeChanges(quint64 timestamp, int object)
+{
+    QVector<TouchData> changes;
+    changes.reserve(changed_);
+    for (int i = 0; i < slots_.size(); ++i) {
+        Slot& slot = slots_[i];
+        if (!slot.dirty) {
+            continue;
+        }
+        slot.dirty = false;
+
+        TouchData::FingerState state = TouchData::FingerStateNotPresent;
+        if (slot.trackingId >= 0) {
+            state = slot.inaccurate ? TouchData::FingerStateInaccurate : TouchData::FingerStateAccurate;
+        } else if (!slot.reported) {
+            // Pressed and released between two takes
+            continue;
+        }
+        slot.reported = slot.trackingId >= 0;
+        changes.append(TouchData(TimedXyzData(timestamp, slot.x, slot.y, slot.z), object, state, i));
+    }
+    changed_ = 0;
+    transitions_ = false;
+    return changes;
+}
@@ -0,0 +1,144 @@
+/**
+   @file touchtracker.h
+   @brief Multi-touch protocol B contact tracking
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef TOUCHTRACKER_H
+#define TOUCHTRACKER_H
+
+#include <QVector>
+#include <linux/input.h>
+#include "datatypes/touchdata.h"
+
+/**
+ * Tracks the contacts of a touch device from its input events.
+ *
+ * Multi-touch devices are tracked with protocol B: \c ABS_MT_SLOT selects
+ * the slot following \c ABS_MT_* events apply to, and
+ * \c ABS_MT_TRACKING_ID assigns a contact to a slot or, with -1, releases
+ * it. Devices without \c ABS_MT_* events are tracked as a single contact
+ * from \c ABS_X, \c ABS_Y, \c ABS_PRESSURE and \c BTN_TOUCH.
+ *
+ * Events update the slots directly, and sync() closes a frame on
+ * \c SYN_REPORT. Contacts changed by any frame since the last call to
+ * takeChanges() are returned by it, so several frames can be coalesced
+ * into one set of changes. Each contact is reported with its slot as
+ * TouchData::slot_, and a released contact once with
+ * TouchData::FingerStateNotPresent.
+ *
+ * After \c SYN_DROPPED events are ignored up to the next \c SYN_REPORT,
+ * as required by the protocol, and the contacts must then be read back
+ * from the device with resync().
+ */
+class TouchTracker
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param maxSlots Number of tracked slots. Events for higher slots
+     *                 are ignored.
+     */
+    TouchTracker(int maxSlots = 10);
+
+    /**
+     * Forget all contacts.
+     */
+    void reset();
+
+    /**
+     * Apply an input event to the tracked contacts.
+     *
+     * @param ev Input event.
+     */
+    void handleEvent(const struct input_event& ev);
+
+    /**
+     * Are there changes not yet taken.
+     */
+    bool hasChanges() const { return changed_ > 0; }
+
+    /**
+     * Has any contact been pressed or released since last takeChanges().
+     * Such changes should not be held back for coalescing.
+     */
+    bool hasTransitions() const { return transitions_; }
+
+    /**
+     * Have events been dropped, so that contacts must be read back from
+     * the device with resync().
+     */
+    bool needsResync() const { return resync_; }
+
+    /**
+     * Read the contacts from the device, with \c EVIOCGMTSLOTS or, for
+     * single touch devices, \c EVIOCGABS and \c EVIOCGKEY, and apply
+     * them as one frame. If the device can not be read, all contacts
+     * are released so that none is left stuck.
+     *
+     * @param fd Open device file descriptor.
+     * @return was the device state read.
+     */
+    bool resync(int fd);
+
+    /**
+     * Apply a snapshot of the device state as one frame.
+     *
+     * @param state Events describing the state, ending with \c SYN_REPORT.
+     */
+    void resync(const QVector<struct input_event>& state);
+
+    /**
+     * Take contacts changed since last call.
+     *
+     * @param timestamp Timestamp for the reported contacts.
+     * @param object Event source reported as TouchData::object_.
+     * @return Changed contacts, by slot.
+     */
+    QVector<TouchData> takeChanges(quint64 timestamp, int object = 0);
+
+private:
+    struct Slot {
+        Slot() : trackingId(-1), x(0), y(0), z(0), inaccurate(false),
+                 reported(false), pending(false), dirty(false) {}
+
+        int trackingId;  /**< contact in slot, -1 for none */
+        int x;
+        int y;
+        int z;
+        bool inaccurate; /**< coordinates may be mirrored (BTN_MODE) */
+        bool reported;   /**< contact was reported as present */
+        bool pending;    /**< changed in current frame */
+        bool dirty;      /**< changed since last takeChanges() */
+    };
+
+    void sync();
+    void setValue(int Slot::*field, int value);
+    void setTrackingId(int value);
+
+    QVector<Slot> slots_;
+    int current_;      /**< slot selected with ABS_MT_SLOT */
+    bool multiTouch_;  /**< device sends ABS_MT_* events */
+    bool dropping_;    /**< ignoring events after SYN_DROPPED */
+    bool resync_;      /**< events were dropped, state must be read back */
+    bool transitions_;
+    int changed_;
+};
+
+#endif // TOUCHTRACKER_H
@@ -0,0 +1,80 @@
+/**
+   @file attitudedata.h
+   @brief Datatype for device attitude as a unit quaternion
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef ATTITUDEDATA_H
+#define ATTITUDEDATA_H
+
+#include <datatypes/genericdata.h>
+
+/**
+ * @brief Datatype for device attitude.
+ *
+ * Unit quaternion rotating vectors from the device frame to the world
+ * frame, where x points east, y north and z up. The equivalent rotation
+ * matrix is given by toMatrix().
+ */
+class AttitudeData : public TimedData
+{
+public:
+    /**
+     * Default constructor. Creates identity rotation.
+     */
+    AttitudeData() : TimedData(0), w_(1), x_(0), y_(0), z_(0) {}
+
+    /**
+     * Constructor.
+     *
+     * @param timestamp monotonic time (microsec)
+     * @param w scalar part.
+     * @param x x of vector part.
+     * @param y y of vector part.
+     * @param z z of vector part.
+     */
+    AttitudeData(const quint64& timestamp, float w, float x, float y, float z) :
+        TimedData(timestamp), w_(w), x_(x), y_(y), z_(z) {}
+
+    /**
+     * Rotation matrix of the quaternion, row major. Row \c i holds the
+     * device frame components of world axis \c i.
+     *
+     * @param m matrix to fill.
+     */
+    void toMatrix(float m[3][3]) const
+    {
+        m[0][0] = 1 - 2 * (y_ * y_ + z_ * z_);
+        m[0][1] = 2 * (x_ * y_ - w_ * z_);
+        m[0][2] = 2 * (x_ * z_ + w_ * y_);
+        m[1][0] = 2 * (x_ * y_ + w_ * z_);
+        m[1][1] = 1 - 2 * (x_ * x_ + z_ * z_);
+        m[1][2] = 2 * (y_ * z_ - w_ * x_);
+        m[2][0] = 2 * (x_ * z_ - w_ * y_);
+        m[2][1] = 2 * (y_ * z_ + w_ * x_);
+        m[2][2] = 1 - 2 * (x_ * x_ + y_ * y_);
+    }
+
+    float w_; /**< scalar part */
+    float x_; /**< x of vector part */
+    float y_; /**< y of vector part */
+    float z_; /**< z of vector part */
+};
+Q_DECLARE_METATYPE(AttitudeData)
+
+#endif // ATTITUDEDATA_H
@@ -0,0 +1,102 @@
+/**
+   @file clockoffsets.cpp
+   @brief Readings of the system clocks taken at one instant
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "clockoffsets.h"
+
+#include <time.h>
+
+/**
+ * How many times the clocks are read to find the tightest bracket.
+ */
+static const int SAMPLE_ATTEMPTS = 3;
+
+static quint64 readClock(clockid_t clock)
+{
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return (quint64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+ClockOffsets ClockOffsets::sample()
+{
+    ClockOffsets best;
+    quint64 bestWidth = 0;
+
+    // Preemption between the readings would skew the offsets, so keep
+    // the attempt with the shortest monotonic bracket
+    for (int i = 0; i < SAMPLE_ATTEMPTS; ++i) {
+        quint64 before = readClock(CLOCK_MONOTONIC);
+        quint64 boottime = readClock(CLOCK_BOOTTIME);
+        quint64 realtime = readClock(CLOCK_REALTIME);
+        quint64 after = readClock(CLOCK_MONOTONIC);
+
+        quint64 width = after - before;
+        if (i == 0 || width < bestWidth) {
+            bestWidth = width;
+            best.monotonic_ = before + width / 2;
+            best.boottime_ = boottime;
+            best.realtime_ = realtime;
+            best.uncertainty_ = qMin<quint64>((width + 1) / 2, 0xffffffffULL);
+        }
+    }
+    return best;
+}
+
+bool ClockOffsets::clockByName(const QString& name, Clock& clock)
+{
+    if (name == "monotonic") {
+        clock = Monotonic;
+    } else if (name == "boottime") {
+        clock = Boottime;
+    } else if (name == "realtime") {
+        clock = Realtime;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+quint64 ClockOffsets::reading(Clock clock) const
+{
+    switch (clock) {
+    case Monotonic: return monotonic_;
+    case Boottime:  return boottime_;
+    case Realtime:  return realtime_;
+    }
+    return monotonic_;
+}
+
+qint64 ClockOffsets::offset(Clock from, Clock to) const
+{
+    return (qint64)(reading(to) - reading(from));
+}
+
+quint64 ClockOffsets::convert(quint64 timestamp, Clock from, Clock to) const
+{
+    if (from == to) {
+        return timestamp;
+    }
+    qint64 ns = (qint64)timestamp * 1000 + offset(from, to);
+    if (ns <= 0) {
+        return 0;
+    }
+    return (ns + 500) / 1000;
+}
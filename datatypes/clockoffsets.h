@@ -0,0 +1,130 @@
+/**
+   @file clockoffsets.h
+   @brief Readings of the system clocks taken at one instant
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef CLOCKOFFSETS_H
+#define CLOCKOFFSETS_H
+
+#include <QtGlobal>
+#include <QString>
+
+/**
+ * @brief Readings of CLOCK_MONOTONIC, CLOCK_BOOTTIME and CLOCK_REALTIME
+ *        taken at one instant.
+ *
+ * Sample timestamps are in microseconds of the time base of the sensor,
+ * usually the monotonic clock. With a recent ClockOffsets a client can
+ * map them to another clock with convert(), without reading the clocks
+ * itself for every sample.
+ *
+ * The boottime and realtime readings are taken between two monotonic
+ * readings and paired with their midpoint; uncertainty_ is half the
+ * distance of the two. Boottime drifts from monotonic only across
+ * suspend, realtime also when the wall clock is set or slewed, so
+ * offsets need to be refreshed now and then.
+ *
+ * Sessions which enable clock sync receive these in their data stream,
+ * see SocketHandler::setClockSync(). Readings sent ahead of the first
+ * sample after a gap in the data, such as a system suspend, have a
+ * nonzero gap_. Samples before and after such readings are not
+ * continuous, even if their timestamps are close.
+ */
+class ClockOffsets
+{
+public:
+    /**
+     * Clock domains.
+     */
+    enum Clock
+    {
+        Monotonic = 0, /**< CLOCK_MONOTONIC */
+        Boottime,      /**< CLOCK_BOOTTIME */
+        Realtime       /**< CLOCK_REALTIME */
+    };
+
+    /**
+     * Value of the sample count of a data stream frame which carries a
+     * ClockOffsets instead of samples.
+     */
+    static const unsigned int FrameTag = 0xffffffff;
+
+    /**
+     * Default constructor. Creates invalid readings.
+     */
+    ClockOffsets() : monotonic_(0), boottime_(0), realtime_(0), gap_(0), uncertainty_(0) {}
+
+    /**
+     * Read the clocks now.
+     *
+     * @return readings.
+     */
+    static ClockOffsets sample();
+
+    /**
+     * Clock by its time base name, as in
+     * AbstractSensorChannel::timeBase().
+     *
+     * @param name \c monotonic, \c boottime or \c realtime.
+     * @param clock set to the clock.
+     * @return was name known.
+     */
+    static bool clockByName(const QString& name, Clock& clock);
+
+    /**
+     * Are there readings.
+     */
+    bool isValid() const { return monotonic_ != 0; }
+
+    /**
+     * Reading of a clock.
+     *
+     * @param clock clock.
+     * @return reading (nanosec).
+     */
+    quint64 reading(Clock clock) const;
+
+    /**
+     * Offset to add to a time of one clock to get the time of another.
+     *
+     * @param from clock converted from.
+     * @param to clock converted to.
+     * @return offset (nanosec).
+     */
+    qint64 offset(Clock from, Clock to) const;
+
+    /**
+     * Convert a timestamp between clocks.
+     *
+     * @param timestamp time of clock \c from (microsec).
+     * @param from clock converted from.
+     * @param to clock converted to.
+     * @return time of clock \c to (microsec), rounded to the nearest
+     *         microsecond and clamped to zero.
+     */
+    quint64 convert(quint64 timestamp, Clock from, Clock to) const;
+
+    quint64 monotonic_;   /**< CLOCK_MONOTONIC reading (nanosec) */
+    quint64 boottime_;    /**< CLOCK_BOOTTIME reading (nanosec) */
+    quint64 realtime_;    /**< CLOCK_REALTIME reading (nanosec) */
+    quint64 gap_;         /**< length of the gap these readings mark, zero if none (microsec) */
+    quint32 uncertainty_; /**< how far readings may be apart (nanosec) */
+};
+
+#endif // CLOCKOFFSETS_H
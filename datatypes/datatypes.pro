@@ -25,7 +25,12 @@ HEADERS += xyz.h \
     touchdata.h \
     proximity.h \
     lid.h \
-    liddata.h
+    liddata.h \
+    environmentdata.h \
+    posturedata.h \
+    attitudedata.h \
+    clockoffsets.h \
+    sampleschema.h
 
 SOURCES += xyz.cpp \
     orientation.cpp \
@@ -33,7 +38,9 @@ SOURCES += xyz.cpp \
     compass.cpp \
     utils.cpp \
     tap.cpp \
-    lid.cpp
+    lid.cpp \
+    clockoffsets.cpp \
+    sampleschema.cpp
 
 include(../common-install.pri)
 publicheaders.path  = $${publicheaders.path}/datatypes
@@ -0,0 +1,60 @@
+/**
+   @file environmentdata.h
+   @brief Datatype for combined temperature and humidity measurements
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef ENVIRONMENTDATA_H
+#define ENVIRONMENTDATA_H
+
+#include <datatypes/genericdata.h>
+
+/**
+ * @brief Datatype for ambient conditions and values derived from them.
+ *
+ * Temperatures are in degrees Celsius, humidity is relative humidity
+ * in percent.
+ */
+class EnvironmentData : public TimedData
+{
+public:
+    /**
+     * Default constructor.
+     */
+    EnvironmentData() : TimedData(0), temperature_(0), humidity_(0), dewPoint_(0), heatIndex_(0) {}
+
+    /**
+     * Constructor.
+     *
+     * @param timestamp monotonic time (microsec)
+     * @param temperature ambient temperature.
+     * @param humidity relative humidity.
+     * @param dewPoint dew point temperature.
+     * @param heatIndex apparent temperature.
+     */
+    EnvironmentData(const quint64& timestamp, float temperature, float humidity, float dewPoint, float heatIndex) :
+        TimedData(timestamp), temperature_(temperature), humidity_(humidity), dewPoint_(dewPoint), heatIndex_(heatIndex) {}
+
+    float temperature_; /**< ambient temperature */
+    float humidity_;    /**< relative humidity */
+    float dewPoint_;    /**< dew point */
+    float heatIndex_;   /**< heat index */
+};
+Q_DECLARE_METATYPE(EnvironmentData)
+
+#endif // ENVIRONMENTDATA_H
@@ -0,0 +1,71 @@
+/**
+   @file posturedata.h
+   @brief Datatype for device posture
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef POSTUREDATA_H
+#define POSTUREDATA_H
+
+#include <datatypes/genericdata.h>
+
+/**
+ * @brief Datatype for the posture of a device with a hinge, such as a
+ *        convertible laptop.
+ *
+ * Hinge angle is the opening angle between base and lid in degrees:
+ * 0 when closed, 180 when opened flat and up to 360 when the lid is
+ * folded back against the base.
+ */
+class PostureData : public TimedData
+{
+public:
+    /**
+     * Posture of the device.
+     */
+    enum Posture
+    {
+        Unknown = 0, /**< Posture not known yet. */
+        Closed,      /**< Lid closed on the base. */
+        Laptop,      /**< Lid opened up to flat. */
+        Flat,        /**< Lid and base on the same plane. */
+        Tent,        /**< Lid folded back, device standing on its edges. */
+        Tablet       /**< Lid folded back against the base. */
+    };
+
+    /**
+     * Default constructor.
+     */
+    PostureData() : TimedData(0), posture_(Unknown), angle_(0) {}
+
+    /**
+     * Constructor.
+     *
+     * @param timestamp monotonic time (microsec)
+     * @param posture device posture.
+     * @param angle hinge angle in degrees.
+     */
+    PostureData(const quint64& timestamp, Posture posture, float angle) :
+        TimedData(timestamp), posture_(posture), angle_(angle) {}
+
+    Posture posture_; /**< device posture */
+    float angle_;     /**< hinge angle */
+};
+Q_DECLARE_METATYPE(PostureData)
+
+#endif // POSTUREDATA_H
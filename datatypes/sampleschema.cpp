@@ -0,0 +1,177 @@
+/**
+   @file sampleschema.cpp
+   @brief Field layout descriptions of sample datatypes
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "sampleschema.h"
+#include "genericdata.h"
+#include "timedunsigned.h"
+#include "orientationdata.h"
+#include "posedata.h"
+#include "tapdata.h"
+#include "liddata.h"
+#include "posturedata.h"
+#include "environmentdata.h"
+#include "attitudedata.h"
+#include "clockoffsets.h"
+
+#include <QStringList>
+
+SampleSchema::SampleSchema(const char* name, int size, const Field* fields, int fieldCount) :
+    name_(name),
+    size_(size),
+    fields_(fields),
+    fieldCount_(fieldCount),
+    packedSize_(0)
+{
+    for (int i = 0; i < fieldCount_; ++i) {
+        packedSize_ += typeSize(fields_[i].type);
+    }
+}
+
+QString SampleSchema::describe() const
+{
+    QStringList parts;
+    parts << name_;
+    for (int i = 0; i < fieldCount_; ++i) {
+        parts << QString("%1:%2").arg(fields_[i].name).arg(typeName(fields_[i].type));
+    }
+    return parts.join(" ");
+}
+
+int SampleSchema::typeSize(FieldType type)
+{
+    switch (type) {
+    case UInt64: return 8;
+    case Int32:  return 4;
+    case UInt32: return 4;
+    case Float:  return 4;
+    case Bool:   return 1;
+    }
+    return 0;
+}
+
+const char* SampleSchema::typeName(FieldType type)
+{
+    switch (type) {
+    case UInt64: return "u64";
+    case Int32:  return "i32";
+    case UInt32: return "u32";
+    case Float:  return "f32";
+    case Bool:   return "bool";
+    }
+    return "";
+}
+
+/**
+ * Offset of a member in T, which may be declared in a base class of T.
+ */
+template<class T, class B, class M>
+static int fieldOffset(M B::*member)
+{
+    static union {
+        char bytes[sizeof(T)];
+        quint64 align;
+    } storage;
+    const T* sample = reinterpret_cast<const T*>(storage.bytes);
+    return reinterpret_cast<const char*>(&(sample->*member)) - storage.bytes;
+}
+
+#define SCHEMA_FIELD(TYPE, NAME, MEMBER, FIELDTYPE) \
+    { NAME, SampleSchema::FIELDTYPE, fieldOffset<TYPE>(&TYPE::MEMBER) }
+
+#define DEFINE_SAMPLE_SCHEMA(TYPE, ...) \
+    template<> const SampleSchema* sampleSchema<TYPE>() \
+    { \
+        static const SampleSchema::Field fields[] = { __VA_ARGS__ }; \
+        static const SampleSchema schema(#TYPE, sizeof(TYPE), fields, sizeof(fields) / sizeof(fields[0])); \
+        return &schema; \
+    }
+
+DEFINE_SAMPLE_SCHEMA(TimedXyzData,
+    SCHEMA_FIELD(TimedXyzData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(TimedXyzData, "x", x_, Float),
+    SCHEMA_FIELD(TimedXyzData, "y", y_, Float),
+    SCHEMA_FIELD(TimedXyzData, "z", z_, Float))
+
+DEFINE_SAMPLE_SCHEMA(TimedUnsigned,
+    SCHEMA_FIELD(TimedUnsigned, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(TimedUnsigned, "value", value_, UInt32))
+
+DEFINE_SAMPLE_SCHEMA(CalibratedMagneticFieldData,
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "x", x_, Int32),
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "y", y_, Int32),
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "z", z_, Int32),
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "rx", rx_, Int32),
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "ry", ry_, Int32),
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "rz", rz_, Int32),
+    SCHEMA_FIELD(CalibratedMagneticFieldData, "level", level_, Int32))
+
+DEFINE_SAMPLE_SCHEMA(CompassData,
+    SCHEMA_FIELD(CompassData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(CompassData, "degrees", degrees_, Int32),
+    SCHEMA_FIELD(CompassData, "rawDegrees", rawDegrees_, Int32),
+    SCHEMA_FIELD(CompassData, "correctedDegrees", correctedDegrees_, Int32),
+    SCHEMA_FIELD(CompassData, "level", level_, Int32))
+
+DEFINE_SAMPLE_SCHEMA(ProximityData,
+    SCHEMA_FIELD(ProximityData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(ProximityData, "value", value_, UInt32),
+    SCHEMA_FIELD(ProximityData, "withinProximity", withinProximity_, Bool))
+
+DEFINE_SAMPLE_SCHEMA(PoseData,
+    SCHEMA_FIELD(PoseData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(PoseData, "orientation", orientation_, Int32))
+
+DEFINE_SAMPLE_SCHEMA(TapData,
+    SCHEMA_FIELD(TapData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(TapData, "direction", direction_, Int32),
+    SCHEMA_FIELD(TapData, "type", type_, Int32))
+
+DEFINE_SAMPLE_SCHEMA(LidData,
+    SCHEMA_FIELD(LidData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(LidData, "type", type_, Int32),
+    SCHEMA_FIELD(LidData, "value", value_, UInt32))
+
+DEFINE_SAMPLE_SCHEMA(PostureData,
+    SCHEMA_FIELD(PostureData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(PostureData, "posture", posture_, Int32),
+    SCHEMA_FIELD(PostureData, "angle", angle_, Float))
+
+DEFINE_SAMPLE_SCHEMA(EnvironmentData,
+    SCHEMA_FIELD(EnvironmentData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(EnvironmentData, "temperature", temperature_, Float),
+    SCHEMA_FIELD(EnvironmentData, "humidity", humidity_, Float),
+    SCHEMA_FIELD(EnvironmentData, "dewPoint", dewPoint_, Float),
+    SCHEMA_FIELD(EnvironmentData, "heatIndex", heatIndex_, Float))
+
+DEFINE_SAMPLE_SCHEMA(AttitudeData,
+    SCHEMA_FIELD(AttitudeData, "timestamp", timestamp_, UInt64),
+    SCHEMA_FIELD(AttitudeData, "w", w_, Float),
+    SCHEMA_FIELD(AttitudeData, "x", x_, Float),
+    SCHEMA_FIELD(AttitudeData, "y", y_, Float),
+    SCHEMA_FIELD(AttitudeData, "z", z_, Float))
+
+DEFINE_SAMPLE_SCHEMA(ClockOffsets,
+    SCHEMA_FIELD(ClockOffsets, "monotonic", monotonic_, UInt64),
+    SCHEMA_FIELD(ClockOffsets, "boottime", boottime_, UInt64),
+    SCHEMA_FIELD(ClockOffsets, "realtime", realtime_, UInt64),
+    SCHEMA_FIELD(ClockOffsets, "gap", gap_, UInt64),
+    SCHEMA_FIELD(ClockOffsets, "uncertainty", uncertainty_, UInt32))
@@ -0,0 +1,151 @@
+/**
+   @file sampleschema.h
+   @brief Field layout descriptions of sample datatypes
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SAMPLESCHEMA_H
+#define SAMPLESCHEMA_H
+
+#include <QString>
+
+/**
+ * Description of the fields of a sample datatype, used to encode samples
+ * without depending on the in-memory layout of the struct.
+ *
+ * Each datatype written to clients has one static schema, returned by
+ * sampleSchema<T>(). The schema lists the fields in wire order with their
+ * offsets in the struct.
+ */
+class SampleSchema
+{
+public:
+    /**
+     * Wire type of a field.
+     */
+    enum FieldType
+    {
+        UInt64 = 0, /**< 64-bit unsigned integer */
+        Int32,      /**< 32-bit signed integer, also used for enums */
+        UInt32,     /**< 32-bit unsigned integer */
+        Float,      /**< 32-bit IEEE 754 float */
+        Bool        /**< 8-bit boolean */
+    };
+
+    /**
+     * Single field of a datatype.
+     */
+    struct Field
+    {
+        const char* name; /**< field name */
+        FieldType type;   /**< wire type */
+        int offset;       /**< offset in the struct */
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param name Name of the datatype.
+     * @param size Size of the struct.
+     * @param fields Field table, must outlive the schema.
+     * @param fieldCount Number of fields in the table.
+     */
+    SampleSchema(const char* name, int size, const Field* fields, int fieldCount);
+
+    /**
+     * Name of the datatype.
+     */
+    const char* name() const { return name_; }
+
+    /**
+     * Size of the datatype struct.
+     */
+    int size() const { return size_; }
+
+    /**
+     * Number of fields.
+     */
+    int fieldCount() const { return fieldCount_; }
+
+    /**
+     * Field by index.
+     */
+    const Field& field(int i) const { return fields_[i]; }
+
+    /**
+     * Size of a sample with fields packed without padding.
+     */
+    int packedSize() const { return packedSize_; }
+
+    /**
+     * Description of the schema, e.g.
+     * <tt>TimedXyzData timestamp:u64 x:f32 y:f32 z:f32</tt>.
+     */
+    QString describe() const;
+
+    /**
+     * Size of a field type on the wire.
+     */
+    static int typeSize(FieldType type);
+
+    /**
+     * Short name of a field type, as used in describe().
+     */
+    static const char* typeName(FieldType type);
+
+private:
+    const char* name_;
+    int size_;
+    const Field* fields_;
+    int fieldCount_;
+    int packedSize_;
+};
+
+/**
+ * Schema of a sample datatype. Specialized for each datatype which is
+ * written to clients.
+ */
+template<class T> const SampleSchema* sampleSchema();
+
+class TimedXyzData;
+class TimedUnsigned;
+class CalibratedMagneticFieldData;
+class CompassData;
+class ProximityData;
+class PoseData;
+class TapData;
+class LidData;
+class PostureData;
+class EnvironmentData;
+class AttitudeData;
+class ClockOffsets;
+
+template<> const SampleSchema* sampleSchema<TimedXyzData>();
+template<> const SampleSchema* sampleSchema<TimedUnsigned>();
+template<> const SampleSchema* sampleSchema<CalibratedMagneticFieldData>();
+template<> const SampleSchema* sampleSchema<CompassData>();
+template<> const SampleSchema* sampleSchema<ProximityData>();
+template<> const SampleSchema* sampleSchema<PoseData>();
+template<> const SampleSchema* sampleSchema<TapData>();
+template<> const SampleSchema* sampleSchema<LidData>();
+template<> const SampleSchema* sampleSchema<PostureData>();
+template<> const SampleSchema* sampleSchema<EnvironmentData>();
+template<> const SampleSchema* sampleSchema<AttitudeData>();
+template<> const SampleSchema* sampleSchema<ClockOffsets>();
+
+#endif // SAMPLESCHEMA_H
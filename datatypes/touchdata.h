@@ -44,13 +44,14 @@ public:
         FingerStateInaccurate      /**< Coordinates are either accurate or mirrored. */
     };
 
-    int object_;         /**< Touch event source (which finger), 1,2,... */
+    int object_;         /**< Touch event source (which input device) */
     FingerState state_;  /**< Touch event finger state */
+    int slot_;           /**< Contact slot on the source (which finger), 0,1,... */
 
     /**
      * Default Constructor. Initialises all values as zero.
      */
-    TouchData() : TimedXyzData(), object_(0), state_(FingerStateNotPresent) {}
+    TouchData() : TimedXyzData(), object_(0), state_(FingerStateNotPresent), slot_(0) {}
 
     /**
      * Constructor.
@@ -58,9 +59,10 @@ public:
      * @param timedXyzData contained data.
      * @param object event source.
      * @param state event state.
+     * @param slot contact slot on the event source.
      */
-    TouchData(TimedXyzData timedXyzData, int object, FingerState state) :
-        TimedXyzData(timedXyzData), object_(object), state_(state) {}
+    TouchData(TimedXyzData timedXyzData, int object, FingerState state, int slot = 0) :
+        TimedXyzData(timedXyzData), object_(object), state_(state), slot_(slot) {}
 };
 
 #endif // TOUCHDATA_H
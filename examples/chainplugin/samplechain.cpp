@@ -51,7 +51,7 @@ SampleChain::SampleChain(const QString& id) :
     nameOutputBuffer("sampledata", outputBuffer_);
 
     // Create a new bin and add elements into it with names.
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
     filterBin_->add(adaptorReader_, "adaptor");
     filterBin_->add(sampleFilter_, "filter");
     filterBin_->add(outputBuffer_, "output");
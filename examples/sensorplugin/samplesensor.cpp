@@ -44,7 +44,7 @@ SampleSensorChannel::SampleSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<TimedUnsigned>(128);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
     filterBin_->add(chainReader_, "chain");
     filterBin_->add(outputBuffer_, "output");
 
@@ -55,7 +55,7 @@ SampleSensorChannel::SampleSensorChannel(const QString& id) :
     // Connect the 'sampledata' buffer in chain and reader.
     connectToSource(sampleChain_, "sampledata", chainReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
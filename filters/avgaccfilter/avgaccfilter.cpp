@@ -24,12 +24,23 @@
 AvgAccFilter::AvgAccFilter() :
     Filter<TimedXyzData, AvgAccFilter, TimedXyzData>(this, &AvgAccFilter::interpret),
     avgAccdata(0,0,0,0),
-    filterFactor(0.54)
+    filterFactor(0.54),
+    averageX(0),
+    averageY(0),
+    averageZ(0),
+    averageValid(false)
 {
 }
 
 void AvgAccFilter::interpret(unsigned, const TimedXyzData *data)
 {
+    if (!averageValid) {
+        averageX = data->x_;
+        averageY = data->y_;
+        averageZ = data->z_;
+        averageValid = true;
+    }
+
     avgAccdata.x_ = data->x_ * filterFactor + averageX * (1.0f - filterFactor);
     avgAccdata.y_ = data->y_ * filterFactor + averageY * (1.0f - filterFactor);
     avgAccdata.z_ = data->z_ * filterFactor + averageZ * (1.0f - filterFactor);
@@ -53,6 +64,11 @@ void AvgAccFilter::reset()
     avgAccdata.z_ = 0;
 }
 
+void AvgAccFilter::discontinuity()
+{
+    averageValid = false;
+}
+
 void AvgAccFilter::setFactor(qreal f)
 {
     filterFactor = f;
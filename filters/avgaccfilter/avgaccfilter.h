@@ -39,6 +39,11 @@ public:
     void setFactor(qreal);
     qreal factor();
 
+    /**
+     * Restart averaging from the next sample after a gap in the data.
+     */
+    virtual void discontinuity();
+
 private:
 
     AvgAccFilter();
@@ -55,6 +60,7 @@ private:
     qreal averageX;
     qreal averageY;
     qreal averageZ;
+    bool averageValid;
 
     QList<TimedXyzData> avgAccelBuffer;
 
@@ -27,19 +27,25 @@
 #include "coordinatealignfilter.h"
 
 CoordinateAlignFilter::CoordinateAlignFilter() :
-        Filter<TimedXyzData, CoordinateAlignFilter, TimedXyzData>(this, &CoordinateAlignFilter::filter)
+        Filter<TimedXyzData, CoordinateAlignFilter, TimedXyzData>(this, &CoordinateAlignFilter::filter),
+        identity_(true)
 {
 }
 
 void CoordinateAlignFilter::filter(unsigned, const TimedXyzData* data)
 {
-    TimedXyzData transformed;
+    if (identity_) {
+        source_.propagate(1, data);
+        return;
+    }
 
-    transformed.timestamp_ = data->timestamp_;
+    TimedXyzData* transformed = source_.nextSlot();
 
-    transformed.x_ = matrix_.get(0,0)*data->x_ + matrix_.get(0,1)*data->y_ + matrix_.get(0,2)*data->z_;
-    transformed.y_ = matrix_.get(1,0)*data->x_ + matrix_.get(1,1)*data->y_ + matrix_.get(1,2)*data->z_;
-    transformed.z_ = matrix_.get(2,0)*data->x_ + matrix_.get(2,1)*data->y_ + matrix_.get(2,2)*data->z_;
+    transformed->timestamp_ = data->timestamp_;
 
-    source_.propagate(1, &transformed);
+    transformed->x_ = matrix_.get(0,0)*data->x_ + matrix_.get(0,1)*data->y_ + matrix_.get(0,2)*data->z_;
+    transformed->y_ = matrix_.get(1,0)*data->x_ + matrix_.get(1,1)*data->y_ + matrix_.get(1,2)*data->z_;
+    transformed->z_ = matrix_.get(2,0)*data->x_ + matrix_.get(2,1)*data->y_ + matrix_.get(2,2)*data->z_;
+
+    source_.commit();
 }
@@ -29,6 +29,7 @@
 
 #include "datatypes/orientationdata.h"
 #include "filter.h"
+#include "mountmatrix.h"
 
 /**
  * TMatrix holds a transformation matrix.
@@ -44,7 +45,7 @@ public:
     TMatrix(const TMatrix& other) {
         setMatrix(other.data_);
     }
-    TMatrix(double m[][DIM]) {
+    TMatrix(const double m[][DIM]) {
         setMatrix(m);
     }
 
@@ -88,7 +89,7 @@ public:
 
     const TMatrix& matrix() const { return matrix_; }
 
-    void setMatrix(const TMatrix& matrix) { matrix_ = matrix; }
+    void setMatrix(const TMatrix& matrix) { matrix_ = matrix; identity_ = MountMatrix::isIdentity(matrix.data_); }
 
 protected:
     /**
@@ -100,6 +101,7 @@ private:
     void filter(unsigned, const TimedXyzData*);
 
     TMatrix matrix_;
+    bool identity_; /**< matrix is identity, samples pass through */
 };
 
 #endif // COORDINATEALIGNFILTER_H
@@ -36,30 +36,42 @@ const char *DeclinationFilter::s_declinationKey = "/system/osso/location/setting
 DeclinationFilter::DeclinationFilter() :
         Filter<CompassData, DeclinationFilter, CompassData>(this, &DeclinationFilter::correct),
         m_declinationCorrection(0),
-        m_lastUpdate_us(0)
+        m_lastUpdate_us(0),
+        m_reloaded(0)
 {
     // XXX: multiplication order is a bit fishy, but: config = milliseconds, default is 1 hour?
     quint64 updateInterval_ms = SensorFrameworkConfig::configuration()->value<quint64>("compass/declination_update_interval", 1000 * 60 * 60);
     m_updateInterval_us = updateInterval_ms * 1000;
     loadSettings();
+
+    connect(SensorFrameworkConfig::watcher(), SIGNAL(reloaded()), this, SLOT(configReloaded()));
+}
+
+void DeclinationFilter::configReloaded()
+{
+    quint64 updateInterval_ms = SensorFrameworkConfig::configuration()->value<quint64>("compass/declination_update_interval", 1000 * 60 * 60);
+    m_updateInterval_us.store(updateInterval_ms * 1000);
+    m_reloaded.storeRelease(1);
 }
 
 void DeclinationFilter::correct(unsigned, const CompassData* data)
 {
-    CompassData newOrientation(*data);
-    if (newOrientation.timestamp_ - m_lastUpdate_us > m_updateInterval_us) {
+    CompassData* newOrientation = source_.nextSlot();
+    *newOrientation = *data;
+    if (m_reloaded.testAndSetAcquire(1, 0) ||
+        newOrientation->timestamp_ - m_lastUpdate_us > m_updateInterval_us.load()) {
         loadSettings();
-        m_lastUpdate_us = newOrientation.timestamp_;
+        m_lastUpdate_us = newOrientation->timestamp_;
     }
 
-    newOrientation.correctedDegrees_ = newOrientation.degrees_;
+    newOrientation->correctedDegrees_ = newOrientation->degrees_;
     if (m_declinationCorrection.loadAcquire() != 0) {
-        newOrientation.correctedDegrees_ += m_declinationCorrection.loadAcquire();
-        newOrientation.correctedDegrees_ %= 360;
-//        sensordLogT() << "DeclinationFilter corrected degree " << newOrientation.degrees_ << " => " << newOrientation.correctedDegrees_ << ". Level: " << newOrientation.level_;
+        newOrientation->correctedDegrees_ += m_declinationCorrection.loadAcquire();
+        newOrientation->correctedDegrees_ %= 360;
+//        sensordLogT() << "DeclinationFilter corrected degree " << newOrientation->degrees_ << " => " << newOrientation->correctedDegrees_ << ". Level: " << newOrientation->level_;
     }
-    m_orientation = newOrientation;
-    source_.propagate(1, &m_orientation);
+    m_orientation = *newOrientation;
+    source_.commit();
 }
 
 void DeclinationFilter::loadSettings()
@@ -29,6 +29,7 @@
 
 #include <QObject>
 #include <QAtomicInt>
+#include <atomic>
 #include "datatypes/orientationdata.h"
 #include "filter.h"
 
@@ -56,6 +57,14 @@ public:
      */
     int declinationCorrection();
 
+private Q_SLOTS:
+    /**
+     * Apply reloaded configuration. Runs in the main thread; the filter
+     * picks up the new interval and refreshes declination when the next
+     * sample is processed in the adaptor thread.
+     */
+    void configReloaded();
+
 private:
     DeclinationFilter();
 
@@ -66,7 +75,8 @@ private:
     CompassData m_orientation;
     QAtomicInt m_declinationCorrection;
     quint64 m_lastUpdate_us;
-    quint64 m_updateInterval_us;
+    std::atomic<quint64> m_updateInterval_us;
+    QAtomicInt m_reloaded; /**< set on reload, cleared by next sample */
 
     static const char *s_declinationKey;
 };
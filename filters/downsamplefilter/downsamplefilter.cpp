@@ -56,6 +56,11 @@ void DownsampleFilter::setTimeout(int ms)
     sensordLogD() << "DownsampleFilter timeout = " << ms;
 }
 
+void DownsampleFilter::discontinuity()
+{
+    buffer_.clear();
+}
+
 void DownsampleFilter::filter(unsigned, const TimedXyzData* data)
 {
     buffer_.push_back(*data);
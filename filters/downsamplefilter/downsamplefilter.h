@@ -83,6 +83,12 @@ public:
      */
     void setTimeout(int ms);
 
+    /**
+     * Drop buffered samples, which must not be averaged with samples
+     * after a gap in the data.
+     */
+    virtual void discontinuity();
+
 protected:
     /**
      * Constructor.
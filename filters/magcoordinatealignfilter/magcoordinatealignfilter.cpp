@@ -27,25 +27,31 @@
 #include "magcoordinatealignfilter.h"
 
 MagCoordinateAlignFilter::MagCoordinateAlignFilter() :
-        Filter<CalibratedMagneticFieldData, MagCoordinateAlignFilter, CalibratedMagneticFieldData>(this, &MagCoordinateAlignFilter::filter)
+        Filter<CalibratedMagneticFieldData, MagCoordinateAlignFilter, CalibratedMagneticFieldData>(this, &MagCoordinateAlignFilter::filter),
+        identity_(true)
 {
 }
 
 void MagCoordinateAlignFilter::filter(unsigned, const CalibratedMagneticFieldData* data)
 {
-    CalibratedMagneticFieldData transformed;
+    if (identity_) {
+        source_.propagate(1, data);
+        return;
+    }
 
-    transformed.timestamp_ = data->timestamp_;
+    CalibratedMagneticFieldData* transformed = source_.nextSlot();
 
-    transformed.x_ = matrix_.get(0,0)*data->x_ + matrix_.get(0,1)*data->y_ + matrix_.get(0,2)*data->z_;
-    transformed.y_ = matrix_.get(1,0)*data->x_ + matrix_.get(1,1)*data->y_ + matrix_.get(1,2)*data->z_;
-    transformed.z_ = matrix_.get(2,0)*data->x_ + matrix_.get(2,1)*data->y_ + matrix_.get(2,2)*data->z_;
+    transformed->timestamp_ = data->timestamp_;
 
-    transformed.rx_ = matrix_.get(0,0)*data->rx_ + matrix_.get(0,1)*data->ry_ + matrix_.get(0,2)*data->rz_;
-    transformed.ry_ = matrix_.get(1,0)*data->rx_ + matrix_.get(1,1)*data->ry_ + matrix_.get(1,2)*data->rz_;
-    transformed.rz_ = matrix_.get(2,0)*data->rx_ + matrix_.get(2,1)*data->ry_ + matrix_.get(2,2)*data->rz_;
+    transformed->x_ = matrix_.get(0,0)*data->x_ + matrix_.get(0,1)*data->y_ + matrix_.get(0,2)*data->z_;
+    transformed->y_ = matrix_.get(1,0)*data->x_ + matrix_.get(1,1)*data->y_ + matrix_.get(1,2)*data->z_;
+    transformed->z_ = matrix_.get(2,0)*data->x_ + matrix_.get(2,1)*data->y_ + matrix_.get(2,2)*data->z_;
 
-    transformed.level_ = data->level_;
+    transformed->rx_ = matrix_.get(0,0)*data->rx_ + matrix_.get(0,1)*data->ry_ + matrix_.get(0,2)*data->rz_;
+    transformed->ry_ = matrix_.get(1,0)*data->rx_ + matrix_.get(1,1)*data->ry_ + matrix_.get(1,2)*data->rz_;
+    transformed->rz_ = matrix_.get(2,0)*data->rx_ + matrix_.get(2,1)*data->ry_ + matrix_.get(2,2)*data->rz_;
 
-    source_.propagate(1, &transformed);
+    transformed->level_ = data->level_;
+
+    source_.commit();
 }
@@ -29,6 +29,7 @@
 
 #include "datatypes/orientationdata.h"
 #include "filter.h"
+#include "mountmatrix.h"
 
 /**
  * TMagMatrix holds a transformation matrix.
@@ -44,7 +45,7 @@ public:
     TMagMatrix(const TMagMatrix& other) {
         setMatrix(other.data_);
     }
-    TMagMatrix(double m[][DIM]) {
+    TMagMatrix(const double m[][DIM]) {
         setMatrix(m);
     }
 
@@ -88,7 +89,7 @@ public:
 
     const TMagMatrix& matrix() const { return matrix_; }
 
-    void setMatrix(const TMagMatrix& matrix) { matrix_ = matrix; }
+    void setMatrix(const TMagMatrix& matrix) { matrix_ = matrix; identity_ = MountMatrix::isIdentity(matrix.data_); }
 
 protected:
     /**
@@ -100,6 +101,7 @@ private:
     void filter(unsigned, const CalibratedMagneticFieldData*);
 
     TMagMatrix matrix_;
+    bool identity_; /**< matrix is identity, samples pass through */
 };
 
 #endif // MagCoordinateAlignFilter_H
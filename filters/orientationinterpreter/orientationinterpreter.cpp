@@ -42,22 +42,33 @@ const int OrientationInterpreter::THRESHOLD_LANDSCAPE = 25;
 const int OrientationInterpreter::THRESHOLD_PORTRAIT = 20;
 const int OrientationInterpreter::DISCARD_TIME = 750000;
 const int OrientationInterpreter::AVG_BUFFER_MAX_SIZE = 10;
-const char* OrientationInterpreter::CPU_BOOST_PATH = "/sys/power/pm_optimizer_rotation";
+const int OrientationInterpreter::DECISION_WINDOW = 0;
+const int OrientationInterpreter::SETTLE_TIME = 0;
+const int OrientationInterpreter::MIN_CONFIDENCE = 50;
+const int OrientationInterpreter::MOTION_VETO_RATE = 0;
+const int OrientationInterpreter::MOTION_HOLD_TIME = 200000;
 typedef PoseData (OrientationInterpreter::*ptrFUN)(int);
 
 OrientationInterpreter::OrientationInterpreter() :
         accDataSink(this, &OrientationInterpreter::accDataAvailable),
+        gyroDataSink(this, &OrientationInterpreter::gyroDataAvailable),
         topEdge(PoseData::Undefined),
         face(PoseData::Undefined),
         previousFace(PoseData::Undefined),
         orientationData(PoseData::Undefined),
-        cpuBoostFile(CPU_BOOST_PATH)
-
+        pendingTopEdge(PoseData::Undefined),
+        pendingSince(0),
+        hintSent(false),
+        confidenceValue(0),
+        lastMotion(0)
 {
     addSink(&accDataSink, "accsink");
+    addSink(&gyroDataSink, "gyrosink");
     addSource(&topEdgeSource, "topedge");
     addSource(&faceSource, "face");
     addSource(&orientationSource, "orientation");
+    addSource(&rotationHintSource, "rotationhint");
+    addSource(&confidenceSource, "confidence");
 
     minLimit = SensorFrameworkConfig::configuration()->value("orientation/overflow_min", QVariant(OVERFLOW_MIN)).toInt();
     maxLimit = SensorFrameworkConfig::configuration()->value("orientation/overflow_max", QVariant(OVERFLOW_MAX)).toInt();
@@ -66,11 +77,71 @@ OrientationInterpreter::OrientationInterpreter() :
     angleThresholdLandscape = SensorFrameworkConfig::configuration()->value("orientation/threshold_landscape",QVariant(THRESHOLD_LANDSCAPE)).toInt();
     discardTime = SensorFrameworkConfig::configuration()->value("orientation/discard_time", QVariant(DISCARD_TIME)).toUInt();
     maxBufferSize = SensorFrameworkConfig::configuration()->value("orientation/buffer_size", QVariant(AVG_BUFFER_MAX_SIZE)).toInt();
+    decisionWindow = SensorFrameworkConfig::configuration()->value("orientation/decision_window", QVariant(DECISION_WINDOW)).toUInt();
+    settleTime = SensorFrameworkConfig::configuration()->value("orientation/settle_time", QVariant(SETTLE_TIME)).toUInt();
+    minConfidence = SensorFrameworkConfig::configuration()->value("orientation/min_confidence", QVariant(MIN_CONFIDENCE)).toInt();
+    motionVetoRate = SensorFrameworkConfig::configuration()->value("orientation/motion_veto_rate", QVariant(MOTION_VETO_RATE)).toInt();
+    motionHoldTime = SensorFrameworkConfig::configuration()->value("orientation/motion_hold_time", QVariant(MOTION_HOLD_TIME)).toUInt();
+
+    // Reloaded values are stored from the main thread while samples are
+    // processed in the adaptor thread; each sample loads them once
+    SensorFrameworkConfig::bind<int>("orientation/overflow_min", OVERFLOW_MIN, this, &minLimit);
+    SensorFrameworkConfig::bind<int>("orientation/overflow_max", OVERFLOW_MAX, this, &maxLimit);
+    SensorFrameworkConfig::bind<int>("orientation/threshold_portrait", THRESHOLD_PORTRAIT, this, &angleThresholdPortrait);
+    SensorFrameworkConfig::bind<int>("orientation/threshold_landscape", THRESHOLD_LANDSCAPE, this, &angleThresholdLandscape);
+    SensorFrameworkConfig::bind<unsigned long>("orientation/discard_time", DISCARD_TIME, this, &discardTime);
+    SensorFrameworkConfig::bind<int>("orientation/buffer_size", AVG_BUFFER_MAX_SIZE, this, &maxBufferSize);
+    SensorFrameworkConfig::bind<unsigned long>("orientation/decision_window", DECISION_WINDOW, this, &decisionWindow);
+    SensorFrameworkConfig::bind<unsigned long>("orientation/settle_time", SETTLE_TIME, this, &settleTime);
+    SensorFrameworkConfig::bind<int>("orientation/min_confidence", MIN_CONFIDENCE, this, &minConfidence);
+    SensorFrameworkConfig::bind<int>("orientation/motion_veto_rate", MOTION_VETO_RATE, this, &motionVetoRate);
+    SensorFrameworkConfig::bind<unsigned long>("orientation/motion_hold_time", MOTION_HOLD_TIME, this, &motionHoldTime);
+}
 
-    // Open the handle for boosting cpu on changes that affect orientation
-    if (cpuBoostFile.exists()) {
-            cpuBoostFile.open(QIODevice::WriteOnly);
-      }
+void OrientationInterpreter::setDecision(unsigned long window, unsigned long settle, int minimumConfidence)
+{
+    decisionWindow = window;
+    settleTime = settle;
+    minConfidence = minimumConfidence;
+}
+
+void OrientationInterpreter::setMotionVeto(int rate, unsigned long holdTime)
+{
+    motionVetoRate = rate;
+    motionHoldTime = holdTime;
+}
+
+void OrientationInterpreter::discontinuity()
+{
+    dataBuffer.clear();
+    votes.clear();
+    pendingTopEdge = topEdge.orientation_;
+    hintSent = false;
+    lastMotion = 0;
+}
+
+void OrientationInterpreter::gyroDataAvailable(unsigned, const TimedXyzData* pdata)
+{
+    const int vetoRate = motionVetoRate.load();
+    if (vetoRate <= 0)
+        return;
+
+    double rate = sqrt((double)pdata->x_ * pdata->x_ + (double)pdata->y_ * pdata->y_ + (double)pdata->z_ * pdata->z_);
+    if (rate > vetoRate)
+    {
+        // Read by the accelerometer thread
+        lastMotion = qMax<quint64>(pdata->timestamp_, 1);
+    }
+}
+
+bool OrientationInterpreter::inMotion() const
+{
+    const quint64 motion = lastMotion.load();
+    if (motionVetoRate.load() <= 0 || motion == 0)
+        return false;
+
+    // Gyroscope samples may be ahead of the averaged accelerometer data
+    return (qint64)(data.timestamp_ - motion) < (qint64)motionHoldTime.load();
 }
 
 void OrientationInterpreter::accDataAvailable(unsigned, const AccelerationData* pdata)
@@ -88,7 +159,9 @@ void OrientationInterpreter::accDataAvailable(unsigned, const AccelerationData*
     dataBuffer.append(data);
 
     // Clear old values from buffer.
-    while (dataBuffer.count() > maxBufferSize || (dataBuffer.count() > 1 && (data.timestamp_ - dataBuffer.first().timestamp_ > discardTime)))
+    const int bufferSize = maxBufferSize.load();
+    const quint64 discard = discardTime.load();
+    while (dataBuffer.count() > bufferSize || (dataBuffer.count() > 1 && (data.timestamp_ - dataBuffer.first().timestamp_ > discard)))
     {
         dataBuffer.removeFirst();
     }
@@ -121,7 +194,7 @@ void OrientationInterpreter::accDataAvailable(unsigned, const AccelerationData*
 bool OrientationInterpreter::overFlowCheck()
 {
     int vector = ((data.x_ * data.x_ + data.y_ * data.y_ + data.z_ * data.z_) / 1000);
-    return !((vector >= minLimit) && (vector <= maxLimit));
+    return !((vector >= minLimit.load()) && (vector <= maxLimit.load()));
 }
 
 int OrientationInterpreter::orientationCheck(const AccelerationData &data,  OrientationMode mode) const
@@ -169,13 +242,13 @@ PoseData OrientationInterpreter::rotateToLandscape(int rotation)
 PoseData OrientationInterpreter::orientationRotation (const AccelerationData &data, OrientationMode mode, PoseData (OrientationInterpreter::*ptrFUN)(int))
 {
     int rotation = orientationCheck(data, mode);
-    int threshold = (mode == OrientationInterpreter::Portrait) ? angleThresholdPortrait : angleThresholdLandscape;
+    int threshold = (mode == OrientationInterpreter::Portrait) ? angleThresholdPortrait.load() : angleThresholdLandscape.load();
     //if rotation is bigger than the threshold, then rotate using the function passed
     PoseData newTopEdge = (abs(rotation) > threshold) ? (this->*ptrFUN)(rotation) : PoseData::Undefined;
     return newTopEdge;
 }
 
-void OrientationInterpreter::processTopEdge()
+PoseData::Orientation OrientationInterpreter::topEdgeCandidate()
 {
     PoseData newTopEdge = PoseData::Undefined;
     ptrFUN rotator;
@@ -199,21 +272,73 @@ void OrientationInterpreter::processTopEdge()
         newTopEdge = orientationRotation(data, mode, rotator);
     }
 
-    // Propagate if changed
-    if (topEdge.orientation_ != newTopEdge.orientation_)
+    return newTopEdge.orientation_;
+}
+
+void OrientationInterpreter::processTopEdge()
+{
+    Vote vote = { data.timestamp_, topEdgeCandidate() };
+    votes.append(vote);
+    const quint64 window = decisionWindow.load();
+    while (votes.count() > 1 && data.timestamp_ - votes.first().timestamp > window)
     {
-        // Request CPU clock raise to get smooth desktop rotation
-        if (cpuBoostFile.isOpen())
-        {
-            cpuBoostFile.write("1", 1);
-            cpuBoostFile.flush();
-        }
+        votes.removeFirst();
+    }
+
+    // Score candidates, ties go to the latest vote
+    int counts[PoseData::FaceUp + 1] = { 0, };
+    foreach (const Vote& v, votes)
+    {
+        ++counts[v.orientation];
+    }
+    PoseData::Orientation winner = vote.orientation;
+    for (int i = 0; i <= PoseData::FaceUp; ++i)
+    {
+        if (counts[i] > counts[winner])
+            winner = (PoseData::Orientation)i;
+    }
+    unsigned confidence = counts[winner] * 100 / votes.count();
+
+    if (winner == topEdge.orientation_)
+    {
+        pendingTopEdge = topEdge.orientation_;
+        confidenceValue = confidence;
+        return;
+    }
 
-        topEdge.orientation_ = newTopEdge.orientation_;
-        sensordLogT() << "new TopEdge value: " << topEdge.orientation_;
-        topEdge.timestamp_ = data.timestamp_;
-        topEdgeSource.propagate(1, &topEdge);
+    if (winner != pendingTopEdge)
+    {
+        pendingTopEdge = winner;
+        pendingSince = data.timestamp_;
+        hintSent = false;
+    }
+
+    if (inMotion())
+    {
+        // Settle time starts over once the device is held still
+        pendingSince = data.timestamp_;
+        return;
+    }
+
+    // Let consumers get ready, e.g. raise CPU clock for smooth rotation
+    if (!hintSent && winner != PoseData::Undefined)
+    {
+        hintSent = true;
+        PoseData hint(data.timestamp_, winner);
+        rotationHintSource.propagate(1, &hint);
     }
+
+    if (data.timestamp_ - pendingSince < settleTime.load() || (int)confidence < minConfidence.load())
+        return;
+
+    confidenceValue = confidence;
+    topEdge.orientation_ = winner;
+    sensordLogT() << "new TopEdge value: " << topEdge.orientation_ << "confidence" << confidence;
+    topEdge.timestamp_ = data.timestamp_;
+    topEdgeSource.propagate(1, &topEdge);
+
+    TimedUnsigned confidenceData(data.timestamp_, confidence);
+    confidenceSource.propagate(1, &confidenceData);
 }
 
 void OrientationInterpreter::processFace()
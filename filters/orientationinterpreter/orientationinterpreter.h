@@ -30,10 +30,11 @@
 #define ORIENTATIONINTERPRETER_H
 
 #include <QObject>
-#include <QFile>
+#include <atomic>
 #include "filter.h"
 #include <datatypes/orientationdata.h>
 #include <datatypes/posedata.h>
+#include <datatypes/timedunsigned.h>
 
 /**
  * @brief Filter for calculating device orientation.
@@ -41,23 +42,46 @@
  * Filter for calculating the device orientation. Input from
  * #AccelerometerChain is used.
  *
+ * Each averaged accelerometer sample votes for a top edge candidate.
+ * Votes of the last \c decision_window microseconds are scored, and the
+ * candidate with most votes wins; its share of the votes is the
+ * confidence (percent). A winner different from the current top edge
+ * becomes pending, and is accepted once it has won for \c settle_time
+ * microseconds with at least \c min_confidence. The window and settle
+ * time default to 0, so each averaged sample decides alone.
+ *
+ * If gyroscope samples (mdps) are fed to \c gyrosink, rotation rates
+ * above \c motion_veto_rate (0 by default, disabled) veto changes of the top edge until the rate
+ * has stayed below it for \c motion_hold_time microseconds; settle
+ * time is counted from the end of the motion.
+ *
+ * When a defined top edge becomes pending outside of motion, it is
+ * propagated on \c rotationhint before the decision is made, so that
+ * consumers can prepare for the rotation.
  */
 class OrientationInterpreter : public QObject, public FilterBase
 {
     Q_OBJECT;
 
     Q_PROPERTY(PoseData orientation READ orientation);
+    Q_PROPERTY(int confidence READ confidence);
 
 private:
     Sink<OrientationInterpreter, AccelerationData> accDataSink;
+    Sink<OrientationInterpreter, TimedXyzData> gyroDataSink;
     Source<PoseData> topEdgeSource;
     Source<PoseData> faceSource;
     Source<PoseData> orientationSource;
+    Source<PoseData> rotationHintSource;
+    Source<TimedUnsigned> confidenceSource;
 
     void accDataAvailable(unsigned, const AccelerationData*);
+    void gyroDataAvailable(unsigned, const TimedXyzData*);
 
     bool overFlowCheck();
+    PoseData::Orientation topEdgeCandidate();
     void processTopEdge();
+    bool inMotion() const;
     void processFace();
     void processOrientation();
 
@@ -71,16 +95,38 @@ private:
     AccelerationData data;
     QList<AccelerationData> dataBuffer;
 
-    int minLimit;
-    int maxLimit;
-    int angleThresholdPortrait;
-    int angleThresholdLandscape;
-    unsigned long discardTime;
-    int maxBufferSize;
+    // Parameters are updated from the main thread on configuration reload
+    std::atomic<int> minLimit;
+    std::atomic<int> maxLimit;
+    std::atomic<int> angleThresholdPortrait;
+    std::atomic<int> angleThresholdLandscape;
+    std::atomic<unsigned long> discardTime;
+    std::atomic<int> maxBufferSize;
 
     PoseData orientationData;
 
-    QFile cpuBoostFile;
+    /**
+     * Top edge candidate of one averaged sample.
+     */
+    struct Vote
+    {
+        quint64 timestamp;
+        PoseData::Orientation orientation;
+    };
+    QList<Vote> votes;
+
+    std::atomic<unsigned long> decisionWindow;
+    std::atomic<unsigned long> settleTime;
+    std::atomic<int> minConfidence;
+    std::atomic<int> motionVetoRate;
+    std::atomic<unsigned long> motionHoldTime;
+
+    PoseData::Orientation pendingTopEdge;
+    quint64 pendingSince;
+    bool hintSent;
+    unsigned confidenceValue;
+
+    std::atomic<quint64> lastMotion; /**< time of last motion, 0 if none */
 
     enum OrientationMode
     {
@@ -105,7 +151,11 @@ private:
     static const int DISCARD_TIME;
     static const int AVG_BUFFER_MAX_SIZE;
 
-    static const char* CPU_BOOST_PATH;
+    static const int DECISION_WINDOW;
+    static const int SETTLE_TIME;
+    static const int MIN_CONFIDENCE;
+    static const int MOTION_VETO_RATE;
+    static const int MOTION_HOLD_TIME;
 
 public:
     /**
@@ -118,6 +168,37 @@ public:
     }
 
     PoseData orientation() const { return orientationData; }
+
+    /**
+     * Confidence of the latest top edge decision.
+     *
+     * @return share of votes of the winning candidate (percent).
+     */
+    int confidence() const { return confidenceValue; }
+
+    /**
+     * Set decision parameters, see class description.
+     *
+     * @param window scoring window (microsec).
+     * @param settle time a new candidate must win before it is accepted (microsec).
+     * @param minimumConfidence smallest confidence (percent) accepted.
+     */
+    void setDecision(unsigned long window, unsigned long settle, int minimumConfidence);
+
+    /**
+     * Set gyroscope motion veto, see class description.
+     *
+     * @param rate rotation rate (mdps) considered motion, zero disables veto.
+     * @param holdTime time after motion during which changes are vetoed (microsec).
+     */
+    void setMotionVeto(int rate, unsigned long holdTime);
+
+    /**
+     * Drop averaging buffer, votes and pending decision after a gap in
+     * the data. The current orientation is kept until new samples
+     * decide otherwise.
+     */
+    virtual void discontinuity();
 };
 
 #endif
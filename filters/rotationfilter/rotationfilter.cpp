@@ -25,21 +25,46 @@
 */
 
 #include "rotationfilter.h"
+#include "scheduler.h"
 #include <math.h>
 
 RotationFilter::RotationFilter() :
         accelerometerDataSink_(this, &RotationFilter::interpret),
         compassDataSink_(this, &RotationFilter::updateZvalue),
-        rotation_(0,0,0,0)
+        magnetometerDataSink_(this, &RotationFilter::updateMagneticField),
+        updateCallback_(this, &RotationFilter::update),
+        updatePending_(false),
+        rotation_(0,0,0,0),
+        hasMagneticField_(false)
 {
     addSink(&accelerometerDataSink_, "accelerometersink");
     addSink(&compassDataSink_, "compasssink");
+    addSink(&magnetometerDataSink_, "magnetometersink");
     addSource(&source_, "source");
+    addSource(&attitudeSource_, "attitude");
 }
 
 void RotationFilter::interpret(unsigned, const TimedXyzData* data)
 {
+    // A reader draining several samples in one epoch must not make the
+    // earlier ones disappear, so the pending one is produced first
+    if (updatePending_) {
+        update();
+    }
+    acceleration_ = *data;
+    updatePending_ = true;
+    Scheduler::defer(this, &updateCallback_);
+}
+
+void RotationFilter::update()
+{
+    if (!updatePending_) {
+        return;
+    }
+    updatePending_ = false;
+
     const double RADIANS_TO_DEGREES = 180/M_PI;
+    const TimedXyzData* data = &acceleration_;
 
     rotation_.timestamp_ = data->timestamp_;
 
@@ -65,6 +90,11 @@ void RotationFilter::interpret(unsigned, const TimedXyzData* data)
     }
 
     source_.propagate(1, &rotation_);
+
+    if (hasMagneticField_ && triad(*data, magneticField_, attitude_)) {
+        attitude_.timestamp_ = data->timestamp_;
+        attitudeSource_.propagate(1, &attitude_);
+    }
 }
 
 double RotationFilter::vectorLength(const TimedXyzData& data)
@@ -80,3 +110,87 @@ void RotationFilter::updateZvalue(unsigned, const CompassData* data)
     /// Compass output is [0, 360), rotation is (-180, 180]
     rotation_.z_ = -1 * (data->degrees_ - 180);
 }
+
+void RotationFilter::updateMagneticField(unsigned, const CalibratedMagneticFieldData* data)
+{
+    magneticField_ = *data;
+    hasMagneticField_ = true;
+}
+
+bool RotationFilter::triad(const TimedXyzData& accel, const CalibratedMagneticFieldData& mag, AttitudeData& attitude)
+{
+    float up[3] = { accel.x_, accel.y_, accel.z_ };
+    float field[3] = { (float)mag.x_, (float)mag.y_, (float)mag.z_ };
+
+    float upNorm = sqrtf(up[0] * up[0] + up[1] * up[1] + up[2] * up[2]);
+    float fieldNorm = sqrtf(field[0] * field[0] + field[1] * field[1] + field[2] * field[2]);
+    if (upNorm == 0 || fieldNorm == 0) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        up[i] /= upNorm;
+    }
+
+    // East is perpendicular to both the field and up
+    float east[3] = {
+        field[1] * up[2] - field[2] * up[1],
+        field[2] * up[0] - field[0] * up[2],
+        field[0] * up[1] - field[1] * up[0]
+    };
+    float eastNorm = sqrtf(east[0] * east[0] + east[1] * east[1] + east[2] * east[2]);
+    if (eastNorm < 1e-3f * fieldNorm) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        east[i] /= eastNorm;
+    }
+
+    float north[3] = {
+        up[1] * east[2] - up[2] * east[1],
+        up[2] * east[0] - up[0] * east[2],
+        up[0] * east[1] - up[1] * east[0]
+    };
+
+    // Rows are the world axes in device frame
+    const float* m[3] = { east, north, up };
+
+    // Shepperd's method, picking the largest pivot for stability
+    float w, x, y, z;
+    float trace = m[0][0] + m[1][1] + m[2][2];
+    if (trace > 0) {
+        float s = sqrtf(trace + 1) * 2;
+        w = 0.25f * s;
+        x = (m[2][1] - m[1][2]) / s;
+        y = (m[0][2] - m[2][0]) / s;
+        z = (m[1][0] - m[0][1]) / s;
+    } else if (m[0][0] > m[1][1] && m[0][0] > m[2][2]) {
+        float s = sqrtf(1 + m[0][0] - m[1][1] - m[2][2]) * 2;
+        w = (m[2][1] - m[1][2]) / s;
+        x = 0.25f * s;
+        y = (m[0][1] + m[1][0]) / s;
+        z = (m[0][2] + m[2][0]) / s;
+    } else if (m[1][1] > m[2][2]) {
+        float s = sqrtf(1 + m[1][1] - m[0][0] - m[2][2]) * 2;
+        w = (m[0][2] - m[2][0]) / s;
+        x = (m[0][1] + m[1][0]) / s;
+        y = 0.25f * s;
+        z = (m[1][2] + m[2][1]) / s;
+    } else {
+        float s = sqrtf(1 + m[2][2] - m[0][0] - m[1][1]) * 2;
+        w = (m[1][0] - m[0][1]) / s;
+        x = (m[0][2] + m[2][0]) / s;
+        y = (m[1][2] + m[2][1]) / s;
+        z = 0.25f * s;
+    }
+
+    // q and -q are the same rotation, keep w non-negative
+    float norm = sqrtf(w * w + x * x + y * y + z * z);
+    if (w < 0) {
+        norm = -norm;
+    }
+    attitude.w_ = w / norm;
+    attitude.x_ = x / norm;
+    attitude.y_ = y / norm;
+    attitude.z_ = z / norm;
+    return true;
+}
@@ -29,13 +29,27 @@
 #include <QObject>
 
 #include "orientationdata.h"
+#include "attitudedata.h"
 #include "filter.h"
+#include "callback.h"
 
 /**
  * @brief Filter for calculating device axis rotations.
  *
  * Axis rotations are given in degrees. Rotation is defined as the angle
  * between the acceleration vector and the positive axis.
+ *
+ * When calibrated magnetometer data is fed to \c magnetometersink, the
+ * full attitude is also computed for each acceleration sample with the
+ * TRIAD method and propagated from \c attitude, at the timestamp of the
+ * acceleration sample. Unlike the Euler angles, the attitude has float
+ * precision and no gimbal lock.
+ *
+ * Output is deferred with Scheduler::defer(), so when one commit updates
+ * both the acceleration and the compass heading, e.g. through the
+ * compass chain, a single rotation is produced from both. Only inputs
+ * are coalesced: every acceleration sample still produces a rotation,
+ * also when several of them are read in one epoch.
  */
 class RotationFilter : public QObject, public FilterBase
 {
@@ -50,6 +64,18 @@ public:
         return new RotationFilter();
     }
 
+    /**
+     * Compute attitude from the acceleration and the magnetic field,
+     * both in the device frame. Acceleration points up at rest, the
+     * magnetic field north and, away from the equator, down or up.
+     *
+     * @param accel acceleration.
+     * @param mag magnetic field.
+     * @param attitude computed attitude, timestamp is not touched.
+     * @return false if either vector is zero or they are parallel.
+     */
+    static bool triad(const TimedXyzData& accel, const CalibratedMagneticFieldData& mag, AttitudeData& attitude);
+
 private:
 
     /**
@@ -66,16 +92,27 @@ private:
 
     Sink<RotationFilter, TimedXyzData> accelerometerDataSink_;
     Sink<RotationFilter, CompassData> compassDataSink_;
+    Sink<RotationFilter, CalibratedMagneticFieldData> magnetometerDataSink_;
     Source<TimedXyzData> source_;
+    Source<AttitudeData> attitudeSource_;
 
     void interpret(unsigned, const TimedXyzData*);
     void updateZvalue(unsigned, const CompassData*);
+    void updateMagneticField(unsigned, const CalibratedMagneticFieldData*);
+    void update();
 
     inline int dotProduct(TimedXyzData a, TimedXyzData b) const {
         return (a.x_ * b.x_) + (a.y_ * b.y_) + (a.z_ * b.z_);
     }
 
+    Callback<RotationFilter> updateCallback_;
+
+    TimedXyzData acceleration_;
+    bool updatePending_;   /**< acceleration_ is waiting for update() */
     TimedXyzData rotation_;
+    CalibratedMagneticFieldData magneticField_;
+    bool hasMagneticField_;
+    AttitudeData attitude_;
 };
 
 #endif // ROTATIONFILTER_H
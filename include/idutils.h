@@ -41,4 +41,68 @@ inline QString getCleanId(const QString& id)
     return pos != -1 ? id.left(pos) : id;
 }
 
+/**
+ * Separator between node ID and instance index, as in
+ * "accelerometeradaptor@1".
+ */
+const char SENSOR_INSTANCE_SEPARATOR = '@';
+
+/**
+ * Return instance index of an ID. For example return for "foo@1;bar" is 1,
+ * and for "foo" 0, the primary instance.
+ *
+ * @param id ID.
+ * @return instance index.
+ */
+inline int getInstanceIndex(const QString& id)
+{
+    QString cleanId = getCleanId(id);
+    int pos = cleanId.lastIndexOf(SENSOR_INSTANCE_SEPARATOR);
+    if (pos == -1) {
+        return 0;
+    }
+    bool ok;
+    int index = cleanId.mid(pos + 1).toInt(&ok);
+    return (ok && index > 0) ? index : 0;
+}
+
+/**
+ * Return ID without instance index and parameters. For example return
+ * for "foo@1;bar" is "foo".
+ *
+ * @param id ID.
+ * @return base ID.
+ */
+inline QString getBaseId(const QString& id)
+{
+    QString cleanId = getCleanId(id);
+    int pos = cleanId.lastIndexOf(SENSOR_INSTANCE_SEPARATOR);
+    return pos != -1 ? cleanId.left(pos) : cleanId;
+}
+
+/**
+ * Return ID of given instance. Instance 0 is the base ID itself.
+ *
+ * @param baseId Base ID, e.g. "accelerometeradaptor".
+ * @param index Instance index.
+ * @return instance ID, e.g. "accelerometeradaptor@1".
+ */
+inline QString getInstanceId(const QString& baseId, int index)
+{
+    return index > 0 ? baseId + SENSOR_INSTANCE_SEPARATOR + QString::number(index) : baseId;
+}
+
+/**
+ * Return D-Bus object path element of a sensor ID. The instance
+ * separator is not allowed in object paths and is replaced by '_'.
+ *
+ * @param id Sensor ID.
+ * @return object path element.
+ */
+inline QString getObjectPathId(const QString& id)
+{
+    QString pathId = getCleanId(id);
+    return pathId.replace(SENSOR_INSTANCE_SEPARATOR, '_');
+}
+
 #endif // ID_UTILS_H
@@ -44,7 +44,10 @@ typedef enum
     SmIdNotRegistered,
     SmFactoryNotRegistered,
     SmNotInstantiated,
-    SmAdaptorNotStarted
+    SmAdaptorNotStarted,
+    SmQuotaExceeded,
+    SmCredentialsMismatch,
+    SmNotPermitted
 } SensorManagerError;
 
 /**
@@ -50,6 +50,9 @@ struct AbstractSensorChannelInterface::AbstractSensorChannelInterfaceImpl : publ
     bool m_running;
     bool m_standbyOverride;
     bool m_downsampling;
+    unsigned int m_predictionHorizon_us;
+    bool m_clockSync;
+    QString m_timeBase;
 };
 
 AbstractSensorChannelInterface::AbstractSensorChannelInterfaceImpl::AbstractSensorChannelInterfaceImpl(QObject* parent, int sessionId, const QString& path, const char* interfaceName) :
@@ -63,7 +66,9 @@ AbstractSensorChannelInterface::AbstractSensorChannelInterfaceImpl::AbstractSens
     m_socketReader(parent),
     m_running(false),
     m_standbyOverride(false),
-    m_downsampling(true)
+    m_downsampling(true),
+    m_predictionHorizon_us(0),
+    m_clockSync(false)
 {
 }
 
@@ -151,6 +156,11 @@ QDBusReply<void> AbstractSensorChannelInterface::start(int sessionId)
     setBufferInterval(sessionId, pimpl_->m_bufferInterval_ms);
     setBufferSize(sessionId, pimpl_->m_bufferSize);
     setDownsampling(pimpl_->m_sessionId, pimpl_->m_downsampling);
+    if (pimpl_->m_predictionHorizon_us)
+        setPredictionHorizon(pimpl_->m_sessionId, pimpl_->m_predictionHorizon_us);
+    // Readings sent before start were flushed above
+    if (pimpl_->m_clockSync)
+        setClockSync(pimpl_->m_sessionId, true);
 
     return returnValue;
 }
@@ -385,6 +395,16 @@ QString AbstractSensorChannelInterface::description()
     return getAccessor<QString>("description");
 }
 
+QString AbstractSensorChannelInterface::timeBase()
+{
+    return getAccessor<QString>("timeBase");
+}
+
+QString AbstractSensorChannelInterface::location()
+{
+    return getAccessor<QString>("location");
+}
+
 QString AbstractSensorChannelInterface::id()
 {
     return getAccessor<QString>("id");
@@ -484,6 +504,12 @@ void AbstractSensorChannelInterface::dataReceived()
 {
     do
     {
+        if(pimpl_->m_socketReader.readClockFrame())
+        {
+            if(pimpl_->m_socketReader.clockOffsets().gap_)
+                emit discontinuity(pimpl_->m_socketReader.clockOffsets().gap_);
+            continue;
+        }
         if(!dataReceivedImpl())
             return;
     } while(pimpl_->m_socketReader.socket()->bytesAvailable());
@@ -582,6 +608,49 @@ void AbstractSensorChannelInterface::setDownsamplingFinished(QDBusPendingCallWat
     }
 }
 
+bool AbstractSensorChannelInterface::predictionSupported()
+{
+    return getAccessor<bool>("predictionSupported");
+}
+
+unsigned int AbstractSensorChannelInterface::predictionHorizon()
+{
+    return pimpl_->m_predictionHorizon_us;
+}
+
+bool AbstractSensorChannelInterface::setPredictionHorizon(unsigned int horizon_us)
+{
+    QDBusReply<bool> reply = setPredictionHorizon(pimpl_->m_sessionId, horizon_us);
+    if (!reply.isValid() || !reply.value())
+        return false;
+    pimpl_->m_predictionHorizon_us = horizon_us;
+    return true;
+}
+
+QDBusReply<bool> AbstractSensorChannelInterface::setPredictionHorizon(int sessionId, unsigned int horizon_us)
+{
+    clearError();
+
+    QList<QVariant> argumentList;
+    argumentList << QVariant::fromValue(sessionId) << QVariant::fromValue(horizon_us);
+    QDBusReply<bool> reply = callWithArgumentList(QDBus::Block, QLatin1String("setPredictionHorizon"), argumentList);
+    if (!reply.isValid()) {
+        qDebug() << reply.error().message();
+        setError(SaCannotAccessSensor, reply.error().message());
+    }
+    return reply;
+}
+
+XYZ AbstractSensorChannelInterface::predict(quint64 timestamp)
+{
+    QDBusReply<XYZ> reply(call(QDBus::Block, QLatin1String("predict"), QVariant::fromValue(timestamp)));
+    if (!reply.isValid()) {
+        qDebug() << "Failed to get prediction from sensord: " << reply.error().message();
+        return XYZ();
+    }
+    return reply.value();
+}
+
 void AbstractSensorChannelInterface::displayStateChanged(bool displayState)
 {
     if (!pimpl_->m_standbyOverride) {
@@ -593,3 +662,42 @@ void AbstractSensorChannelInterface::displayStateChanged(bool displayState)
     }
 }
 
+bool AbstractSensorChannelInterface::setClockSync(bool enable)
+{
+    pimpl_->m_clockSync = enable;
+    return setClockSync(pimpl_->m_sessionId, enable).isValid();
+}
+
+QDBusReply<void> AbstractSensorChannelInterface::setClockSync(int sessionId, bool enable)
+{
+    clearError();
+
+    QList<QVariant> argumentList;
+    argumentList << QVariant::fromValue(sessionId) << QVariant::fromValue(enable);
+    QDBusReply<void> reply = callWithArgumentList(QDBus::Block, QLatin1String("setClockSync"), argumentList);
+    if (!reply.isValid()) {
+        qDebug() << reply.error().message();
+        setError(SaCannotAccessSensor, reply.error().message());
+    }
+    return reply;
+}
+
+ClockOffsets AbstractSensorChannelInterface::clockOffsets() const
+{
+    return pimpl_->m_socketReader.clockOffsets();
+}
+
+quint64 AbstractSensorChannelInterface::toClock(quint64 timestamp, ClockOffsets::Clock clock)
+{
+    const ClockOffsets& offsets = pimpl_->m_socketReader.clockOffsets();
+    if (!offsets.isValid())
+        return timestamp;
+
+    // Time base does not change during the session
+    if (pimpl_->m_timeBase.isEmpty())
+        pimpl_->m_timeBase = timeBase();
+    ClockOffsets::Clock from;
+    if (!ClockOffsets::clockByName(pimpl_->m_timeBase, from))
+        from = ClockOffsets::Monotonic;
+    return offsets.convert(timestamp, from, clock);
+}
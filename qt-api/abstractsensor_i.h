@@ -38,6 +38,7 @@
 #include "serviceinfo.h"
 #include "socketreader.h"
 #include "datatypes/datarange.h"
+#include "datatypes/xyz.h"
 
 /**
  * Base-class for client facades of different sensor types.
@@ -50,6 +51,8 @@ class AbstractSensorChannelInterface : public QObject
     Q_PROPERTY(SensorError errorCode READ errorCode)
     Q_PROPERTY(QString errorString READ errorString)
     Q_PROPERTY(QString description READ description)
+    Q_PROPERTY(QString timeBase READ timeBase)
+    Q_PROPERTY(QString location READ location)
     Q_PROPERTY(QString id READ id)
     Q_PROPERTY(int dataRate READ dataRate WRITE setDataRate)
     Q_PROPERTY(int interval READ interval WRITE setInterval)
@@ -59,6 +62,8 @@ class AbstractSensorChannelInterface : public QObject
     Q_PROPERTY(unsigned int bufferSize READ bufferSize WRITE setBufferSize)
     Q_PROPERTY(bool hwBuffering READ hwBuffering)
     Q_PROPERTY(bool downsampling READ downsampling WRITE setDownsampling)
+    Q_PROPERTY(bool predictionSupported READ predictionSupported)
+    Q_PROPERTY(unsigned int predictionHorizon READ predictionHorizon WRITE setPredictionHorizon)
 
 public:
 
@@ -103,6 +108,22 @@ public:
      */
     QString description();
 
+    /**
+     * Get the clock sample timestamps are in.
+     *
+     * @return \c "monotonic", \c "boottime" or \c "realtime".
+     */
+    QString timeBase();
+
+    /**
+     * Get physical location of the sensor, e.g. \c base or \c lid.
+     * Tells apart instances of the same sensor type, like
+     * \c accelerometersensor and \c accelerometersensor@1.
+     *
+     * @return location, empty if unknown.
+     */
+    QString location();
+
     /**
      * Get ID of the sensor.
      *
@@ -194,6 +215,70 @@ public:
      */
     bool setDownsampling(bool value);
 
+    /**
+     * Can the sensor extrapolate its readings to a later time. Supported
+     * by sensors reporting XYZ readings that change smoothly.
+     *
+     * @return is prediction supported.
+     */
+    bool predictionSupported();
+
+    /**
+     * Prediction horizon of this session.
+     *
+     * @return horizon in microseconds, zero if disabled.
+     */
+    unsigned int predictionHorizon();
+
+    /**
+     * Deliver readings predicted this far ahead of their measurement,
+     * e.g. the expected delay until they are displayed. Predicted
+     * readings carry the timestamp they were predicted to.
+     *
+     * @param horizon_us horizon in microseconds, zero disables prediction.
+     * @return was the horizon set.
+     */
+    bool setPredictionHorizon(unsigned int horizon_us);
+
+    /**
+     * Extrapolate the latest readings to given time.
+     *
+     * @param timestamp target time in the time base of the sensor, see
+     *                  #timeBase(). It is limited to a short interval
+     *                  from the latest reading.
+     * @return predicted reading, zero if there is none.
+     */
+    XYZ predict(quint64 timestamp);
+
+    /**
+     * Receive clock readings from sensord along with the readings, so
+     * that reading timestamps can be converted to other clocks with
+     * #toClock(). Readings are refreshed every few seconds.
+     *
+     * @param enable enable clock sync.
+     * @return was the setting sent.
+     */
+    bool setClockSync(bool enable);
+
+    /**
+     * Latest clock readings received from sensord.
+     *
+     * @return clock readings, invalid until clock sync is enabled and
+     *         the first readings have arrived.
+     */
+    ClockOffsets clockOffsets() const;
+
+    /**
+     * Convert a reading timestamp from the time base of the sensor to
+     * another clock, using the latest clock readings.
+     *
+     * @param timestamp reading timestamp (microsec), see #timeBase().
+     * @param clock clock to convert to.
+     * @return time of \c clock (microsec), or \c timestamp unchanged if
+     *         no clock readings have been received.
+     */
+    quint64 toClock(quint64 timestamp, ClockOffsets::Clock clock);
+
     /**
      * Returns list of available buffer interval ranges.
      *
@@ -382,6 +467,24 @@ private Q_SLOTS: // METHODS
      */
     QDBusReply<void> setDownsampling(int sessionId, bool value);
 
+    /**
+     * Set prediction horizon to session.
+     *
+     * @param sessionId session ID.
+     * @param horizon_us horizon in microseconds.
+     * @return DBus reply.
+     */
+    QDBusReply<bool> setPredictionHorizon(int sessionId, unsigned int horizon_us);
+
+    /**
+     * Set clock sync to session.
+     *
+     * @param sessionId session ID.
+     * @param enable clock sync.
+     * @return DBus reply.
+     */
+    QDBusReply<void> setClockSync(int sessionId, bool enable);
+
     /**
      * Start sensor for session.
      *
@@ -499,6 +602,16 @@ protected slots:
     void setDownsamplingFinished(QDBusPendingCallWatcher *watch);
     void setDataRangeIndexFinished(QDBusPendingCallWatcher *watch);
 
+Q_SIGNALS:
+    /**
+     * Sent when sensord has detected a gap in the readings, e.g. because
+     * the system was suspended. Readings after the signal do not
+     * continue the ones before it. Requires clock sync, see
+     * #setClockSync().
+     *
+     * @param gap length of the gap (microsec), at least 1.
+     */
+    void discontinuity(quint64 gap);
 
 private:
     struct AbstractSensorChannelInterfaceImpl;
@@ -25,13 +25,14 @@
  */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "accelerometersensor_i.h"
 
 const char* AccelerometerSensorChannelInterface::staticInterfaceName = "local.AccelerometerSensor";
 
 AbstractSensorChannelInterface* AccelerometerSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new AccelerometerSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new AccelerometerSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 AccelerometerSensorChannelInterface::AccelerometerSensorChannelInterface(const QString &path, int sessionId) :
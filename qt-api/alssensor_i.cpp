@@ -27,12 +27,13 @@
 #include "sensormanagerinterface.h"
 #include "alssensor_i.h"
 #include "socketreader.h"
+#include "idutils.h"
 
 const char* ALSSensorChannelInterface::staticInterfaceName = "local.ALSSensor";
 
 AbstractSensorChannelInterface* ALSSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new ALSSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new ALSSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 ALSSensorChannelInterface::ALSSensorChannelInterface(const QString& path, int sessionId)
@@ -25,13 +25,14 @@
  */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "compasssensor_i.h"
 
 const char* CompassSensorChannelInterface::staticInterfaceName = "local.CompassSensor";
 
 AbstractSensorChannelInterface* CompassSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new CompassSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new CompassSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 CompassSensorChannelInterface::CompassSensorChannelInterface(const QString &path, int sessionId) :
@@ -0,0 +1,77 @@
+/**
+   @file environmentsensor_i.cpp
+   @brief Client interface for EnvironmentSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "sensormanagerinterface.h"
+#include "environmentsensor_i.h"
+#include "socketreader.h"
+#include "idutils.h"
+
+const char* EnvironmentSensorChannelInterface::staticInterfaceName = "local.EnvironmentSensor";
+
+AbstractSensorChannelInterface* EnvironmentSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
+{
+    return new EnvironmentSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
+}
+
+EnvironmentSensorChannelInterface::EnvironmentSensorChannelInterface(const QString& path, int sessionId)
+    : AbstractSensorChannelInterface(path, EnvironmentSensorChannelInterface::staticInterfaceName, sessionId)
+{
+}
+
+EnvironmentSensorChannelInterface* EnvironmentSensorChannelInterface::interface(const QString& id)
+{
+    SensorManagerInterface& sm = SensorManagerInterface::instance();
+    if (!sm.registeredAndCorrectClassName(id, EnvironmentSensorChannelInterface::staticMetaObject.className())) {
+        return 0;
+    }
+
+    return dynamic_cast<EnvironmentSensorChannelInterface*>(sm.interface(id));
+}
+
+bool EnvironmentSensorChannelInterface::dataReceivedImpl()
+{
+    QVector<EnvironmentData> values;
+    if (!read<EnvironmentData>(values))
+        return false;
+    foreach(const EnvironmentData &data, values)
+        emit environmentChanged(data);
+    return true;
+}
+
+double EnvironmentSensorChannelInterface::temperature()
+{
+    return getAccessor<double>("temperature");
+}
+
+double EnvironmentSensorChannelInterface::humidity()
+{
+    return getAccessor<double>("humidity");
+}
+
+double EnvironmentSensorChannelInterface::dewPoint()
+{
+    return getAccessor<double>("dewPoint");
+}
+
+double EnvironmentSensorChannelInterface::heatIndex()
+{
+    return getAccessor<double>("heatIndex");
+}
@@ -0,0 +1,119 @@
+/**
+   @file environmentsensor_i.h
+   @brief Client interface for EnvironmentSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef ENVIRONMENTSENSOR_I_H
+#define ENVIRONMENTSENSOR_I_H
+
+#include <QtDBus/QtDBus>
+
+#include "datatypes/environmentdata.h"
+#include "abstractsensor_i.h"
+
+/**
+ * Client interface for listening to changes of ambient temperature and
+ * humidity, with dew point and heat index derived from them.
+ */
+class EnvironmentSensorChannelInterface : public AbstractSensorChannelInterface
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(EnvironmentSensorChannelInterface)
+    Q_PROPERTY(double temperature READ temperature)
+    Q_PROPERTY(double humidity READ humidity)
+    Q_PROPERTY(double dewPoint READ dewPoint)
+    Q_PROPERTY(double heatIndex READ heatIndex)
+
+public:
+    /**
+     * Name of the D-Bus interface for this class.
+     */
+    static const char* staticInterfaceName;
+
+    /**
+     * Create new instance of the class.
+     *
+     * @param id Sensor ID.
+     * @param sessionId Session ID.
+     * @return Pointer to new instance of the class.
+     */
+    static AbstractSensorChannelInterface* factoryMethod(const QString& id, int sessionId);
+
+    /**
+     * Get latest reported temperature from sensor daemon.
+     *
+     * @return temperature in degrees Celsius.
+     */
+    double temperature();
+
+    /**
+     * Get latest reported relative humidity from sensor daemon.
+     *
+     * @return relative humidity in percent.
+     */
+    double humidity();
+
+    /**
+     * Get latest dew point from sensor daemon.
+     *
+     * @return dew point in degrees Celsius.
+     */
+    double dewPoint();
+
+    /**
+     * Get latest heat index from sensor daemon.
+     *
+     * @return apparent temperature in degrees Celsius.
+     */
+    double heatIndex();
+
+    /**
+     * Constructor.
+     *
+     * @param path      path.
+     * @param sessionId session ID.
+     */
+    EnvironmentSensorChannelInterface(const QString& path, int sessionId);
+
+    /**
+     * Request an interface to the sensor.
+     *
+     * @param id sensor ID.
+     * @return Pointer to interface, or NULL on failure.
+     */
+    static EnvironmentSensorChannelInterface* interface(const QString& id);
+
+protected:
+    virtual bool dataReceivedImpl();
+
+Q_SIGNALS:
+    /**
+     * Sent when temperature or humidity has changed beyond the
+     * reporting thresholds.
+     *
+     * @param value new readings and derived values.
+     */
+    void environmentChanged(const EnvironmentData& value);
+};
+
+namespace local {
+  typedef ::EnvironmentSensorChannelInterface EnvironmentSensor;
+}
+
+#endif
@@ -27,6 +27,7 @@
 */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "gyroscopesensor_i.h"
 #include <datatypes/orientationdata.h>
 
@@ -34,7 +35,7 @@ const char* GyroscopeSensorChannelInterface::staticInterfaceName = "local.Gyrosc
 
 AbstractSensorChannelInterface* GyroscopeSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new GyroscopeSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new GyroscopeSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 GyroscopeSensorChannelInterface::GyroscopeSensorChannelInterface(const QString &path, int sessionId)
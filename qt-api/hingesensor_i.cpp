@@ -0,0 +1,67 @@
+/**
+   @file hingesensor_i.cpp
+   @brief Client interface for HingeSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "sensormanagerinterface.h"
+#include "hingesensor_i.h"
+#include "socketreader.h"
+#include "idutils.h"
+
+const char* HingeSensorChannelInterface::staticInterfaceName = "local.HingeSensor";
+
+AbstractSensorChannelInterface* HingeSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
+{
+    return new HingeSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
+}
+
+HingeSensorChannelInterface::HingeSensorChannelInterface(const QString& path, int sessionId)
+    : AbstractSensorChannelInterface(path, HingeSensorChannelInterface::staticInterfaceName, sessionId)
+{
+}
+
+HingeSensorChannelInterface* HingeSensorChannelInterface::interface(const QString& id)
+{
+    SensorManagerInterface& sm = SensorManagerInterface::instance();
+    if (!sm.registeredAndCorrectClassName(id, HingeSensorChannelInterface::staticMetaObject.className())) {
+        return 0;
+    }
+
+    return dynamic_cast<HingeSensorChannelInterface*>(sm.interface(id));
+}
+
+bool HingeSensorChannelInterface::dataReceivedImpl()
+{
+    QVector<PostureData> values;
+    if (!read<PostureData>(values))
+        return false;
+    foreach(const PostureData &data, values)
+        emit postureChanged(data);
+    return true;
+}
+
+int HingeSensorChannelInterface::posture()
+{
+    return getAccessor<int>("posture");
+}
+
+double HingeSensorChannelInterface::angle()
+{
+    return getAccessor<double>("angle");
+}
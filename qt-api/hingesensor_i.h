@@ -0,0 +1,102 @@
+/**
+   @file hingesensor_i.h
+   @brief Client interface for HingeSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef HINGESENSOR_I_H
+#define HINGESENSOR_I_H
+
+#include <QtDBus/QtDBus>
+
+#include "datatypes/posturedata.h"
+#include "abstractsensor_i.h"
+
+/**
+ * Client interface for listening to device posture changes of a
+ * convertible.
+ */
+class HingeSensorChannelInterface : public AbstractSensorChannelInterface
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(HingeSensorChannelInterface)
+    Q_PROPERTY(int posture READ posture)
+    Q_PROPERTY(double angle READ angle)
+
+public:
+    /**
+     * Name of the D-Bus interface for this class.
+     */
+    static const char* staticInterfaceName;
+
+    /**
+     * Create new instance of the class.
+     *
+     * @param id Sensor ID.
+     * @param sessionId Session ID.
+     * @return Pointer to new instance of the class.
+     */
+    static AbstractSensorChannelInterface* factoryMethod(const QString& id, int sessionId);
+
+    /**
+     * Get current posture from sensor daemon.
+     *
+     * @return posture as PostureData::Posture.
+     */
+    int posture();
+
+    /**
+     * Get latest hinge angle from sensor daemon.
+     *
+     * @return hinge angle in degrees.
+     */
+    double angle();
+
+    /**
+     * Constructor.
+     *
+     * @param path      path.
+     * @param sessionId session ID.
+     */
+    HingeSensorChannelInterface(const QString& path, int sessionId);
+
+    /**
+     * Request an interface to the sensor.
+     *
+     * @param id sensor ID.
+     * @return Pointer to interface, or NULL on failure.
+     */
+    static HingeSensorChannelInterface* interface(const QString& id);
+
+protected:
+    virtual bool dataReceivedImpl();
+
+Q_SIGNALS:
+    /**
+     * Sent when device posture has changed.
+     *
+     * @param value new posture and the hinge angle it was detected at.
+     */
+    void postureChanged(const PostureData& value);
+};
+
+namespace local {
+  typedef ::HingeSensorChannelInterface HingeSensor;
+}
+
+#endif
@@ -26,12 +26,13 @@
 #include "sensormanagerinterface.h"
 #include "humiditysensor_i.h"
 #include "socketreader.h"
+#include "idutils.h"
 
 const char* HumiditySensorChannelInterface::staticInterfaceName = "local.HumiditySensor";
 
 AbstractSensorChannelInterface* HumiditySensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new HumiditySensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new HumiditySensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 HumiditySensorChannelInterface::HumiditySensorChannelInterface(const QString& path, int sessionId)
@@ -26,12 +26,13 @@
 #include "sensormanagerinterface.h"
 #include "lidsensor_i.h"
 #include "socketreader.h"
+#include "idutils.h"
 
 const char* LidSensorChannelInterface::staticInterfaceName = "local.LidSensor";
 
 AbstractSensorChannelInterface* LidSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new LidSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new LidSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 LidSensorChannelInterface::LidSensorChannelInterface(const QString& path, int sessionId)
@@ -26,13 +26,14 @@
  */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "magnetometersensor_i.h"
 
 const char* MagnetometerSensorChannelInterface::staticInterfaceName = "local.MagnetometerSensor";
 
 AbstractSensorChannelInterface* MagnetometerSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new MagnetometerSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new MagnetometerSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 MagnetometerSensorChannelInterface::MagnetometerSensorChannelInterface(const QString& path, int sessionId) :
@@ -25,13 +25,14 @@
  */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "orientationsensor_i.h"
 
 const char* OrientationSensorChannelInterface::staticInterfaceName = "local.OrientationSensor";
 
 AbstractSensorChannelInterface* OrientationSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new OrientationSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new OrientationSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 OrientationSensorChannelInterface::OrientationSensorChannelInterface(const QString &path, int sessionId) :
@@ -80,6 +81,11 @@ int OrientationSensorChannelInterface::threshold()
     return getAccessor<int>("threshold");
 }
 
+int OrientationSensorChannelInterface::confidence()
+{
+    return getAccessor<int>("confidence");
+}
+
 void OrientationSensorChannelInterface::setThreshold(int value)
 {
     setAccessor<int>("setThreshold", value);
@@ -41,6 +41,7 @@ class OrientationSensorChannelInterface : public AbstractSensorChannelInterface
     Q_DISABLE_COPY(OrientationSensorChannelInterface)
     Q_PROPERTY(Unsigned orientation READ orientation)
     Q_PROPERTY(int threshold READ threshold WRITE setThreshold)
+    Q_PROPERTY(int confidence READ confidence)
 
 public:
     /**
@@ -81,6 +82,14 @@ public:
      */
     void setThreshold(int value);
 
+    /**
+     * Gets the confidence of the current orientation, i.e. the share of
+     * recent readings that agreed on it.
+     *
+     * @return Confidence (percent).
+     */
+    int confidence();
+
     /**
      * Constructor.
      *
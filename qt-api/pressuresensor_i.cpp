@@ -26,12 +26,13 @@
 #include "sensormanagerinterface.h"
 #include "pressuresensor_i.h"
 #include "socketreader.h"
+#include "idutils.h"
 
 const char* PressureSensorChannelInterface::staticInterfaceName = "local.PressureSensor";
 
 AbstractSensorChannelInterface* PressureSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new PressureSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new PressureSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 PressureSensorChannelInterface::PressureSensorChannelInterface(const QString& path, int sessionId)
@@ -26,13 +26,14 @@
  */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "proximitysensor_i.h"
 
 const char* ProximitySensorChannelInterface::staticInterfaceName = "local.ProximitySensor";
 
 AbstractSensorChannelInterface* ProximitySensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new ProximitySensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new ProximitySensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 
@@ -22,7 +22,9 @@ SOURCES += sensormanagerinterface.cpp \
     humiditysensor_i.cpp \
     pressuresensor_i.cpp \
     temperaturesensor_i.cpp \
-    stepcountersensor_i.cpp
+    stepcountersensor_i.cpp \
+    hingesensor_i.cpp \
+    environmentsensor_i.cpp
 
 HEADERS += sensormanagerinterface.h \
     sensormanager_i.h \
@@ -41,7 +43,9 @@ HEADERS += sensormanagerinterface.h \
     humiditysensor_i.h \
     pressuresensor_i.h \
     temperaturesensor_i.h \
-    stepcountersensor_i.h
+    stepcountersensor_i.h \
+    hingesensor_i.h \
+    environmentsensor_i.h
 
 SENSORFW_INCLUDEPATHS = .. \
     ../include \
@@ -25,18 +25,20 @@
  */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "rotationsensor_i.h"
 
 const char* RotationSensorChannelInterface::staticInterfaceName = "local.RotationSensor";
 
 AbstractSensorChannelInterface* RotationSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new RotationSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new RotationSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 RotationSensorChannelInterface::RotationSensorChannelInterface(const QString &path, int sessionId) :
     AbstractSensorChannelInterface(path, RotationSensorChannelInterface::staticInterfaceName, sessionId),
-    frameAvailableConnected(false)
+    frameAvailableConnected(false),
+    attitudeOutput(false)
 {
 }
 
@@ -63,6 +65,16 @@ RotationSensorChannelInterface* RotationSensorChannelInterface::interface(const
 
 bool RotationSensorChannelInterface::dataReceivedImpl()
 {
+    if(attitudeOutput)
+    {
+        QVector<AttitudeData> attitudes;
+        if(!read<AttitudeData>(attitudes))
+            return false;
+        foreach(const AttitudeData& data, attitudes)
+            emit attitudeAvailable(data);
+        return true;
+    }
+
     QVector<TimedXyzData> values;
     if(!read<TimedXyzData>(values))
         return false;
@@ -92,6 +104,23 @@ bool RotationSensorChannelInterface::hasZ()
     return getAccessor<bool>("hasZ");
 }
 
+bool RotationSensorChannelInterface::hasAttitude()
+{
+    return getAccessor<bool>("hasAttitude");
+}
+
+bool RotationSensorChannelInterface::setAttitudeOutput(bool value)
+{
+    QDBusReply<bool> reply(call(QDBus::Block, QLatin1String("setAttitudeOutput"), QVariant::fromValue(sessionId()), QVariant::fromValue(value)));
+    if(!reply.isValid() || !reply.value())
+    {
+        qDebug() << "Failed to set attitude output to sensord: " << reply.error().message();
+        return false;
+    }
+    attitudeOutput = value;
+    return true;
+}
+
 void RotationSensorChannelInterface::connectNotify(const QMetaMethod &signal)
 {
     static const QMetaMethod frameAvailableSignal = QMetaMethod::fromSignal(&RotationSensorChannelInterface::frameAvailable);
@@ -32,6 +32,7 @@
 
 #include "abstractsensor_i.h"
 #include <datatypes/xyz.h>
+#include <datatypes/attitudedata.h>
 
 /**
  * Client interface for listening device rotation changes.
@@ -42,6 +43,7 @@ class RotationSensorChannelInterface: public AbstractSensorChannelInterface
     Q_DISABLE_COPY(RotationSensorChannelInterface)
     Q_PROPERTY(XYZ rotation READ rotation)
     Q_PROPERTY(bool hasZ READ hasZ)
+    Q_PROPERTY(bool hasAttitude READ hasAttitude)
 
 public:
     /**
@@ -74,6 +76,24 @@ public:
      */
     bool hasZ();
 
+    /**
+     * Can the sensor report attitude quaternions. Requires a magnetometer.
+     *
+     * @return Is attitude output available.
+     */
+    bool hasAttitude();
+
+    /**
+     * Switch this session between Euler angle and attitude quaternion
+     * output. When enabled, readings are delivered through
+     * attitudeAvailable() instead of dataAvailable(). Should be set
+     * before start().
+     *
+     * @param value Deliver attitude quaternions.
+     * @return was the output switched.
+     */
+    bool setAttitudeOutput(bool value);
+
     /**
      * Constructor.
      *
@@ -115,6 +135,7 @@ protected:
 
 private:
     bool frameAvailableConnected; /**< has applicaiton connected slot for frameAvailable signal. */
+    bool attitudeOutput; /**< is session receiving attitude quaternions. */
 
 Q_SIGNALS:
     /**
@@ -132,6 +153,14 @@ Q_SIGNALS:
      * @param frame New measurement frame.
      */
     void frameAvailable(const QVector<XYZ>& frame);
+
+    /**
+     * Sent when device attitude has changed, if attitude output has
+     * been enabled with setAttitudeOutput().
+     *
+     * @param data Current device attitude.
+     */
+    void attitudeAvailable(const AttitudeData& data);
 };
 
 namespace local {
@@ -130,6 +130,11 @@ QDBusReply<bool> LocalSensorManagerInterface::releaseSensor(const QString& id, i
     return reply;
 }
 
+QDBusReply<bool> LocalSensorManagerInterface::reloadConfig()
+{
+    return call(QLatin1String("reloadConfig"));
+}
+
 void LocalSensorManagerInterface::releaseSensorFinished(QDBusPendingCallWatcher *watch)
 {
     watch->deleteLater();
@@ -106,6 +106,13 @@ public Q_SLOTS:
      */
     QDBusReply<bool> releaseSensor(const QString& id, int sessionId);
 
+    /**
+     * Request sensor daemon to reload its configuration files.
+     *
+     * @return DBus reply.
+     */
+    QDBusReply<bool> reloadConfig();
+
 Q_SIGNALS:
 
     /**
@@ -51,15 +51,24 @@ SensorManagerInterface& SensorManagerInterface::instance()
     return *ifc_;
 }
 
-bool SensorManagerInterface::registeredAndCorrectClassName(const QString& id, const QString& className ) const
+QString SensorManagerInterface::registeredId(const QString& id) const
 {
+    // Instances of a sensor share the interface registered for the sensor
     QString cleanId = getCleanId(id);
-    return ( sensorInterfaceMap_.contains(cleanId) ) && ( sensorInterfaceMap_[cleanId].type == className );
+    if ( !sensorInterfaceMap_.contains(cleanId) && getInstanceIndex(cleanId) > 0 )
+        return getBaseId(cleanId);
+    return cleanId;
+}
+
+bool SensorManagerInterface::registeredAndCorrectClassName(const QString& id, const QString& className ) const
+{
+    QString registered = registeredId(id);
+    return ( sensorInterfaceMap_.contains(registered) ) && ( sensorInterfaceMap_[registered].type == className );
 }
 
 AbstractSensorChannelInterface* SensorManagerInterface::interface(const QString& id)
 {
-    if ( !sensorInterfaceMap_.contains(id) )
+    if ( !sensorInterfaceMap_.contains(registeredId(id)) )
     {
         qDebug() << "Requested sensor id '" << id << "' interface not known";
         return 0;
@@ -71,7 +80,7 @@ AbstractSensorChannelInterface* SensorManagerInterface::interface(const QString&
     if ( sessionId >= 0 ) // sensor is available
     {
         QString cleanId = getCleanId(id);
-        ifc = sensorInterfaceMap_[cleanId].sensorInterfaceFactory(cleanId, sessionId);
+        ifc = sensorInterfaceMap_[registeredId(cleanId)].sensorInterfaceFactory(cleanId, sessionId);
     }
     else
     {
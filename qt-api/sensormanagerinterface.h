@@ -59,6 +59,13 @@ protected:
     SensorManagerInterface();
     virtual ~SensorManagerInterface() {}
 
+    /**
+     * ID under which the interface of a sensor is registered. Instances
+     * like "accelerometersensor@1" use the interface of their sensor
+     * unless registered separately.
+     */
+    QString registeredId(const QString& id) const;
+
     QMap<QString, SensorInterfaceEntry> sensorInterfaceMap_;
 
     static SensorManagerInterface* ifc_;
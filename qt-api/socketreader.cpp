@@ -127,6 +127,26 @@ bool SocketReader::read(void* buffer, int size)
     return (bytesRead > 0);
 }
 
+bool SocketReader::readClockFrame()
+{
+    unsigned int tag;
+    if (!socket_ || socket_->peek((char*)&tag, sizeof(tag)) != sizeof(tag) || tag != ClockOffsets::FrameTag) {
+        return false;
+    }
+    socket_->read((char*)&tag, sizeof(tag));
+    if (!read((void*)&clockOffsets_, sizeof(clockOffsets_))) {
+        qWarning() << "Error occured while reading clock frame from socket: " << socket_->errorString();
+        socket_->readAll();
+        return false;
+    }
+    return true;
+}
+
+const ClockOffsets& SocketReader::clockOffsets() const
+{
+    return clockOffsets_;
+}
+
 bool SocketReader::isConnected()
 {
     return (socket_ && socket_->isValid() && socket_->state() == QLocalSocket::ConnectedState);
@@ -31,6 +31,8 @@
 #include <QLocalSocket>
 #include <QVector>
 
+#include "datatypes/clockoffsets.h"
+
 /**
  * @brief Helper class for reading socket datachannel from sensord
  *
@@ -109,6 +111,22 @@ public:
      */
     bool isConnected();
 
+    /**
+     * Read a clock frame if one is next in the socket. Clock frames are
+     * sent to sessions with clock sync enabled, in between the sample
+     * frames.
+     *
+     * @return was a clock frame read.
+     */
+    bool readClockFrame();
+
+    /**
+     * Latest clock readings received from the socket.
+     *
+     * @return clock readings, invalid if none has been received.
+     */
+    const ClockOffsets& clockOffsets() const;
+
 private:
     /**
      * Prefix text needed to be written to the sensor daemon socket connection
@@ -123,6 +141,7 @@ private:
 
     QLocalSocket* socket_; /**< socket data connection to sensord */
     bool tagRead_; /**< is initial magic byte read from the socket */
+    ClockOffsets clockOffsets_; /**< latest clock readings */
 };
 
 template<typename T>
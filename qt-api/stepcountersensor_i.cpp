@@ -29,12 +29,13 @@
 #include "sensormanagerinterface.h"
 #include "stepcountersensor_i.h"
 #include "socketreader.h"
+#include "idutils.h"
 
 const char* StepCounterSensorChannelInterface::staticInterfaceName = "local.StepCounterSensor";
 
 AbstractSensorChannelInterface* StepCounterSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new StepCounterSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new StepCounterSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 StepCounterSensorChannelInterface::StepCounterSensorChannelInterface(const QString& path, int sessionId)
@@ -26,13 +26,14 @@
  */
 
 #include "sensormanagerinterface.h"
+#include "idutils.h"
 #include "tapsensor_i.h"
 
 const char* TapSensorChannelInterface::staticInterfaceName = "local.TapSensor";
 
 AbstractSensorChannelInterface* TapSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new TapSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new TapSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 TapSensorChannelInterface::TapSensorChannelInterface(const QString& path, int sessionId)
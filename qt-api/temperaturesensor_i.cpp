@@ -26,12 +26,13 @@
 #include "sensormanagerinterface.h"
 #include "temperaturesensor_i.h"
 #include "socketreader.h"
+#include "idutils.h"
 
 const char* TemperatureSensorChannelInterface::staticInterfaceName = "local.TemperatureSensor";
 
 AbstractSensorChannelInterface* TemperatureSensorChannelInterface::factoryMethod(const QString& id, int sessionId)
 {
-    return new TemperatureSensorChannelInterface(OBJECT_PATH + "/" + id, sessionId);
+    return new TemperatureSensorChannelInterface(OBJECT_PATH + "/" + getObjectPathId(id), sessionId);
 }
 
 TemperatureSensorChannelInterface::TemperatureSensorChannelInterface(const QString& path, int sessionId)
@@ -132,6 +132,7 @@ systemctl daemon-reload || :
 %{_libdir}/libsensorclient-qt5.so.*
 %{_libdir}/libsensordatatypes-qt5.so.*
 %attr(755,root,root)%{_sbindir}/sensorfwd
+%attr(755,root,root)%{_bindir}/sensorctl
 %dir %{_libdir}/sensord-qt5
 %{_libdir}/sensord-qt5/*.so
 %{_libdir}/libsensorfw*.so.*
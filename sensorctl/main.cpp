@@ -0,0 +1,154 @@
+/**
+   @file main.cpp
+   @brief Command line tool for inspecting and streaming sensors
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+
+#include "sensorstream.h"
+#include "abstractsensor_i.h"
+
+#include <stdio.h>
+
+static QString rangesToString(const DataRangeList& ranges)
+{
+    QStringList list;
+    foreach (const DataRange& range, ranges) {
+        list << QString("[%1, %2] res %3").arg(range.min).arg(range.max).arg(range.resolution);
+    }
+    return list.join(", ");
+}
+
+static QString intervalsToString(const DataRangeList& ranges)
+{
+    QStringList list;
+    foreach (const DataRange& range, ranges) {
+        if (range.min == range.max) {
+            list << QString::number(range.min);
+        } else {
+            list << QString("%1-%2").arg(range.min).arg(range.max);
+        }
+    }
+    return list.join(", ");
+}
+
+static int listSensors()
+{
+    QStringList sensors = SensorStream::availableSensors();
+    if (sensors.isEmpty()) {
+        fprintf(stderr, "No sensors available\n");
+        return 1;
+    }
+
+    foreach (const QString& sensor, sensors) {
+        AbstractSensorChannelInterface* ifc = SensorStream::open(sensor);
+        if (!ifc) {
+            printf("%s\n  unavailable\n", qPrintable(sensor));
+            continue;
+        }
+        printf("%s\n", qPrintable(sensor));
+        printf("  description: %s\n", qPrintable(ifc->description()));
+        printf("  type:        %s\n", qPrintable(ifc->type()));
+        printf("  time base:   %s\n", qPrintable(ifc->timeBase()));
+        printf("  location:    %s\n", ifc->location().isEmpty() ? "-" : qPrintable(ifc->location()));
+        printf("  interval:    %d ms\n", ifc->interval());
+        printf("  intervals:   %s\n", qPrintable(intervalsToString(ifc->getAvailableIntervals())));
+        printf("  data ranges: %s\n", qPrintable(rangesToString(ifc->getAvailableDataRanges())));
+        printf("  hw buffering: %s\n", ifc->hwBuffering() ? "yes" : "no");
+        delete ifc;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("sensorctl");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "List sensors of the sensor daemon and stream their samples.\n\n"
+        "Commands:\n"
+        "  list             List sensors with their metadata\n"
+        "  stream <sensor>  Stream samples of a sensor to stdout");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "list or stream");
+    parser.addPositionalArgument("sensor", "Sensor to stream, e.g. accelerometersensor", "[sensor]");
+
+    QCommandLineOption intervalOption("interval", "Requested sample interval.", "ms");
+    QCommandLineOption bufferSizeOption("buffer-size", "Number of samples buffered per frame.", "samples");
+    QCommandLineOption bufferIntervalOption("buffer-interval", "Longest time a sample stays buffered.", "ms");
+    QCommandLineOption downsampleOption("downsample", "Downsample to the requested interval.");
+    QCommandLineOption standbyOption("standby-override", "Keep the sensor running with display off.");
+    QCommandLineOption csvOption("csv", "Write samples as CSV.");
+    QCommandLineOption statsOption("stats", "Print rate, jitter and latency every period.", "ms");
+    QCommandLineOption recordOption("record", "Record samples as CSV to a file.", "file");
+    QCommandLineOption countOption("count", "Stop after given number of samples.", "n");
+    QCommandLineOption durationOption("duration", "Stop after given number of seconds.", "s");
+    parser.addOptions(QList<QCommandLineOption>() << intervalOption << bufferSizeOption
+                      << bufferIntervalOption << downsampleOption << standbyOption
+                      << csvOption << statsOption << recordOption << countOption
+                      << durationOption);
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    if (args.at(0) == "list") {
+        return listSensors();
+    }
+
+    if (args.at(0) != "stream" || args.size() != 2) {
+        parser.showHelp(1);
+    }
+
+    SensorStream stream(args.at(1));
+    stream.setFormat(parser.isSet(csvOption) ? SensorStream::Csv : SensorStream::Human);
+    stream.setInterval(parser.value(intervalOption).toInt());
+    stream.setBufferSize(parser.value(bufferSizeOption).toUInt());
+    stream.setBufferInterval(parser.value(bufferIntervalOption).toUInt());
+    stream.setDownsampling(parser.isSet(downsampleOption));
+    stream.setStandbyOverride(parser.isSet(standbyOption));
+    stream.setCount(parser.value(countOption).toInt());
+    if (parser.isSet(statsOption)) {
+        stream.setStatsPeriod(parser.value(statsOption).toInt());
+    }
+    if (parser.isSet(recordOption) && !stream.setRecordFile(parser.value(recordOption))) {
+        return 1;
+    }
+
+    QObject::connect(&stream, SIGNAL(finished()), &app, SLOT(quit()));
+    int duration = parser.value(durationOption).toInt();
+    if (duration > 0) {
+        QTimer::singleShot(duration * 1000, &app, SLOT(quit()));
+    }
+
+    if (!stream.start()) {
+        return 1;
+    }
+    app.exec();
+    stream.stop();
+
+    int count = parser.value(countOption).toInt();
+    return (count > 0 && stream.received() < count) ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+/**
+   @file samplestats.cpp
+   @brief Rate, jitter and latency statistics of a sample stream
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "samplestats.h"
+
+#include <algorithm>
+#include <math.h>
+
+void SampleStats::add(quint64 timestamp_us, quint64 received_us)
+{
+    timestamps_.append(timestamp_us);
+    latencies_.append((qint64)(received_us - timestamp_us));
+}
+
+void SampleStats::reset()
+{
+    timestamps_.resize(0);
+    latencies_.resize(0);
+}
+
+double SampleStats::rate() const
+{
+    double interval = meanInterval();
+    return interval > 0 ? 1000000.0 / interval : 0;
+}
+
+double SampleStats::meanInterval() const
+{
+    if (timestamps_.size() < 2) {
+        return 0;
+    }
+    return (double)(timestamps_.last() - timestamps_.first()) / (timestamps_.size() - 1);
+}
+
+double SampleStats::jitter() const
+{
+    if (timestamps_.size() < 3) {
+        return 0;
+    }
+    double mean = meanInterval();
+    double sum = 0;
+    for (int i = 1; i < timestamps_.size(); ++i) {
+        double d = (double)(timestamps_.at(i) - timestamps_.at(i - 1)) - mean;
+        sum += d * d;
+    }
+    return sqrt(sum / (timestamps_.size() - 1));
+}
+
+qint64 SampleStats::latency(double percent) const
+{
+    if (latencies_.isEmpty()) {
+        return 0;
+    }
+    QVector<qint64> sorted(latencies_);
+    int index = qBound(0, (int)ceil(percent / 100.0 * sorted.size()) - 1, sorted.size() - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted.at(index);
+}
+
+QString SampleStats::summary() const
+{
+    return QString("n=%1 rate=%2Hz interval=%3ms jitter=%4ms latency p50=%5ms p90=%6ms p99=%7ms")
+        .arg(count())
+        .arg(rate(), 0, 'f', 1)
+        .arg(meanInterval() / 1000.0, 0, 'f', 2)
+        .arg(jitter() / 1000.0, 0, 'f', 2)
+        .arg(latency(50) / 1000.0, 0, 'f', 2)
+        .arg(latency(90) / 1000.0, 0, 'f', 2)
+        .arg(latency(99) / 1000.0, 0, 'f', 2);
+}
@@ -0,0 +1,87 @@
+/**
+   @file samplestats.h
+   @brief Rate, jitter and latency statistics of a sample stream
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SAMPLESTATS_H
+#define SAMPLESTATS_H
+
+#include <QVector>
+#include <QString>
+
+/**
+ * Collects sample and receive timestamps of a stream, and computes the
+ * sample rate, the jitter of the sample interval and percentiles of the
+ * delivery latency over the collected samples.
+ */
+class SampleStats
+{
+public:
+    /**
+     * Add a sample.
+     *
+     * @param timestamp_us Sample timestamp.
+     * @param received_us Time the sample was received, in the clock of
+     *                    the sample timestamps.
+     */
+    void add(quint64 timestamp_us, quint64 received_us);
+
+    /**
+     * Forget collected samples.
+     */
+    void reset();
+
+    /**
+     * Number of collected samples.
+     */
+    int count() const { return timestamps_.size(); }
+
+    /**
+     * Sample rate in Hz, from sample timestamps.
+     */
+    double rate() const;
+
+    /**
+     * Mean interval between samples in microseconds.
+     */
+    double meanInterval() const;
+
+    /**
+     * Standard deviation of the interval between samples in microseconds.
+     */
+    double jitter() const;
+
+    /**
+     * Latency percentile in microseconds.
+     *
+     * @param percent Percentile, 0-100.
+     */
+    qint64 latency(double percent) const;
+
+    /**
+     * One line summary of the statistics.
+     */
+    QString summary() const;
+
+private:
+    QVector<quint64> timestamps_;
+    QVector<qint64> latencies_;
+};
+
+#endif // SAMPLESTATS_H
@@ -0,0 +1,33 @@
+QT += dbus network
+QT -= gui
+
+TEMPLATE = app
+TARGET = sensorctl
+
+include( ../common-config.pri )
+
+CONFIG += console
+
+SENSORFW_INCLUDEPATHS = .. \
+                        ../include \
+                        ../datatypes \
+                        ../core \
+                        ../qt-api
+
+DEPENDPATH += $$SENSORFW_INCLUDEPATHS
+INCLUDEPATH += $$SENSORFW_INCLUDEPATHS
+
+QMAKE_LIBDIR_FLAGS += -L../qt-api \
+                      -L../datatypes \
+                      -lsensorclient-qt$${QT_MAJOR_VERSION} \
+                      -lsensordatatypes-qt$${QT_MAJOR_VERSION}
+
+HEADERS += samplestats.h \
+           sensorstream.h
+
+SOURCES += main.cpp \
+           samplestats.cpp \
+           sensorstream.cpp
+
+target.path = /usr/bin
+INSTALLS += target
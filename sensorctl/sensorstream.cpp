@@ -0,0 +1,419 @@
+/**
+   @file sensorstream.cpp
+   @brief Streams samples of a sensor to stdout
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "sensorstream.h"
+#include "sensormanagerinterface.h"
+#include "idutils.h"
+#include "accelerometersensor_i.h"
+#include "alssensor_i.h"
+#include "compasssensor_i.h"
+#include "environmentsensor_i.h"
+#include "gyroscopesensor_i.h"
+#include "hingesensor_i.h"
+#include "humiditysensor_i.h"
+#include "lidsensor_i.h"
+#include "magnetometersensor_i.h"
+#include "orientationsensor_i.h"
+#include "pressuresensor_i.h"
+#include "proximitysensor_i.h"
+#include "rotationsensor_i.h"
+#include "stepcountersensor_i.h"
+#include "tapsensor_i.h"
+#include "temperaturesensor_i.h"
+
+#include <stdio.h>
+
+template<class T>
+static void registerInterface(const QString& sensor)
+{
+    SensorManagerInterface::instance().registerSensorInterface<T>(sensor);
+}
+
+/**
+ * Client interface, signals and sample columns of a sensor.
+ */
+struct SensorEntry
+{
+    const char* name;
+    void (*registerInterface)(const QString& sensor);
+    const char* signal;
+    const char* slot;
+    const char* frameSignal;
+    const char* frameSlot;
+    const char* columns;
+};
+
+static const SensorEntry sensorTable[] = {
+    { "accelerometersensor", registerInterface<AccelerometerSensorChannelInterface>,
+      SIGNAL(dataAvailable(const XYZ&)), SLOT(xyzReceived(const XYZ&)),
+      SIGNAL(frameAvailable(const QVector<XYZ>&)), SLOT(xyzFrameReceived(const QVector<XYZ>&)),
+      "x,y,z" },
+    { "gyroscopesensor", registerInterface<GyroscopeSensorChannelInterface>,
+      SIGNAL(dataAvailable(const XYZ&)), SLOT(xyzReceived(const XYZ&)),
+      SIGNAL(frameAvailable(const QVector<XYZ>&)), SLOT(xyzFrameReceived(const QVector<XYZ>&)),
+      "x,y,z" },
+    { "rotationsensor", registerInterface<RotationSensorChannelInterface>,
+      SIGNAL(dataAvailable(const XYZ&)), SLOT(xyzReceived(const XYZ&)),
+      SIGNAL(frameAvailable(const QVector<XYZ>&)), SLOT(xyzFrameReceived(const QVector<XYZ>&)),
+      "x,y,z" },
+    { "magnetometersensor", registerInterface<MagnetometerSensorChannelInterface>,
+      SIGNAL(dataAvailable(const MagneticField&)), SLOT(magneticFieldReceived(const MagneticField&)),
+      SIGNAL(frameAvailable(const QVector<MagneticField>&)), SLOT(magneticFieldFrameReceived(const QVector<MagneticField>&)),
+      "x,y,z,rx,ry,rz,level" },
+    { "compasssensor", registerInterface<CompassSensorChannelInterface>,
+      SIGNAL(dataAvailable(const Compass&)), SLOT(compassReceived(const Compass&)),
+      0, 0, "degrees,rawDegrees,correctedDegrees,level" },
+    { "alssensor", registerInterface<ALSSensorChannelInterface>,
+      SIGNAL(ALSChanged(const Unsigned&)), SLOT(unsignedReceived(const Unsigned&)),
+      0, 0, "lux" },
+    { "orientationsensor", registerInterface<OrientationSensorChannelInterface>,
+      SIGNAL(orientationChanged(const Unsigned&)), SLOT(unsignedReceived(const Unsigned&)),
+      0, 0, "orientation" },
+    { "pressuresensor", registerInterface<PressureSensorChannelInterface>,
+      SIGNAL(pressureChanged(const Unsigned&)), SLOT(unsignedReceived(const Unsigned&)),
+      0, 0, "pressure" },
+    { "temperaturesensor", registerInterface<TemperatureSensorChannelInterface>,
+      SIGNAL(temperatureChanged(const Unsigned&)), SLOT(unsignedReceived(const Unsigned&)),
+      0, 0, "temperature" },
+    { "humiditysensor", registerInterface<HumiditySensorChannelInterface>,
+      SIGNAL(relativeHumidityChanged(const Unsigned&)), SLOT(unsignedReceived(const Unsigned&)),
+      0, 0, "humidity" },
+    { "stepcountersensor", registerInterface<StepCounterSensorChannelInterface>,
+      SIGNAL(StepCounterChanged(const Unsigned&)), SLOT(unsignedReceived(const Unsigned&)),
+      0, 0, "steps" },
+    { "proximitysensor", registerInterface<ProximitySensorChannelInterface>,
+      SIGNAL(reflectanceDataAvailable(const Proximity&)), SLOT(proximityReceived(const Proximity&)),
+      0, 0, "withinProximity,reflectance" },
+    { "tapsensor", registerInterface<TapSensorChannelInterface>,
+      SIGNAL(dataAvailable(const Tap&)), SLOT(tapReceived(const Tap&)),
+      0, 0, "direction,type" },
+    { "lidsensor", registerInterface<LidSensorChannelInterface>,
+      SIGNAL(lidChanged(const LidData&)), SLOT(lidReceived(const LidData&)),
+      0, 0, "type,value" },
+    { "hingesensor", registerInterface<HingeSensorChannelInterface>,
+      SIGNAL(postureChanged(const PostureData&)), SLOT(postureReceived(const PostureData&)),
+      0, 0, "posture,angle" },
+    { "environmentsensor", registerInterface<EnvironmentSensorChannelInterface>,
+      SIGNAL(environmentChanged(const EnvironmentData&)), SLOT(environmentReceived(const EnvironmentData&)),
+      0, 0, "temperature,humidity,dewPoint,heatIndex" },
+    { 0, 0, 0, 0, 0, 0, 0 }
+};
+
+static const SensorEntry* findSensor(const QString& sensor)
+{
+    QString baseId = getBaseId(sensor);
+    for (int i = 0; sensorTable[i].name; ++i) {
+        if (baseId == sensorTable[i].name) {
+            return &sensorTable[i];
+        }
+    }
+    return 0;
+}
+
+bool SensorStream::registerSensor(const QString& sensor)
+{
+    const SensorEntry* entry = findSensor(sensor);
+    if (!entry) {
+        fprintf(stderr, "Unknown sensor: %s\n", qPrintable(sensor));
+        return false;
+    }
+
+    SensorManagerInterface& sm = SensorManagerInterface::instance();
+    if (!sm.isValid()) {
+        fprintf(stderr, "Cannot connect to sensor daemon: %s\n", qPrintable(sm.lastError().message()));
+        return false;
+    }
+    QDBusReply<bool> reply(sm.loadPlugin(entry->name));
+    if (!reply.isValid() || !reply.value()) {
+        fprintf(stderr, "Failed to load plugin for %s\n", qPrintable(sensor));
+        return false;
+    }
+    entry->registerInterface(entry->name);
+    return true;
+}
+
+QStringList SensorStream::availableSensors()
+{
+    SensorManagerInterface& sm = SensorManagerInterface::instance();
+    QDBusReply<QStringList> reply(sm.call("availableSensorPlugins"));
+    if (!reply.isValid()) {
+        return QStringList();
+    }
+    QStringList plugins = reply.value();
+    plugins.sort();
+
+    QStringList sensors;
+    foreach (const QString& plugin, plugins) {
+        QDBusReply<QStringList> instances(sm.call("availableSensorInstances", plugin));
+        if (instances.isValid() && !instances.value().isEmpty()) {
+            sensors << instances.value();
+        } else {
+            sensors << plugin;
+        }
+    }
+    return sensors;
+}
+
+AbstractSensorChannelInterface* SensorStream::open(const QString& sensor)
+{
+    if (!registerSensor(sensor)) {
+        return 0;
+    }
+    AbstractSensorChannelInterface* ifc = SensorManagerInterface::instance().interface(sensor);
+    if (!ifc || !ifc->isValid()) {
+        fprintf(stderr, "Failed to open session for %s\n", qPrintable(sensor));
+        delete ifc;
+        return 0;
+    }
+    return ifc;
+}
+
+SensorStream::SensorStream(const QString& sensor, QObject* parent) :
+    QObject(parent),
+    sensor_(sensor),
+    interface_(0),
+    format_(Human),
+    interval_ms_(0),
+    bufferSize_(0),
+    bufferInterval_ms_(0),
+    downsampling_(false),
+    standbyOverride_(false),
+    count_(0),
+    received_(0),
+    statsPeriod_ms_(0),
+    clock_(CLOCK_MONOTONIC),
+    out_(stdout)
+{
+    connect(&statsTimer_, SIGNAL(timeout()), this, SLOT(printStats()));
+}
+
+SensorStream::~SensorStream()
+{
+    stop();
+}
+
+bool SensorStream::setRecordFile(const QString& path)
+{
+    recordFile_.setFileName(path);
+    if (!recordFile_.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        fprintf(stderr, "Cannot open %s: %s\n", qPrintable(path), qPrintable(recordFile_.errorString()));
+        return false;
+    }
+    record_.setDevice(&recordFile_);
+    return true;
+}
+
+bool SensorStream::connectSignals()
+{
+    const SensorEntry* entry = findSensor(sensor_);
+    if (!entry) {
+        return false;
+    }
+    columns_ = QString(entry->columns).split(',');
+    connect(interface_, entry->signal, this, entry->slot);
+    if (entry->frameSignal) {
+        connect(interface_, entry->frameSignal, this, entry->frameSlot);
+    }
+    return true;
+}
+
+bool SensorStream::start()
+{
+    interface_ = open(sensor_);
+    if (!interface_ || !connectSignals()) {
+        return false;
+    }
+
+    QString timeBase = interface_->timeBase();
+    if (timeBase == "boottime") {
+        clock_ = CLOCK_BOOTTIME;
+    } else if (timeBase == "realtime") {
+        clock_ = CLOCK_REALTIME;
+    } else {
+        clock_ = CLOCK_MONOTONIC;
+    }
+
+    if (interval_ms_ > 0) {
+        interface_->setInterval(interval_ms_);
+    }
+    if (bufferSize_ > 0) {
+        interface_->setBufferSize(bufferSize_);
+    }
+    if (bufferInterval_ms_ > 0) {
+        interface_->setBufferInterval(bufferInterval_ms_);
+    }
+    interface_->setDownsampling(downsampling_);
+    interface_->setStandbyOverride(standbyOverride_);
+
+    if (format_ == Csv) {
+        out_ << csvHeader() << endl;
+    }
+    if (record_.device()) {
+        record_ << csvHeader() << endl;
+    }
+
+    QDBusReply<void> reply = interface_->start();
+    if (!reply.isValid()) {
+        fprintf(stderr, "Failed to start %s: %s\n", qPrintable(sensor_), qPrintable(reply.error().message()));
+        return false;
+    }
+    if (statsPeriod_ms_ > 0) {
+        statsTimer_.start(statsPeriod_ms_);
+    }
+    return true;
+}
+
+void SensorStream::stop()
+{
+    if (!interface_) {
+        return;
+    }
+    statsTimer_.stop();
+    interface_->stop();
+    delete interface_;
+    interface_ = 0;
+
+    out_.flush();
+    if (record_.device()) {
+        record_.flush();
+        recordFile_.close();
+    }
+    if (totalStats_.count()) {
+        fprintf(stderr, "%s total: %s\n", qPrintable(sensor_), qPrintable(totalStats_.summary()));
+    }
+}
+
+quint64 SensorStream::now() const
+{
+    struct timespec ts;
+    clock_gettime(clock_, &ts);
+    return (quint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+QString SensorStream::csvHeader() const
+{
+    return "timestamp," + columns_.join(",");
+}
+
+void SensorStream::writeSample(quint64 timestamp, const QVector<double>& values)
+{
+    if (count_ > 0 && received_ >= count_) {
+        return;
+    }
+    quint64 received = now();
+    stats_.add(timestamp, received);
+    totalStats_.add(timestamp, received);
+    ++received_;
+
+    QString csv = QString::number(timestamp);
+    foreach (double value, values) {
+        csv += ',' + QString::number(value);
+    }
+
+    if (format_ == Csv) {
+        out_ << csv << endl;
+    } else {
+        out_ << QString("%1.%2").arg(timestamp / 1000000).arg(timestamp % 1000000, 6, 10, QChar('0'));
+        for (int i = 0; i < values.size() && i < columns_.size(); ++i) {
+            out_ << ' ' << columns_.at(i) << '=' << values.at(i);
+        }
+        out_ << endl;
+    }
+    if (record_.device()) {
+        record_ << csv << '\n';
+    }
+
+    if (count_ > 0 && received_ == count_) {
+        emit finished();
+    }
+}
+
+void SensorStream::printStats()
+{
+    if (!stats_.count()) {
+        fprintf(stderr, "%s: no samples\n", qPrintable(sensor_));
+        return;
+    }
+    fprintf(stderr, "%s: %s\n", qPrintable(sensor_), qPrintable(stats_.summary()));
+    stats_.reset();
+}
+
+void SensorStream::xyzReceived(const XYZ& data)
+{
+    writeSample(data.XYZData().timestamp_, QVector<double>() << data.x() << data.y() << data.z());
+}
+
+void SensorStream::xyzFrameReceived(const QVector<XYZ>& frame)
+{
+    foreach (const XYZ& data, frame) {
+        xyzReceived(data);
+    }
+}
+
+void SensorStream::magneticFieldReceived(const MagneticField& data)
+{
+    writeSample(data.data().timestamp_, QVector<double>() << data.x() << data.y() << data.z()
+                << data.rx() << data.ry() << data.rz() << data.level());
+}
+
+void SensorStream::magneticFieldFrameReceived(const QVector<MagneticField>& frame)
+{
+    foreach (const MagneticField& data, frame) {
+        magneticFieldReceived(data);
+    }
+}
+
+void SensorStream::compassReceived(const Compass& data)
+{
+    const CompassData& d = data.data();
+    writeSample(d.timestamp_, QVector<double>() << d.degrees_ << d.rawDegrees_ << d.correctedDegrees_ << d.level_);
+}
+
+void SensorStream::unsignedReceived(const Unsigned& data)
+{
+    writeSample(data.UnsignedData().timestamp_, QVector<double>() << data.x());
+}
+
+void SensorStream::tapReceived(const Tap& data)
+{
+    writeSample(data.tapData().timestamp_, QVector<double>() << data.direction() << data.type());
+}
+
+void SensorStream::proximityReceived(const Proximity& data)
+{
+    writeSample(data.proximityData().timestamp_, QVector<double>() << data.withinProximity() << data.reflectance());
+}
+
+void SensorStream::lidReceived(const LidData& data)
+{
+    writeSample(data.timestamp_, QVector<double>() << data.type_ << data.value_);
+}
+
+void SensorStream::postureReceived(const PostureData& data)
+{
+    writeSample(data.timestamp_, QVector<double>() << data.posture_ << data.angle_);
+}
+
+void SensorStream::environmentReceived(const EnvironmentData& data)
+{
+    writeSample(data.timestamp_, QVector<double>() << data.temperature_ << data.humidity_
+                                                   << data.dewPoint_ << data.heatIndex_);
+}
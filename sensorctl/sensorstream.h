@@ -0,0 +1,192 @@
+/**
+   @file sensorstream.h
+   @brief Streams samples of a sensor to stdout
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef SENSORSTREAM_H
+#define SENSORSTREAM_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+#include <time.h>
+
+#include "samplestats.h"
+#include "xyz.h"
+#include "unsigned.h"
+#include "compass.h"
+#include "magneticfield.h"
+#include "tap.h"
+#include "proximity.h"
+#include "lid.h"
+#include "posturedata.h"
+#include "environmentdata.h"
+
+class AbstractSensorChannelInterface;
+
+/**
+ * Streams samples of one sensor through the client library.
+ *
+ * Samples are written to stdout as human readable lines or CSV, and
+ * optionally recorded as CSV to a file. Rate, jitter and latency of the
+ * stream are printed to stderr at a fixed period, and once more when
+ * the stream ends.
+ */
+class SensorStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Output format of samples.
+     */
+    enum Format
+    {
+        Human = 0, /**< one labelled line per sample */
+        Csv        /**< comma separated values with a header line */
+    };
+
+    /**
+     * Load plugin of a sensor in the daemon and register its client
+     * interface.
+     *
+     * @param sensor Sensor name, e.g. \c accelerometersensor.
+     * @return was sensor registered.
+     */
+    static bool registerSensor(const QString& sensor);
+
+    /**
+     * Names of sensors available in the daemon, including configured
+     * instances such as \c accelerometersensor@1.
+     */
+    static QStringList availableSensors();
+
+    /**
+     * Open a session to a registered sensor.
+     *
+     * @param sensor Sensor name.
+     * @return Session interface, or \c NULL.
+     */
+    static AbstractSensorChannelInterface* open(const QString& sensor);
+
+    /**
+     * Constructor.
+     *
+     * @param sensor Sensor name.
+     * @param parent Parent object.
+     */
+    SensorStream(const QString& sensor, QObject* parent = 0);
+
+    virtual ~SensorStream();
+
+    void setFormat(Format format) { format_ = format; }
+    void setInterval(int interval_ms) { interval_ms_ = interval_ms; }
+    void setBufferSize(unsigned int size) { bufferSize_ = size; }
+    void setBufferInterval(unsigned int interval_ms) { bufferInterval_ms_ = interval_ms; }
+    void setDownsampling(bool value) { downsampling_ = value; }
+    void setStandbyOverride(bool value) { standbyOverride_ = value; }
+
+    /**
+     * Stop after given number of samples.
+     */
+    void setCount(int count) { count_ = count; }
+
+    /**
+     * Print statistics every given number of milliseconds, 0 to print
+     * them only at the end.
+     */
+    void setStatsPeriod(int period_ms) { statsPeriod_ms_ = period_ms; }
+
+    /**
+     * Record samples as CSV to a file.
+     *
+     * @param path File to write.
+     * @return was file opened.
+     */
+    bool setRecordFile(const QString& path);
+
+    /**
+     * Open session and start streaming.
+     *
+     * @return was streaming started.
+     */
+    bool start();
+
+    /**
+     * Stop streaming and print final statistics.
+     */
+    void stop();
+
+    /**
+     * Number of samples received.
+     */
+    int received() const { return received_; }
+
+Q_SIGNALS:
+    /**
+     * Emitted when the requested number of samples has been received.
+     */
+    void finished();
+
+private Q_SLOTS:
+    void xyzReceived(const XYZ& data);
+    void xyzFrameReceived(const QVector<XYZ>& frame);
+    void magneticFieldReceived(const MagneticField& data);
+    void magneticFieldFrameReceived(const QVector<MagneticField>& frame);
+    void compassReceived(const Compass& data);
+    void unsignedReceived(const Unsigned& data);
+    void tapReceived(const Tap& data);
+    void proximityReceived(const Proximity& data);
+    void lidReceived(const LidData& data);
+    void postureReceived(const PostureData& data);
+    void environmentReceived(const EnvironmentData& data);
+    void printStats();
+
+private:
+    bool connectSignals();
+    void writeSample(quint64 timestamp, const QVector<double>& values);
+    QString csvHeader() const;
+    quint64 now() const;
+
+    QString sensor_;
+    AbstractSensorChannelInterface* interface_;
+    QStringList columns_;
+    Format format_;
+    int interval_ms_;
+    unsigned int bufferSize_;
+    unsigned int bufferInterval_ms_;
+    bool downsampling_;
+    bool standbyOverride_;
+    int count_;
+    int received_;
+    int statsPeriod_ms_;
+    clockid_t clock_;
+    SampleStats stats_;
+    SampleStats totalStats_;
+    QTimer statsTimer_;
+    QFile recordFile_;
+    QTextStream record_;
+    QTextStream out_;
+};
+
+#endif // SENSORSTREAM_H
@@ -42,6 +42,8 @@
 #include <fcntl.h>
 
 #include "config.h"
+#include "deviceprobe.h"
+#include "cpuaccounting.h"
 #include "sensormanager.h"
 #include "sensormanager_a.h"
 #include "logging.h"
@@ -252,6 +254,17 @@ int main(int argc, char *argv[])
         }
     }
 
+    // Probe device nodes in the background while the rest of the
+    // daemon starts up; adaptors pick the results up from the cache.
+    // Must happen after fork() as threads do not survive it.
+    DeviceProbe::instance().prefetch(DeviceProbe::configuredPaths());
+
+    if (SensorFrameworkConfig::configuration()->value<bool>("global/watch_config", true)) {
+        SensorFrameworkConfig::watcher()->setWatching(true);
+    }
+
+    CpuAccounting::setEnabled(SensorFrameworkConfig::configuration()->value<bool>("global/cpu_accounting", false));
+
     SensorManager& sm = SensorManager::instance();
 
 #ifdef PROVIDE_CONTEXT_INFO
@@ -22,6 +22,7 @@ SUBDIRS = datatypes \
           sensors \
           sensord \
           qt-api \
+          sensorctl \
           chains \
           tests \
           examples
@@ -74,6 +75,7 @@ contains(CONFIG,hybris) {
     QTCONFIGFILES.files = sensord.prf
 
     qt-api.depends = datatypes
+    sensorctl.depends = qt-api
     sensord.depends = datatypes adaptors sensors chains
 
     include( doc/doc.pri )
@@ -38,7 +38,7 @@ AccelerometerSensorChannel::AccelerometerSensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    accelerometerChain_ = sm.requestChain("accelerometerchain");
+    accelerometerChain_ = sm.requestChain(instanceId("accelerometerchain"));
     if (!accelerometerChain_) {
         setValid(false);
         return;
@@ -50,7 +50,7 @@ AccelerometerSensorChannel::AccelerometerSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<AccelerationData>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(accelerometerReader_, "accelerometer");
     filterBin_->add(outputBuffer_, "buffer");
@@ -60,13 +60,14 @@ AccelerometerSensorChannel::AccelerometerSensorChannel(const QString& id) :
     // Join datasources to the chain
     connectToSource(accelerometerChain_, "accelerometer", accelerometerReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
 
     // Set MetaData
     setDescription("x, y, and z axes accelerations in mG");
+    setPredictionModel(SamplePredictor::Linear);
     setRangeSource(accelerometerChain_);
     addStandbyOverrideSource(accelerometerChain_);
     setIntervalSource(accelerometerChain_);
@@ -79,7 +80,7 @@ AccelerometerSensorChannel::~AccelerometerSensorChannel()
 
         disconnectFromSource(accelerometerChain_, "accelerometer", accelerometerReader_);
 
-        sm.releaseChain("accelerometerchain");
+        sm.releaseChain(instanceId("accelerometerchain"));
 
         delete accelerometerReader_;
         delete outputBuffer_;
@@ -46,7 +46,7 @@ ALSSensorChannel::ALSSensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    alsAdaptor_ = sm.requestDeviceAdaptor("alsadaptor");
+    alsAdaptor_ = sm.requestDeviceAdaptor(instanceId("alsadaptor"));
     if (!alsAdaptor_) {
         setValid(false);
         return;
@@ -57,7 +57,7 @@ ALSSensorChannel::ALSSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<TimedUnsigned>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(alsReader_, "als");
     filterBin_->add(outputBuffer_, "buffer");
@@ -67,7 +67,7 @@ ALSSensorChannel::ALSSensorChannel(const QString& id) :
     // Join datasources to the chain
     connectToSource(alsAdaptor_, "als", alsReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
@@ -101,7 +101,7 @@ ALSSensorChannel::~ALSSensorChannel()
 
         disconnectFromSource(alsAdaptor_, "als", alsReader_);
 
-        sm.releaseDeviceAdaptor("alsadaptor");
+        sm.releaseDeviceAdaptor(instanceId("alsadaptor"));
 
         delete alsReader_;
         delete outputBuffer_;
@@ -139,7 +139,7 @@ void ALSSensorChannel::emitData(const TimedUnsigned& value)
     if (value.value_ != previousValue_.value_) {
         previousValue_.value_ = value.value_;
 
-        writeToClients((const void*)(&value), sizeof(value));
+        writeToClients(value);
     }
 
 #ifdef PROVIDE_CONTEXT_INFO
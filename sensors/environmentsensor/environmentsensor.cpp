@@ -0,0 +1,111 @@
+/**
+   @file environmentsensor.cpp
+   @brief EnvironmentSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "environmentsensor.h"
+
+#include "sensormanager.h"
+#include "bin.h"
+#include "bufferreader.h"
+
+EnvironmentSensorChannel::EnvironmentSensorChannel(const QString& id) :
+        AbstractSensorChannel(id),
+        DataEmitter<EnvironmentData>(1)
+{
+    SensorManager& sm = SensorManager::instance();
+
+    environmentChain_ = sm.requestChain("environmentchain");
+    if (!environmentChain_) {
+        setValid(false);
+        return;
+    }
+    setValid(environmentChain_->isValid());
+
+    environmentReader_ = new BufferReader<EnvironmentData>(1);
+
+    outputBuffer_ = new RingBuffer<EnvironmentData>(1);
+
+    // Create buffers for filter chain
+    filterBin_ = new Bin(id);
+
+    filterBin_->add(environmentReader_, "environment");
+    filterBin_->add(outputBuffer_, "buffer");
+
+    filterBin_->join("environment", "source", "buffer", "sink");
+
+    // Join datasources to the chain
+    connectToSource(environmentChain_, "environment", environmentReader_);
+
+    marshallingBin_ = new Bin(id);
+    marshallingBin_->add(this, "sensorchannel");
+
+    outputBuffer_->join(this);
+
+    setDescription("ambient temperature, humidity, dew point and heat index");
+    addStandbyOverrideSource(environmentChain_);
+    setIntervalSource(environmentChain_);
+}
+
+EnvironmentSensorChannel::~EnvironmentSensorChannel()
+{
+    if (isValid()) {
+        SensorManager& sm = SensorManager::instance();
+
+        disconnectFromSource(environmentChain_, "environment", environmentReader_);
+
+        sm.releaseChain("environmentchain");
+
+        delete environmentReader_;
+        delete outputBuffer_;
+        delete marshallingBin_;
+        delete filterBin_;
+    }
+}
+
+bool EnvironmentSensorChannel::start()
+{
+    sensordLogD() << id() << "Starting EnvironmentSensorChannel";
+
+    if (AbstractSensorChannel::start()) {
+        marshallingBin_->start();
+        filterBin_->start();
+        environmentChain_->start();
+    }
+    return true;
+}
+
+bool EnvironmentSensorChannel::stop()
+{
+    sensordLogD() << id() << "Stopping EnvironmentSensorChannel";
+
+    if (AbstractSensorChannel::stop()) {
+        environmentChain_->stop();
+        filterBin_->stop();
+        marshallingBin_->stop();
+    }
+    return true;
+}
+
+void EnvironmentSensorChannel::emitData(const EnvironmentData& value)
+{
+    // The chain reports only changes beyond its thresholds
+    previousValue_ = value;
+    writeToClients(value);
+}
@@ -0,0 +1,95 @@
+/**
+   @file environmentsensor.h
+   @brief EnvironmentSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef ENVIRONMENT_SENSOR_CHANNEL_H
+#define ENVIRONMENT_SENSOR_CHANNEL_H
+
+#include "abstractsensor.h"
+#include "abstractchain.h"
+#include "environmentsensor_a.h"
+#include "dataemitter.h"
+#include "datatypes/environmentdata.h"
+
+class Bin;
+template <class TYPE> class BufferReader;
+
+/**
+ * @brief Sensor for ambient conditions and the comfort values derived
+ *        from them.
+ *
+ * Reports temperature, relative humidity, dew point and heat index as
+ * produced by #EnvironmentChain. Samples are sent only when temperature
+ * or humidity has changed by at least the configured thresholds, and
+ * the adaptors are polled less often while readings stay stable.
+ */
+class EnvironmentSensorChannel :
+        public AbstractSensorChannel,
+        public DataEmitter<EnvironmentData>
+{
+    Q_OBJECT
+    Q_PROPERTY(EnvironmentData environment READ environment)
+
+public:
+    /**
+     * Factory method for EnvironmentSensorChannel.
+     * @return New EnvironmentSensorChannel as AbstractSensorChannel*
+     */
+    static AbstractSensorChannel* factoryMethod(const QString& id)
+    {
+        EnvironmentSensorChannel* sc = new EnvironmentSensorChannel(id);
+        new EnvironmentSensorChannelAdaptor(sc);
+
+        return sc;
+    }
+
+    /**
+     * Property method returning the last reported sample.
+     * @return Last reported sample.
+     */
+    EnvironmentData environment() const { return previousValue_; }
+
+public Q_SLOTS:
+    bool start();
+    bool stop();
+
+signals:
+    /**
+     * Sent when ambient conditions have changed.
+     * @param value New readings and derived values.
+     */
+    void environmentChanged(const EnvironmentData& value);
+
+protected:
+    EnvironmentSensorChannel(const QString& id);
+    virtual ~EnvironmentSensorChannel();
+
+private:
+    EnvironmentData                  previousValue_;
+    Bin*                             filterBin_;
+    Bin*                             marshallingBin_;
+    AbstractChain*                   environmentChain_;
+    BufferReader<EnvironmentData>*   environmentReader_;
+    RingBuffer<EnvironmentData>*     outputBuffer_;
+
+    void emitData(const EnvironmentData& value);
+};
+
+#endif // ENVIRONMENT_SENSOR_CHANNEL_H
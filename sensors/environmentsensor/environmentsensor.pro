@@ -0,0 +1,11 @@
+TARGET       = environmentsensor
+
+HEADERS += environmentsensor.h   \
+           environmentsensor_a.h \
+           environmentplugin.h
+
+SOURCES += environmentsensor.cpp   \
+           environmentsensor_a.cpp \
+           environmentplugin.cpp
+
+include( ../sensor-config.pri )
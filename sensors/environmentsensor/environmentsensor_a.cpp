@@ -0,0 +1,48 @@
+/**
+   @file environmentsensor_a.cpp
+   @brief D-Bus adaptor for EnvironmentSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "environmentsensor_a.h"
+#include "datatypes/environmentdata.h"
+
+EnvironmentSensorChannelAdaptor::EnvironmentSensorChannelAdaptor(QObject* parent) :
+    AbstractSensorChannelAdaptor(parent)
+{
+}
+
+double EnvironmentSensorChannelAdaptor::temperature() const
+{
+    return qvariant_cast<EnvironmentData>(parent()->property("environment")).temperature_;
+}
+
+double EnvironmentSensorChannelAdaptor::humidity() const
+{
+    return qvariant_cast<EnvironmentData>(parent()->property("environment")).humidity_;
+}
+
+double EnvironmentSensorChannelAdaptor::dewPoint() const
+{
+    return qvariant_cast<EnvironmentData>(parent()->property("environment")).dewPoint_;
+}
+
+double EnvironmentSensorChannelAdaptor::heatIndex() const
+{
+    return qvariant_cast<EnvironmentData>(parent()->property("environment")).heatIndex_;
+}
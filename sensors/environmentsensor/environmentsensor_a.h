@@ -0,0 +1,50 @@
+/**
+   @file environmentsensor_a.h
+   @brief D-Bus adaptor for EnvironmentSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef ENVIRONMENT_SENSOR_H
+#define ENVIRONMENT_SENSOR_H
+
+#include <QtDBus/QtDBus>
+#include <QObject>
+
+#include "abstractsensor_a.h"
+
+class EnvironmentSensorChannelAdaptor : public AbstractSensorChannelAdaptor
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(EnvironmentSensorChannelAdaptor)
+    Q_CLASSINFO("D-Bus Interface", "local.EnvironmentSensor")
+    Q_PROPERTY(double temperature READ temperature)
+    Q_PROPERTY(double humidity READ humidity)
+    Q_PROPERTY(double dewPoint READ dewPoint)
+    Q_PROPERTY(double heatIndex READ heatIndex)
+
+public:
+    EnvironmentSensorChannelAdaptor(QObject* parent);
+
+public Q_SLOTS:
+    double temperature() const;
+    double humidity() const;
+    double dewPoint() const;
+    double heatIndex() const;
+};
+
+#endif
@@ -38,8 +38,8 @@ void GyroscopePlugin::Register(class Loader&)
 
 QStringList GyroscopePlugin::Dependencies() {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-    return QString("gyroscopeadaptor").split(":", Qt::SkipEmptyParts);
+    return QString("gyroscopechain").split(":", Qt::SkipEmptyParts);
 #else
-    return QString("gyroscopeadaptor").split(":", QString::SkipEmptyParts);
+    return QString("gyroscopechain").split(":", QString::SkipEmptyParts);
 #endif
 }
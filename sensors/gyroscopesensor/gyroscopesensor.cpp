@@ -37,8 +37,8 @@ GyroscopeSensorChannel::GyroscopeSensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    gyroscopeAdaptor_ = sm.requestDeviceAdaptor("gyroscopeadaptor");
-    if (!gyroscopeAdaptor_) {
+    gyroscopeChain_ = sm.requestChain(instanceId("gyroscopechain"));
+    if (!gyroscopeChain_) {
         setValid(false);
         return;
     }
@@ -48,27 +48,28 @@ GyroscopeSensorChannel::GyroscopeSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<TimedXyzData>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
     filterBin_->add(gyroscopeReader_, "gyroscope");
     filterBin_->add(outputBuffer_, "output");
 
     filterBin_->join("gyroscope", "source", "output", "sink");
 
     // Join datasources to the chain
-    connectToSource(gyroscopeAdaptor_, "gyroscope", gyroscopeReader_);
+    connectToSource(gyroscopeChain_, "gyroscope", gyroscopeReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
 
     // Set MetaData
     setDescription("x, y, and z axes angular velocity in mdps");
-    setRangeSource(gyroscopeAdaptor_);
-    addStandbyOverrideSource(gyroscopeAdaptor_);
-    setIntervalSource(gyroscopeAdaptor_);
+    setPredictionModel(SamplePredictor::ConstantValue);
+    setRangeSource(gyroscopeChain_);
+    addStandbyOverrideSource(gyroscopeChain_);
+    setIntervalSource(gyroscopeChain_);
 
-    setValid(true);
+    setValid(gyroscopeChain_->isValid());
 }
 
 GyroscopeSensorChannel::~GyroscopeSensorChannel()
@@ -76,9 +77,9 @@ GyroscopeSensorChannel::~GyroscopeSensorChannel()
     if (isValid()) {
         SensorManager& sm = SensorManager::instance();
 
-        disconnectFromSource(gyroscopeAdaptor_, "gyroscope", gyroscopeReader_);
+        disconnectFromSource(gyroscopeChain_, "gyroscope", gyroscopeReader_);
 
-        sm.releaseDeviceAdaptor("gyroscopeadaptor");
+        sm.releaseChain(instanceId("gyroscopechain"));
 
         delete gyroscopeReader_;
         delete outputBuffer_;
@@ -94,7 +95,7 @@ bool GyroscopeSensorChannel::start()
     if (AbstractSensorChannel::start()) {
         marshallingBin_->start();
         filterBin_->start();
-        gyroscopeAdaptor_->startSensor();
+        gyroscopeChain_->start();
     }
     return true;
 }
@@ -104,7 +105,7 @@ bool GyroscopeSensorChannel::stop()
     sensordLogD() << id() << "Stopping GyroscopeSensorChannel";
 
     if (AbstractSensorChannel::stop()) {
-        gyroscopeAdaptor_->stopSensor();
+        gyroscopeChain_->stop();
         filterBin_->stop();
         marshallingBin_->stop();
     }
@@ -114,5 +115,5 @@ bool GyroscopeSensorChannel::stop()
 void GyroscopeSensorChannel::emitData(const TimedXyzData& value)
 {
     previousSample_ = value;
-    writeToClients((const void*)(&value), sizeof(TimedXyzData));
+    writeToClients(value);
 }
@@ -28,7 +28,7 @@
 #define GYROSCOPE_SENSOR_CHANNEL_H
 
 #include "abstractsensor.h"
-#include "deviceadaptor.h"
+#include "abstractchain.h"
 
 #include "gyroscopesensor_a.h"
 #include "dataemitter.h"
@@ -77,7 +77,7 @@ private:
     Bin*                         filterBin_;
     Bin*                         marshallingBin_;
 
-    DeviceAdaptor*                     gyroscopeAdaptor_;
+    AbstractChain*              gyroscopeChain_;
     BufferReader<TimedXyzData>* gyroscopeReader_;
     RingBuffer<TimedXyzData>*   outputBuffer_;
 
@@ -0,0 +1,114 @@
+/**
+   @file hingesensor.cpp
+   @brief HingeSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#include "hingesensor.h"
+
+#include "sensormanager.h"
+#include "bin.h"
+#include "bufferreader.h"
+
+HingeSensorChannel::HingeSensorChannel(const QString& id) :
+        AbstractSensorChannel(id),
+        DataEmitter<PostureData>(1)
+{
+    SensorManager& sm = SensorManager::instance();
+
+    hingeChain_ = sm.requestChain("hingechain");
+    if (!hingeChain_) {
+        setValid(false);
+        return;
+    }
+    setValid(hingeChain_->isValid());
+
+    postureReader_ = new BufferReader<PostureData>(1);
+
+    outputBuffer_ = new RingBuffer<PostureData>(1);
+
+    // Create buffers for filter chain
+    filterBin_ = new Bin(id);
+
+    filterBin_->add(postureReader_, "posture");
+    filterBin_->add(outputBuffer_, "buffer");
+
+    filterBin_->join("posture", "source", "buffer", "sink");
+
+    // Join datasources to the chain
+    connectToSource(hingeChain_, "posture", postureReader_);
+
+    marshallingBin_ = new Bin(id);
+    marshallingBin_->add(this, "sensorchannel");
+
+    outputBuffer_->join(this);
+
+    setDescription("device posture from hinge angle");
+    setRangeSource(hingeChain_);
+    addStandbyOverrideSource(hingeChain_);
+    setIntervalSource(hingeChain_);
+}
+
+HingeSensorChannel::~HingeSensorChannel()
+{
+    if (isValid()) {
+        SensorManager& sm = SensorManager::instance();
+
+        disconnectFromSource(hingeChain_, "posture", postureReader_);
+
+        sm.releaseChain("hingechain");
+
+        delete postureReader_;
+        delete outputBuffer_;
+        delete marshallingBin_;
+        delete filterBin_;
+    }
+}
+
+bool HingeSensorChannel::start()
+{
+    sensordLogD() << id() << "Starting HingeSensorChannel";
+
+    if (AbstractSensorChannel::start()) {
+        previousValue_ = PostureData();
+        marshallingBin_->start();
+        filterBin_->start();
+        hingeChain_->start();
+    }
+    return true;
+}
+
+bool HingeSensorChannel::stop()
+{
+    sensordLogD() << id() << "Stopping HingeSensorChannel";
+
+    if (AbstractSensorChannel::stop()) {
+        hingeChain_->stop();
+        filterBin_->stop();
+        marshallingBin_->stop();
+    }
+    return true;
+}
+
+void HingeSensorChannel::emitData(const PostureData& value)
+{
+    if (value.posture_ != previousValue_.posture_) {
+        previousValue_ = value;
+        writeToClients(value);
+    }
+}
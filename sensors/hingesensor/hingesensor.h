@@ -0,0 +1,96 @@
+/**
+   @file hingesensor.h
+   @brief HingeSensor
+
+   <p>
+   This file is part of Sensord.
+
+   Sensord is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   Sensord is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with Sensord.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+
+#ifndef HINGE_SENSOR_CHANNEL_H
+#define HINGE_SENSOR_CHANNEL_H
+
+#include "abstractsensor.h"
+#include "abstractchain.h"
+#include "hingesensor_a.h"
+#include "dataemitter.h"
+#include "datatypes/posturedata.h"
+
+class Bin;
+template <class TYPE> class BufferReader;
+
+/**
+ * @brief Sensor for the posture of a convertible.
+ *
+ * Reports posture changes (closed, laptop, flat, tent, tablet) derived
+ * by #HingeChain from the base and lid accelerometers. Clients get one
+ * sample per change instead of two acceleration streams.
+ */
+class HingeSensorChannel :
+        public AbstractSensorChannel,
+        public DataEmitter<PostureData>
+{
+    Q_OBJECT
+    Q_PROPERTY(PostureData posture READ posture)
+
+public:
+    /**
+     * Factory method for HingeSensorChannel.
+     * @return New HingeSensorChannel as AbstractSensorChannel*
+     */
+    static AbstractSensorChannel* factoryMethod(const QString& id)
+    {
+        HingeSensorChannel* sc = new HingeSensorChannel(id);
+        new HingeSensorChannelAdaptor(sc);
+
+        return sc;
+    }
+
+    /**
+     * Property method returning current posture and hinge angle.
+     * @return Current posture.
+     */
+    PostureData posture() const
+    {
+        return hingeChain_->property("posture").value<PostureData>();
+    }
+
+public Q_SLOTS:
+    bool start();
+    bool stop();
+
+signals:
+    /**
+     * Sent when posture has changed.
+     * @param posture New posture.
+     */
+    void postureChanged(const PostureData& posture);
+
+protected:
+    HingeSensorChannel(const QString& id);
+    virtual ~HingeSensorChannel();
+
+private:
+    PostureData                    previousValue_;
+    Bin*                           filterBin_;
+    Bin*                           marshallingBin_;
+    AbstractChain*                 hingeChain_;
+    BufferReader<PostureData>*     postureReader_;
+    RingBuffer<PostureData>*       outputBuffer_;
+
+    void emitData(const PostureData& value);
+};
+
+#endif // HINGE_SENSOR_CHANNEL_H
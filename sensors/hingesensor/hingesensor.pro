@@ -0,0 +1,11 @@
+TARGET       = hingesensor
+
+HEADERS += hingesensor.h   \
+           hingesensor_a.h \
+           hingeplugin.h
+
+SOURCES += hingesensor.cpp   \
+           hingesensor_a.cpp \
+           hingeplugin.cpp
+
+include( ../sensor-config.pri )
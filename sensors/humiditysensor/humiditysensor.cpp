@@ -28,27 +28,41 @@
 #include "sensormanager.h"
 #include "bin.h"
 #include "bufferreader.h"
+#include "config.h"
 #include "datatypes/orientation.h"
 
 HumiditySensorChannel::HumiditySensorChannel(const QString& id) :
         AbstractSensorChannel(id),
         DataEmitter<TimedUnsigned>(1),
-        previousRelativeValue_(0,0)
+        previousRelativeValue_(0,0),
+        environmentChain_(NULL)
 {
     SensorManager& sm = SensorManager::instance();
 
-    humidityAdaptor_ = sm.requestDeviceAdaptor("humidityadaptor");
+    humidityAdaptor_ = sm.requestDeviceAdaptor(instanceId("humidityadaptor"));
     if (!humidityAdaptor_) {
         setValid(false);
         return;
     }
 
+    // With sparse reporting changes are read from the environment chain,
+    // which backs off polling while readings are stable
+    if (instance() == 0 && SensorFrameworkConfig::configuration()->value<bool>("environment/sparse_channels", false)
+        && sm.loadPlugin("environmentchain")) {
+        environmentChain_ = sm.requestChain("environmentchain");
+        if (environmentChain_ && !environmentChain_->isValid()) {
+            sm.releaseChain("environmentchain");
+            environmentChain_ = NULL;
+        }
+    }
+    NodeBase* source = environmentChain_ ? (NodeBase*)environmentChain_ : (NodeBase*)humidityAdaptor_;
+
     humidityReader_ = new BufferReader<TimedUnsigned>(1);
 
     outputBuffer_ = new RingBuffer<TimedUnsigned>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(humidityReader_, "humidity");
     filterBin_->add(outputBuffer_, "buffer");
@@ -56,9 +70,9 @@ HumiditySensorChannel::HumiditySensorChannel(const QString& id) :
     filterBin_->join("humidity", "source", "buffer", "sink");
 
     // Join datasources to the chain
-    connectToSource(humidityAdaptor_, "humidity", humidityReader_);
+    connectToSource(source, "humidity", humidityReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
@@ -66,8 +80,8 @@ HumiditySensorChannel::HumiditySensorChannel(const QString& id) :
 
     setDescription("relative humidity in percentage");
     setRangeSource(humidityAdaptor_);
-    addStandbyOverrideSource(humidityAdaptor_);
-    setIntervalSource(humidityAdaptor_);
+    addStandbyOverrideSource(source);
+    setIntervalSource(source);
 
     setValid(true);
 }
@@ -77,9 +91,14 @@ HumiditySensorChannel::~HumiditySensorChannel()
     if (isValid()) {
         SensorManager& sm = SensorManager::instance();
 
-        disconnectFromSource(humidityAdaptor_, "humidity", humidityReader_);
+        if (environmentChain_) {
+            disconnectFromSource(environmentChain_, "humidity", humidityReader_);
+            sm.releaseChain("environmentchain");
+        } else {
+            disconnectFromSource(humidityAdaptor_, "humidity", humidityReader_);
+        }
 
-        sm.releaseDeviceAdaptor("humidityadaptor");
+        sm.releaseDeviceAdaptor(instanceId("humidityadaptor"));
 
         delete humidityReader_;
         delete outputBuffer_;
@@ -95,7 +114,10 @@ bool HumiditySensorChannel::start()
     if (AbstractSensorChannel::start()) {
         marshallingBin_->start();
         filterBin_->start();
-        humidityAdaptor_->startSensor();
+        if (environmentChain_)
+            environmentChain_->start();
+        else
+            humidityAdaptor_->startSensor();
     }
     return true;
 }
@@ -105,7 +127,10 @@ bool HumiditySensorChannel::stop()
     sensordLogD() << id() << "Stopping HumiditySensorChannel";
 
     if (AbstractSensorChannel::stop()) {
-        humidityAdaptor_->stopSensor();
+        if (environmentChain_)
+            environmentChain_->stop();
+        else
+            humidityAdaptor_->stopSensor();
         filterBin_->stop();
         marshallingBin_->stop();
     }
@@ -117,6 +142,6 @@ void HumiditySensorChannel::emitData(const TimedUnsigned& value)
     if (value.value_ != previousRelativeValue_.value_) {
         previousRelativeValue_.value_ = value.value_;
 
-        writeToClients((const void*)(&value), sizeof(value));
+        writeToClients(value);
     }
 }
@@ -38,6 +38,7 @@
 class Bin;
 template <class TYPE> class BufferReader;
 class FilterBase;
+class AbstractChain;
 
 /**
  * @brief Sensor for accessing the relative humidity sensor measurements.
@@ -92,6 +93,7 @@ private:
     Bin*                          filterBin_;
     Bin*                          marshallingBin_;
     DeviceAdaptor*                humidityAdaptor_;
+    AbstractChain*                environmentChain_; /**< source with sparse reporting, or NULL */
     BufferReader<TimedUnsigned>*  humidityReader_;
     RingBuffer<TimedUnsigned>*    outputBuffer_;
 
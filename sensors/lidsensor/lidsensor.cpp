@@ -38,7 +38,7 @@ LidSensorChannel::LidSensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    lidAdaptor_ = sm.requestDeviceAdaptor("lidsensoradaptor");
+    lidAdaptor_ = sm.requestDeviceAdaptor(instanceId("lidsensoradaptor"));
     if (!lidAdaptor_) {
         setValid(false);
         return;
@@ -49,7 +49,7 @@ LidSensorChannel::LidSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<LidData>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(lidReader_, "lid");
     filterBin_->add(outputBuffer_, "buffer");
@@ -59,7 +59,7 @@ LidSensorChannel::LidSensorChannel(const QString& id) :
     // Join datasources to the chain
     connectToSource(lidAdaptor_, "lid", lidReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
@@ -79,7 +79,7 @@ LidSensorChannel::~LidSensorChannel()
 
         disconnectFromSource(lidAdaptor_, "lid", lidReader_);
 
-        sm.releaseDeviceAdaptor("lidadaptor");
+        sm.releaseDeviceAdaptor(instanceId("lidsensoradaptor"));
 
         delete lidReader_;
         delete outputBuffer_;
@@ -117,6 +117,6 @@ void LidSensorChannel::emitData(const LidData& value)
     if (value.value_ != previousValue_.value_) {
         previousValue_.value_ = value.value_;
 
-        writeToClients((const void*)(&value), sizeof(value));
+        writeToClients(value);
     }
 }
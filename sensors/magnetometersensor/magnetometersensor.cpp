@@ -40,7 +40,7 @@ MagnetometerSensorChannel::MagnetometerSensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    magChain_ = sm.requestChain("magcalibrationchain");
+    magChain_ = sm.requestChain(instanceId("magcalibrationchain"));
     if (!magChain_) {
         setValid(false);
         return;
@@ -63,7 +63,7 @@ MagnetometerSensorChannel::MagnetometerSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<CalibratedMagneticFieldData>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(magnetometerReader_, "magnetometer");
     filterBin_->add(outputBuffer_, "buffer");
@@ -87,7 +87,7 @@ MagnetometerSensorChannel::MagnetometerSensorChannel(const QString& id) :
     // Join datasources to the chain
     connectToSource(magChain_, "calibratedmagnetometerdata", magnetometerReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
@@ -117,7 +117,7 @@ MagnetometerSensorChannel::~MagnetometerSensorChannel()
         SensorManager& sm = SensorManager::instance();
 
         disconnectFromSource(magChain_, "calibratedmagnetometerdata", magnetometerReader_);
-        sm.releaseChain("magcalibrationchain");
+        sm.releaseChain(instanceId("magcalibrationchain"));
 
         if (scaleFilter_) delete scaleFilter_;
 
@@ -51,6 +51,7 @@ class OrientationSensorChannel :
 {
     Q_OBJECT;
     Q_PROPERTY(Unsigned orientation READ orientation);
+    Q_PROPERTY(int confidence READ confidence);
 
 public:
 
@@ -76,6 +77,15 @@ public:
         return Unsigned(o);
     }
 
+    /**
+    * Property method returning confidence of current orientation.
+    * @return Confidence (percent).
+    */
+    int confidence() const
+    {
+        return orientationChain_->property("confidence").toInt();
+    }
+
 public Q_SLOTS:
     bool start();
     bool stop();
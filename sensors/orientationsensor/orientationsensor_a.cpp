@@ -45,3 +45,8 @@ void OrientationSensorChannelAdaptor::setThreshold(int value)
 {
     parent()->setProperty("threshold", value);
 }
+
+int OrientationSensorChannelAdaptor::confidence() const
+{
+    return qvariant_cast<int>(parent()->property("confidence"));
+}
@@ -40,6 +40,7 @@ class OrientationSensorChannelAdaptor : public AbstractSensorChannelAdaptor
     Q_CLASSINFO("D-Bus Interface", "local.OrientationSensor")
     Q_PROPERTY(Unsigned orientation READ orientation)
     Q_PROPERTY(int threshold READ threshold WRITE setThreshold)
+    Q_PROPERTY(int confidence READ confidence)
 
 public:
     OrientationSensorChannelAdaptor(QObject* parent);
@@ -48,6 +49,7 @@ public Q_SLOTS:
     Unsigned orientation() const;
     int threshold() const;
     void setThreshold(int value);
+    int confidence() const;
 
 Q_SIGNALS:
     void orientationChanged(const Unsigned& orientation);
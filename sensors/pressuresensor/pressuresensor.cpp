@@ -36,7 +36,7 @@ PressureSensorChannel::PressureSensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    pressureAdaptor_ = sm.requestDeviceAdaptor("pressureadaptor");
+    pressureAdaptor_ = sm.requestDeviceAdaptor(instanceId("pressureadaptor"));
     if (!pressureAdaptor_) {
         setValid(false);
         return;
@@ -47,7 +47,7 @@ PressureSensorChannel::PressureSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<TimedUnsigned>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(pressureReader_, "pressure");
     filterBin_->add(outputBuffer_, "buffer");
@@ -57,7 +57,7 @@ PressureSensorChannel::PressureSensorChannel(const QString& id) :
     // Join datasources to the chain
     connectToSource(pressureAdaptor_, "pressure", pressureReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
@@ -77,7 +77,7 @@ PressureSensorChannel::~PressureSensorChannel()
 
         disconnectFromSource(pressureAdaptor_, "pressure", pressureReader_);
 
-        sm.releaseDeviceAdaptor("pressureadaptor");
+        sm.releaseDeviceAdaptor(instanceId("pressureadaptor"));
 
         delete pressureReader_;
         delete outputBuffer_;
@@ -115,6 +115,6 @@ void PressureSensorChannel::emitData(const TimedUnsigned& value)
     if (value.value_ != previousValue_.value_) {
         previousValue_.value_ = value.value_;
 
-        writeToClients((const void*)(&value), sizeof(value));
+        writeToClients(value);
     }
 }
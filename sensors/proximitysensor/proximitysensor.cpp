@@ -37,7 +37,7 @@ ProximitySensorChannel::ProximitySensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    proximityAdaptor_ = sm.requestDeviceAdaptor("proximityadaptor");
+    proximityAdaptor_ = sm.requestDeviceAdaptor(instanceId("proximityadaptor"));
     if (!proximityAdaptor_ ) {
         setValid(false);
         return;
@@ -48,7 +48,7 @@ ProximitySensorChannel::ProximitySensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<ProximityData>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(proximityReader_, "proximity");
     filterBin_->add(outputBuffer_, "buffer");
@@ -58,7 +58,7 @@ ProximitySensorChannel::ProximitySensorChannel(const QString& id) :
     // Join datasources to the chain
     connectToSource(proximityAdaptor_, "proximity", proximityReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
@@ -78,7 +78,7 @@ ProximitySensorChannel::~ProximitySensorChannel()
 
         disconnectFromSource(proximityAdaptor_, "proximity", proximityReader_);
 
-        sm.releaseDeviceAdaptor("proximityadaptor");
+        sm.releaseDeviceAdaptor(instanceId("proximityadaptor"));
 
         delete proximityReader_;
         delete outputBuffer_;
@@ -120,6 +120,6 @@ void ProximitySensorChannel::emitData(const ProximityData& value)
     {
         previousValue_.value_ = value.value_;
         previousValue_.withinProximity_ = value.withinProximity_;
-        writeToClients((const void *)&value, sizeof(ProximityData));
+        writeToClients(value);
     }
 }
@@ -34,7 +34,11 @@
 RotationSensorChannel::RotationSensorChannel(const QString& id) :
         AbstractSensorChannel(id),
         DataEmitter<TimedXyzData>(1),
+        magnetometerChain_(NULL),
         compassReader_(NULL),
+        magnetometerReader_(NULL),
+        attitudeBuffer_(NULL),
+        attitudeEmitter_(this),
         prevRotation_(0,0,0,0)
 {
     SensorManager& sm = SensorManager::instance();
@@ -54,6 +58,13 @@ RotationSensorChannel::RotationSensorChannel(const QString& id) :
         sensordLogW() << NodeBase::id() << "Unable to use compass for z-axis rotation.";
     }
 
+    magnetometerChain_ = sm.requestChain("magcalibrationchain");
+    if (magnetometerChain_ && magnetometerChain_->isValid()) {
+        magnetometerReader_ = new BufferReader<CalibratedMagneticFieldData>(1);
+    } else {
+        sensordLogW() << NodeBase::id() << "Unable to use magnetometer for attitude.";
+    }
+
     rotationFilter_ = sm.instantiateFilter("rotationfilter");
     if (!rotationFilter_) {
         setValid(false);
@@ -64,7 +75,7 @@ RotationSensorChannel::RotationSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<TimedXyzData>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(accelerometerReader_, "accelerometer");
     filterBin_->add(rotationFilter_, "rotationfilter");
@@ -76,6 +87,15 @@ RotationSensorChannel::RotationSensorChannel(const QString& id) :
         filterBin_->join("compass", "source", "rotationfilter", "compasssink");
     }
 
+    if (hasAttitude())
+    {
+        attitudeBuffer_ = new RingBuffer<AttitudeData>(1);
+        filterBin_->add(magnetometerReader_, "magnetometer");
+        filterBin_->add(attitudeBuffer_, "attitudebuffer");
+        filterBin_->join("magnetometer", "source", "rotationfilter", "magnetometersink");
+        filterBin_->join("rotationfilter", "attitude", "attitudebuffer", "sink");
+    }
+
     filterBin_->join("accelerometer", "source", "rotationfilter", "accelerometersink");
     filterBin_->join("rotationfilter", "source", "buffer", "sink");
 
@@ -87,12 +107,25 @@ RotationSensorChannel::RotationSensorChannel(const QString& id) :
         addStandbyOverrideSource(compassChain_);
     }
 
-    marshallingBin_ = new Bin;
+    if (hasAttitude())
+    {
+        connectToSource(magnetometerChain_, "calibratedmagnetometerdata", magnetometerReader_);
+        addStandbyOverrideSource(magnetometerChain_);
+    }
+
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
 
+    if (hasAttitude())
+    {
+        marshallingBin_->add(&attitudeEmitter_, "attitudeemitter");
+        attitudeBuffer_->join(&attitudeEmitter_);
+    }
+
     setDescription("x, y, and z axes rotation in degrees");
+    setPredictionModel(SamplePredictor::Angular);
     introduceAvailableDataRange(DataRange(-179, 180, 1));
     addStandbyOverrideSource(accelerometerChain_);
 
@@ -126,9 +159,19 @@ RotationSensorChannel::~RotationSensorChannel()
         if (hasZ())
         {
             disconnectFromSource(compassChain_, "truenorth", compassReader_);
-            sm.releaseChain("compasschain");
             delete compassReader_;
         }
+        if (compassChain_)
+            sm.releaseChain("compasschain");
+
+        if (hasAttitude())
+        {
+            disconnectFromSource(magnetometerChain_, "calibratedmagnetometerdata", magnetometerReader_);
+            delete magnetometerReader_;
+            delete attitudeBuffer_;
+        }
+        if (magnetometerChain_)
+            sm.releaseChain("magcalibrationchain");
 
         delete accelerometerReader_;
         delete rotationFilter_;
@@ -151,6 +194,8 @@ bool RotationSensorChannel::start()
             compassChain_->setProperty("compassEnabled", true);
             compassChain_->start();
         }
+        if (hasAttitude())
+            magnetometerChain_->start();
     }
     return true;
 }
@@ -167,6 +212,8 @@ bool RotationSensorChannel::stop()
             compassChain_->stop();
             compassChain_->setProperty("compassEnabled", false);
         }
+        if (hasAttitude())
+            magnetometerChain_->stop();
         marshallingBin_->stop();
     }
     return true;
@@ -180,6 +227,39 @@ void RotationSensorChannel::emitData(const TimedXyzData& value)
     downsampleAndPropagate(value, downsampleBuffer_);
 }
 
+void RotationSensorChannel::emitAttitude(const AttitudeData& value)
+{
+    QMutexLocker locker(&mutex_);
+
+    if (!attitudeSessions_.isEmpty())
+        writeToClients(value);
+}
+
+void AttitudeEmitter::emitData(const AttitudeData& value)
+{
+    channel_->emitAttitude(value);
+}
+
+bool RotationSensorChannel::setAttitudeOutput(int sessionId, bool value)
+{
+    QMutexLocker locker(&mutex_);
+
+    if (!value) {
+        attitudeSessions_.remove(sessionId);
+        return true;
+    }
+    if (!hasAttitude())
+        return false;
+    attitudeSessions_.insert(sessionId);
+    return true;
+}
+
+bool RotationSensorChannel::sessionAcceptsSample(int sessionId, const SampleSchema* schema) const
+{
+    bool attitude = attitudeSessions_.contains(sessionId);
+    return attitude == (schema == sampleSchema<AttitudeData>());
+}
+
 unsigned int RotationSensorChannel::interval() const
 {
     // Just provide accelerometer rate for now.
@@ -193,6 +273,10 @@ bool RotationSensorChannel::setInterval(int sessionId, unsigned int interval_us)
     {
         success = compassChain_->setIntervalRequest(sessionId, interval_us) && success;
     }
+    if (hasAttitude())
+    {
+        magnetometerChain_->setIntervalRequest(sessionId, interval_us);
+    }
 
     return success;
 }
@@ -200,6 +284,7 @@ bool RotationSensorChannel::setInterval(int sessionId, unsigned int interval_us)
 void RotationSensorChannel::removeSession(int sessionId)
 {
     downsampleBuffer_.remove(sessionId);
+    setAttitudeOutput(sessionId, false);
     AbstractSensorChannel::removeSession(sessionId);
 }
 
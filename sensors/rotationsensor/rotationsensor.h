@@ -28,18 +28,41 @@
 #define ROTATION_SENSOR_CHANNEL_H
 
 #include <QMutex>
+#include <QSet>
 #include "abstractsensor.h"
 #include "abstractchain.h"
 #include "rotationsensor_a.h"
 #include "dataemitter.h"
 #include "datatypes/orientationdata.h"
+#include "datatypes/attitudedata.h"
 
 class Bin;
 template <class TYPE> class BufferReader;
 class FilterBase;
+class RotationSensorChannel;
+
+/**
+ * Forwards attitude samples to the sensor channel.
+ */
+class AttitudeEmitter : public DataEmitter<AttitudeData>
+{
+public:
+    AttitudeEmitter(RotationSensorChannel* channel) :
+        DataEmitter<AttitudeData>(1),
+        channel_(channel) {}
+
+protected:
+    void emitData(const AttitudeData& value);
+
+private:
+    RotationSensorChannel* channel_;
+};
 
 /**
  * @brief Sensor providing device rotation around axes.
+ *
+ * When the magnetometer is available, sessions can switch their sample
+ * stream from Euler angles to #AttitudeData with setAttitudeOutput().
  */
 class RotationSensorChannel :
         public AbstractSensorChannel,
@@ -48,6 +71,7 @@ class RotationSensorChannel :
     Q_OBJECT;
     Q_PROPERTY(XYZ rotation READ rotation);
     Q_PROPERTY(bool hasZ READ hasZ);
+    Q_PROPERTY(bool hasAttitude READ hasAttitude);
 
 public:
     /**
@@ -72,6 +96,21 @@ public:
         return compassReader_;
     }
 
+    bool hasAttitude() const
+    {
+        return magnetometerReader_;
+    }
+
+    /**
+     * Select the samples written to a session: #AttitudeData when
+     * enabled, Euler angles as TimedXyzData otherwise.
+     *
+     * @param sessionId session ID.
+     * @param value write attitude.
+     * @return false if attitude is not available.
+     */
+    bool setAttitudeOutput(int sessionId, bool value);
+
     virtual unsigned int interval() const;
     virtual bool setInterval(int sessionId, unsigned int interval_us);
 
@@ -94,20 +133,30 @@ protected:
     RotationSensorChannel(const QString& id);
     virtual ~RotationSensorChannel();
 
+    virtual bool sessionAcceptsSample(int sessionId, const SampleSchema* schema) const;
+
 private:
     Bin*                         filterBin_;
     Bin*                         marshallingBin_;
     AbstractChain*               accelerometerChain_;
     AbstractChain*               compassChain_;
+    AbstractChain*               magnetometerChain_;
     BufferReader<TimedXyzData>*  accelerometerReader_;
     BufferReader<CompassData>*   compassReader_;
+    BufferReader<CalibratedMagneticFieldData>* magnetometerReader_;
     FilterBase*                  rotationFilter_;
     RingBuffer<TimedXyzData>*    outputBuffer_;
+    RingBuffer<AttitudeData>*    attitudeBuffer_;
+    AttitudeEmitter              attitudeEmitter_;
+    QSet<int>                    attitudeSessions_;
     TimedXyzData                 prevRotation_;
     TimedXyzDownsampleBuffer     downsampleBuffer_;
     QMutex                       mutex_;
 
     void emitData(const TimedXyzData& value);
+    void emitAttitude(const AttitudeData& value);
+
+    friend class AttitudeEmitter;
 };
 
 #endif // ROTATION_SENSOR_CHANNEL_H
@@ -25,6 +25,7 @@
 */
 
 #include "rotationsensor_a.h"
+#include "rotationsensor.h"
 
 RotationSensorChannelAdaptor::RotationSensorChannelAdaptor(QObject* parent) :
     AbstractSensorChannelAdaptor(parent)
@@ -40,3 +41,13 @@ bool RotationSensorChannelAdaptor::hasZ() const
 {
     return qvariant_cast<bool>(parent()->property("hasZ"));
 }
+
+bool RotationSensorChannelAdaptor::hasAttitude() const
+{
+    return qvariant_cast<bool>(parent()->property("hasAttitude"));
+}
+
+bool RotationSensorChannelAdaptor::setAttitudeOutput(int sessionId, bool value)
+{
+    return static_cast<RotationSensorChannel*>(parent())->setAttitudeOutput(sessionId, value);
+}
@@ -39,6 +39,7 @@ class RotationSensorChannelAdaptor : public AbstractSensorChannelAdaptor
     Q_CLASSINFO("D-Bus Interface", "local.RotationSensor")
     Q_PROPERTY(XYZ rotation READ rotation)
     Q_PROPERTY(bool hasZ READ hasZ)
+    Q_PROPERTY(bool hasAttitude READ hasAttitude)
 
 public:
     RotationSensorChannelAdaptor(QObject* parent);
@@ -46,6 +47,8 @@ public:
 public Q_SLOTS:
     XYZ rotation() const;
     bool hasZ() const;
+    bool hasAttitude() const;
+    bool setAttitudeOutput(int sessionId, bool value);
 
 Q_SIGNALS:
     void dataAvailable(const XYZ& data);
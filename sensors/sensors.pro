@@ -16,6 +16,8 @@ SUBDIRS  = accelerometersensor \
            humiditysensor \
            pressuresensor \
            temperaturesensor \
-           stepcountersensor
+           stepcountersensor \
+           hingesensor \
+           environmentsensor
 
 contextprovider:SUBDIRS += contextplugin
@@ -39,7 +39,7 @@ StepCounterSensorChannel::StepCounterSensorChannel(const QString& id) :
 {
     SensorManager& sm = SensorManager::instance();
 
-    stepcounterAdaptor_ = sm.requestDeviceAdaptor("stepcounteradaptor");
+    stepcounterAdaptor_ = sm.requestDeviceAdaptor(instanceId("stepcounteradaptor"));
     if (!stepcounterAdaptor_) {
         setValid(false);
         return;
@@ -50,7 +50,7 @@ StepCounterSensorChannel::StepCounterSensorChannel(const QString& id) :
     outputBuffer_ = new RingBuffer<TimedUnsigned>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(stepcounterReader_, "stepcounter");
     filterBin_->add(outputBuffer_, "buffer");
@@ -60,7 +60,7 @@ StepCounterSensorChannel::StepCounterSensorChannel(const QString& id) :
     // Join datasources to the chain
     connectToSource(stepcounterAdaptor_, "stepcounter", stepcounterReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
@@ -80,7 +80,7 @@ StepCounterSensorChannel::~StepCounterSensorChannel()
 
         disconnectFromSource(stepcounterAdaptor_, "stepcounter", stepcounterReader_);
 
-        sm.releaseDeviceAdaptor("stepcounteradaptor");
+        sm.releaseDeviceAdaptor(instanceId("stepcounteradaptor"));
 
         delete stepcounterReader_;
         delete outputBuffer_;
@@ -118,6 +118,6 @@ void StepCounterSensorChannel::emitData(const TimedUnsigned& value)
     if (value.value_ != previousValue_.value_) {
         previousValue_.value_ = value.value_;
 
-        writeToClients((const void*)(&value), sizeof(value));
+        writeToClients(value);
     }
 }
@@ -28,27 +28,41 @@
 #include "sensormanager.h"
 #include "bin.h"
 #include "bufferreader.h"
+#include "config.h"
 #include "datatypes/orientation.h"
 
 TemperatureSensorChannel::TemperatureSensorChannel(const QString& id) :
         AbstractSensorChannel(id),
         DataEmitter<TimedUnsigned>(1),
-        previousValue_(0,0)
+        previousValue_(0,0),
+        environmentChain_(NULL)
 {
     SensorManager& sm = SensorManager::instance();
 
-    temperatureAdaptor_ = sm.requestDeviceAdaptor("temperatureadaptor");
+    temperatureAdaptor_ = sm.requestDeviceAdaptor(instanceId("temperatureadaptor"));
     if (!temperatureAdaptor_) {
         setValid(false);
         return;
     }
 
+    // With sparse reporting changes are read from the environment chain,
+    // which backs off polling while readings are stable
+    if (instance() == 0 && SensorFrameworkConfig::configuration()->value<bool>("environment/sparse_channels", false)
+        && sm.loadPlugin("environmentchain")) {
+        environmentChain_ = sm.requestChain("environmentchain");
+        if (environmentChain_ && !environmentChain_->isValid()) {
+            sm.releaseChain("environmentchain");
+            environmentChain_ = NULL;
+        }
+    }
+    NodeBase* source = environmentChain_ ? (NodeBase*)environmentChain_ : (NodeBase*)temperatureAdaptor_;
+
     temperatureReader_ = new BufferReader<TimedUnsigned>(1);
 
     outputBuffer_ = new RingBuffer<TimedUnsigned>(1);
 
     // Create buffers for filter chain
-    filterBin_ = new Bin;
+    filterBin_ = new Bin(id);
 
     filterBin_->add(temperatureReader_, "temperature");
     filterBin_->add(outputBuffer_, "buffer");
@@ -56,17 +70,17 @@ TemperatureSensorChannel::TemperatureSensorChannel(const QString& id) :
     filterBin_->join("temperature", "source", "buffer", "sink");
 
     // Join datasources to the chain
-    connectToSource(temperatureAdaptor_, "temperature", temperatureReader_);
+    connectToSource(source, "temperature", temperatureReader_);
 
-    marshallingBin_ = new Bin;
+    marshallingBin_ = new Bin(id);
     marshallingBin_->add(this, "sensorchannel");
 
     outputBuffer_->join(this);
 
     setDescription("ambient temperature in celsius");
     setRangeSource(temperatureAdaptor_);
-    addStandbyOverrideSource(temperatureAdaptor_);
-    setIntervalSource(temperatureAdaptor_);
+    addStandbyOverrideSource(source);
+    setIntervalSource(source);
 
     setValid(true);
 }
@@ -76,9 +90,14 @@ TemperatureSensorChannel::~TemperatureSensorChannel()
     if (isValid()) {
         SensorManager& sm = SensorManager::instance();
 
-        disconnectFromSource(temperatureAdaptor_, "temperature", temperatureReader_);
+        if (environmentChain_) {
+            disconnectFromSource(environmentChain_, "temperature", temperatureReader_);
+            sm.releaseChain("environmentchain");
+        } else {
+            disconnectFromSource(temperatureAdaptor_, "temperature", temperatureReader_);
+        }
 
-        sm.releaseDeviceAdaptor("temperatureadaptor");
+        sm.releaseDeviceAdaptor(instanceId("temperatureadaptor"));
 
         delete temperatureReader_;
         delete outputBuffer_;
@@ -94,7 +113,10 @@ bool TemperatureSensorChannel::start()
     if (AbstractSensorChannel::start()) {
         marshallingBin_->start();
         filterBin_->start();
-        temperatureAdaptor_->startSensor();
+        if (environmentChain_)
+            environmentChain_->start();
+        else
+            temperatureAdaptor_->startSensor();
     }
     return true;
 }
@@ -104,7 +126,10 @@ bool TemperatureSensorChannel::stop()
     sensordLogD() << id() << "Stopping TemperatureSensorChannel";
 
     if (AbstractSensorChannel::stop()) {
-        temperatureAdaptor_->stopSensor();
+        if (environmentChain_)
+            environmentChain_->stop();
+        else
+            temperatureAdaptor_->stopSensor();
         filterBin_->stop();
         marshallingBin_->stop();
     }
@@ -116,6 +141,6 @@ void TemperatureSensorChannel::emitData(const TimedUnsigned& value)
     if (value.value_ != previousValue_.value_) {
         previousValue_.value_ = value.value_;
 
-        writeToClients((const void*)(&value), sizeof(value));
+        writeToClients(value);
     }
 }
@@ -38,6 +38,7 @@
 class Bin;
 template <class TYPE> class BufferReader;
 class FilterBase;
+class AbstractChain;
 
 /**
  * @brief Sensor for accessing the internal ambient light sensor measurements.
@@ -91,6 +92,7 @@ private:
     Bin*                          filterBin_;
     Bin*                          marshallingBin_;
     DeviceAdaptor*                temperatureAdaptor_;
+    AbstractChain*                environmentChain_; /**< source with sparse reporting, or NULL */
     BufferReader<TimedUnsigned>*  temperatureReader_;
     RingBuffer<TimedUnsigned>*    outputBuffer_;
 
@@ -38,7 +38,56 @@
 #include "clientapitest.h"
 #include <QSettings>
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
 namespace {
+/**
+ * Connect to the sensord data socket and claim the given session.
+ *
+ * @return socket fd, or -1 on failure.
+ */
+int claimSession(int sessionId)
+{
+    QByteArray path("/run/sensord.sock");
+    QByteArray env = qgetenv("SENSORFW_SOCKET_PATH");
+    if (!env.isEmpty())
+        path.prepend(env);
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.constData(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    char tag;
+    if (::connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        read(fd, &tag, 1) != 1 ||
+        write(fd, &sessionId, sizeof(sessionId)) != sizeof(sessionId)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Has sensord closed the connection within given time.
+ */
+bool isClosedByPeer(int fd, int timeout_ms)
+{
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    if (poll(&pfd, 1, timeout_ms) <= 0)
+        return false;
+    char byte;
+    return (pfd.revents & POLLHUP) || read(fd, &byte, 1) == 0;
+}
+
 bool areTheSameSample(const XYZ &sample1, const XYZ &sample2)
 {
     return sample1.XYZData().timestamp_ == sample2.XYZData().timestamp_
@@ -527,6 +576,73 @@ void ClientApiTest::testSessionInitiation()
     QVERIFY2(orientation && orientation->isValid(), "Could not get orientation sensor channel");
 }
 
+void ClientApiTest::testSessionSocketOwnership()
+{
+    SensorManagerInterface& sm = SensorManagerInterface::instance();
+    QDBusReply<int> reply = sm.requestSensor("orientationsensor");
+    QVERIFY(reply.isValid());
+    int sessionId = reply.value();
+    QVERIFY(sessionId >= 0);
+
+    // Another user must not be able to attach to the session
+    pid_t child;
+    int status = 0;
+    if (getuid() == 0) {
+        child = fork();
+        QVERIFY(child >= 0);
+        if (child == 0) {
+            if (setuid(65534) != 0)
+                _exit(2);
+            int fd = claimSession(sessionId);
+            _exit((fd >= 0 && isClosedByPeer(fd, 2000)) ? 0 : 1);
+        }
+        QCOMPARE(waitpid(child, &status, 0), child);
+        QVERIFY2(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Session socket was accepted from another user");
+    }
+
+    // Another process of the same user can, like a client whose PID
+    // differs from the bus-reported one inside a sandbox
+    child = fork();
+    QVERIFY(child >= 0);
+    if (child == 0) {
+        int fd = claimSession(sessionId);
+        _exit((fd >= 0 && !isClosedByPeer(fd, 500)) ? 0 : 1);
+    }
+    QCOMPARE(waitpid(child, &status, 0), child);
+    QVERIFY2(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Session socket was rejected from the owning user");
+
+    sm.releaseSensor("orientationsensor", sessionId);
+}
+
+void ClientApiTest::testSessionPreclaim()
+{
+    SensorManagerInterface& sm = SensorManagerInterface::instance();
+    QDBusReply<int> reply = sm.requestSensor("orientationsensor");
+    QVERIFY(reply.isValid());
+    int sessionId = reply.value();
+    QVERIFY(sessionId >= 0);
+
+    // Session IDs are sequential: claiming the next one before it has
+    // been handed out must fail, also for the same user
+    int fd = claimSession(sessionId + 1);
+    QVERIFY(fd >= 0);
+    QVERIFY2(isClosedByPeer(fd, 2000), "Socket was accepted for a session that was not requested");
+    close(fd);
+
+    // The client the ID is handed out to can still connect
+    reply = sm.requestSensor("orientationsensor");
+    QVERIFY(reply.isValid());
+    int nextId = reply.value();
+    QVERIFY(nextId >= 0);
+    fd = claimSession(nextId);
+    QVERIFY(fd >= 0);
+    QVERIFY2(!isClosedByPeer(fd, 500), "Socket of the requesting client was rejected");
+    close(fd);
+
+    sm.releaseSensor("orientationsensor", nextId);
+    sm.releaseSensor("orientationsensor", sessionId);
+}
+
 void ClientApiTest::testBuffering()
 {
     foreach(const QString& sensorName, bufferingSensors)
@@ -72,6 +72,8 @@ private slots:
     // Special cases
     void testCommonAdaptorPipeline();
     void testSessionInitiation();
+    void testSessionSocketOwnership();
+    void testSessionPreclaim();
 
     // Buffering
     void testBuffering();
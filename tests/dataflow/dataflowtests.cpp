@@ -28,22 +28,58 @@
 #include <QtDebug>
 #include <QTest>
 #include <QVariant>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QThread>
+#include <QSemaphore>
+#include <QLocalServer>
+#include <QLocalSocket>
 
 #include <typeinfo>
+#include <unistd.h>
 #include "sensormanager.h"
 #include "bin.h"
 #include "bufferreader.h"
 #include "filter.h"
+#include "ringbuffer.h"
+#include "datatypes/genericdata.h"
 #include "config.h"
+#include "mountmatrix.h"
 #include "dataflowtests.h"
 #include "loader.h"
 #include "plugin.h"
+#include "clientquota.h"
+#include "sockethandler.h"
+#include "deviceprobe.h"
+#include "msctimestamp.h"
+#include "inputeventmask.h"
+#include "touchtracker.h"
+#include "sampleencoder.h"
+#include "clockoffsets.h"
+#include "datatypes/utils.h"
+#include "cpuaccounting.h"
+#include "samplepredictor.h"
+#include "scheduler.h"
+#include "suspendmonitor.h"
+#include "callback.h"
+#include "idutils.h"
+#include "timedunsigned.h"
+#include "environmentdata.h"
+#include <QtEndian>
+#include <QScopedPointer>
 #include <accelerometeradaptor/accelerometeradaptor.h>
 #include <accelerometerchain/accelerometerchain.h>
 #include <coordinatealignfilter/coordinatealignfilter.h>
 
 #include <stdio.h>
+#include <time.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 void DataFlowTest::initTestCase()
 {
@@ -188,6 +224,1226 @@ void DataFlowTest::testChainSharing()
     sm.releaseChain("accelerometerchain");
     // check that does not exist
 }
+void DataFlowTest::testClientQuota()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.path() + "/quota.conf";
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("[quota-uid-4242]\n"
+               "max_rate = 50\n"
+               "max_sessions = 2\n"
+               "max_buffered_bytes = 1024\n"
+               "[quota-exe-quotatestclient]\n"
+               "max_rate = 10\n");
+    file.close();
+    QVERIFY(SensorFrameworkConfig::loadConfig(path, ""));
+
+    // Executable group overrides uid group key by key
+    ClientQuota quota = ClientQuota::forClient(4242, "quotatestclient");
+    QCOMPARE(quota.minInterval_us, 100000u);
+    QCOMPARE(quota.maxSessions, 2);
+    QCOMPARE(quota.maxBufferedBytes, 1024u);
+    QCOMPARE(quota.scope, ClientQuota::ScopeExecutable);
+
+    quota = ClientQuota::forClient(4242, "otherclient");
+    QCOMPARE(quota.minInterval_us, 20000u);
+    QCOMPARE(quota.scope, ClientQuota::ScopeUid);
+
+    // Faster requests are limited, default and slower ones are untouched
+    QCOMPARE(quota.grantInterval(1000), 20000u);
+    QCOMPARE(quota.grantInterval(0), 0u);
+    QCOMPARE(quota.grantInterval(100000), 100000u);
+
+    // Sessions are counted per uid or per executable
+    QList<QPair<uid_t, QString> > sessions;
+    sessions << qMakePair((uid_t)4242, QString("otherclient"))
+             << qMakePair((uid_t)4242, QString("quotatestclient"))
+             << qMakePair((uid_t)1000, QString("quotatestclient"));
+    QVERIFY(!quota.admitSession(4242, "otherclient", sessions));
+    QVERIFY(quota.admitSession(4243, "otherclient", sessions));
+    quota = ClientQuota::forClient(4242, "quotatestclient");
+    quota.scope = ClientQuota::ScopeExecutable;
+    QVERIFY(!quota.admitSession(4242, "quotatestclient", sessions));
+    QVERIFY(quota.admitSession(4242, "otherclient", sessions));
+    sessions.removeLast();
+    QVERIFY(quota.admitSession(4242, "quotatestclient", sessions));
+
+    QVERIFY(!ClientQuota().isLimited());
+    QCOMPARE(ClientQuota().grantInterval(1), 1u);
+    QVERIFY(ClientQuota().admitSession(4242, "otherclient", sessions));
+}
+
+void DataFlowTest::testSessionQuota()
+{
+    QLocalServer server;
+    QString name = QString("sensorfw-quota-test-%1").arg(getpid());
+    QLocalServer::removeServer(name);
+    QVERIFY(server.listen(name));
+    QLocalSocket* socket = new QLocalSocket;
+    socket->connectToServer(name);
+    QVERIFY(socket->waitForConnected(1000));
+    QVERIFY(server.waitForNewConnection(1000));
+    QScopedPointer<QLocalSocket> peer(server.nextPendingConnection());
+    QVERIFY(peer);
+
+    // Nothing is read by the peer, so everything written stays pending.
+    // Each write carries the sample count header.
+    const int header = sizeof(unsigned int);
+    quint64 sample = 0;
+    SessionData session(socket, getpid(), getuid());
+    session.setMaxBufferedBytes(2 * (header + sizeof(sample)));
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(session.write(&sample, sizeof(sample)));
+    QCOMPARE(socket->bytesToWrite(), (qint64)(2 * (header + sizeof(sample))));
+    QCOMPARE(session.getDroppedSamples(), 3u);
+
+    // Batch larger than the quota is written early, and the pending
+    // batch is counted against the quota
+    while (socket->bytesToWrite())
+        QVERIFY(socket->waitForBytesWritten(1000));
+    session.setMaxBufferedBytes(header + 3 * sizeof(sample));
+    session.setBufferSize(10);
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(session.write(&sample, sizeof(sample)));
+    QCOMPARE(socket->bytesToWrite(), (qint64)(header + 3 * sizeof(sample)));
+    QCOMPARE(session.getDroppedSamples(), 3u);
+    QVERIFY(session.write(&sample, sizeof(sample)));
+    QCOMPARE(session.getDroppedSamples(), 4u);
+    while (socket->bytesToWrite())
+        QVERIFY(socket->waitForBytesWritten(1000));
+
+    // Rate limit skips samples whatever the sensor interval is
+    session.setMaxBufferedBytes(0);
+    session.setBufferSize(1);
+    session.setMinInterval(10000000);
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(session.write(&sample, sizeof(sample)));
+    QCOMPARE(socket->bytesToWrite(), (qint64)(header + sizeof(sample)));
+    QCOMPARE(session.getDroppedSamples(), 4u);
+
+    // Variable size encodings are limited the same way: the next sample
+    // is not due before the limit has passed
+    QVERIFY(session.setDataFormat("json"));
+    TimedUnsigned value(1, 2);
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(session.write(&value, sizeof(value), sampleSchema<TimedUnsigned>()));
+    QCOMPARE(socket->bytesToWrite(), (qint64)(header + sizeof(sample)));
+}
+
+void DataFlowTest::testSessionSchema()
+{
+    QLocalServer server;
+    QString name = QString("sensorfw-schema-test-%1").arg(getpid());
+    QLocalServer::removeServer(name);
+    QVERIFY(server.listen(name));
+    QLocalSocket* socket = new QLocalSocket;
+    socket->connectToServer(name);
+    QVERIFY(socket->waitForConnected(1000));
+    QVERIFY(server.waitForNewConnection(1000));
+    QScopedPointer<QLocalSocket> peer(server.nextPendingConnection());
+    QVERIFY(peer);
+
+    // Batched samples are flushed before the header of a new schema, so
+    // the client parses them with the schema they were encoded with
+    SessionData session(socket, getpid(), getuid());
+    QVERIFY(session.setDataFormat("flat"));
+    session.setBufferSize(10);
+    TimedXyzData xyz(1, 1, 2, 3);
+    TimedUnsigned value(2, 7);
+    QVERIFY(session.write(&xyz, sizeof(xyz), sampleSchema<TimedXyzData>()));
+    QVERIFY(session.write(&xyz, sizeof(xyz), sampleSchema<TimedXyzData>()));
+    QVERIFY(session.write(&value, sizeof(value), sampleSchema<TimedUnsigned>()));
+
+    QScopedPointer<SampleEncoder> flat(SampleEncoder::create("flat"));
+    QByteArray expected = flat->header(*sampleSchema<TimedXyzData>());
+    unsigned int count = 2;
+    expected.append((const char*)&count, sizeof(count));
+    flat->encode(*sampleSchema<TimedXyzData>(), &xyz, expected);
+    flat->encode(*sampleSchema<TimedXyzData>(), &xyz, expected);
+    expected.append(flat->header(*sampleSchema<TimedUnsigned>()));
+
+    while (socket->bytesToWrite())
+        QVERIFY(socket->waitForBytesWritten(1000));
+    QByteArray received;
+    while (received.size() < expected.size() && peer->waitForReadyRead(1000))
+        received.append(peer->readAll());
+    QCOMPARE(received, expected);
+}
+
+void DataFlowTest::testDeviceProbe()
+{
+    // Use tmpfs backed stand-in for sysfs when available
+    QString base = QFileInfo("/dev/shm").isWritable() ? QString("/dev/shm") : QDir::tempPath();
+    QTemporaryDir dir(base + "/sensorfw-probe-XXXXXX");
+    QVERIFY(dir.isValid());
+
+    const int COUNT = 64;
+    QStringList paths;
+    for (int i = 0; i < COUNT; ++i) {
+        QString path = QString("%1/device%2/in_accel_raw").arg(dir.path()).arg(i);
+        QVERIFY(QDir().mkpath(QFileInfo(path).path()));
+        if (i % 2 == 0) {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write("0\n");
+        }
+        paths << path;
+    }
+
+    DeviceProbe& probe = DeviceProbe::instance();
+    probe.setTtl(10000);
+
+    // Cold start, each lookup probes synchronously
+    probe.invalidate();
+    QElapsedTimer timer;
+    timer.start();
+    foreach (const QString& path, paths) {
+        probe.probe(path);
+    }
+    qint64 cold_ns = timer.nsecsElapsed();
+
+    // Lookups overlapping the prefetch either hit the cache or wait
+    // for the probe in flight
+    probe.invalidate();
+    probe.prefetch(paths);
+    for (int i = 0; i < COUNT; ++i) {
+        DeviceProbe::Result result = probe.probe(paths.at(i));
+        QCOMPARE(result.exists, i % 2 == 0);
+        QCOMPARE(result.readable, i % 2 == 0);
+        QVERIFY(!result.hasInputName);
+    }
+    QVERIFY(probe.waitForDone(1000));
+
+    // Adaptors created after the prefetch has finished only hit the cache
+    probe.invalidate();
+    probe.prefetch(paths);
+    QVERIFY(probe.waitForDone(1000));
+    timer.restart();
+    foreach (const QString& path, paths) {
+        probe.probe(path);
+    }
+    qint64 prefetched_ns = timer.nsecsElapsed();
+    qDebug() << "[Cold probe ]:" << cold_ns / 1000 << "us cold," << prefetched_ns / 1000 << "us prefetched";
+    QVERIFY(prefetched_ns < cold_ns);
+
+    // Results stay cached until invalidated
+    QFile::remove(paths.at(0));
+    QVERIFY(probe.exists(paths.at(0)));
+    probe.invalidate();
+    QVERIFY(!probe.exists(paths.at(0)));
+
+    // Prefetched results outlive the time to live until first used
+    probe.setTtl(0);
+    probe.prefetch(QStringList() << paths.at(2));
+    QVERIFY(probe.waitForDone(1000));
+    QTest::qSleep(5);
+    QFile::remove(paths.at(2));
+    QVERIFY(probe.exists(paths.at(2)));
+    QTest::qSleep(5);
+    QVERIFY(!probe.exists(paths.at(2)));
+    probe.setTtl(10000);
+
+    // Non-evdev character devices are not opened nor queried
+    if (QFileInfo("/dev/null").exists()) {
+        DeviceProbe::Result result = DeviceProbe::probeUncached("/dev/null");
+        QVERIFY(result.exists);
+        QVERIFY(result.readable);
+        QVERIFY(!result.hasInputName);
+    }
+}
+
+/**
+ * Reads a configuration key in its own thread, the way filters do in
+ * adaptor threads, counting reads that find the key missing.
+ */
+class ConfigReader : public QThread
+{
+public:
+    ConfigReader() : reads(0), missing(0), done(0) {}
+
+    void run()
+    {
+        while (!done.loadAcquire()) {
+            if (!SensorFrameworkConfig::configuration()->exists("reloadtest/buffer_size")) {
+                ++missing;
+            }
+            ++reads;
+        }
+    }
+
+    int reads;
+    int missing;
+    QAtomicInt done;
+};
+
+void DataFlowTest::testConfigReload()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.path() + "/reload.conf";
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("[reloadtest]\n"
+               "threshold = 20\n"
+               "buffer_size = 10\n"
+               "removed = 1\n");
+    file.close();
+    QVERIFY(SensorFrameworkConfig::loadConfig(path, ""));
+
+    QObject context;
+    std::atomic<int> threshold(SensorFrameworkConfig::configuration()->value<int>("reloadtest/threshold", 0));
+    std::atomic<int> removed(SensorFrameworkConfig::configuration()->value<int>("reloadtest/removed", 0));
+    SensorFrameworkConfig::bind<int>("reloadtest/threshold", 0, &context, &threshold);
+    SensorFrameworkConfig::bind<int>("reloadtest/removed", -1, &context, &removed);
+    QCOMPARE(threshold.load(), 20);
+    QCOMPARE(removed.load(), 1);
+
+    QSignalSpy changed(SensorFrameworkConfig::watcher(), SIGNAL(valueChanged(QString,QVariant)));
+    QSignalSpy reloaded(SensorFrameworkConfig::watcher(), SIGNAL(reloaded()));
+
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("[reloadtest]\n"
+               "threshold = 35\n"
+               "buffer_size = 10\n"
+               "added = 2\n");
+    file.close();
+    QVERIFY(SensorFrameworkConfig::reloadConfig());
+
+    // Only changed, added and removed keys are reported. Files loaded by
+    // earlier tests may have disappeared, so ignore keys of other groups.
+    QCOMPARE(reloaded.count(), 1);
+    QStringList keys;
+    for (int i = 0; i < changed.count(); ++i) {
+        QString key = changed.at(i).at(0).toString();
+        if (key.startsWith("reloadtest/")) {
+            keys << key;
+        }
+    }
+    QCOMPARE(keys.size(), 3);
+    QVERIFY(keys.contains("reloadtest/threshold"));
+    QVERIFY(keys.contains("reloadtest/added"));
+    QVERIFY(keys.contains("reloadtest/removed"));
+
+    QCOMPARE(threshold.load(), 35);
+    QCOMPARE(removed.load(), -1);
+    QCOMPARE(SensorFrameworkConfig::configuration()->value<int>("reloadtest/added", 0), 2);
+    QVERIFY(!SensorFrameworkConfig::configuration()->exists("reloadtest/removed"));
+
+    // Subscriptions end with their context
+    changed.clear();
+    {
+        QObject shortLived;
+        std::atomic<int> value(0);
+        SensorFrameworkConfig::bind<int>("reloadtest/threshold", 0, &shortLived, &value);
+    }
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("[reloadtest]\n"
+               "threshold = 40\n"
+               "buffer_size = 10\n");
+    file.close();
+    QVERIFY(SensorFrameworkConfig::reloadConfig());
+    QCOMPARE(threshold.load(), 40);
+
+    // Readers in other threads never see the configuration half replaced
+    ConfigReader reader;
+    reader.start();
+    for (int i = 0; i < 50; ++i) {
+        QVERIFY(SensorFrameworkConfig::reloadConfig());
+    }
+    reader.done.storeRelease(1);
+    QVERIFY(reader.wait(5000));
+    QVERIFY(reader.reads > 0);
+    QCOMPARE(reader.missing, 0);
+}
+
+void DataFlowTest::testMountMatrix()
+{
+    MountMatrix matrix;
+    QVERIFY(matrix.isIdentity());
+    QVERIFY(MountMatrix::parse("0,1,0,1,0,0,0,0,-1", matrix));
+    QCOMPARE(matrix.data_[0][1], 1.0);
+    QCOMPARE(matrix.data_[2][2], -1.0);
+    QVERIFY(!matrix.isIdentity());
+    QVERIFY(MountMatrix::parse("\"0.5, 0, 0; 0, 1, 0; 0, 0, 1\"", matrix));
+    QCOMPARE(matrix.data_[0][0], 0.5);
+    QVERIFY(!MountMatrix::parse("1,0,0,0,1,0", matrix));
+    QVERIFY(!MountMatrix::parse("1,0,0,0,1,0,0,0,x", matrix));
+
+    // Fake IIO sysfs and udev database
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir root(dir.path());
+    QVERIFY(root.mkpath("iio/iio:device0"));
+    QVERIFY(root.mkpath("iio/iio:device1"));
+    QVERIFY(root.mkpath("udev"));
+
+    QMap<QString, QByteArray> files;
+    files.insert("iio/iio:device0/in_temp_raw", "0\n");
+    files.insert("iio/iio:device1/in_accel_x_raw", "0\n");
+    files.insert("iio/iio:device1/in_accel_mount_matrix", "0, -1, 0; 1, 0, 0; 0, 0, 1\n");
+    files.insert("iio/iio:device1/dev", "250:1\n");
+    files.insert("iio/iio:device1/in_magn_x_raw", "0\n");
+    files.insert("iio/iio:device1/mount_matrix", "-1, 0, 0; 0, -1, 0; 0, 0, 1\n");
+    files.insert("mount.conf", QString("[global]\n"
+                                       "iio_sysfs_path = %1/iio\n"
+                                       "udev_data_path = %1/udev\n"
+                                       "[mountconf]\n"
+                                       "iio_device = iio:device1\n").arg(dir.path()).toLatin1());
+    for (QMap<QString, QByteArray>::const_iterator it = files.constBegin(); it != files.constEnd(); ++it) {
+        QFile file(root.absoluteFilePath(it.key()));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(it.value());
+    }
+    QVERIFY(SensorFrameworkConfig::loadConfig(root.absoluteFilePath("mount.conf"), ""));
+
+    // Channel specific sysfs attribute of the device the adaptor reads
+    QString device1 = root.absoluteFilePath("iio/iio:device1");
+    matrix = MountMatrix::forSensor("mounttest", "accel", device1);
+    QCOMPARE(matrix.origin(), MountMatrix::OriginSysfs);
+    QCOMPARE(matrix.toString(), QString("0,-1,0,1,0,0,0,0,1"));
+
+    // Device wide sysfs attribute
+    matrix = MountMatrix::forSensor("mounttest", "magn", device1);
+    QCOMPARE(matrix.origin(), MountMatrix::OriginSysfs);
+    QCOMPARE(matrix.toString(), QString("-1,0,0,0,-1,0,0,0,1"));
+
+    // Configured device
+    matrix = MountMatrix::forSensor("mountconf", "accel");
+    QCOMPARE(matrix.origin(), MountMatrix::OriginSysfs);
+    QCOMPARE(matrix.toString(), QString("0,-1,0,1,0,0,0,0,1"));
+
+    // Adaptors not reading an IIO device don't get the matrix of one
+    matrix = MountMatrix::forSensor("mounttest", "accel");
+    QCOMPARE(matrix.origin(), MountMatrix::OriginDefault);
+    QVERIFY(matrix.isIdentity());
+
+    // Device without mounting matrix
+    matrix = MountMatrix::forSensor("mounttest", "temp", root.absoluteFilePath("iio/iio:device0"));
+    QCOMPARE(matrix.origin(), MountMatrix::OriginDefault);
+    QVERIFY(matrix.isIdentity());
+
+    // udev hwdb property overrides sysfs
+    QFile udev(root.absoluteFilePath("udev/c250:1"));
+    QVERIFY(udev.open(QIODevice::WriteOnly));
+    udev.write("I:123456\n"
+               "E:ACCEL_MOUNT_MATRIX=1, 0, 0; 0, 0, 1; 0, 1, 0\n");
+    udev.close();
+    matrix = MountMatrix::forSensor("mounttest", "accel", device1);
+    QCOMPARE(matrix.origin(), MountMatrix::OriginUdev);
+    QCOMPARE(matrix.toString(), QString("1,0,0,0,0,1,0,1,0"));
+
+    // Configuration overrides both
+    QFile conf(root.absoluteFilePath("override.conf"));
+    QVERIFY(conf.open(QIODevice::WriteOnly));
+    conf.write("[mounttest]\n"
+               "transformation_matrix = \"0,0,1,0,1,0,1,0,0\"\n");
+    conf.close();
+    QVERIFY(SensorFrameworkConfig::loadConfig(conf.fileName(), ""));
+    matrix = MountMatrix::forSensor("mounttest", "accel", device1);
+    QCOMPARE(matrix.origin(), MountMatrix::OriginConfig);
+    QCOMPARE(matrix.toString(), QString("0,0,1,0,1,0,1,0,0"));
+}
+
+/**
+ * Ring buffer reader collecting everything written to the buffer.
+ */
+class SampleCollector : public RingBufferReader<TimedXyzData>
+{
+public:
+    QList<TimedXyzData> samples;
+
+    void pushNewData()
+    {
+        TimedXyzData data;
+        while (read(1, &data)) {
+            samples.append(data);
+        }
+    }
+
+    unsigned drain(TimedXyzData* values, unsigned n)
+    {
+        return read(n, values);
+    }
+};
+
+void DataFlowTest::testSourceSlot()
+{
+    Source<TimedXyzData> source;
+    RingBuffer<TimedXyzData> buffer(2);
+    SampleCollector collector;
+    QVERIFY(source.join(buffer.sink("sink")));
+    QVERIFY(buffer.join(&collector));
+
+    // Single ring buffer sink: slots are in buffer storage, and nothing
+    // is visible to readers before commit
+    TimedXyzData* first = source.nextSlot();
+    *first = TimedXyzData(1, 1, 2, 3);
+    collector.pushNewData();
+    QCOMPARE(collector.samples.size(), 0);
+    source.commit();
+    collector.pushNewData();
+    QCOMPARE(collector.samples.size(), 1);
+
+    TimedXyzData* second = source.nextSlot();
+    QVERIFY(second != first);
+    *second = TimedXyzData(2, 4, 5, 6);
+    source.commit();
+    QCOMPARE(source.nextSlot(), first);
+    *first = TimedXyzData(3, 7, 8, 9);
+    source.commit();
+    collector.pushNewData();
+    QCOMPARE(collector.samples.size(), 3);
+    QCOMPARE(collector.samples.at(1).timestamp_, (quint64)2);
+    QCOMPARE(collector.samples.at(2).z_, 9.0f);
+
+    // Several sinks: slot belongs to the source and is propagated to all
+    RingBuffer<TimedXyzData> other(2);
+    SampleCollector otherCollector;
+    QVERIFY(source.join(other.sink("sink")));
+    QVERIFY(other.join(&otherCollector));
+    TimedXyzData* shared = source.nextSlot();
+    QCOMPARE(source.nextSlot(), shared);
+    *shared = TimedXyzData(4, 1, 1, 1);
+    source.commit();
+    collector.pushNewData();
+    otherCollector.pushNewData();
+    QCOMPARE(collector.samples.size(), 4);
+    QCOMPARE(otherCollector.samples.size(), 1);
+    QCOMPARE(otherCollector.samples.at(0).timestamp_, (quint64)4);
+
+    QVERIFY(source.unjoin(other.sink("sink")));
+    QVERIFY(other.unjoin(&otherCollector));
+    QVERIFY(buffer.unjoin(&collector));
+}
+
+void DataFlowTest::testRingBufferOverrun()
+{
+    Source<TimedXyzData> source;
+    RingBuffer<TimedXyzData> buffer(4);
+    SampleCollector slow;
+    SampleCollector fast;
+    slow.setReadyCallback(0);
+    QVERIFY(source.join(buffer.sink("sink")));
+    QVERIFY(buffer.join(&slow));
+    QVERIFY(buffer.join(&fast));
+
+    // Fast reader keeps up, slow one only gets the last buffer full
+    for (int i = 1; i <= 10; ++i) {
+        TimedXyzData sample(i, i, 0, 0);
+        source.propagate(1, &sample);
+    }
+    QCOMPARE(fast.samples.size(), 10);
+    QCOMPARE(fast.overruns(), 0u);
+    QCOMPARE(fast.maxLag(), 1u);
+
+    slow.pushNewData();
+    QCOMPARE(slow.samples.size(), 4);
+    QCOMPARE(slow.samples.at(0).timestamp_, (quint64)7);
+    QCOMPARE(slow.samples.at(3).timestamp_, (quint64)10);
+    QCOMPARE(slow.overruns(), 6u);
+    QCOMPARE(slow.maxLag(), 10u);
+
+    // Writer mid-slot: the slot being filled is not readable yet
+    TimedXyzData* slot = source.nextSlot();
+    *slot = TimedXyzData(11, 11, 0, 0);
+    slow.pushNewData();
+    QCOMPARE(slow.samples.size(), 4);
+    source.commit();
+    slow.pushNewData();
+    QCOMPARE(slow.samples.size(), 5);
+    QCOMPARE(slow.overruns(), 6u);
+
+    slow.resetStatistics();
+    QCOMPARE(slow.overruns(), 0u);
+    QCOMPARE(slow.maxLag(), 0u);
+
+    QVERIFY(buffer.unjoin(&fast));
+    QVERIFY(buffer.unjoin(&slow));
+}
+
+/**
+ * Reader draining a ring buffer in its own thread, checking that every
+ * sample it gets is consistent and in order.
+ */
+class ThreadedCollector : public QThread, public RingBufferReader<TimedXyzData>
+{
+public:
+    ThreadedCollector() : count(0), torn(0), unordered(0), last(0), done(0)
+    {
+        setReadyCallback(0);
+    }
+
+    void pushNewData()
+    {
+        TimedXyzData data[8];
+        unsigned n;
+        while ((n = read(8, data))) {
+            for (unsigned i = 0; i < n; ++i) {
+                if (data[i].y_ != 2 * data[i].x_ || data[i].z_ != -data[i].x_) {
+                    ++torn;
+                }
+                if (data[i].timestamp_ <= last) {
+                    ++unordered;
+                }
+                last = data[i].timestamp_;
+                ++count;
+            }
+        }
+    }
+
+    void run()
+    {
+        while (!done.loadAcquire()) {
+            pushNewData();
+        }
+        pushNewData();
+    }
+
+    unsigned count;
+    unsigned torn;
+    unsigned unordered;
+    quint64 last;
+    QAtomicInt done;
+};
+
+void DataFlowTest::testRingBufferThreads()
+{
+    const int SAMPLES = 200000;
+    const int READERS = 4;
+
+    Source<TimedXyzData> source;
+    RingBuffer<TimedXyzData> buffer(16);
+    QVERIFY(source.join(buffer.sink("sink")));
+
+    QList<ThreadedCollector*> readers;
+    for (int i = 0; i < READERS; ++i) {
+        readers << new ThreadedCollector;
+        QVERIFY(buffer.join(readers.last()));
+        readers.last()->start();
+    }
+
+    for (int i = 1; i <= SAMPLES; ++i) {
+        TimedXyzData* sample = source.nextSlot();
+        *sample = TimedXyzData(i, i, 2 * i, -i);
+        source.commit();
+    }
+
+    foreach (ThreadedCollector* reader, readers) {
+        reader->done.storeRelease(1);
+        QVERIFY(reader->wait(10000));
+        QCOMPARE(reader->torn, 0u);
+        QCOMPARE(reader->unordered, 0u);
+        QCOMPARE(reader->last, (quint64)SAMPLES);
+        QCOMPARE(reader->count + reader->overruns(), (unsigned)SAMPLES);
+        QVERIFY(reader->maxLag() >= 1);
+        QVERIFY(buffer.unjoin(reader));
+    }
+    qDeleteAll(readers);
+}
+
+/**
+ * Reader which holds the writer thread inside its wakeup until released.
+ */
+class BlockingReader : public RingBufferReader<TimedXyzData>
+{
+public:
+    void pushNewData()
+    {
+        TimedXyzData data;
+        while (read(1, &data)) {
+        }
+        entered.release();
+        proceed.acquire();
+    }
+
+    QSemaphore entered;
+    QSemaphore proceed;
+};
+
+/**
+ * Writes one sample from its own thread, as an adaptor thread does.
+ */
+class SampleWriter : public QThread
+{
+public:
+    SampleWriter(Source<TimedXyzData>* source) : source_(source) {}
+
+    void run()
+    {
+        TimedXyzData sample(1, 1, 2, -1);
+        source_->propagate(1, &sample);
+    }
+
+private:
+    Source<TimedXyzData>* source_;
+};
+
+/**
+ * Unjoins a reader from its own thread, as the main loop does before
+ * deleting a chain.
+ */
+class ReaderUnjoiner : public QThread
+{
+public:
+    ReaderUnjoiner(RingBuffer<TimedXyzData>* buffer, BlockingReader* reader) :
+        unjoined(0), buffer_(buffer), reader_(reader) {}
+
+    void run()
+    {
+        buffer_->unjoin(reader_);
+        unjoined.storeRelease(1);
+    }
+
+    QAtomicInt unjoined;
+
+private:
+    RingBuffer<TimedXyzData>* buffer_;
+    BlockingReader* reader_;
+};
+
+void DataFlowTest::testRingBufferUnjoin()
+{
+    Source<TimedXyzData> source;
+    RingBuffer<TimedXyzData> buffer(4);
+    QScopedPointer<BlockingReader> reader(new BlockingReader);
+    QVERIFY(source.join(buffer.sink("sink")));
+    QVERIFY(buffer.join(reader.data()));
+
+    SampleWriter writer(&source);
+    writer.start();
+    QVERIFY(reader->entered.tryAcquire(1, 10000));
+
+    // Unjoin must not return, and the reader must not be deleted, while
+    // the writer thread is still running it
+    ReaderUnjoiner unjoiner(&buffer, reader.data());
+    unjoiner.start();
+    QTest::qSleep(100);
+    QVERIFY(!unjoiner.unjoined.loadAcquire());
+
+    reader->proceed.release();
+    QVERIFY(unjoiner.wait(10000));
+    QVERIFY(unjoiner.unjoined.loadAcquire());
+    QVERIFY(writer.wait(10000));
+
+    // Retired reader is no longer woken
+    reader.reset();
+    TimedXyzData sample(2, 2, 4, -2);
+    source.propagate(1, &sample);
+}
+
+void DataFlowTest::benchmarkRingBuffer_data()
+{
+    QTest::addColumn<int>("readers");
+    QTest::newRow("1 reader") << 1;
+    QTest::newRow("2 readers") << 2;
+    QTest::newRow("4 readers") << 4;
+    QTest::newRow("8 readers") << 8;
+}
+
+void DataFlowTest::benchmarkRingBuffer()
+{
+    QFETCH(int, readers);
+
+    Source<TimedXyzData> source;
+    RingBuffer<TimedXyzData> buffer(64);
+    QList<SampleCollector*> collectors;
+    QVERIFY(source.join(buffer.sink("sink")));
+    for (int i = 0; i < readers; ++i) {
+        collectors << new SampleCollector;
+        collectors.last()->setReadyCallback(0);
+        QVERIFY(buffer.join(collectors.last()));
+    }
+
+    TimedXyzData sample(1, 1.5f, -2.0f, 9.81f);
+    TimedXyzData out[32];
+    QBENCHMARK {
+        for (int i = 0; i < 32; ++i) {
+            source.propagate(1, &sample);
+        }
+        foreach (SampleCollector* collector, collectors) {
+            QCOMPARE(collector->drain(out, 32), 32u);
+        }
+    }
+
+    foreach (SampleCollector* collector, collectors) {
+        QVERIFY(buffer.unjoin(collector));
+    }
+    qDeleteAll(collectors);
+}
+
+/**
+ * Doubles x of samples.
+ */
+class DoublingFilter : public Filter<TimedXyzData, DoublingFilter, TimedXyzData>
+{
+public:
+    DoublingFilter() : Filter<TimedXyzData, DoublingFilter, TimedXyzData>(this, &DoublingFilter::filter) {}
+
+private:
+    void filter(unsigned, const TimedXyzData* data)
+    {
+        TimedXyzData out(data->timestamp_, 2 * data->x_, 0, 0);
+        source_.propagate(1, &out);
+    }
+};
+
+/**
+ * Two input filter outputting x of both latest inputs, either on each
+ * input or deferred to the end of the epoch.
+ */
+class MergeFilter : public FilterBase
+{
+public:
+    MergeFilter(bool deferred) :
+        fired(0),
+        firstSink_(this, &MergeFilter::first),
+        secondSink_(this, &MergeFilter::second),
+        fireCallback_(this, &MergeFilter::fire),
+        deferred_(deferred)
+    {
+        addSink(&firstSink_, "first");
+        addSink(&secondSink_, "second");
+        addSource(&source_, "source");
+    }
+
+    int fired;
+
+private:
+    void first(unsigned, const TimedXyzData* data) { first_ = *data; update(); }
+    void second(unsigned, const TimedXyzData* data) { second_ = *data; update(); }
+
+    void update()
+    {
+        if (deferred_) {
+            Scheduler::defer(this, &fireCallback_);
+        } else {
+            fire();
+        }
+    }
+
+    void fire()
+    {
+        ++fired;
+        TimedXyzData out(first_.timestamp_, first_.x_, second_.x_, 0);
+        source_.propagate(1, &out);
+    }
+
+    Sink<MergeFilter, TimedXyzData> firstSink_;
+    Sink<MergeFilter, TimedXyzData> secondSink_;
+    Source<TimedXyzData> source_;
+    Callback<MergeFilter> fireCallback_;
+    bool deferred_;
+    TimedXyzData first_;
+    TimedXyzData second_;
+};
+
+void DataFlowTest::testGraphScheduling_data()
+{
+    QTest::addColumn<bool>("deferred");
+    QTest::addColumn<bool>("shortPathFirst");
+    QTest::newRow("immediate") << false << false;
+    QTest::newRow("immediate, reversed join") << false << true;
+    QTest::newRow("deferred") << true << false;
+    QTest::newRow("deferred, reversed join") << true << true;
+}
+
+void DataFlowTest::testGraphScheduling()
+{
+    QFETCH(bool, deferred);
+    QFETCH(bool, shortPathFirst);
+
+    // Diamond: input reaches the merge filter directly and through a
+    // doubling filter and a second buffer
+    Source<TimedXyzData> source;
+    RingBuffer<TimedXyzData> input(8);
+    RingBuffer<TimedXyzData> doubled(8);
+    RingBuffer<TimedXyzData> output(8);
+    BufferReader<TimedXyzData> longReader(4);
+    BufferReader<TimedXyzData> shortReader(4);
+    BufferReader<TimedXyzData> doubledReader(4);
+    DoublingFilter doubling;
+    MergeFilter merge(deferred);
+    SampleCollector collector;
+
+    QVERIFY(source.join(input.sink("sink")));
+    QVERIFY(longReader.source("source")->join(doubling.sink("sink")));
+    QVERIFY(doubling.source("source")->join(doubled.sink("sink")));
+    QVERIFY(doubled.join(&doubledReader));
+    QVERIFY(doubledReader.source("source")->join(merge.sink("second")));
+    QVERIFY(shortReader.source("source")->join(merge.sink("first")));
+    QVERIFY(merge.source("source")->join(output.sink("sink")));
+    QVERIFY(output.join(&collector));
+    if (shortPathFirst) {
+        QVERIFY(input.join(&shortReader));
+        QVERIFY(input.join(&longReader));
+    } else {
+        QVERIFY(input.join(&longReader));
+        QVERIFY(input.join(&shortReader));
+    }
+
+    QVERIFY(Scheduler::height(&longReader) > Scheduler::height(&doubledReader));
+    QVERIFY(Scheduler::height(&doubledReader) > Scheduler::height(&merge));
+    QCOMPARE(Scheduler::height(&merge), 1);
+    QVERIFY(!Scheduler::inEpoch());
+
+    for (int i = 1; i <= 3; ++i) {
+        TimedXyzData sample(i, i, 0, 0);
+        source.propagate(1, &sample);
+    }
+
+    if (deferred) {
+        // One output per commit, from both updated inputs
+        QCOMPARE(merge.fired, 3);
+        QCOMPARE(collector.samples.size(), 3);
+        for (int i = 0; i < 3; ++i) {
+            QCOMPARE(collector.samples.at(i).x_, (float)(i + 1));
+            QCOMPARE(collector.samples.at(i).y_, (float)(2 * (i + 1)));
+        }
+    } else {
+        // One output per input, in the same order whatever the join order
+        QCOMPARE(merge.fired, 6);
+        QCOMPARE(collector.samples.size(), 6);
+        QCOMPARE(collector.samples.at(0).x_, 1.0f);
+        QCOMPARE(collector.samples.at(0).y_, 0.0f);
+        QCOMPARE(collector.samples.at(1).x_, 1.0f);
+        QCOMPARE(collector.samples.at(1).y_, 2.0f);
+        QCOMPARE(collector.samples.at(5).x_, 3.0f);
+        QCOMPARE(collector.samples.at(5).y_, 6.0f);
+    }
+
+    // Outside an epoch deferred work runs right away
+    TimedXyzData sample(4, 4, 0, 0);
+    collector.samples.clear();
+    static_cast<SinkTyped<TimedXyzData>*>(merge.sink("first"))->collect(1, &sample);
+    QCOMPARE(collector.samples.size(), 1);
+    QCOMPARE(collector.samples.at(0).x_, 4.0f);
+
+    QVERIFY(input.unjoin(&shortReader));
+    QVERIFY(input.unjoin(&longReader));
+    QVERIFY(output.unjoin(&collector));
+    QVERIFY(doubled.unjoin(&doubledReader));
+}
+
+void DataFlowTest::testMscTimestamp()
+{
+    MscTimestamp mapper(100000);
+    QVERIFY(!mapper.isSynced());
+
+    // First frame anchors hardware clock to event time
+    QCOMPARE(mapper.map(1000, 5000000), (quint64)5000000);
+    QVERIFY(mapper.isSynced());
+
+    // Later frames follow hardware intervals, event time jitter is ignored
+    QCOMPARE(mapper.map(11000, 5010300), (quint64)5010000);
+    QCOMPARE(mapper.map(21000, 5020050), (quint64)5020000);
+
+    // Frame with less latency than the anchor lowers the offset
+    QCOMPARE(mapper.map(31000, 5029800), (quint64)5029800);
+    QCOMPARE(mapper.map(41000, 5040100), (quint64)5039800);
+
+    // Counter wraparound
+    MscTimestamp wrapping;
+    QCOMPARE(wrapping.map(0xfffff000u, 1000000), (quint64)1000000);
+    QCOMPARE(wrapping.map(0x00001000u, 1008192), (quint64)1008192);
+    QCOMPARE(wrapping.map(0x00003000u, 1016400), (quint64)1016384);
+
+    // Large difference, e.g. device reset, resyncs to event time
+    QCOMPARE(mapper.map(5, 9000000), (quint64)9000000);
+    QCOMPARE(mapper.map(10005, 9010200), (quint64)9010000);
+
+    mapper.reset();
+    QVERIFY(!mapper.isSynced());
+    QCOMPARE(mapper.map(123, 9500000), (quint64)9500000);
+}
+
+void DataFlowTest::testInputEventMask()
+{
+    InputEventMask mask;
+    QVERIFY(mask.isEmpty());
+    QVERIFY(mask.accepts(EV_KEY, KEY_A));
+
+    mask.add(EV_ABS, ABS_X);
+    mask.add(EV_ABS, ABS_Y);
+    mask.add(EV_ABS, ABS_Z);
+    mask.add(EV_SW);
+    QVERIFY(!mask.isEmpty());
+    QVERIFY(mask.accepts(EV_SYN, SYN_REPORT));
+    QVERIFY(mask.accepts(EV_ABS, ABS_Y));
+    QVERIFY(!mask.accepts(EV_ABS, ABS_PRESSURE));
+    QVERIFY(mask.accepts(EV_SW, SW_LID));
+    QVERIFY(mask.accepts(EV_SW, SW_TABLET_MODE));
+    QVERIFY(!mask.accepts(EV_KEY, KEY_A));
+
+    // Recorded stream of a combined device: keys, wheel, lid switch and
+    // absolute axes, each frame terminated by SYN_REPORT
+    const unsigned short recorded[][3] = {
+        { EV_KEY, KEY_A, 1 },         { EV_SYN, SYN_REPORT, 0 },
+        { EV_ABS, ABS_X, 10 },        { EV_ABS, ABS_Y, 20 },
+        { EV_ABS, ABS_PRESSURE, 5 },  { EV_SYN, SYN_REPORT, 0 },
+        { EV_REL, REL_WHEEL, 1 },     { EV_SYN, SYN_REPORT, 0 },
+        { EV_SW, SW_LID, 1 },         { EV_SYN, SYN_REPORT, 0 },
+        { EV_KEY, KEY_A, 0 },         { EV_MSC, MSC_SCAN, 4 },
+        { EV_SYN, SYN_REPORT, 0 },
+        { EV_ABS, ABS_Z, 30 },        { EV_SYN, SYN_REPORT, 0 },
+    };
+    const int count = sizeof(recorded) / sizeof(recorded[0]);
+
+    input_event events[count];
+    memset(events, 0, sizeof(events));
+    int frames = 0;
+    for (int i = 0; i < count; ++i) {
+        events[i].type = recorded[i][0];
+        events[i].code = recorded[i][1];
+        events[i].value = recorded[i][2];
+        if (events[i].type == EV_SYN) {
+            ++frames;
+        }
+    }
+    QCOMPARE(frames, 6);
+
+    int remaining = mask.filter(events, count);
+    QCOMPARE(remaining, 7);
+
+    // Only frames with consumed events are left, each would wake sensord once
+    int wakeups = 0;
+    for (int i = 0; i < remaining; ++i) {
+        QVERIFY(mask.accepts(events[i].type, events[i].code));
+        if (events[i].type == EV_SYN && events[i].code == SYN_REPORT) {
+            ++wakeups;
+        }
+    }
+    QCOMPARE(wakeups, 3);
+    QCOMPARE((int)events[0].code, (int)ABS_X);
+    QCOMPARE((int)events[2].type, (int)EV_SYN);
+    QCOMPARE((int)events[3].code, (int)SW_LID);
+    QCOMPARE((int)events[5].code, (int)ABS_Z);
+
+    // Empty mask leaves the stream untouched
+    InputEventMask all;
+    QCOMPARE(all.filter(events, remaining), remaining);
+
+    // Hardware timestamps alone do not keep a frame, but travel along
+    // with the events they time
+    mask.addAuxiliary(EV_MSC, MSC_TIMESTAMP);
+    QVERIFY(mask.hasAuxiliary());
+    QVERIFY(!all.hasAuxiliary());
+    const unsigned short timestamped[][3] = {
+        { EV_MSC, MSC_TIMESTAMP, 100 }, { EV_KEY, KEY_A, 1 },
+        { EV_SYN, SYN_REPORT, 0 },
+        { EV_MSC, MSC_TIMESTAMP, 200 }, { EV_ABS, ABS_X, 10 },
+        { EV_SYN, SYN_REPORT, 0 },
+        { EV_MSC, MSC_TIMESTAMP, 300 }, { EV_SYN, SYN_REPORT, 0 },
+    };
+    const int timestampedCount = sizeof(timestamped) / sizeof(timestamped[0]);
+    for (int i = 0; i < timestampedCount; ++i) {
+        events[i].type = timestamped[i][0];
+        events[i].code = timestamped[i][1];
+        events[i].value = timestamped[i][2];
+    }
+    QCOMPARE(mask.filter(events, timestampedCount), 3);
+    QCOMPARE((int)events[0].code, (int)MSC_TIMESTAMP);
+    QCOMPARE(events[0].value, 200);
+    QCOMPARE((int)events[1].code, (int)ABS_X);
+    QCOMPARE((int)events[2].type, (int)EV_SYN);
+}
+
+static input_event touchEvent(unsigned short type, unsigned short code, int value)
+{
+    input_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    return ev;
+}
+
+void DataFlowTest::testTouchTracker()
+{
+    TouchTracker tracker(4);
+    QVERIFY(!tracker.hasChanges());
+
+    // Two fingers down in one frame
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_SLOT, 0));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_TRACKING_ID, 10));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_X, 100));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_Y, 200));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_SLOT, 1));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_TRACKING_ID, 11));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_X, 300));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_Y, 400));
+    // Pointer emulation is ignored on multi-touch devices
+    tracker.handleEvent(touchEvent(EV_KEY, BTN_TOUCH, 1));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_X, 100));
+    QVERIFY(!tracker.hasChanges());
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    QVERIFY(tracker.hasChanges());
+    QVERIFY(tracker.hasTransitions());
+
+    // Contacts carry both the input device and the slot
+    QVector<TouchData> changes = tracker.takeChanges(1000, 3);
+    QCOMPARE(changes.size(), 2);
+    QCOMPARE(changes.at(0).object_, 3);
+    QCOMPARE(changes.at(0).slot_, 0);
+    QCOMPARE(changes.at(0).x_, 100.0f);
+    QCOMPARE(changes.at(0).y_, 200.0f);
+    QCOMPARE(changes.at(0).state_, TouchData::FingerStateAccurate);
+    QCOMPARE(changes.at(1).object_, 3);
+    QCOMPARE(changes.at(1).slot_, 1);
+    QCOMPARE(changes.at(1).x_, 300.0f);
+    QCOMPARE(changes.at(1).timestamp_, (quint64)1000);
+    QVERIFY(!tracker.hasChanges());
+
+    // Second finger moves in two frames, which are coalesced. Slot
+    // stays selected across frames.
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_X, 310));
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_Y, 410));
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    QVERIFY(!tracker.hasTransitions());
+    changes = tracker.takeChanges(2000);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.at(0).slot_, 1);
+    QCOMPARE(changes.at(0).x_, 310.0f);
+    QCOMPARE(changes.at(0).y_, 410.0f);
+
+    // Unchanged values do not produce records
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_X, 310));
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    QVERIFY(!tracker.hasChanges());
+
+    // First finger lifts
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_SLOT, 0));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_TRACKING_ID, -1));
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    QVERIFY(tracker.hasTransitions());
+    changes = tracker.takeChanges(3000);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.at(0).slot_, 0);
+    QCOMPARE(changes.at(0).state_, TouchData::FingerStateNotPresent);
+
+    // Events up to the next SYN_REPORT after SYN_DROPPED are ignored,
+    // and the contacts are then read back. The release of the second
+    // finger was lost with the dropped events.
+    QVERIFY(!tracker.needsResync());
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_DROPPED, 0));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_SLOT, 1));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_POSITION_X, 999));
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    QVERIFY(!tracker.hasChanges());
+    QVERIFY(tracker.needsResync());
+    QVector<struct input_event> state;
+    state << touchEvent(EV_ABS, ABS_MT_SLOT, 0) << touchEvent(EV_ABS, ABS_MT_TRACKING_ID, -1)
+          << touchEvent(EV_ABS, ABS_MT_SLOT, 1) << touchEvent(EV_ABS, ABS_MT_TRACKING_ID, -1)
+          << touchEvent(EV_ABS, ABS_MT_SLOT, 1) << touchEvent(EV_SYN, SYN_REPORT, 0);
+    tracker.resync(state);
+    QVERIFY(!tracker.needsResync());
+    QVERIFY(tracker.hasTransitions());
+    changes = tracker.takeChanges(3500);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.at(0).slot_, 1);
+    QCOMPARE(changes.at(0).state_, TouchData::FingerStateNotPresent);
+
+    // Contacts are released if the device can not be read back
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_SLOT, 2));
+    tracker.handleEvent(touchEvent(EV_ABS, ABS_MT_TRACKING_ID, 12));
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    QCOMPARE(tracker.takeChanges(3600).size(), 1);
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_DROPPED, 0));
+    tracker.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    QVERIFY(!tracker.resync(-1));
+    changes = tracker.takeChanges(3700);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.at(0).slot_, 2);
+    QCOMPARE(changes.at(0).state_, TouchData::FingerStateNotPresent);
+
+    // Single touch device
+    TouchTracker single;
+    single.handleEvent(touchEvent(EV_KEY, BTN_TOUCH, 1));
+    single.handleEvent(touchEvent(EV_ABS, ABS_X, 5));
+    single.handleEvent(touchEvent(EV_ABS, ABS_Y, 6));
+    single.handleEvent(touchEvent(EV_SYN, SYN_REPORT, 0));
+    changes = single.takeChanges(4000);
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes.at(0).slot_, 0);
+    QCOMPARE(changes.at(0).x_, 5.0f);
+    QCOMPARE(changes.at(0).state_, TouchData::FingerStateAccurate);
+}
+
+void DataFlowTest::testSampleEncoders()
+{
+    const SampleSchema* schema = sampleSchema<TimedXyzData>();
+    QCOMPARE(schema->describe(), QString("TimedXyzData timestamp:u64 x:f32 y:f32 z:f32"));
+    QCOMPARE(schema->packedSize(), 20);
+    QCOMPARE(sampleSchema<ProximityData>()->packedSize(), 13);
+    QCOMPARE(sampleSchema<EnvironmentData>()->describe(),
+             QString("EnvironmentData timestamp:u64 temperature:f32 humidity:f32 dewPoint:f32 heatIndex:f32"));
+
+    QVERIFY(!SampleEncoder::create("protobuf"));
+
+    TimedXyzData sample(1234567890123ULL, 1.5f, -2.0f, 9.81f);
+    QByteArray out;
+
+    QScopedPointer<SampleEncoder> raw(SampleEncoder::create("raw"));
+    raw->encode(*schema, &sample, out);
+    QCOMPARE(out.size(), (int)sizeof(TimedXyzData));
+    QCOMPARE(memcmp(out.constData(), &sample, sizeof(sample)), 0);
+
+    QScopedPointer<SampleEncoder> flat(SampleEncoder::create("flat"));
+    QByteArray header = flat->header(*schema);
+    QVERIFY(header.startsWith("SFWF"));
+    QCOMPARE(qFromLittleEndian<quint32>((const uchar*)header.constData() + 4), (quint32)(header.size() - 8));
+    QCOMPARE(header.mid(8), schema->describe().toLatin1());
+
+    out.clear();
+    flat->encode(*schema, &sample, out);
+    QCOMPARE(out.size(), flat->sampleSize(*schema));
+    const uchar* p = (const uchar*)out.constData();
+    QCOMPARE(qFromLittleEndian<quint64>(p), sample.timestamp_);
+    quint32 bits = qFromLittleEndian<quint32>(p + 8);
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    QCOMPARE(x, 1.5f);
+
+    ProximityData proximity(42, 7, true);
+    out.clear();
+    flat->encode(*sampleSchema<ProximityData>(), &proximity, out);
+    QCOMPARE(out.size(), 13);
+    QCOMPARE(qFromLittleEndian<quint32>((const uchar*)out.constData() + 8), (quint32)7);
+    QCOMPARE((int)out.at(12), 1);
+
+    QScopedPointer<SampleEncoder> json(SampleEncoder::create("json"));
+    QCOMPARE(json->sampleSize(*schema), 0);
+    out.clear();
+    json->encode(*sampleSchema<TimedUnsigned>(), &proximity, out);
+    QCOMPARE(out, QByteArray("{\"type\":\"TimedUnsigned\",\"timestamp\":42,\"value\":7}\n"));
+}
+
+void DataFlowTest::benchmarkSampleEncoders_data()
+{
+    QTest::addColumn<QString>("format");
+    foreach (const QString& format, SampleEncoder::formats()) {
+        QTest::newRow(format.toLatin1().constData()) << format;
+    }
+}
+
+void DataFlowTest::benchmarkSampleEncoders()
+{
+    QFETCH(QString, format);
+
+    QScopedPointer<SampleEncoder> encoder(SampleEncoder::create(format));
+    const SampleSchema* schema = sampleSchema<TimedXyzData>();
+    TimedXyzData sample(1234567890123ULL, 1.5f, -2.0f, 9.81f);
+    QByteArray out;
+    out.reserve(256);
+
+    QBENCHMARK {
+        out.resize(0);
+        encoder->encode(*schema, &sample, out);
+    }
+}
+
 QList<QString> DataFlowTest::getKeys(const SensorManager &that)
 {
     return that.getAdaptorTypes();
@@ -208,4 +1464,525 @@ int DataFlowTest::getRefCount(const SensorManager &that, QString key)
     return that.getAdaptorCount(key);
 }
 
+void DataFlowTest::testClockOffsets()
+{
+    ClockOffsets::Clock clock;
+    QVERIFY(ClockOffsets::clockByName("boottime", clock));
+    QCOMPARE(clock, ClockOffsets::Boottime);
+    QVERIFY(!ClockOffsets::clockByName("tai", clock));
+    QVERIFY(!ClockOffsets().isValid());
+
+    ClockOffsets offsets;
+    offsets.monotonic_ = 5000000000ULL;
+    offsets.boottime_ = 5250000400ULL;
+    offsets.realtime_ = 1700000000000000000ULL;
+    QCOMPARE(offsets.offset(ClockOffsets::Monotonic, ClockOffsets::Boottime), (qint64)250000400);
+    QCOMPARE(offsets.offset(ClockOffsets::Boottime, ClockOffsets::Monotonic), (qint64)-250000400);
+    QCOMPARE(offsets.convert(4000000, ClockOffsets::Monotonic, ClockOffsets::Boottime), (quint64)4250000);
+    QCOMPARE(offsets.convert(4250000, ClockOffsets::Boottime, ClockOffsets::Monotonic), (quint64)4000000);
+    QCOMPARE(offsets.convert(4000000, ClockOffsets::Boottime, ClockOffsets::Realtime),
+             (quint64)(1700000000000000000ULL - 5250000400ULL + 4000000000ULL + 500) / 1000);
+    QCOMPARE(offsets.convert(100000, ClockOffsets::Boottime, ClockOffsets::Monotonic), (quint64)0);
+
+    // Conversions of freshly sampled readings agree with the clocks
+    offsets = ClockOffsets::sample();
+    QVERIFY(offsets.isValid());
+    QVERIFY(offsets.boottime_ >= offsets.monotonic_ - offsets.uncertainty_);
+    quint64 now = Utils::getTimeStamp();
+    timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    quint64 boottime = (quint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    quint64 converted = offsets.convert(now, ClockOffsets::Monotonic, ClockOffsets::Boottime);
+    qint64 error = (qint64)(boottime - converted);
+    QVERIFY(error >= -1 - (qint64)offsets.uncertainty_ / 1000);
+    QVERIFY(error < 100000);
+
+    // Clock frames in the flat format carry the tag and packed readings
+    const SampleSchema* schema = sampleSchema<ClockOffsets>();
+    QCOMPARE(schema->describe(), QString("ClockOffsets monotonic:u64 boottime:u64 realtime:u64 gap:u64 uncertainty:u32"));
+    QScopedPointer<SampleEncoder> flat(SampleEncoder::create("flat"));
+    QByteArray out;
+    flat->encode(*schema, &offsets, out);
+    QCOMPARE(out.size(), 36);
+    QCOMPARE(qFromLittleEndian<quint64>((const uchar*)out.constData() + 8), offsets.boottime_);
+}
+
+/**
+ * Passes samples through and records the order of gap notifications.
+ */
+class GapFilter : public Filter<TimedXyzData, GapFilter, TimedXyzData>
+{
+public:
+    GapFilter(QList<GapFilter*>& log) :
+        Filter<TimedXyzData, GapFilter, TimedXyzData>(this, &GapFilter::filter),
+        log_(log)
+    {
+    }
+
+    void discontinuity() { log_ << this; }
+
+private:
+    void filter(unsigned, const TimedXyzData* data) { source_.propagate(1, data); }
+
+    QList<GapFilter*>& log_;
+};
+
+void DataFlowTest::testSuspendGap()
+{
+    // Virtual clock: boottime runs ahead of monotonic while suspended
+    SuspendMonitor monitor(100000);
+    ClockOffsets clocks;
+    clocks.monotonic_ = 10000000000ULL;
+    clocks.boottime_ = 12000000000ULL;
+    QCOMPARE(monitor.check(clocks), 0u);
+
+    clocks.monotonic_ += 1000000000ULL;
+    clocks.boottime_ += 1050000000ULL;
+    QCOMPARE(monitor.check(clocks), 0u);
+    QCOMPARE(monitor.lastGap(), (quint64)0);
+
+    clocks.monotonic_ += 1000000ULL;
+    clocks.boottime_ += 1000000ULL + 30000000000ULL;
+    QCOMPARE(monitor.check(clocks), 1u);
+    QCOMPARE(monitor.lastGap(), (quint64)30000000);
+
+    // Short suspends do not add up to a detected one
+    clocks.boottime_ += 60000000ULL;
+    QCOMPARE(monitor.check(clocks), 1u);
+    clocks.boottime_ += 60000000ULL;
+    QCOMPARE(monitor.check(clocks), 1u);
+    QCOMPARE(monitor.resumeCount(), 1u);
+
+    // Diamond: the second filter is reached directly and through the
+    // first one, and is notified once, after it
+    QList<GapFilter*> log;
+    RingBuffer<TimedXyzData> input(8);
+    RingBuffer<TimedXyzData> middle(8);
+    BufferReader<TimedXyzData> directReader(4);
+    BufferReader<TimedXyzData> firstReader(4);
+    BufferReader<TimedXyzData> middleReader(4);
+    GapFilter first(log);
+    GapFilter second(log);
+
+    QVERIFY(input.join(&directReader));
+    QVERIFY(input.join(&firstReader));
+    QVERIFY(directReader.source("source")->join(second.sink("sink")));
+    QVERIFY(firstReader.source("source")->join(first.sink("sink")));
+    QVERIFY(first.source("source")->join(middle.sink("sink")));
+    QVERIFY(middle.join(&middleReader));
+    QVERIFY(middleReader.source("source")->join(second.sink("sink")));
+
+    Scheduler::discontinuity(input.sink("sink")->downstream());
+    QCOMPARE(log.size(), 2);
+    QCOMPARE(log.at(0), &first);
+    QCOMPARE(log.at(1), &second);
+}
+
+void DataFlowTest::testCpuAccounting()
+{
+    Source<TimedXyzData> source;
+    RingBuffer<TimedXyzData> input(4);
+    BufferReader<TimedXyzData> reader(4);
+    RingBuffer<TimedXyzData> output(4);
+    SampleCollector collector;
+
+    Bin bin("cputest");
+    bin.add(&reader, "reader");
+    bin.add(&output, "buffer");
+    QVERIFY(bin.join("reader", "source", "buffer", "sink"));
+    QVERIFY(source.join(input.sink("sink")));
+    QVERIFY(input.join(&reader));
+    QVERIFY(output.join(&collector));
+
+    CpuAccounting::Node* inputNode = CpuAccounting::node("cputest/input");
+    CpuAccounting::Node* readerNode = CpuAccounting::node("cputest/reader");
+    CpuAccounting::Node* sourceNode = CpuAccounting::node("cputest/reader/source");
+    source.setCpuNode(inputNode);
+    CpuAccounting::reset();
+
+    // Disabled by default, nothing is accounted
+    QVERIFY(!CpuAccounting::isEnabled());
+    TimedXyzData sample(1, 1, 2, 3);
+    source.propagate(1, &sample);
+    QCOMPARE(inputNode->calls(), (quint64)0);
+    QCOMPARE(readerNode->calls(), (quint64)0);
+
+    CpuAccounting::setEnabled(true);
+    for (int i = 0; i < 10; ++i) {
+        sample.timestamp_ = i + 2;
+        source.propagate(1, &sample);
+    }
+    CpuAccounting::setEnabled(false);
+
+    QCOMPARE(collector.samples.size(), 11);
+    QCOMPARE(inputNode->calls(), (quint64)10);
+    QCOMPARE(readerNode->calls(), (quint64)10);
+    QCOMPARE(sourceNode->calls(), (quint64)10);
+
+    // Scopes nest: downstream work is child time of the upstream node
+    QVERIFY(inputNode->totalNs() >= readerNode->totalNs());
+    QVERIFY(readerNode->totalNs() >= sourceNode->totalNs());
+    QCOMPARE(inputNode->selfNs() + readerNode->totalNs(), inputNode->totalNs());
+    QCOMPARE(readerNode->selfNs() + sourceNode->totalNs(), readerNode->totalNs());
+
+    QStringList report = CpuAccounting::report();
+    QCOMPARE(report.filter("cputest/reader:").size(), 1);
+    QVERIFY(report.filter("cputest/reader:").first().contains("10 call(s)"));
+
+    CpuAccounting::reset();
+    QCOMPARE(inputNode->calls(), (quint64)0);
+    QVERIFY(CpuAccounting::report().filter("cputest/").isEmpty());
+
+    QVERIFY(output.unjoin(&collector));
+    QVERIFY(input.unjoin(&reader));
+    QVERIFY(source.unjoin(input.sink("sink")));
+    QVERIFY(bin.unjoin("reader", "source", "buffer", "sink"));
+}
+
+void DataFlowTest::testSensorInstances()
+{
+    QCOMPARE(getInstanceIndex("foo"), 0);
+    QCOMPARE(getInstanceIndex("foo@1;bar"), 1);
+    QCOMPARE(getInstanceIndex("foo@x"), 0);
+    QCOMPARE(getBaseId("foo@1;bar"), QString("foo"));
+    QCOMPARE(getBaseId("foo"), QString("foo"));
+    QCOMPARE(getInstanceId("foo", 0), QString("foo"));
+    QCOMPARE(getInstanceId("foo", 2), QString("foo@2"));
+    QCOMPARE(getObjectPathId("foo@2;bar"), QString("foo_2"));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.path() + "/instances.conf";
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    // Two fake accelerometers polled from plain files, each with its own
+    // mounting matrix
+    QFile(dir.path() + "/accel0").open(QIODevice::WriteOnly);
+    QFile(dir.path() + "/accel1").open(QIODevice::WriteOnly);
+    file.write(QString("[instancetest]\n"
+                       "location = base\n"
+                       "interval = 100\n"
+                       "[instancetest@2]\n"
+                       "location = keyboard\n"
+                       "[instancetest@1]\n"
+                       "location = lid\n"
+                       "interval = 50\n"
+                       "[accelerometer]\n"
+                       "input_match = nosuchinputdevice\n"
+                       "mode = 1\n"
+                       "default_interval = 100\n"
+                       "path = %1/accel0\n"
+                       "transformation_matrix = \"0,1,0,1,0,0,0,0,1\"\n"
+                       "[accelerometer@1]\n"
+                       "path = %1/accel1\n"
+                       "transformation_matrix = \"-1,0,0,0,-1,0,0,0,1\"\n").arg(dir.path()).toLatin1());
+    file.close();
+    QVERIFY(SensorFrameworkConfig::loadConfig(path, ""));
+
+    // Configured instances are listed in index order
+    SensorManager& sm = SensorManager::instance();
+    QStringList instances = sm.availableSensorInstances("instancetest");
+    QCOMPARE(instances.size(), 3);
+    QCOMPARE(instances.at(0), QString("instancetest"));
+    QCOMPARE(instances.at(1), QString("instancetest@1"));
+    QCOMPARE(instances.at(2), QString("instancetest@2"));
+    QCOMPARE(sm.availableSensorInstances("nosuchsensor"), QStringList() << "nosuchsensor");
+
+    // Unknown base types can't be instantiated
+    QVERIFY(sm.requestDeviceAdaptor("nosuchadaptor@1") == NULL);
+
+    // A further instance is a separate adaptor reading its own device
+    QCOMPARE(sm.loadPlugin("accelerometeradaptor"), true);
+    DeviceAdaptor* primary = sm.requestDeviceAdaptor("accelerometeradaptor");
+    DeviceAdaptor* second = sm.requestDeviceAdaptor("accelerometeradaptor@1");
+    QVERIFY(primary);
+    QVERIFY(second);
+    QVERIFY(primary != second);
+    QCOMPARE(primary->instance(), 0);
+    QCOMPARE(second->instance(), 1);
+    QCOMPARE(second->configKey("instancetest", "interval"), QString("instancetest@1/interval"));
+    QCOMPARE(second->configKey("instancetest", "mode"), QString("instancetest/mode"));
+    QCOMPARE(second->configKey("instancetest", "mode", false), QString("instancetest@1/mode"));
+    QCOMPARE(primary->configKey("instancetest", "interval"), QString("instancetest/interval"));
+
+    // Both run at the same time
+    QVERIFY(primary->startSensor());
+    QVERIFY(second->startSensor());
+    QVERIFY(dynamic_cast<SysfsAdaptor*>(primary)->isRunning());
+    QVERIFY(dynamic_cast<SysfsAdaptor*>(second)->isRunning());
+    second->stopSensor();
+    QVERIFY(dynamic_cast<SysfsAdaptor*>(primary)->isRunning());
+    primary->stopSensor();
+
+    // Mounting matrices are per instance and not inherited
+    QCOMPARE(MountMatrix::forSensor("accelerometer", "accel").toString(), QString("0,1,0,1,0,0,0,0,1"));
+    QCOMPARE(MountMatrix::forSensor("accelerometer@1", "accel").toString(), QString("-1,0,0,0,-1,0,0,0,1"));
+    QVERIFY(MountMatrix::forSensor("accelerometer@2", "accel").isIdentity());
+
+    // Chain instances read their own adaptor instance
+    QCOMPARE(sm.loadPlugin("accelerometerchain"), true);
+    AbstractChain* primaryChain = sm.requestChain("accelerometerchain");
+    AbstractChain* secondChain = sm.requestChain("accelerometerchain@1");
+    QVERIFY(primaryChain);
+    QVERIFY(secondChain);
+    QVERIFY(primaryChain != secondChain);
+    QVERIFY(primaryChain->start());
+    QVERIFY(secondChain->start());
+    QVERIFY(primaryChain->running());
+    QVERIFY(secondChain->running());
+    QVERIFY(dynamic_cast<SysfsAdaptor*>(primary)->isRunning());
+    QVERIFY(dynamic_cast<SysfsAdaptor*>(second)->isRunning());
+    QVERIFY(primaryChain->stop());
+    QVERIFY(secondChain->stop());
+    sm.releaseChain("accelerometerchain@1");
+    sm.releaseChain("accelerometerchain");
+
+    sm.releaseDeviceAdaptor("accelerometeradaptor@1");
+    sm.releaseDeviceAdaptor("accelerometeradaptor");
+    SensorFrameworkConfig::loadConfig("/etc/sensorfw/sensord.conf", "/etc/sensorfw/sensord.conf.d");
+}
+
+void DataFlowTest::testSamplePredictor()
+{
+    TimedXyzData predicted;
+    SamplePredictor none;
+    none.update(TimedXyzData(0, 1, 2, 3));
+    QVERIFY(!none.predict(1000, predicted));
+
+    // Acceleration ramping 2 mG/ms on x is extrapolated along the ramp,
+    // up to the horizon
+    SamplePredictor linear(SamplePredictor::Linear, 4, 100000);
+    QVERIFY(!linear.predict(0, predicted));
+    for (int i = 0; i < 4; ++i) {
+        linear.update(TimedXyzData(1000000 + i * 20000, 1000 + i * 40, -500, 0));
+    }
+    QVERIFY(linear.predict(1090000, predicted));
+    QCOMPARE(predicted.timestamp_, (quint64)1090000);
+    QVERIFY(qAbs(predicted.x_ - 1180) < 0.01f);
+    QVERIFY(qAbs(predicted.y_ + 500) < 0.01f);
+    QVERIFY(linear.predict(2000000, predicted));
+    QCOMPARE(predicted.timestamp_, (quint64)1160000);
+    QVERIFY(qAbs(predicted.x_ - 1320) < 0.01f);
+
+    // Timestamps going backwards restart the history
+    linear.update(TimedXyzData(10000, 7, 8, 9));
+    QVERIFY(linear.predict(40000, predicted));
+    QCOMPARE(predicted.x_, 7.0f);
+
+    // Angular rate holds
+    SamplePredictor rate(SamplePredictor::ConstantValue);
+    rate.update(TimedXyzData(0, 100, 0, 0));
+    rate.update(TimedXyzData(10000, 300, 0, 0));
+    QVERIFY(rate.predict(30000, predicted));
+    QCOMPARE(predicted.timestamp_, (quint64)30000);
+    QCOMPARE(predicted.x_, 300.0f);
+
+    // Heading turning 6 degrees per sample across the +-180 wrap
+    SamplePredictor angular(SamplePredictor::Angular);
+    angular.update(TimedXyzData(0, 0, 0, 168));
+    angular.update(TimedXyzData(20000, 0, 0, 174));
+    angular.update(TimedXyzData(40000, 0, 0, 180));
+    angular.update(TimedXyzData(60000, 0, 0, -174));
+    QVERIFY(angular.predict(100000, predicted));
+    QVERIFY(qAbs(predicted.z_ + 162) < 0.01f);
+
+    // On a 1 Hz swing sampled at 100 Hz, readings predicted 30 ms ahead
+    // are much closer to the truth than the latest reading
+    SamplePredictor swing(SamplePredictor::Linear);
+    double heldError = 0;
+    double predictedError = 0;
+    for (int i = 0; i < 300; ++i) {
+        quint64 t = i * 10000;
+        swing.update(TimedXyzData(t, 1000 * sin(2 * M_PI * t / 1e6), 0, 0));
+        if (i < 4)
+            continue;
+        double truth = 1000 * sin(2 * M_PI * (t + 30000) / 1e6);
+        QVERIFY(swing.predict(t + 30000, predicted));
+        heldError += (1000 * sin(2 * M_PI * t / 1e6) - truth) * (1000 * sin(2 * M_PI * t / 1e6) - truth);
+        predictedError += (predicted.x_ - truth) * (predicted.x_ - truth);
+    }
+    QVERIFY(predictedError * 4 < heldError);
+}
+
+/**
+ * Accelerometer-like channel running at a fixed 10 ms interval, whose
+ * samples are pushed by the test.
+ */
+class PredictingChannel : public AbstractSensorChannel
+{
+public:
+    PredictingChannel() : AbstractSensorChannel("predictingchannel")
+    {
+        setPredictionModel(SamplePredictor::Linear);
+        introduceAvailableInterval(DataRange(10000, 1000000, 0));
+        setValid(true);
+    }
+
+    bool downsamplingSupported() const { return true; }
+    void push(const TimedXyzData& data) { downsampleAndPropagate(data, buffer_); }
+
+protected:
+    unsigned int interval() const { return 10000; }
+    bool setInterval(int, unsigned int) { return true; }
+
+private:
+    TimedXyzDownsampleBuffer buffer_;
+};
+
+void DataFlowTest::testPredictedDownsampling()
+{
+    SensorManager& sm = SensorManager::instance();
+    const int sessionId = 9000;
+    sm.socketHandler().setSessionOwner(sessionId, getpid(), geteuid());
+
+    QByteArray path("/run/sensord.sock");
+    QByteArray env = qgetenv("SENSORFW_SOCKET_PATH");
+    if (!env.isEmpty())
+        path.prepend(env);
+    QLocalSocket client;
+    client.connectToServer(path);
+    QVERIFY(client.waitForConnected(1000));
+    QTRY_VERIFY(client.bytesAvailable() > 0);
+    client.readAll();
+    client.write((const char*)&sessionId, sizeof(sessionId));
+    QTRY_VERIFY(sm.socketHandler().getSocketFd(sessionId) != 0);
+
+    // Downsampled 4:1 and predicted 20 ms ahead
+    PredictingChannel channel;
+    channel.start(sessionId);
+    channel.setIntervalRequest(sessionId, 40000);
+    channel.setDownsamplingEnabled(sessionId, true);
+    QVERIFY(channel.setPredictionHorizon(sessionId, 20000));
+
+    // Acceleration ramping 4 mG/ms on x
+    for (int i = 0; i < 8; ++i)
+        channel.push(TimedXyzData(1000000 + i * 10000, 1000 + i * 40, 0, 0));
+
+    // Each frame carries the sample count and one averaged sample
+    const int frameSize = sizeof(unsigned int) + sizeof(TimedXyzData);
+    QByteArray received;
+    for (int n = 0; n < 100 && received.size() < 2 * frameSize; ++n) {
+        QTest::qWait(10);
+        received.append(client.readAll());
+    }
+    QCOMPARE(received.size(), 2 * frameSize);
+
+    // The average of the predicted samples, not a prediction from the
+    // latest raw one: 1240..1360 averages to 1300, at the predicted time
+    // of the latest sample
+    TimedXyzData last;
+    memcpy(&last, received.constData() + frameSize + sizeof(unsigned int), sizeof(last));
+    QCOMPARE(last.timestamp_, (quint64)1090000);
+    QVERIFY(qAbs(last.x_ - 1300) < 0.01f);
+
+    channel.stop(sessionId);
+    sm.socketHandler().removeSession(sessionId);
+}
+
+void DataFlowTest::testIdleReclaim()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.path() + "/idle.conf";
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("[global]\n"
+               "idle_timeout = 20\n");
+    file.close();
+    QVERIFY(SensorFrameworkConfig::loadConfig(path, ""));
+
+    SensorManager& sm = SensorManager::instance();
+    QCOMPARE(sm.loadPlugin("accelerometerchain"), true);
+    AbstractChain* chain = sm.requestChain("accelerometerchain");
+    QVERIFY(chain);
+    QCOMPARE(sm.memoryUsage().filter("chain accelerometerchain:").size(), 1);
+    QCOMPARE(sm.memoryUsage().filter("adaptor accelerometeradaptor:").size(), 1);
+    QVERIFY(sm.memoryUsage().first().startsWith("heap:"));
+
+    // Used again within the grace period, the chain is kept
+    sm.releaseChain("accelerometerchain");
+    QVERIFY(sm.memoryUsage().filter("chain accelerometerchain:").first().endsWith(", idle"));
+    QCOMPARE(sm.requestChain("accelerometerchain"), chain);
+    QTest::qWait(60);
+    QCOMPARE(sm.memoryUsage().filter("chain accelerometerchain:").size(), 1);
+    QVERIFY(!sm.memoryUsage().filter("chain accelerometerchain:").first().endsWith(", idle"));
+
+    // Idle past the grace period, the chain and the adaptor it used are
+    // deleted, and created again on next request
+    sm.releaseChain("accelerometerchain");
+    QTRY_VERIFY(sm.memoryUsage().filter("chain accelerometerchain:").isEmpty());
+    QVERIFY(sm.memoryUsage().filter("adaptor accelerometeradaptor:").isEmpty());
+    QCOMPARE(getRefCount(sm, "accelerometeradaptor"), 0);
+
+    chain = sm.requestChain("accelerometerchain");
+    QVERIFY(chain);
+    QVERIFY(chain->isValid());
+    QCOMPARE(getRefCount(sm, "accelerometeradaptor"), 1);
+    QVERIFY(chain->start());
+    QVERIFY(chain->stop());
+
+    // Zero timeout keeps idle nodes
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("[global]\n"
+               "idle_timeout = 0\n");
+    file.close();
+    QVERIFY(SensorFrameworkConfig::reloadConfig());
+    sm.releaseChain("accelerometerchain");
+    QTest::qWait(60);
+    QCOMPARE(sm.memoryUsage().filter("chain accelerometerchain:").size(), 1);
+}
+
+void DataFlowTest::testIdleReclaimSensor()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.path() + "/idle.conf";
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("[global]\n"
+               "idle_timeout = 20\n");
+    file.close();
+    QVERIFY(SensorFrameworkConfig::loadConfig(path, ""));
+
+    SensorManager& sm = SensorManager::instance();
+    QCOMPARE(sm.loadPlugin("compasssensor"), true);
+    QString idle = sm.memoryUsage().first();
+
+    // Compass sensor pulls in the compass chain, which shares the
+    // magnetometer and accelerometer chains
+    QStringList nodes;
+    nodes << "sensor compasssensor:" << "chain compasschain:"
+          << "chain magcalibrationchain:" << "chain accelerometerchain:";
+    int session = sm.requestSensor("compasssensor");
+    QVERIFY(session != INVALID_SESSION);
+    QString active = sm.memoryUsage().first();
+    foreach (const QString& node, nodes) {
+        QCOMPARE(sm.memoryUsage().filter(node).size(), 1);
+    }
+    QVERIFY(getRefCount(sm, "magnetometeradaptor") > 0);
+
+    // Everything is deleted once idle, readers are unjoined before the
+    // buffers they read go away and no reference is left behind
+    QVERIFY(sm.releaseSensor("compasssensor", session));
+    foreach (const QString& node, nodes) {
+        QTRY_VERIFY(sm.memoryUsage().filter(node).isEmpty());
+    }
+    QCOMPARE(getRefCount(sm, "magnetometeradaptor"), 0);
+    QCOMPARE(getRefCount(sm, "accelerometeradaptor"), 0);
+    QString reclaimed = sm.memoryUsage().first();
+    qDebug() << "Idle before:" << idle << "active:" << active << "reclaimed:" << reclaimed;
+
+    // Created again on next request and usable
+    session = sm.requestSensor("compasssensor");
+    QVERIFY(session != INVALID_SESSION);
+    foreach (const QString& node, nodes) {
+        QCOMPARE(sm.memoryUsage().filter(node).size(), 1);
+    }
+    QCOMPARE(getRefCount(sm, "magnetometeradaptor"), 1);
+    QVERIFY(sm.releaseSensor("compasssensor", session));
+    foreach (const QString& node, nodes) {
+        QTRY_VERIFY(sm.memoryUsage().filter(node).isEmpty());
+    }
+}
+
 QTEST_MAIN(DataFlowTest)
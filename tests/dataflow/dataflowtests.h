@@ -45,6 +45,34 @@ private slots:
 
     void testAdaptorSharing();
     void testChainSharing();
+    void testClientQuota();
+    void testSessionQuota();
+    void testSessionSchema();
+    void testDeviceProbe();
+    void testConfigReload();
+    void testMountMatrix();
+    void testSourceSlot();
+    void testRingBufferOverrun();
+    void testRingBufferThreads();
+    void testRingBufferUnjoin();
+    void benchmarkRingBuffer_data();
+    void benchmarkRingBuffer();
+    void testGraphScheduling_data();
+    void testGraphScheduling();
+    void testMscTimestamp();
+    void testInputEventMask();
+    void testTouchTracker();
+    void testSampleEncoders();
+    void benchmarkSampleEncoders_data();
+    void benchmarkSampleEncoders();
+    void testClockOffsets();
+    void testSuspendGap();
+    void testCpuAccounting();
+    void testSensorInstances();
+    void testSamplePredictor();
+    void testPredictedDownsampling();
+    void testIdleReclaim();
+    void testIdleReclaimSensor();
 
     void cleanup() {};
     void cleanupTestCase();
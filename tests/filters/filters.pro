@@ -11,14 +11,24 @@ HEADERS += filtertests.h \
     ../../filters/orientationinterpreter/orientationinterpreter.h \
     ../../filters/coordinatealignfilter/coordinatealignfilter.h \
     ../../filters/declinationfilter/declinationfilter.h \
-    ../../filters/rotationfilter/rotationfilter.h 
+    ../../filters/rotationfilter/rotationfilter.h \
+    ../../chains/environmentchain/environmentfilter.h \
+    ../../chains/environmentchain/intervalbackoff.h \
+    ../../chains/hingechain/hingefilter.h \
+    ../../chains/gyroscopechain/gyroscopealignfilter.h \
+    ../../chains/compasschain/compassfilter.h
 
     
 SOURCES += filtertests.cpp \
     ../../filters/orientationinterpreter/orientationinterpreter.cpp \
     ../../filters/coordinatealignfilter/coordinatealignfilter.cpp \
     ../../filters/declinationfilter/declinationfilter.cpp \
-    ../../filters/rotationfilter/rotationfilter.cpp
+    ../../filters/rotationfilter/rotationfilter.cpp \
+    ../../chains/environmentchain/environmentfilter.cpp \
+    ../../chains/environmentchain/intervalbackoff.cpp \
+    ../../chains/hingechain/hingefilter.cpp \
+    ../../chains/gyroscopechain/gyroscopealignfilter.cpp \
+    ../../chains/compasschain/compassfilter.cpp
 
 INCLUDEPATH += ../../include \
     ../../ \
@@ -26,6 +36,10 @@ INCLUDEPATH += ../../include \
     ../../filters/coordinatealignfilter \
     ../../filters/declinationfilter \
     ../../filters/rotationfilter \
+    ../../chains/environmentchain \
+    ../../chains/hingechain \
+    ../../chains/gyroscopechain \
+    ../../chains/compasschain \
     ../../core \
     ../../datatypes
     
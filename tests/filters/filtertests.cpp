@@ -27,6 +27,8 @@
 
 #include <QtDebug>
 #include <QTest>
+#include <QSignalSpy>
+#include <QThread>
 #include <QVariant>
 
 #include "sensormanager.h"
@@ -38,9 +40,17 @@
 #include "orientationinterpreter.h"
 #include "declinationfilter.h"
 #include "rotationfilter.h"
+#include "environmentfilter.h"
+#include "intervalbackoff.h"
+#include "hingefilter.h"
+#include "gyroscopealignfilter.h"
+#include "mountmatrix.h"
+#include "compassfilter.h"
+#include "scheduler.h"
 #include "filtertests.h"
 #include "config.h"
 #include <QSettings>
+#include <math.h>
 
 void FilterApiTest::initTestCase()
 {
@@ -129,6 +139,173 @@ void FilterApiTest::testCoordinateAlignFilter()
     delete coordAlignFilter;
 }
 
+void FilterApiTest::testGyroscopeAlignFilter()
+{
+    // Mounting matrix in IIO format
+    MountMatrix mountMatrix;
+    QVERIFY(MountMatrix::parse("0, 0, -1; -1, 0, 0; 0, 1, 0", mountMatrix));
+    TMatrix matrix(mountMatrix.data_);
+
+    // Input data to feed to the filter, bias is (1, 2, 0)
+    TimedXyzData inputData[] = {
+        TimedXyzData(1, 1, 2, 0),
+        TimedXyzData(2, 2, 2, 0),
+        TimedXyzData(3, 1, 5, 0),
+        TimedXyzData(4, 1, 2, 4),
+        TimedXyzData(5, 4, 7, 1)
+    };
+
+    // Expected output data: 2 * M * (in - bias)
+    TimedXyzData expectedResult[] = {
+        TimedXyzData(1, 0, 0, 0),
+        TimedXyzData(2, 0,-2, 0),
+        TimedXyzData(3, 0, 0, 6),
+        TimedXyzData(4,-8, 0, 0),
+        TimedXyzData(5,-2,-6,10)
+    };
+
+    int numInputs = (sizeof(inputData) / sizeof(TimedXyzData));
+
+    Bin filterBin;
+    DummyAdaptor<TimedXyzData> dummyAdaptor;
+
+    GyroscopeAlignFilter* alignFilter = (GyroscopeAlignFilter*)GyroscopeAlignFilter::factoryMethod();
+    alignFilter->setProperty("transMatrix", QVariant::fromValue(matrix));
+    alignFilter->setScale(2.0);
+    alignFilter->setBias(1, 2, 0);
+
+    RingBuffer<TimedXyzData> outputBuffer(10);
+    filterBin.add(&dummyAdaptor, "adapter");
+    filterBin.add(alignFilter, "alignfilter");
+    filterBin.add(&outputBuffer, "buffer");
+
+    filterBin.join("adapter", "source", "alignfilter", "sink");
+    filterBin.join("alignfilter", "source", "buffer", "sink");
+
+    DummyDataEmitter<TimedXyzData> dbusEmitter;
+    Bin marshallingBin;
+    marshallingBin.add(&dbusEmitter, "testdataemitter");
+    outputBuffer.join(&dbusEmitter);
+
+    dummyAdaptor.setTestData(numInputs, inputData);
+    dbusEmitter.setExpectedData(numInputs, expectedResult);
+
+    marshallingBin.start();
+    filterBin.start();
+
+    for (int i = 0; i < numInputs; ++i) {
+        dummyAdaptor.pushNewData();
+    }
+
+    filterBin.stop();
+    marshallingBin.stop();
+
+    QCOMPARE (dummyAdaptor.getDataCount(), dbusEmitter.numSamplesReceived());
+
+    // Stationary samples within threshold of the current bias become the new bias
+    alignFilter->setBiasTracking(5, 4);
+    TimedXyzData stationary[] = {
+        TimedXyzData(6, 2, 3, 1),
+        TimedXyzData(7, 4, 1, -1),
+        TimedXyzData(8, 2, 3, 1),
+        TimedXyzData(9, 4, 1, -1)
+    };
+    // Last sample is already corrected with the new bias (3, 2, 0)
+    TimedXyzData stationaryResult[] = {
+        TimedXyzData(6,-2,-2, 2),
+        TimedXyzData(7, 2,-6,-2),
+        TimedXyzData(8,-2,-2, 2),
+        TimedXyzData(9, 2,-2,-2)
+    };
+    dummyAdaptor.setTestData(4, stationary);
+    dbusEmitter.setExpectedData(4, stationaryResult);
+    marshallingBin.start();
+    filterBin.start();
+    for (int i = 0; i < 4; ++i) {
+        dummyAdaptor.pushNewData();
+    }
+    filterBin.stop();
+    marshallingBin.stop();
+
+    TimedXyzData bias = alignFilter->bias();
+    QCOMPARE(bias.x_, 3.0f);
+    QCOMPARE(bias.y_, 2.0f);
+    QCOMPARE(bias.z_, 0.0f);
+
+    delete alignFilter;
+}
+
+/**
+ * Collects aligned gyroscope output.
+ */
+class XyzCollector : public DataEmitter<TimedXyzData>
+{
+public:
+    XyzCollector() : DataEmitter<TimedXyzData>(10) {}
+
+    QList<TimedXyzData> samples;
+
+protected:
+    void emitData(const TimedXyzData& data) { samples.append(data); }
+};
+
+/**
+ * Flips a gyroscope align filter between two transforms, the way a
+ * configuration reload does from the main thread.
+ */
+class TransformFlipper : public QThread
+{
+public:
+    TransformFlipper(GyroscopeAlignFilter* filter) : done(0), filter_(filter) {}
+
+    void run()
+    {
+        const float noBias[3] = { 0, 0, 0 };
+        const float unitBias[3] = { 1, 1, 1 };
+        for (int i = 0; !done.loadAcquire(); ++i) {
+            if (i % 2)
+                filter_->setTransform(TMatrix(), 2.0, unitBias);
+            else
+                filter_->setTransform(TMatrix(), 1.0, noBias);
+        }
+    }
+
+    QAtomicInt done;
+
+private:
+    GyroscopeAlignFilter* filter_;
+};
+
+void FilterApiTest::testGyroscopeAlignReconfigure()
+{
+    GyroscopeAlignFilter* alignFilter = (GyroscopeAlignFilter*)GyroscopeAlignFilter::factoryMethod();
+    RingBuffer<TimedXyzData> outputBuffer(10);
+    XyzCollector collector;
+    alignFilter->source("source")->join(outputBuffer.sink("sink"));
+    outputBuffer.join(&collector);
+
+    // Samples are aligned with either transform, never with the scale
+    // of one and the bias of the other
+    TransformFlipper flipper(alignFilter);
+    flipper.start();
+    SinkTyped<TimedXyzData>* sink = static_cast<SinkTyped<TimedXyzData>*>(alignFilter->sink("sink"));
+    for (int i = 0; i < 20000; ++i) {
+        TimedXyzData sample(i, 5, 5, 5);
+        sink->collect(1, &sample);
+    }
+    flipper.done.storeRelease(1);
+    QVERIFY(flipper.wait(5000));
+
+    QCOMPARE(collector.samples.size(), 20000);
+    foreach (const TimedXyzData& sample, collector.samples) {
+        QVERIFY(sample.x_ == 5 || sample.x_ == 8);
+        QCOMPARE(sample.y_, sample.x_);
+        QCOMPARE(sample.z_, sample.x_);
+    }
+
+    delete alignFilter;
+}
+
 // TODO: Add some state changes to verify functionality of threshold setting.
 void FilterApiTest::testTopEdgeInterpretationFilter()
 {
@@ -318,6 +495,175 @@ void FilterApiTest::testOrientationInterpretationFilter()
     delete orientationInterpreterFilter;
 }
 
+/**
+ * Collects pose output.
+ */
+class PoseCollector : public DataEmitter<PoseData>
+{
+public:
+    PoseCollector() : DataEmitter<PoseData>(10) {}
+
+    QList<PoseData> samples;
+
+protected:
+    void emitData(const PoseData& data) { samples.append(data); }
+};
+
+void FilterApiTest::testOrientationDecision()
+{
+    // Portrait, a 200 ms tilt to landscape while rotating fast, portrait
+    // again and finally a steady landscape, sampled at 50 Hz
+    const int numInputs = 100;
+    AccelerationData accInput[numInputs];
+    TimedXyzData gyroInput[numInputs];
+    int numGyro = 0;
+    for (int i = 0; i < numInputs; ++i) {
+        quint64 t = i * 20000;
+        bool tilted = (t > 400000 && t <= 600000) || t > 1000000;
+        accInput[i] = tilted ? AccelerationData(t, -981, 0, 100) : AccelerationData(t, 0, -981, 100);
+        if (t > 400000 && t <= 600000)
+            gyroInput[numGyro++] = TimedXyzData(t - 1000, 0, 0, 300000);
+    }
+
+    for (int veto = 0; veto < 2; ++veto) {
+        DummyAdaptor<AccelerationData> accAdaptor;
+        DummyAdaptor<TimedXyzData> gyroAdaptor;
+        PoseCollector topEdgeCollector;
+        PoseCollector hintCollector;
+
+        FilterBase* orientationInterpreterFilter = OrientationInterpreter::factoryMethod();
+        OrientationInterpreter* interpreter = (OrientationInterpreter*)orientationInterpreterFilter;
+        interpreter->setDecision(100000, 60000, 50);
+        interpreter->setMotionVeto(veto ? 100000 : 0, 100000);
+        RingBuffer<PoseData> topEdgeBuffer(10);
+        RingBuffer<PoseData> hintBuffer(10);
+
+        Bin filterBin;
+        filterBin.add(&accAdaptor, "accelerometer");
+        filterBin.add(&gyroAdaptor, "gyroscope");
+        filterBin.add(orientationInterpreterFilter, "orientationfilter");
+        filterBin.add(&topEdgeBuffer, "topedgebuffer");
+        filterBin.add(&hintBuffer, "hintbuffer");
+        filterBin.join("accelerometer", "source", "orientationfilter", "accsink");
+        filterBin.join("gyroscope", "source", "orientationfilter", "gyrosink");
+        filterBin.join("orientationfilter", "topedge", "topedgebuffer", "sink");
+        filterBin.join("orientationfilter", "rotationhint", "hintbuffer", "sink");
+
+        Bin marshallingBin;
+        marshallingBin.add(&topEdgeCollector, "topedgecollector");
+        marshallingBin.add(&hintCollector, "hintcollector");
+        topEdgeBuffer.join(&topEdgeCollector);
+        hintBuffer.join(&hintCollector);
+
+        accAdaptor.setTestData(numInputs, accInput);
+        gyroAdaptor.setTestData(numGyro, gyroInput);
+
+        marshallingBin.start();
+        filterBin.start();
+
+        for (int i = 0, g = 0; i < numInputs; ++i) {
+            if (g < numGyro && gyroInput[g].timestamp_ < accInput[i].timestamp_) {
+                gyroAdaptor.pushNewData();
+                ++g;
+            }
+            accAdaptor.pushNewData();
+        }
+
+        filterBin.stop();
+        marshallingBin.stop();
+
+        // Portrait is accepted after the settle time, the final landscape
+        // after averaging turns it over and it has settled
+        QList<PoseData>& topEdges = topEdgeCollector.samples;
+        QList<PoseData>& hints = hintCollector.samples;
+        QCOMPARE(topEdges.first().orientation_, PoseData::BottomUp);
+        QCOMPARE(topEdges.first().timestamp_, (quint64)60000);
+        QCOMPARE(hints.first().timestamp_, (quint64)0);
+        QCOMPARE(topEdges.last().orientation_, PoseData::LeftUp);
+        QCOMPARE(topEdges.last().timestamp_, (quint64)1260000);
+        QCOMPARE(hints.last().timestamp_, (quint64)1200000);
+        QCOMPARE(interpreter->confidence(), 100);
+
+        if (veto) {
+            // The tilt happened during motion and is ignored
+            QCOMPARE(topEdges.size(), 2);
+            QCOMPARE(hints.size(), 2);
+        } else {
+            // Without a gyroscope the tilt causes a false rotation and back
+            QCOMPARE(topEdges.size(), 4);
+            QCOMPARE(topEdges.at(1).orientation_, PoseData::LeftUp);
+            QCOMPARE(topEdges.at(1).timestamp_, (quint64)660000);
+            QCOMPARE(topEdges.at(2).orientation_, PoseData::BottomUp);
+            QCOMPARE(hints.size(), 4);
+            QCOMPARE(hints.at(1).timestamp_, (quint64)600000);
+        }
+
+        delete orientationInterpreterFilter;
+    }
+}
+
+void FilterApiTest::testOrientationDefaults()
+{
+    // Default decisions follow each averaged sample, the same as with
+    // scoring, settling and the motion veto turned off
+    const int numInputs = 100;
+    AccelerationData accInput[numInputs];
+    for (int i = 0; i < numInputs; ++i) {
+        quint64 t = i * 20000;
+        bool tilted = (t > 400000 && t <= 600000) || t > 1000000;
+        accInput[i] = tilted ? AccelerationData(t, -981, 0, 100) : AccelerationData(t, 0, -981, 100);
+    }
+
+    DummyAdaptor<AccelerationData> accAdaptor;
+    PoseCollector defaultCollector;
+    PoseCollector plainCollector;
+
+    FilterBase* defaultFilter = OrientationInterpreter::factoryMethod();
+    FilterBase* plainFilter = OrientationInterpreter::factoryMethod();
+    ((OrientationInterpreter*)plainFilter)->setDecision(0, 0, 0);
+    ((OrientationInterpreter*)plainFilter)->setMotionVeto(0, 0);
+    RingBuffer<PoseData> defaultBuffer(10);
+    RingBuffer<PoseData> plainBuffer(10);
+
+    Bin filterBin;
+    filterBin.add(&accAdaptor, "accelerometer");
+    filterBin.add(defaultFilter, "defaultfilter");
+    filterBin.add(plainFilter, "plainfilter");
+    filterBin.add(&defaultBuffer, "defaultbuffer");
+    filterBin.add(&plainBuffer, "plainbuffer");
+    filterBin.join("accelerometer", "source", "defaultfilter", "accsink");
+    filterBin.join("accelerometer", "source", "plainfilter", "accsink");
+    filterBin.join("defaultfilter", "topedge", "defaultbuffer", "sink");
+    filterBin.join("plainfilter", "topedge", "plainbuffer", "sink");
+
+    Bin marshallingBin;
+    marshallingBin.add(&defaultCollector, "defaultcollector");
+    marshallingBin.add(&plainCollector, "plaincollector");
+    defaultBuffer.join(&defaultCollector);
+    plainBuffer.join(&plainCollector);
+
+    accAdaptor.setTestData(numInputs, accInput);
+    marshallingBin.start();
+    filterBin.start();
+    for (int i = 0; i < numInputs; ++i) {
+        accAdaptor.pushNewData();
+    }
+    filterBin.stop();
+    marshallingBin.stop();
+
+    QList<PoseData>& defaults = defaultCollector.samples;
+    QList<PoseData>& plain = plainCollector.samples;
+    QCOMPARE(defaults.size(), 4);
+    QCOMPARE(defaults.size(), plain.size());
+    for (int i = 0; i < defaults.size(); ++i) {
+        QCOMPARE(defaults.at(i).orientation_, plain.at(i).orientation_);
+        QCOMPARE(defaults.at(i).timestamp_, plain.at(i).timestamp_);
+    }
+
+    delete defaultFilter;
+    delete plainFilter;
+}
+
 void FilterApiTest::testDeclinationFilter()
 {
     // Input data to feed to the filter
@@ -488,4 +834,600 @@ void FilterApiTest::testRotationFilter()
     delete rotationFilter;
 }
 
+void FilterApiTest::testRotationAttitude()
+{
+    // Device attitudes as (yaw, pitch, roll) in degrees, including near
+    // vertical and upside down ones where Euler angles break down
+    const double attitudes[][3] = {
+        { 0, 0, 0 }, { 90, 0, 0 }, { -135, 30, 10 }, { 45, 89, 0 },
+        { 10, -89, 60 }, { 200, 20, 179 }, { 0, 0, 180 }
+    };
+    const double inclination = 60 * M_PI / 180;
+    const double world[2][3] = {
+        { 0, 0, 9810 },                                               // gravity reaction
+        { 0, 48000 * cos(inclination), -48000 * sin(inclination) }    // magnetic field
+    };
+
+    for (unsigned n = 0; n < sizeof(attitudes) / sizeof(attitudes[0]); ++n) {
+        double a = attitudes[n][0] * M_PI / 180;
+        double b = attitudes[n][1] * M_PI / 180;
+        double c = attitudes[n][2] * M_PI / 180;
+        double rz[3][3] = { { cos(a), -sin(a), 0 }, { sin(a), cos(a), 0 }, { 0, 0, 1 } };
+        double rx[3][3] = { { 1, 0, 0 }, { 0, cos(b), -sin(b) }, { 0, sin(b), cos(b) } };
+        double ry[3][3] = { { cos(c), 0, sin(c) }, { 0, 1, 0 }, { -sin(c), 0, cos(c) } };
+
+        // r = rz * rx * ry maps device frame to world frame
+        double t[3][3], r[3][3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                t[i][j] = rz[i][0] * rx[0][j] + rz[i][1] * rx[1][j] + rz[i][2] * rx[2][j];
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                r[i][j] = t[i][0] * ry[0][j] + t[i][1] * ry[1][j] + t[i][2] * ry[2][j];
+            }
+        }
+
+        // Sensors see world vectors rotated into device frame by r^T
+        double device[2][3];
+        for (int v = 0; v < 2; ++v) {
+            for (int j = 0; j < 3; ++j) {
+                device[v][j] = r[0][j] * world[v][0] + r[1][j] * world[v][1] + r[2][j] * world[v][2];
+            }
+        }
+        TimedXyzData accel(0, device[0][0], device[0][1], device[0][2]);
+        CalibratedMagneticFieldData mag(0, qRound(device[1][0]), qRound(device[1][1]), qRound(device[1][2]), 0, 0, 0, 3);
+
+        AttitudeData attitude;
+        QVERIFY(RotationFilter::triad(accel, mag, attitude));
+        float norm = attitude.w_ * attitude.w_ + attitude.x_ * attitude.x_ +
+                     attitude.y_ * attitude.y_ + attitude.z_ * attitude.z_;
+        QVERIFY(qAbs(norm - 1) < 1e-5f);
+        QVERIFY(attitude.w_ >= 0);
+
+        float m[3][3];
+        attitude.toMatrix(m);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                QVERIFY2(qAbs(m[i][j] - r[i][j]) < 1e-3,
+                         qPrintable(QString("attitude %1, element %2,%3: %4 != %5").arg(n).arg(i).arg(j).arg(m[i][j]).arg(r[i][j])));
+            }
+        }
+    }
+
+    // Field parallel to gravity or missing leaves heading undefined
+    AttitudeData attitude;
+    QVERIFY(!RotationFilter::triad(TimedXyzData(0, 0, 0, 9810), CalibratedMagneticFieldData(0, 0, 0, -48000, 0, 0, 0, 3), attitude));
+    QVERIFY(!RotationFilter::triad(TimedXyzData(0, 0, 0, 9810), CalibratedMagneticFieldData(), attitude));
+    QVERIFY(!RotationFilter::triad(TimedXyzData(0, 0, 0, 0), CalibratedMagneticFieldData(0, 0, 48000, 0, 0, 0, 0, 3), attitude));
+}
+
+void FilterApiTest::testEnvironmentFilter()
+{
+    // Reference values computed from the published formulas
+    QVERIFY(qAbs(EnvironmentFilter::dewPoint(20, 50) - 9.3f) < 0.1f);
+    QVERIFY(qAbs(EnvironmentFilter::dewPoint(30, 80) - 26.2f) < 0.1f);
+    QVERIFY(qAbs(EnvironmentFilter::dewPoint(25, 0) - EnvironmentFilter::dewPoint(25, 1)) < 0.001f);
+    QVERIFY(qAbs(EnvironmentFilter::heatIndex(20, 50) - 19.4f) < 0.1f);
+    QVERIFY(qAbs(EnvironmentFilter::heatIndex(32, 60) - 37.1f) < 0.1f);
+    QVERIFY(qAbs(EnvironmentFilter::heatIndex(40, 40) - 48.3f) < 0.1f);
+
+    TimedUnsigned temperatureInput[] = {
+        TimedUnsigned(1, 20),
+        TimedUnsigned(3, 20),
+        TimedUnsigned(5, 21),
+        TimedUnsigned(7, 22),
+        TimedUnsigned(9, 22)
+    };
+
+    TimedUnsigned humidityInput[] = {
+        TimedUnsigned(2, 50),
+        TimedUnsigned(4, 51),
+        TimedUnsigned(6, 51),
+        TimedUnsigned(8, 51),
+        TimedUnsigned(10, 55)
+    };
+
+    // First complete pair is always reported, after that only changes
+    // of at least 2 degrees or 3 % are.
+    EnvironmentData expectedResult[] = {
+        EnvironmentData(2, 20, 50, 0, 0),
+        EnvironmentData(7, 22, 51, 0, 0),
+        EnvironmentData(10, 22, 55, 0, 0)
+    };
+
+    int numInputs = (sizeof(temperatureInput) / sizeof(TimedUnsigned));
+    int numOutputs = (sizeof(expectedResult) / sizeof(EnvironmentData));
+
+    DummyAdaptor<TimedUnsigned> temperatureAdaptor;
+    DummyAdaptor<TimedUnsigned> humidityAdaptor;
+    DummyDataEmitter<EnvironmentData> dbusEmitter;
+
+    FilterBase* environmentFilter = EnvironmentFilter::factoryMethod();
+    ((EnvironmentFilter*)environmentFilter)->setThresholds(2, 3);
+    QSignalSpy spy((EnvironmentFilter*)environmentFilter, SIGNAL(significantChange()));
+    RingBuffer<EnvironmentData> outputBuffer(10);
+
+    Bin filterBin;
+    filterBin.add(&temperatureAdaptor, "temperature");
+    filterBin.add(&humidityAdaptor, "humidity");
+    filterBin.add(environmentFilter, "environmentfilter");
+    filterBin.add(&outputBuffer, "buffer");
+
+    filterBin.join("temperature", "source", "environmentfilter", "temperaturesink");
+    filterBin.join("humidity", "source", "environmentfilter", "humiditysink");
+    filterBin.join("environmentfilter", "source", "buffer", "sink");
+
+    Bin marshallingBin;
+    marshallingBin.add(&dbusEmitter, "testdataemitter");
+    outputBuffer.join(&dbusEmitter);
+
+    temperatureAdaptor.setTestData(numInputs, temperatureInput);
+    humidityAdaptor.setTestData(numInputs, humidityInput);
+    dbusEmitter.setExpectedData(numOutputs, expectedResult);
+
+    marshallingBin.start();
+    filterBin.start();
+
+    for (int i = 0; i < numInputs; ++i) {
+        temperatureAdaptor.pushNewData();
+        humidityAdaptor.pushNewData();
+    }
+
+    filterBin.stop();
+    marshallingBin.stop();
+
+    QCOMPARE(dbusEmitter.numSamplesReceived(), numOutputs);
+    QCOMPARE(spy.count(), numOutputs);
+
+    delete environmentFilter;
+}
+
+void FilterApiTest::testIntervalBackoff()
+{
+    // 1 s requested, 4 samples per backoff period, up to 10 s
+    IntervalBackoff backoff(10000000, 4);
+    backoff.reset(1000000);
+    QCOMPARE(backoff.interval(), 1000000u);
+    QCOMPARE(backoff.period(), 4000);
+
+    // Stable readings double the interval every period up to the maximum
+    QVERIFY(backoff.expire());
+    QCOMPARE(backoff.interval(), 2000000u);
+    QCOMPARE(backoff.period(), 8000);
+    QVERIFY(backoff.expire());
+    QVERIFY(backoff.expire());
+    QCOMPARE(backoff.interval(), 8000000u);
+    QVERIFY(backoff.expire());
+    QCOMPARE(backoff.interval(), 10000000u);
+    QVERIFY(!backoff.expire());
+    QCOMPARE(backoff.interval(), 10000000u);
+
+    // A change drops back to the requested interval at once
+    QVERIFY(backoff.change());
+    QCOMPARE(backoff.interval(), 1000000u);
+
+    // A change at the requested interval holds off the next backoff
+    QVERIFY(!backoff.change());
+    QVERIFY(!backoff.expire());
+    QCOMPARE(backoff.interval(), 1000000u);
+    QVERIFY(backoff.expire());
+    QCOMPARE(backoff.interval(), 2000000u);
+
+    // A new request starts over
+    backoff.reset(5000000);
+    QCOMPARE(backoff.interval(), 5000000u);
+    QCOMPARE(backoff.requested(), 5000000u);
+    QVERIFY(backoff.expire());
+    QCOMPARE(backoff.interval(), 10000000u);
+}
+
+/**
+ * Collects posture output.
+ */
+class PostureCollector : public DataEmitter<PostureData>
+{
+public:
+    PostureCollector() : DataEmitter<PostureData>(10) {}
+
+    QList<PostureData> samples;
+
+protected:
+    void emitData(const PostureData& data) { samples.append(data); }
+};
+
+void FilterApiTest::testHingeFilter()
+{
+    float angle = -1;
+    AccelerationData flat(0, 0, 0, 1000);
+
+    // Lid gravity turned opposite to the opening of the lid
+    QVERIFY(HingeFilter::hingeAngle(flat, AccelerationData(0, 0, -1000, 0), HingeFilter::AxisX, 0.5f, angle));
+    QVERIFY(qAbs(angle - 90) < 0.01f);
+    QVERIFY(HingeFilter::hingeAngle(flat, flat, HingeFilter::AxisX, 0.5f, angle));
+    QVERIFY(qAbs(angle - 180) < 0.01f);
+    QVERIFY(HingeFilter::hingeAngle(flat, AccelerationData(0, 0, 1000, 0), HingeFilter::AxisX, 0.5f, angle));
+    QVERIFY(qAbs(angle - 270) < 0.01f);
+    QVERIFY(HingeFilter::hingeAngle(flat, AccelerationData(0, 0, -1000, 0), HingeFilter::AxisNegX, 0.5f, angle));
+    QVERIFY(qAbs(angle - 270) < 0.01f);
+    QVERIFY(HingeFilter::hingeAngle(flat, AccelerationData(0, 1000, 0, 0), HingeFilter::AxisY, 0.5f, angle));
+    QVERIFY(qAbs(angle - 90) < 0.01f);
+
+    // Undefined while standing on the hinge
+    QVERIFY(!HingeFilter::hingeAngle(AccelerationData(0, 1000, 0, 100), flat, HingeFilter::AxisX, 0.5f, angle));
+
+    HingeFilter::Axis axis;
+    QVERIFY(HingeFilter::parseAxis("-y", axis));
+    QCOMPARE(axis, HingeFilter::AxisNegY);
+    QVERIFY(!HingeFilter::parseAxis("z", axis));
+
+    QCOMPARE(HingeFilter::classify(100, PostureData::Unknown, 10), PostureData::Laptop);
+    QCOMPARE(HingeFilter::classify(170, PostureData::Laptop, 10), PostureData::Laptop);
+    QCOMPARE(HingeFilter::classify(180, PostureData::Laptop, 10), PostureData::Flat);
+    QCOMPARE(HingeFilter::classify(5, PostureData::Unknown, 10), PostureData::Closed);
+    QCOMPARE(HingeFilter::classify(355, PostureData::Closed, 10), PostureData::Closed);
+    QCOMPARE(HingeFilter::classify(355, PostureData::Unknown, 10), PostureData::Tablet);
+    QCOMPARE(HingeFilter::classify(250, PostureData::Tablet, 10), PostureData::Tent);
+
+    // Laptop is reported after three pairs, the moving sample is ignored
+    // and flat is reported after three more.
+    AccelerationData baseInput[8];
+    AccelerationData lidInput[8];
+    for (int i = 0; i < 8; ++i) {
+        baseInput[i] = AccelerationData(i * 10000, 0, 0, 1000);
+        lidInput[i] = AccelerationData(i * 10000 + 5, 0, -1000, 0);
+        if (i == 3)
+            lidInput[i].y_ = -1500;
+        if (i >= 4)
+            lidInput[i] = AccelerationData(i * 10000 + 5, 0, 0, 1000);
+    }
+
+    DummyAdaptor<AccelerationData> baseAdaptor;
+    DummyAdaptor<AccelerationData> lidAdaptor;
+    PostureCollector collector;
+
+    FilterBase* hingeFilter = HingeFilter::factoryMethod();
+    ((HingeFilter*)hingeFilter)->setAxis(HingeFilter::AxisX);
+    ((HingeFilter*)hingeFilter)->setGating(0.5f, 0.15f, 50000, 3, 10);
+    RingBuffer<PostureData> outputBuffer(10);
+
+    Bin filterBin;
+    filterBin.add(&baseAdaptor, "base");
+    filterBin.add(&lidAdaptor, "lid");
+    filterBin.add(hingeFilter, "hingefilter");
+    filterBin.add(&outputBuffer, "buffer");
+
+    filterBin.join("base", "source", "hingefilter", "basesink");
+    filterBin.join("lid", "source", "hingefilter", "lidsink");
+    filterBin.join("hingefilter", "source", "buffer", "sink");
+
+    Bin marshallingBin;
+    marshallingBin.add(&collector, "collector");
+    outputBuffer.join(&collector);
+
+    baseAdaptor.setTestData(8, baseInput);
+    lidAdaptor.setTestData(8, lidInput);
+
+    marshallingBin.start();
+    filterBin.start();
+
+    for (int i = 0; i < 8; ++i) {
+        baseAdaptor.pushNewData();
+        lidAdaptor.pushNewData();
+    }
+
+    filterBin.stop();
+    marshallingBin.stop();
+
+    QCOMPARE(collector.samples.size(), 2);
+    QCOMPARE(collector.samples.at(0).posture_, PostureData::Laptop);
+    QCOMPARE(collector.samples.at(0).timestamp_, (quint64)10005);
+    QVERIFY(qAbs(collector.samples.at(0).angle_ - 90) < 0.01f);
+    QCOMPARE(collector.samples.at(1).posture_, PostureData::Flat);
+    QCOMPARE(collector.samples.at(1).timestamp_, (quint64)50005);
+    QCOMPARE(((HingeFilter*)hingeFilter)->posture(), (int)PostureData::Flat);
+
+    delete hingeFilter;
+}
+
+/**
+ * Pushes all test data of an adaptor from its own thread.
+ */
+class SamplePusher : public QThread
+{
+public:
+    SamplePusher(DummyAdaptor<AccelerationData>* adaptor, int count) : adaptor_(adaptor), count_(count) {}
+
+    void run()
+    {
+        for (int i = 0; i < count_; ++i)
+            adaptor_->pushNewData();
+    }
+
+private:
+    DummyAdaptor<AccelerationData>* adaptor_;
+    int count_;
+};
+
+void FilterApiTest::testHingeFilterThreads()
+{
+    // Base and lid arrive from different threads, as from two adaptors
+    const int count = 5000;
+    QVector<AccelerationData> baseInput(count, AccelerationData(0, 0, 0, 1000));
+    QVector<AccelerationData> lidInput(count, AccelerationData(0, 0, -1000, 0));
+
+    DummyAdaptor<AccelerationData> baseAdaptor;
+    DummyAdaptor<AccelerationData> lidAdaptor;
+    PostureCollector collector;
+
+    HingeFilter* hingeFilter = (HingeFilter*)HingeFilter::factoryMethod();
+    hingeFilter->setGating(0.5f, 0.15f, 50000, 3, 10);
+    RingBuffer<PostureData> outputBuffer(10);
+    baseAdaptor.source("source")->join(hingeFilter->sink("basesink"));
+    lidAdaptor.source("source")->join(hingeFilter->sink("lidsink"));
+    hingeFilter->source("source")->join(outputBuffer.sink("sink"));
+    outputBuffer.join(&collector);
+
+    baseAdaptor.setTestData(count, baseInput.data());
+    lidAdaptor.setTestData(count, lidInput.data());
+
+    SamplePusher basePusher(&baseAdaptor, count);
+    SamplePusher lidPusher(&lidAdaptor, count);
+    basePusher.start();
+    lidPusher.start();
+    for (int i = 0; i < count && !basePusher.isFinished(); ++i) {
+        PostureData current = hingeFilter->current();
+        QVERIFY(current.posture_ == PostureData::Unknown || current.posture_ == PostureData::Laptop);
+    }
+    QVERIFY(basePusher.wait(10000));
+    QVERIFY(lidPusher.wait(10000));
+
+    QCOMPARE(collector.samples.size(), 1);
+    QCOMPARE(collector.samples.at(0).posture_, PostureData::Laptop);
+    QCOMPARE(hingeFilter->current().posture_, PostureData::Laptop);
+    QVERIFY(qAbs(hingeFilter->current().angle_ - 90) < 0.01f);
+
+    outputBuffer.unjoin(&collector);
+    delete hingeFilter;
+}
+
+/**
+ * Collects compass output for comparisons which are not exact.
+ */
+class CompassCollector : public DataEmitter<CompassData>
+{
+public:
+    CompassCollector() : DataEmitter<CompassData>(10) {}
+
+    QList<CompassData> samples;
+
+protected:
+    void emitData(const CompassData& data) { samples.append(data); }
+};
+
+void FilterApiTest::testCompassFilter()
+{
+    // Level device, field pointing north: heading stays at 0 and is
+    // reported once, and again when calibration level changes.
+    CalibratedMagneticFieldData magInput[] = {
+        CalibratedMagneticFieldData(1, 0, 200, -400, 0, 200, -400, 3),
+        CalibratedMagneticFieldData(3, 0, 200, -400, 0, 200, -400, 3),
+        CalibratedMagneticFieldData(5, 0, 200, -400, 0, 200, -400, 2)
+    };
+    AccelerationData accInput[] = {
+        AccelerationData(2, 0, 0, 1000),
+        AccelerationData(4, 0, 0, 1000)
+    };
+    CompassData expectedResult[] = {
+        CompassData(3, 0, 3),
+        CompassData(5, 0, 2)
+    };
+    int numOutputs = (sizeof(expectedResult) / sizeof(CompassData));
+
+    DummyAdaptor<CalibratedMagneticFieldData> magAdaptor;
+    DummyAdaptor<AccelerationData> accAdaptor;
+    DummyDataEmitter<CompassData> dbusEmitter;
+
+    FilterBase* compassFilter = CompassFilter::factoryMethod();
+    ((CompassFilter*)compassFilter)->setResolution(1);
+    RingBuffer<CompassData> outputBuffer(10);
+
+    Bin filterBin;
+    filterBin.add(&magAdaptor, "magnetometer");
+    filterBin.add(&accAdaptor, "accelerometer");
+    filterBin.add(compassFilter, "compassfilter");
+    filterBin.add(&outputBuffer, "buffer");
+
+    filterBin.join("magnetometer", "source", "compassfilter", "magsink");
+    filterBin.join("accelerometer", "source", "compassfilter", "accsink");
+    filterBin.join("compassfilter", "magnorthangle", "buffer", "sink");
+
+    Bin marshallingBin;
+    marshallingBin.add(&dbusEmitter, "testdataemitter");
+    outputBuffer.join(&dbusEmitter);
+
+    magAdaptor.setTestData(3, magInput);
+    accAdaptor.setTestData(2, accInput);
+    dbusEmitter.setExpectedData(numOutputs, expectedResult);
+
+    marshallingBin.start();
+    filterBin.start();
+
+    magAdaptor.pushNewData();
+    accAdaptor.pushNewData();
+    magAdaptor.pushNewData();
+    accAdaptor.pushNewData();
+    magAdaptor.pushNewData();
+
+    filterBin.stop();
+    marshallingBin.stop();
+
+    QCOMPARE(dbusEmitter.numSamplesReceived(), numOutputs);
+    delete compassFilter;
+
+    // Tilt compensation: the same field seen by a level device and by
+    // one rolled by asin(0.6) gives the same heading of 45 degrees.
+    // Without compensation the rolled device would read 61 degrees.
+    CalibratedMagneticFieldData levelMag(0, -300, 300, -500, 0, 0, 0, 3);
+    CalibratedMagneticFieldData rolledMag(0, -540, 300, -220, 0, 0, 0, 3);
+    AccelerationData levelAcc(0, 0, 0, 1000);
+    AccelerationData rolledAcc(0, 600, 0, 800);
+
+    CalibratedMagneticFieldData* mag[] = { &levelMag, &rolledMag };
+    AccelerationData* acc[] = { &levelAcc, &rolledAcc };
+    for (int n = 0; n < 2; ++n) {
+        DummyAdaptor<CalibratedMagneticFieldData> magSource;
+        DummyAdaptor<AccelerationData> accSource;
+        CompassCollector collector;
+        FilterBase* filter = CompassFilter::factoryMethod();
+        RingBuffer<CompassData> buffer(10);
+
+        Bin bin;
+        bin.add(&magSource, "magnetometer");
+        bin.add(&accSource, "accelerometer");
+        bin.add(filter, "compassfilter");
+        bin.add(&buffer, "buffer");
+        bin.join("magnetometer", "source", "compassfilter", "magsink");
+        bin.join("accelerometer", "source", "compassfilter", "accsink");
+        bin.join("compassfilter", "magnorthangle", "buffer", "sink");
+        buffer.join(&collector);
+        bin.start();
+
+        accSource.setTestData(1, acc[n]);
+        accSource.pushNewData();
+        for (int i = 0; i < 30; ++i) {
+            magSource.setTestData(1, mag[n]);
+            magSource.pushNewData();
+            collector.pushNewData();
+        }
+        bin.stop();
+
+        QVERIFY(!collector.samples.isEmpty());
+        QVERIFY(qAbs(collector.samples.last().degrees_ - 45) <= 1);
+        delete filter;
+    }
+}
+
+void FilterApiTest::testDeferredSamples()
+{
+    // Several samples of one input read in a single epoch each give an
+    // output; only samples of different inputs are coalesced.
+    TimedXyzData accInput[] = {
+        TimedXyzData(1,   0,   0,-500),
+        TimedXyzData(3,   0,-500,   0)
+    };
+    TimedXyzData expectedRotation[] = {
+        TimedXyzData(1,   0,   0,   0),
+        TimedXyzData(3,  90,   0,   0)
+    };
+
+    DummyAdaptor<TimedXyzData> accAdaptor;
+    DummyDataEmitter<TimedXyzData> rotationEmitter;
+    FilterBase* rotationFilter = RotationFilter::factoryMethod();
+    RingBuffer<TimedXyzData> rotationBuffer(10);
+
+    Bin rotationBin;
+    rotationBin.add(&accAdaptor, "adapter");
+    rotationBin.add(rotationFilter, "rotationfilter");
+    rotationBin.add(&rotationBuffer, "buffer");
+    rotationBin.join("adapter", "source", "rotationfilter", "accelerometersink");
+    rotationBin.join("rotationfilter", "source", "buffer", "sink");
+    rotationBuffer.join(&rotationEmitter);
+
+    accAdaptor.setTestData(2, accInput);
+    rotationEmitter.setExpectedData(2, expectedRotation);
+    rotationBin.start();
+    {
+        Scheduler::Epoch epoch;
+        accAdaptor.pushNewData();
+        accAdaptor.pushNewData();
+    }
+    rotationEmitter.pushNewData();
+    rotationBin.stop();
+
+    QCOMPARE(rotationEmitter.numSamplesReceived(), 2);
+    delete rotationFilter;
+
+    CalibratedMagneticFieldData magInput[] = {
+        CalibratedMagneticFieldData(1, -300, 300, -500, 0, 0, 0, 3),
+        CalibratedMagneticFieldData(3, 300, -300, -500, 0, 0, 0, 3)
+    };
+    AccelerationData levelAcc(0, 0, 0, 1000);
+
+    DummyAdaptor<CalibratedMagneticFieldData> magAdaptor;
+    DummyAdaptor<AccelerationData> levelAdaptor;
+    CompassCollector collector;
+    FilterBase* compassFilter = CompassFilter::factoryMethod();
+    ((CompassFilter*)compassFilter)->setResolution(0);
+    RingBuffer<CompassData> compassBuffer(10);
+
+    Bin compassBin;
+    compassBin.add(&magAdaptor, "magnetometer");
+    compassBin.add(&levelAdaptor, "accelerometer");
+    compassBin.add(compassFilter, "compassfilter");
+    compassBin.add(&compassBuffer, "buffer");
+    compassBin.join("magnetometer", "source", "compassfilter", "magsink");
+    compassBin.join("accelerometer", "source", "compassfilter", "accsink");
+    compassBin.join("compassfilter", "magnorthangle", "buffer", "sink");
+    compassBuffer.join(&collector);
+    compassBin.start();
+
+    levelAdaptor.setTestData(1, &levelAcc);
+    levelAdaptor.pushNewData();
+    magAdaptor.setTestData(2, magInput);
+    {
+        Scheduler::Epoch epoch;
+        magAdaptor.pushNewData();
+        magAdaptor.pushNewData();
+    }
+    collector.pushNewData();
+    compassBin.stop();
+
+    QCOMPARE(collector.samples.count(), 2);
+    QCOMPARE(collector.samples.at(0).timestamp_, (quint64)1);
+    QCOMPARE(collector.samples.at(1).timestamp_, (quint64)3);
+    delete compassFilter;
+}
+
+void FilterApiTest::benchmarkCompassFilter()
+{
+    // Magnetometer samples with a cached tilt, no output suppression
+    CalibratedMagneticFieldData magInput[] = {
+        CalibratedMagneticFieldData(0, -540, 300, -220, 0, 0, 0, 3),
+        CalibratedMagneticFieldData(0, 540, -300, 220, 0, 0, 0, 3)
+    };
+    AccelerationData accInput(0, 600, 0, 800);
+
+    DummyAdaptor<CalibratedMagneticFieldData> magAdaptor;
+    DummyAdaptor<AccelerationData> accAdaptor;
+    FilterBase* compassFilter = CompassFilter::factoryMethod();
+    ((CompassFilter*)compassFilter)->setResolution(0);
+    RingBuffer<CompassData> outputBuffer(10);
+
+    Bin filterBin;
+    filterBin.add(&magAdaptor, "magnetometer");
+    filterBin.add(&accAdaptor, "accelerometer");
+    filterBin.add(compassFilter, "compassfilter");
+    filterBin.add(&outputBuffer, "buffer");
+    filterBin.join("magnetometer", "source", "compassfilter", "magsink");
+    filterBin.join("accelerometer", "source", "compassfilter", "accsink");
+    filterBin.join("compassfilter", "magnorthangle", "buffer", "sink");
+    filterBin.start();
+
+    accAdaptor.setTestData(1, &accInput);
+    accAdaptor.pushNewData();
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            magAdaptor.setTestData(2, magInput);
+            magAdaptor.pushNewData();
+            magAdaptor.pushNewData();
+        }
+    }
+
+    filterBin.stop();
+    delete compassFilter;
+}
+
 QTEST_MAIN(FilterApiTest)
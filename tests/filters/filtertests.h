@@ -36,6 +36,8 @@
 #include "source.h"
 #include "orientationdata.h"
 #include "posedata.h"
+#include "environmentdata.h"
+#include "posturedata.h"
 
 class FilterApiTest : public QObject
 {
@@ -46,11 +48,23 @@ private slots:
     void init() {}
 
     void testCoordinateAlignFilter();
+    void testGyroscopeAlignFilter();
+    void testGyroscopeAlignReconfigure();
     void testTopEdgeInterpretationFilter();
     void testFaceInterpretationFilter();
     void testDeclinationFilter();
     void testOrientationInterpretationFilter();
+    void testOrientationDecision();
+    void testOrientationDefaults();
     void testRotationFilter();
+    void testRotationAttitude();
+    void testEnvironmentFilter();
+    void testIntervalBackoff();
+    void testHingeFilter();
+    void testHingeFilterThreads();
+    void testCompassFilter();
+    void testDeferredSamples();
+    void benchmarkCompassFilter();
 
     void cleanup() {}
     void cleanupTestCase() {}
@@ -161,6 +175,13 @@ public:
             QCOMPARE(d1->degrees_, d2->degrees_);
             QCOMPARE(d1->level_, d2->level_);
 
+        } else if (typeid(TYPE) == typeid(EnvironmentData)) {
+            EnvironmentData *d1 = (EnvironmentData *)&data;
+            EnvironmentData *d2 = (EnvironmentData *)&(data_[i]);
+            QCOMPARE(d1->timestamp_, d2->timestamp_);
+            QCOMPARE(d1->temperature_, d2->temperature_);
+            QCOMPARE(d1->humidity_, d2->humidity_);
+
         } else {
             QWARN("No comparison method for this type");
         }